@@ -24,9 +24,12 @@
 
 #include "AppDelegate.h"
 #include "Scenes/MainMenuScene.h"
+#include "Save/SaveManager.h"
+#include "Utils/AudioManager.h"
 #include "Utils/GameSettings.h"
+#include "Utils/JobSystem.h"
 
-// #define USE_AUDIO_ENGINE 1
+#define USE_AUDIO_ENGINE 1
 // #define USE_SIMPLE_AUDIO_ENGINE 1
 
 #if USE_AUDIO_ENGINE && USE_SIMPLE_AUDIO_ENGINE
@@ -54,6 +57,9 @@ AppDelegate::AppDelegate()
 
 AppDelegate::~AppDelegate() 
 {
+    // 先等待存档写入完成，再停止任务线程
+    SaveManager::getInstance()->flush();
+    JobSystem::destroyInstance();
 #if USE_AUDIO_ENGINE
     AudioEngine::end();
 #elif USE_SIMPLE_AUDIO_ENGINE
@@ -152,6 +158,9 @@ bool AppDelegate::applicationDidFinishLaunching() {
         }
     }
 
+    // 短音效在后台解码进音效库，避免战斗中首次播放卡顿
+    AudioManager::preload();
+
     // create a scene. it's an autorelease object
     auto scene = MainMenuScene::createScene();
 
@@ -164,6 +173,8 @@ bool AppDelegate::applicationDidFinishLaunching() {
 // This function will be called when the app is inactive. Note, when receiving a phone call it is invoked.
 void AppDelegate::applicationDidEnterBackground() {
     Director::getInstance()->stopAnimation();
+    // 进入后台可能被系统回收，确保存档已写入
+    SaveManager::getInstance()->flush();
 
 #if USE_AUDIO_ENGINE
     AudioEngine::pauseAll();
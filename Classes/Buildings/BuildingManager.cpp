@@ -229,6 +229,12 @@ void BuildingManager::loadConfigs() {
             config.bulletIsAOE = readBool(item, "bulletIsAOE", false);
             config.bulletAOERange = readFloat(item, "bulletAOERange", 0.0f);
 
+            config.simHP = FixedMath::fromFloats(config.HP);
+            config.simATK = FixedMath::fromFloats(config.ATK);
+            config.simATK_RANGE = FixedMath::fromFloats(config.ATK_RANGE);
+            config.simBulletSpeed = Fixed::fromFloat(config.bulletSpeed);
+            config.simBulletAOERange = Fixed::fromFloat(config.bulletAOERange);
+
             _defenceConfigs[config.id] = config;
         }
     }
@@ -280,6 +286,7 @@ void BuildingManager::loadConfigs() {
                 _enemyBaseId = config.id;
             }
 
+            config.simHP = FixedMath::fromFloats(config.HP);
             _productionConfigs[config.id] = config;
         }
     }
@@ -320,6 +327,7 @@ void BuildingManager::loadConfigs() {
             config.anim_idle_frames = readInt(item, "anim_idle_frames", config.anim_idle_frames);
             config.anim_idle_delay = readFloat(item, "anim_idle_delay", config.anim_idle_delay);
 
+            config.simHP = FixedMath::fromFloats(config.HP);
             _storageConfigs[config.id] = config;
         }
     }
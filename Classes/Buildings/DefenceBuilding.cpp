@@ -1,12 +1,18 @@
 ﻿#include "DefenceBuilding.h"
 #include "Soldier/Soldier.h"
+#include "Soldier/TargetingSystem.h"
 #include "Bullet/Bullet.h"
+#include "Core/BattleEventBus.h"
+#include "Core/CombatRules.h"
 #include "Utils/AnimationUtils.h"
+#include "Utils/AnimationLod.h"
+#include "Utils/AnimationRegistry.h"
 #include "Utils/EffectUtils.h"
 #include "Utils/AudioManager.h"
+#include "Map/BattleSpace.h"
+#include "Utils/FixedMath.h"
 #include <algorithm>
 #include <cmath>
-#include <limits>
 
 USING_NS_CC;
 
@@ -22,18 +28,16 @@ enum class ImpactSound {
 class DefenceBullet : public Bullet {
 public:
     static DefenceBullet* create(const std::string& spriteFrame,
-                                 float damage,
-                                 float speed,
-                                 bool isAOE,
-                                 float aoeRange,
+                                 Fixed damage,
+                                 Fixed speed,
+                                 Fixed splashRadius,
                                  bool allowSky,
                                  bool allowGround,
                                  const std::vector<Soldier*>* enemySoldiers,
                                  ImpactSound impactSound) {
         auto* bullet = new(std::nothrow) DefenceBullet();
         if (bullet && bullet->init(spriteFrame, damage, speed)) {
-            bullet->_isAOE = isAOE;
-            bullet->_aoeRange = aoeRange;
+            bullet->_splashRadius = splashRadius;
             bullet->_allowSky = allowSky;
             bullet->_allowGround = allowGround;
             bullet->_enemySoldiers = enemySoldiers;
@@ -47,25 +51,19 @@ public:
 
 protected:
     void onReachTarget() override {
-        float damage = getDamage();
-        if (_isAOE && _enemySoldiers && _aoeRange > 0.0f) {
-            auto* bulletParent = this->getParent();
-            Vec2 impactPos = this->getPosition();
+        Fixed damage = getDamage();
+        if (_enemySoldiers && _splashRadius > Fixed()) {
+            FixedVec2 impactPos = BattleSpace::simPositionOf(this);
             for (auto* soldier : *_enemySoldiers) {
                 if (!canHitSoldier(soldier)) {
                     continue;
                 }
-                Vec2 soldierPos = soldier->getPosition();
-                if (bulletParent && soldier->getParent()) {
-                    Vec2 worldPos = soldier->getParent()->convertToWorldSpace(soldierPos);
-                    soldierPos = bulletParent->convertToNodeSpace(worldPos);
-                }
-                if (impactPos.distance(soldierPos) <= _aoeRange) {
+                if (CombatRules::inRadius(impactPos, BattleSpace::simPositionOf(soldier), _splashRadius)) {
                     soldier->takeDamage(damage);
                 }
             }
         }
-        else if (auto* soldier = dynamic_cast<Soldier*>(_target)) {
+        else if (auto* soldier = static_cast<Soldier*>(EntityTable::lookup(_target, EntityKind::SOLDIER))) {
             if (canHitSoldier(soldier)) {
                 soldier->takeDamage(damage);
             }
@@ -93,64 +91,33 @@ private:
         if (!soldier || !soldier->getParent()) {
             return false;
         }
-        if (soldier->getCurrentHP() <= 0) {
+        if (soldier->getHP() <= Fixed()) {
             return false;
         }
-        if (soldier->isFlying()) {
-            return _allowSky;
-        }
-        return _allowGround;
+        return CombatRules::canHit(soldier->isFlying(), _allowSky, _allowGround);
     }
 
-    bool _isAOE = false;
-    float _aoeRange = 0.0f;
+    Fixed _splashRadius;            // 0 表示只伤害目标本身
     bool _allowSky = false;
     bool _allowGround = false;
     const std::vector<Soldier*>* _enemySoldiers = nullptr;
     ImpactSound _impactSound = ImpactSound::None;
 };
 
-Animation* buildNumberedAnimation(const std::string& prefix, int start, int end, float delay) {
-    Vector<SpriteFrame*> frames;
-    for (int i = start; i <= end; ++i) {
-        std::string framePath = StringUtils::format("%s%d.png", prefix.c_str(), i);
-        auto texture = Director::getInstance()->getTextureCache()->addImage(framePath);
-        if (!texture) {
-            continue;
-        }
-        Size size = texture->getContentSize();
-        auto frame = SpriteFrame::createWithTexture(texture, Rect(0, 0, size.width, size.height));
-        if (frame) {
-            frames.pushBack(frame);
-        }
-    }
-    if (frames.empty()) {
-        return nullptr;
-    }
-    return Animation::createWithSpriteFrames(frames, delay);
+bool isTreeConfig(const DefenceBuildingConfig* config) {
+    return config && config->spriteFrameName.find("buildings/Tree/") != std::string::npos;
 }
 
-Animation* getMagicImpactAnimation() {
-    static Animation* anim = nullptr;
-    if (!anim) {
-        anim = buildNumberedAnimation("buildings/magic/fire_", 1, 18, 0.05f);
-        if (anim) {
-            anim->retain();
-        }
+bool isMagicConfig(const DefenceBuildingConfig* config) {
+    if (!config) {
+        return false;
     }
-    return anim;
-}
-
-Animation* getFireLoopAnimation() {
-    static Animation* anim = nullptr;
-    if (!anim) {
-        anim = buildNumberedAnimation("buildings/fire/fire_", 1, 33, 0.06f);
-        if (anim) {
-            anim->retain();
-        }
+    if (config->name.find("MagicTower") != std::string::npos) {
+        return true;
     }
-    return anim;
+    return config->spriteFrameName.find("MagicTower") != std::string::npos;
 }
+
 } // namespace
 
 
@@ -164,6 +131,39 @@ void DefenceBuilding::clearEnemySoldiersIf(const std::vector<Soldier*>* soldiers
     }
 }
 
+void DefenceBuilding::preloadAssets(const DefenceBuildingConfig* config) {
+    if (!config) {
+        return;
+    }
+
+    auto* registry = AnimationRegistry::getInstance();
+    if (isTreeConfig(config)) {
+        registry->preload(AnimSeq::TREE_SWAY);
+        return;
+    }
+    if (isMagicConfig(config)) {
+        registry->preload(AnimSeq::MAGIC_IMPACT);
+    }
+    if (CombatRules::isFireTower(config)) {
+        registry->preload(AnimSeq::FIRE_LOOP);
+    }
+
+    std::string baseName = config->spriteFrameName;
+    if (baseName.size() > 4) {
+        std::string suffix = baseName.substr(baseName.size() - 4);
+        if (suffix == ".png" || suffix == ".PNG") {
+            baseName = baseName.substr(0, baseName.size() - 4);
+        }
+    }
+    // 与 playAnimation 使用同一缓存键，开火时直接命中 AnimationCache
+    AnimationUtils::buildAnimationFromFrames(baseName, config->anim_attack,
+        config->anim_attack_frames, config->anim_attack_delay);
+
+    if (CombatRules::firesProjectile(config)) {
+        Director::getInstance()->getTextureCache()->addImage(config->bulletSpriteFrameName);
+    }
+}
+
 
 DefenceBuilding* DefenceBuilding::create(const DefenceBuildingConfig* config, int level) {
     DefenceBuilding* pRet = new(std::nothrow) DefenceBuilding();
@@ -183,9 +183,9 @@ bool DefenceBuilding::init(const DefenceBuildingConfig* config, int level) {
     if (_level < 0) _level = 0;
     if (_level > _config->MAXLEVEL) _level = _config->MAXLEVEL;
 
-    _currentHP = getCurrentMaxHP();
-    _target = nullptr;
-    _lastAttackTime = 0.0f;
+    _currentHP = FixedMath::levelValue(_config->simHP, _level);
+    _target = EntityHandle();
+    _attackCooldown = 0.0f;
     _fireDamageTimer = 0.0f;
     _currentActionKey.clear();
 
@@ -226,9 +226,7 @@ bool DefenceBuilding::init(const DefenceBuildingConfig* config, int level) {
 
     if (isFireTower()) {
         ensureFireEffect();
-        if (_fireEffect) {
-            _fireEffect->setVisible(false);
-        }
+        setFireEffectActive(false);
     }
 
     return true;
@@ -259,7 +257,7 @@ void DefenceBuilding::setLevel(int level) {
         return;
     }
     _level = level;
-    _currentHP = getCurrentMaxHP();
+    _currentHP = FixedMath::levelValue(_config->simHP, _level);
     updateHealthBar(false);
 }
 
@@ -298,6 +296,14 @@ float DefenceBuilding::getCurrentATK_RANGE() const {
     return _config->ATK_RANGE.empty() ? 0.0f : _config->ATK_RANGE[0];
 }
 
+Fixed DefenceBuilding::getSimATK() const {
+    return CombatRules::towerATK(_config, _level);
+}
+
+Fixed DefenceBuilding::getSimRange() const {
+    return CombatRules::towerRange(_config, _level);
+}
+
 int DefenceBuilding::getLength() const {
     return _config->length;
 }
@@ -307,34 +313,36 @@ int DefenceBuilding::getWidth() const {
 }
 
 void DefenceBuilding::update(float dt) {
-    if (_currentHP <= 0) {
+    if (_currentHP <= Fixed()) {
         return;
     }
 
+    if (_attackCooldown > 0.0f) {
+        _attackCooldown -= dt;
+    }
+
     if (isFireTower()) {
         updateFireTower(dt);
         return;
     }
 
-    if (_target) {
-        auto* soldier = dynamic_cast<Soldier*>(_target);
-        if (!canTargetSoldier(soldier)) {
-            setTarget(nullptr);
-        }
+    if (!_target.isNull() && !canTargetSoldier(getTargetSoldier())) {
+        setTarget(nullptr);
     }
 
-    if (!_target) {
+    // 战斗场景启用批量寻敌时由寻敌阶段统一分配目标
+    if (_target.isNull() && !TargetingSystem::isBatching()) {
         findTarget();
     }
 
-    if (_target) {
-        auto* soldier = dynamic_cast<Soldier*>(_target);
+    if (!_target.isNull()) {
+        auto* soldier = getTargetSoldier();
         if (!canTargetSoldier(soldier)) {
             setTarget(nullptr);
             return;
         }
-        float dist = this->getPosition().distance(_target->getPosition());
-        bool inRange = dist <= getCurrentATK_RANGE();
+        Fixed dist = FixedMath::distance(BattleSpace::simPositionOf(this), BattleSpace::simPositionOf(soldier));
+        bool inRange = dist <= getSimRange();
 
         if (inRange) {
             attackTarget();
@@ -349,26 +357,24 @@ void DefenceBuilding::updateFireTower(float dt) {
     std::vector<Soldier*> fallback;
     const auto* candidates = getEnemySoldiers(fallback);
     if (!candidates || candidates->empty()) {
-        if (_fireEffect) {
-            _fireEffect->setVisible(false);
-        }
+        setFireEffectActive(false);
         _fireDamageTimer = 0.0f;
         setTarget(nullptr);
         return;
     }
 
-    const Vec2 selfPos = this->getPosition();
-    const float range = getCurrentATK_RANGE();
+    const FixedVec2 selfPos = BattleSpace::simPositionOf(this);
+    const Fixed range = getSimRange();
     std::vector<Soldier*> targets;
     targets.reserve(candidates->size());
     Soldier* nearest = nullptr;
-    float nearestDist = std::numeric_limits<float>::max();
+    Fixed nearestDist = Fixed::maxValue();
 
     for (auto* soldier : *candidates) {
         if (!canTargetSoldier(soldier)) {
             continue;
         }
-        float dist = selfPos.distance(soldier->getPosition());
+        Fixed dist = FixedMath::distance(selfPos, BattleSpace::simPositionOf(soldier));
         if (dist > range) {
             continue;
         }
@@ -380,32 +386,18 @@ void DefenceBuilding::updateFireTower(float dt) {
     }
 
     if (targets.empty()) {
-        if (_fireEffect) {
-            _fireEffect->setVisible(false);
-        }
+        setFireEffectActive(false);
         _fireDamageTimer = 0.0f;
         setTarget(nullptr);
         return;
     }
 
     if (nearest) {
-        auto* targetParent = nearest->getParent();
-        Vec2 worldPos = targetParent
-            ? targetParent->convertToWorldSpace(nearest->getPosition())
-            : nearest->getPosition();
-        updateFireEffectForTarget(worldPos);
-        if (_fireEffect) {
-            _fireEffect->setVisible(true);
-        }
+        updateFireEffectForTarget(BattleSpace::positionOf(nearest));
+        setFireEffectActive(true);
     }
 
-    float tickInterval = getCurrentATK_SPEED();
-    if (tickInterval <= 0.0f) {
-        tickInterval = 0.5f;
-    }
-    if (tickInterval < 0.15f) {
-        tickInterval = 0.15f;
-    }
+    const float tickInterval = CombatRules::towerAttackInterval(_config, _level);
 
     _fireDamageTimer += dt;
     if (_fireDamageTimer < tickInterval) {
@@ -414,7 +406,7 @@ void DefenceBuilding::updateFireTower(float dt) {
 
     while (_fireDamageTimer >= tickInterval) {
         _fireDamageTimer -= tickInterval;
-        float damage = getCurrentATK();
+        Fixed damage = getSimATK();
         for (auto* soldier : targets) {
             if (canTargetSoldier(soldier)) {
                 soldier->takeDamage(damage);
@@ -426,20 +418,17 @@ void DefenceBuilding::updateFireTower(float dt) {
 
 void DefenceBuilding::onExit() {
     setTarget(nullptr);
+    BattleSpace::forget(this);
     Node::onExit();
 }
 
 void DefenceBuilding::setTarget(cocos2d::Node* target) {
-    if (_target == target) {
-        return;
-    }
-    if (_target) {
-        _target->release();
-    }
-    _target = target;
-    if (_target) {
-        _target->retain();
-    }
+    _target = EntityTable::handleOf(target);
+}
+
+Soldier* DefenceBuilding::getTargetSoldier() const {
+    // 句柄按类别解析，只会得到士兵，无需 dynamic_cast
+    return static_cast<Soldier*>(EntityTable::lookup(_target, EntityKind::SOLDIER));
 }
 
 bool DefenceBuilding::canTargetSoldier(const Soldier* soldier) const {
@@ -447,16 +436,13 @@ bool DefenceBuilding::canTargetSoldier(const Soldier* soldier) const {
     if (!soldier || !soldier->getParent()) {
         return false;
     }
-    if (soldier->getCurrentHP() <= 0) {
+    if (soldier->getHP() <= Fixed()) {
         return false;
     }
     if (!_config) {
         return false;
     }
-    if (soldier->isFlying()) {
-        return _config->SKY_ABLE;
-    }
-    return _config->GROUND_ABLE;
+    return CombatRules::canHit(soldier->isFlying(), _config->SKY_ABLE, _config->GROUND_ABLE);
 }
 
 const std::vector<Soldier*>* DefenceBuilding::getEnemySoldiers(std::vector<Soldier*>& fallback) const {
@@ -486,8 +472,8 @@ const std::vector<Soldier*>* DefenceBuilding::getEnemySoldiers(std::vector<Soldi
     return fallback.empty() ? nullptr : &fallback;
 }
 
-void DefenceBuilding::applyAoeDamage(const Vec2& center, float range, float damage) const {
-    if (range <= 0.0f) {
+void DefenceBuilding::applyAoeDamage(const FixedVec2& center, Fixed range, Fixed damage) const {
+    if (range <= Fixed()) {
         return;
     }
 
@@ -501,40 +487,25 @@ void DefenceBuilding::applyAoeDamage(const Vec2& center, float range, float dama
         if (!canTargetSoldier(soldier)) {
             continue;
         }
-        if (center.distance(soldier->getPosition()) <= range) {
+        if (CombatRules::inRadius(center, BattleSpace::simPositionOf(soldier), range)) {
             soldier->takeDamage(damage);
         }
     }
 }
 
 bool DefenceBuilding::isTreeSprite() const {
-    if (!_config) {
-        return false;
-    }
-    return _config->spriteFrameName.find("buildings/Tree/") != std::string::npos;
+    return isTreeConfig(_config);
 }
 
 bool DefenceBuilding::isMagicTower() const {
-    if (!_config) {
-        return false;
-    }
-    if (_config->name.find("MagicTower") != std::string::npos) {
-        return true;
-    }
-    return _config->spriteFrameName.find("MagicTower") != std::string::npos;
+    return isMagicConfig(_config);
 }
 
 bool DefenceBuilding::isFireTower() const {
-    if (!_config) {
-        return false;
-    }
-    if (_config->name.find("FireTower") != std::string::npos) {
-        return true;
-    }
-    return _config->spriteFrameName.find("FireTower") != std::string::npos;
+    return CombatRules::isFireTower(_config);
 }
 
-void DefenceBuilding::spawnMagicImpact(const Vec2& worldPos) {
+void DefenceBuilding::spawnMagicImpact(const Vec2& battlePos) {
     AudioManager::playMagicHit();
 
     auto* parent = this->getParent();
@@ -542,7 +513,7 @@ void DefenceBuilding::spawnMagicImpact(const Vec2& worldPos) {
         return;
     }
 
-    auto* anim = getMagicImpactAnimation();
+    auto* anim = AnimationRegistry::getInstance()->get(AnimSeq::MAGIC_IMPACT);
     if (!anim) {
         return;
     }
@@ -562,8 +533,7 @@ void DefenceBuilding::spawnMagicImpact(const Vec2& worldPos) {
         return;
     }
 
-    Vec2 localPos = parent->convertToNodeSpace(worldPos);
-    effectSprite->setPosition(localPos);
+    effectSprite->setPosition(BattleSpace::toNodeSpace(parent, battlePos));
     parent->addChild(effectSprite, 30);
 
     auto sequence = Sequence::create(
@@ -579,7 +549,7 @@ void DefenceBuilding::ensureFireEffect() {
         return;
     }
 
-    auto* anim = getFireLoopAnimation();
+    auto* anim = AnimationRegistry::getInstance()->get(AnimSeq::FIRE_LOOP);
     if (!anim) {
         return;
     }
@@ -611,12 +581,29 @@ void DefenceBuilding::ensureFireEffect() {
     }
     effectSprite->setPosition(center);
     attachNode->addChild(effectSprite, 2);
-
-    effectSprite->runAction(RepeatForever::create(Animate::create(anim)));
     _fireEffect = effectSprite;
 }
 
-void DefenceBuilding::updateFireEffectForTarget(const Vec2& targetWorldPos) {
+void DefenceBuilding::setFireEffectActive(bool active) {
+    if (!_fireEffect) {
+        return;
+    }
+    _fireEffect->setVisible(active);
+
+    // 隐藏时停掉循环动画，显示时再启动，避免不可见的33帧动画持续推进
+    bool looping = _fireEffect->getNumberOfRunningActions() > 0;
+    if (active && !looping) {
+        auto* anim = AnimationRegistry::getInstance()->get(AnimSeq::FIRE_LOOP);
+        if (anim) {
+            _fireEffect->runAction(RepeatForever::create(Animate::create(anim)));
+        }
+    }
+    else if (!active && looping) {
+        _fireEffect->stopAllActions();
+    }
+}
+
+void DefenceBuilding::updateFireEffectForTarget(const Vec2& targetBattlePos) {
     ensureFireEffect();
     if (!_fireEffect) {
         return;
@@ -627,11 +614,8 @@ void DefenceBuilding::updateFireEffectForTarget(const Vec2& targetWorldPos) {
         return;
     }
 
-    auto* towerParent = this->getParent();
-    Vec2 worldCenter = towerParent
-        ? towerParent->convertToWorldSpace(this->getPosition())
-        : this->getPosition();
-    Vec2 dir = targetWorldPos - worldCenter;
+    Vec2 center = BattleSpace::positionOf(this);
+    Vec2 dir = targetBattlePos - center;
     float length = dir.length();
     if (length <= 0.01f) {
         return;
@@ -639,9 +623,7 @@ void DefenceBuilding::updateFireEffectForTarget(const Vec2& targetWorldPos) {
     dir.normalize();
 
     constexpr float kFireOffset = 8.0f;
-    Vec2 anchorWorld = worldCenter + dir * kFireOffset;
-    Vec2 localPos = effectParent->convertToNodeSpace(anchorWorld);
-    _fireEffect->setPosition(localPos);
+    _fireEffect->setPosition(BattleSpace::toNodeSpace(effectParent, center + dir * kFireOffset));
 
     float angle = CC_RADIANS_TO_DEGREES(std::atan2(dir.y, dir.x));
     _fireEffect->setRotation(-angle + 180.0f);
@@ -658,32 +640,28 @@ bool DefenceBuilding::playTreeAnimation(int frameCount, float delay, bool loop)
         delay = 0.1f;
     }
 
-    Animation* anim = Animation::create();
-    int loadedFrames = 0;
-    for (int i = 0; i < frameCount; ++i) {
-        std::string framePath = StringUtils::format("buildings/Tree/sprite_%04d.png", i);
-        auto tempSprite = Sprite::create(framePath);
-        if (tempSprite) {
-            Size frameSize = tempSprite->getContentSize();
-            auto frame = SpriteFrame::create(framePath, Rect(0, 0, frameSize.width, frameSize.height));
-            if (frame) {
-                anim->addSpriteFrame(frame);
-                loadedFrames++;
-            }
-        }
-    }
-
-    if (loadedFrames == 0) {
+    Animation* anim = AnimationRegistry::getInstance()->get(AnimSeq::TREE_SWAY);
+    if (!anim) {
         return false;
     }
 
-    anim->setDelayPerUnit(delay);
-    anim->setRestoreOriginalFrame(false);
+    // 帧数或帧间隔与注册表不同时，复用已加载的帧另建一个动画
+    const auto& sharedFrames = anim->getFrames();
+    int loadedFrames = std::min(frameCount, static_cast<int>(sharedFrames.size()));
+    if (loadedFrames != static_cast<int>(sharedFrames.size()) || anim->getDelayPerUnit() != delay) {
+        Vector<AnimationFrame*> frames;
+        for (int i = 0; i < loadedFrames; ++i) {
+            frames.pushBack(sharedFrames.at(i));
+        }
+        anim = Animation::create(frames, delay);
+    }
 
     _bodySprite->stopAllActions();
     if (loop) {
-        auto animate = Animate::create(anim);
-        _bodySprite->runAction(RepeatForever::create(animate));
+        auto act = AnimationLod::createLoop(anim);
+        if (act) {
+            _bodySprite->runAction(act);
+        }
     }
     else {
         auto sequence = Sequence::create(
@@ -731,64 +709,70 @@ void DefenceBuilding::playFallbackAttackEffect() {
 void DefenceBuilding::findTarget() {
     std::vector<Soldier*> fallback;
     const std::vector<Soldier*>* candidates = getEnemySoldiers(fallback);
-    if (!candidates || candidates->empty()) {
+    TowerTargetQuery query;
+    if (!candidates || candidates->empty() || !buildTargetQuery(query)) {
         return;
     }
 
-    Soldier* nearest = nullptr;
-    float nearestDist = 999999.0f;
-    const auto selfPos = this->getPosition();
-    float attackRange = getCurrentATK_RANGE();
+    std::vector<SoldierTarget> targets(candidates->size());
+    for (size_t i = 0; i < candidates->size(); ++i) {
+        TargetSelection::describeSoldier((*candidates)[i], targets[i]);
+    }
 
-    for (auto* soldier : *candidates) {
-        if (!canTargetSoldier(soldier)) {
-            continue;
-        }
+    int nearest = TargetSelection::selectSoldier(query, targets.data(), targets.size());
+    setTarget(nearest >= 0 ? (*candidates)[nearest] : nullptr);
+}
 
-        float dist = selfPos.distance(soldier->getPosition());
-        if (attackRange > 0.0f && dist > attackRange) {
-            continue;
-        }
-        if (dist < nearestDist) {
-            nearestDist = dist;
-            nearest = soldier;
-        }
+bool DefenceBuilding::needsTarget() const {
+    if (_currentHP <= Fixed() || !_config || isFireTower()) {
+        return false;
+    }
+    return _target.isNull() || !canTargetSoldier(getTargetSoldier());
+}
+
+bool DefenceBuilding::buildTargetQuery(TowerTargetQuery& query) const {
+    if (_currentHP <= Fixed() || !_config || isFireTower()) {
+        return false;
     }
+    query.position = BattleSpace::simPositionOf(this);
+    query.range = getSimRange();
+    query.skyAble = _config->SKY_ABLE;
+    query.groundAble = _config->GROUND_ABLE;
+    return true;
+}
 
-    setTarget(nearest);
+void DefenceBuilding::applyTargetDecision(Soldier* target) {
+    setTarget(target);
 }
 
-void DefenceBuilding::takeDamage(float damage) {
-    _currentHP -= damage;
-    if (_currentHP < 0) _currentHP = 0;
+void DefenceBuilding::takeDamage(Fixed damage) {
+    CombatRules::applyDamage(_currentHP, damage);
 
     EffectUtils::playHitFlash(_bodySprite);
     updateHealthBar(true);
 
-    if (_currentHP <= 0) {
+    if (_currentHP <= Fixed()) {
         AudioManager::playBuildingCollapse();
+        if (getParent()) {
+            BattleEventBus::post(BattleEventType::BUILDING_DESTROYED, this);
+        }
         this->removeFromParent();
     }
 }
 
 void DefenceBuilding::attackTarget() {
-    auto* soldier = dynamic_cast<Soldier*>(_target);
+    auto* soldier = getTargetSoldier();
     if (!canTargetSoldier(soldier)) {
         setTarget(nullptr);
         return;
     }
 
-    float currentTime = Director::getInstance()->getTotalFrames() / 60.0f;
-    float attackSpeed = getCurrentATK_SPEED();
-    if (attackSpeed <= 0.0f) {
-        attackSpeed = 0.5f;
-    }
 
-    if (currentTime - _lastAttackTime >= attackSpeed) {
+    if (_attackCooldown <= 0.0f) {
         playAnimation(_config->anim_attack, _config->anim_attack_frames, _config->anim_attack_delay, false);
-        _lastAttackTime = currentTime;
+        _attackCooldown = CombatRules::towerAttackInterval(_config, _level);
 
-        float damage = getCurrentATK();
+        Fixed damage = getSimATK();
 
         ImpactSound impactSound = ImpactSound::None;
         if (!_config->bulletSpriteFrameName.empty()) {
@@ -801,13 +785,12 @@ void DefenceBuilding::attackTarget() {
             }
         }
 
-        if (!_config->bulletSpriteFrameName.empty() && _config->bulletSpeed > 0.0f) {
+        if (CombatRules::firesProjectile(_config)) {
             auto* bullet = DefenceBullet::create(
                 _config->bulletSpriteFrameName,
                 damage,
-                _config->bulletSpeed,
-                _config->bulletIsAOE,
-                _config->bulletAOERange,
+                _config->simBulletSpeed,
+                CombatRules::splashRadius(_config),
                 _config->SKY_ABLE,
                 _config->GROUND_ABLE,
                 s_enemySoldiers,
@@ -818,31 +801,31 @@ void DefenceBuilding::attackTarget() {
                 if (parent) {
                     bool rotateBullet = (impactSound == ImpactSound::ArrowHit);
                     bullet->setRotateToTarget(rotateBullet, 0.0f);
+                    // 子弹跟随塔所在的模拟时钟推进，暂停/加速时与战斗逻辑同步
+                    bullet->setScheduler(getScheduler());
+                    bullet->scheduleUpdate();
                     parent->addChild(bullet, 20);
-                    bullet->setPosition(this->getPosition());
+                    BattleSpace::place(bullet, BattleSpace::simPositionOf(this));
                     bullet->setTarget(soldier);
                     return;
                 }
             }
         }
 
-        if (_config->bulletIsAOE && _config->bulletAOERange > 0.0f) {
-            applyAoeDamage(soldier->getPosition(), _config->bulletAOERange, damage);
+        if (CombatRules::splashRadius(_config) > Fixed()) {
+            applyAoeDamage(BattleSpace::simPositionOf(soldier), CombatRules::splashRadius(_config), damage);
         }
         else {
             soldier->takeDamage(damage);
         }
 
         if (isMagicTower() || isFireTower()) {
-            auto* targetParent = soldier->getParent();
-            Vec2 worldPos = targetParent
-                ? targetParent->convertToWorldSpace(soldier->getPosition())
-                : soldier->getPosition();
+            Vec2 targetPos = BattleSpace::positionOf(soldier);
             if (isMagicTower()) {
-                spawnMagicImpact(worldPos);
+                spawnMagicImpact(targetPos);
             }
             if (isFireTower()) {
-                updateFireEffectForTarget(worldPos);
+                updateFireEffectForTarget(targetPos);
             }
         }
     }
@@ -854,7 +837,7 @@ void DefenceBuilding::updateHealthBar(bool animate) {
     float maxHP = getCurrentMaxHP();
     float pct = 0.0f;
     if (maxHP > 0.00001f) {
-        pct = _currentHP / maxHP;
+        pct = _currentHP.toFloat() / maxHP;
     }
     if (pct < 0.0f) pct = 0.0f;
     if (pct > 1.0f) pct = 1.0f;
@@ -934,8 +917,10 @@ void DefenceBuilding::playAnimation(const std::string& animType, int frameCount,
     _bodySprite->stopAllActions();
 
     if (loop) {
-        auto act = RepeatForever::create(Animate::create(anim));
-        _bodySprite->runAction(act);
+        auto act = AnimationLod::createLoop(anim);
+        if (act) {
+            _bodySprite->runAction(act);
+        }
     }
     else {
         auto sequence = Sequence::create(
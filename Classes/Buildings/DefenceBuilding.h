@@ -3,9 +3,11 @@
 
 #include "cocos2d.h"
 #include "DefenseBuildingData.h"
+#include "Core/EntityTable.h"
 #include <vector>
 
 class Soldier;
+struct TowerTargetQuery;
 
 class DefenceBuilding : public cocos2d::Node {
 public:
@@ -17,14 +19,18 @@ public:
     // 设置敌方士兵列表（由战斗场景提供）
     static void setEnemySoldiers(const std::vector<Soldier*>* soldiers);
     static void clearEnemySoldiersIf(const std::vector<Soldier*>* soldiers);
+    // 预载攻击序列帧与子弹贴图，避免首次开火时同步读盘
+    static void preloadAssets(const DefenceBuildingConfig* config);
 
-    void takeDamage(float damage);
+    void takeDamage(Fixed damage);
 
     int getLevel() const { return _level; }
     int getMaxLevel() const { return _config ? _config->MAXLEVEL : 0; }
     void setLevel(int level);
 
-    float getCurrentHP() const { return _currentHP; }
+    // 模拟用定点血量；getCurrentHP 只供界面显示
+    Fixed getHP() const { return _currentHP; }
+    float getCurrentHP() const { return _currentHP.toFloat(); }
     float getCurrentMaxHP() const;
     float getCurrentDP() const;
     float getCurrentATK_SPEED() const;
@@ -36,6 +42,16 @@ public:
 
     void refreshHealthBarPosition();
 
+    // 批量寻敌（TargetingSystem）：是否需要新目标、生成请求、应用结论
+    bool needsTarget() const;
+    bool buildTargetQuery(TowerTargetQuery& query) const;
+    void applyTargetDecision(Soldier* target);
+    cocos2d::Node* getTarget() const { return EntityTable::lookup(_target, EntityKind::SOLDIER); }
+
+    const DefenceBuildingConfig* getConfig() const { return _config; }
+    // 火焰塔：对射程内全部目标持续造成伤害
+    bool isFireTower() const;
+
     int getId() const { return _config ? _config->id : 0; }
     const std::string& getName() const {
         static std::string empty = "";
@@ -47,30 +63,35 @@ private:
 
     const DefenceBuildingConfig* _config;
     int _level;
-    float _currentHP;
-    float _lastAttackTime;
+    Fixed _currentHP;
+    // 距下次可攻击的剩余时间，按模拟 dt 递减（不再读取 Director 帧数）
+    float _attackCooldown;
     cocos2d::Sprite* _bodySprite;
     cocos2d::Sprite* _healthBar;
     cocos2d::Sprite* _fireEffect = nullptr;
     float _fireDamageTimer = 0.0f;
-    cocos2d::Node* _target;
+    EntityHandle _target;           // 目标士兵句柄，士兵死亡或回收后自动失效
     std::string _currentActionKey;
 
+    Soldier* getTargetSoldier() const;
     // 判断目标是否可被当前建筑攻击（空/地判定、存活判定）
     bool canTargetSoldier(const Soldier* soldier) const;
     // 获取可用的敌方单位列表（优先使用外部注入，必要时临时扫描）
     const std::vector<Soldier*>* getEnemySoldiers(std::vector<Soldier*>& fallback) const;
-    // 近战/范围伤害的统一处理
-    void applyAoeDamage(const cocos2d::Vec2& center, float range, float damage) const;
+    // 战斗模拟用的定点属性（配置加载时已换算）
+    Fixed getSimATK() const;
+    Fixed getSimRange() const;
+    // 近战/范围伤害的统一处理（center 为战斗空间定点坐标）
+    void applyAoeDamage(const FixedVec2& center, Fixed range, Fixed damage) const;
     // 是否为树类建筑（使用序列帧资源）
     bool isTreeSprite() const;
     bool isMagicTower() const;
-    bool isFireTower() const;
     // 播放树的序列帧动画（用于待机/攻击）
     bool playTreeAnimation(int frameCount, float delay, bool loop);
-    void spawnMagicImpact(const cocos2d::Vec2& worldPos);
+    void spawnMagicImpact(const cocos2d::Vec2& battlePos); // 参数为战斗空间坐标
     void ensureFireEffect();
-    void updateFireEffectForTarget(const cocos2d::Vec2& targetWorldPos);
+    void setFireEffectActive(bool active); // 隐藏时同时停止循环动画
+    void updateFireEffectForTarget(const cocos2d::Vec2& targetBattlePos);
     void updateFireTower(float dt);
     // 当没有对应动画资源时的攻击表现
     void playFallbackAttackEffect();
@@ -3,6 +3,7 @@
 
 #include "cocos2d.h"
 #include "Soldier/UnitData.h"
+#include "Utils/FixedMath.h"
 #include <vector>
 
 struct DefenceBuildingConfig {
@@ -37,6 +38,13 @@ struct DefenceBuildingConfig {
     float bulletSpeed = 0.0f;
     bool bulletIsAOE = false;
     float bulletAOERange = 0.0f;
+
+    // 战斗模拟用的定点属性（BuildingManager 加载时换算）
+    std::vector<Fixed> simHP;
+    std::vector<Fixed> simATK;
+    std::vector<Fixed> simATK_RANGE;
+    Fixed simBulletSpeed;
+    Fixed simBulletAOERange;
 };
 
 #endif // __DEFENSE_BUILDING_DATA_H__
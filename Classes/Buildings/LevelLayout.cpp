@@ -0,0 +1,181 @@
+﻿// LevelLayout.cpp
+#include "LevelLayout.h"
+#include "Buildings/BuildingManager.h"
+#include "json/document.h"
+
+USING_NS_CC;
+
+namespace {
+const char* kLevelsConfigPath = "res/levels_config.json";
+
+void stripUtf8Bom(std::string& text) {
+    if (text.size() >= 3 &&
+        static_cast<unsigned char>(text[0]) == 0xEF &&
+        static_cast<unsigned char>(text[1]) == 0xBB &&
+        static_cast<unsigned char>(text[2]) == 0xBF) {
+        text.erase(0, 3);
+    }
+}
+
+int readInt(const rapidjson::Value& obj, const char* key, int fallback) {
+    auto it = obj.FindMember(key);
+    if (it == obj.MemberEnd()) {
+        return fallback;
+    }
+    if (it->value.IsInt()) {
+        return it->value.GetInt();
+    }
+    if (it->value.IsNumber()) {
+        return static_cast<int>(it->value.GetDouble());
+    }
+    return fallback;
+}
+
+float readFloat(const rapidjson::Value& obj, const char* key, float fallback) {
+    auto it = obj.FindMember(key);
+    if (it == obj.MemberEnd() || !it->value.IsNumber()) {
+        return fallback;
+    }
+    return static_cast<float>(it->value.GetDouble());
+}
+
+std::string readString(const rapidjson::Value& obj, const char* key, const std::string& fallback) {
+    auto it = obj.FindMember(key);
+    if (it == obj.MemberEnd() || !it->value.IsString()) {
+        return fallback;
+    }
+    return it->value.GetString();
+}
+
+bool readBool(const rapidjson::Value& obj, const char* key, bool fallback) {
+    auto it = obj.FindMember(key);
+    if (it == obj.MemberEnd() || !it->value.IsBool()) {
+        return fallback;
+    }
+    return it->value.GetBool();
+}
+
+LevelLayout parseLevel(const rapidjson::Value& item, const std::map<int, BuildingOption>& options) {
+    LevelLayout layout;
+    layout.id = readInt(item, "id", 0);
+    layout.name = readString(item, "name", "");
+    layout.towerLevel = readInt(item, "towerLevel", 0);
+    layout.allowOverlap = readBool(item, "allowOverlap", false);
+    auto anchor = item.FindMember("baseAnchor");
+    if (anchor != item.MemberEnd() && anchor->value.IsObject()) {
+        layout.baseAnchor = Vec2(readFloat(anchor->value, "x", 0.0f), readFloat(anchor->value, "y", 0.0f));
+    }
+
+    auto buildings = item.FindMember("buildings");
+    if (buildings != item.MemberEnd() && buildings->value.IsArray()) {
+        layout.buildings.reserve(buildings->value.Size());
+        for (const auto& entry : buildings->value.GetArray()) {
+            if (!entry.IsObject()) {
+                continue;
+            }
+            int type = readInt(entry, "type", 0);
+            auto option = options.find(type);
+            if (option == options.end()) {
+                CCLOG("[关卡布局] 关卡 %d 含未知建筑类型 %d", layout.id, type);
+                continue;
+            }
+            BaseSavedBuilding saved;
+            saved.option = option->second;
+            saved.option.configId = readInt(entry, "configId", saved.option.configId);
+            saved.gridX = readInt(entry, "gridX", 0);
+            saved.gridY = readInt(entry, "gridY", 0);
+            saved.level = readInt(entry, "level", layout.towerLevel);
+            layout.buildings.push_back(saved);
+        }
+    }
+
+    auto waves = item.FindMember("waves");
+    if (waves != item.MemberEnd() && waves->value.IsArray()) {
+        layout.waves.reserve(waves->value.Size());
+        for (const auto& entry : waves->value.GetArray()) {
+            if (!entry.IsObject()) {
+                continue;
+            }
+            LevelWave wave;
+            wave.unitId = readInt(entry, "unitId", 0);
+            wave.count = readInt(entry, "count", 0);
+            wave.interval = readFloat(entry, "interval", wave.interval);
+            wave.delay = readFloat(entry, "delay", wave.delay);
+            if (wave.unitId > 0 && wave.count > 0) {
+                layout.waves.push_back(wave);
+            }
+        }
+    }
+    return layout;
+}
+
+void parseLevelList(const rapidjson::Document& doc, const char* key,
+                    const std::map<int, BuildingOption>& options, std::map<int, LevelLayout>& out) {
+    auto list = doc.FindMember(key);
+    if (list == doc.MemberEnd() || !list->value.IsArray()) {
+        return;
+    }
+    for (const auto& item : list->value.GetArray()) {
+        if (!item.IsObject()) {
+            continue;
+        }
+        LevelLayout layout = parseLevel(item, options);
+        if (layout.id > 0) {
+            out[layout.id] = std::move(layout);
+        }
+    }
+}
+} // namespace
+
+LevelLayoutLibrary* LevelLayoutLibrary::s_instance = nullptr;
+
+LevelLayoutLibrary* LevelLayoutLibrary::getInstance() {
+    if (!s_instance) {
+        s_instance = new LevelLayoutLibrary();
+    }
+    return s_instance;
+}
+
+void LevelLayoutLibrary::load() {
+    if (_loaded) {
+        return;
+    }
+    _loaded = true;
+
+    std::string jsonData = FileUtils::getInstance()->getStringFromFile(kLevelsConfigPath);
+    if (jsonData.empty()) {
+        CCLOG("[关卡布局] 无法读取 %s", kLevelsConfigPath);
+        return;
+    }
+    stripUtf8Bom(jsonData);
+
+    rapidjson::Document doc;
+    doc.Parse(jsonData.c_str());
+    if (doc.HasParseError() || !doc.IsObject()) {
+        CCLOG("[关卡布局] JSON 解析失败，偏移 %zu", doc.GetErrorOffset());
+        return;
+    }
+
+    // 建筑记录按商店选项还原，与基地快照一致
+    auto* manager = BuildingManager::getInstance();
+    manager->loadConfigs();
+    std::map<int, BuildingOption> options;
+    for (const auto& option : manager->getBuildOptions()) {
+        options[option.type] = option;
+    }
+
+    parseLevelList(doc, "attackLevels", options, _attackLevels);
+    parseLevelList(doc, "defenseLevels", options, _defenseLevels);
+    CCLOG("[关卡布局] 读取进攻关卡 %d 个、防守关卡 %d 个",
+        static_cast<int>(_attackLevels.size()), static_cast<int>(_defenseLevels.size()));
+}
+
+const LevelLayout* LevelLayoutLibrary::getAttackLevel(int levelId) const {
+    auto it = _attackLevels.find(levelId);
+    return it != _attackLevels.end() ? &it->second : nullptr;
+}
+
+const LevelLayout* LevelLayoutLibrary::getDefenseLevel(int levelId) const {
+    auto it = _defenseLevels.find(levelId);
+    return it != _defenseLevels.end() ? &it->second : nullptr;
+}
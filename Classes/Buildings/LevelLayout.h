@@ -0,0 +1,58 @@
+﻿// LevelLayout.h
+#ifndef __LEVEL_LAYOUT_H__
+#define __LEVEL_LAYOUT_H__
+
+#include "cocos2d.h"
+#include "Scenes/BaseScene.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// 防守关卡的一波来袭士兵
+struct LevelWave {
+    int unitId = 0;
+    int count = 0;
+    float interval = 0.5f;
+    float delay = 0.0f;
+};
+
+/**
+ * @brief 关卡布局数据（res/levels_config.json）
+ *
+ * 建筑记录与基地快照共用 BaseSavedBuilding：type 对应商店选项，
+ * configId 可覆盖为敌方专用配置，未写 level 时取关卡的 towerLevel。
+ */
+struct LevelLayout {
+    int id = 0;
+    std::string name;
+    int towerLevel = 0;                         // 敌方基地与未指定等级建筑的等级
+    cocos2d::Vec2 baseAnchor;                   // 敌方基地左下角格子
+    bool allowOverlap = false;                  // 旧关卡有意叠放的建筑：校验时只计数不剔除
+    std::vector<BaseSavedBuilding> buildings;
+    std::vector<LevelWave> waves;               // 防守关卡来袭波次
+};
+
+/**
+ * @brief 关卡布局库（单例）
+ *
+ * 首次访问时读取并解析一次配置，之后按关卡ID查询。
+ */
+class LevelLayoutLibrary {
+public:
+    static LevelLayoutLibrary* getInstance();
+
+    void load();
+    const LevelLayout* getAttackLevel(int levelId) const;
+    const LevelLayout* getDefenseLevel(int levelId) const;
+
+private:
+    LevelLayoutLibrary() = default;
+
+    std::map<int, LevelLayout> _attackLevels;
+    std::map<int, LevelLayout> _defenseLevels;
+    bool _loaded = false;
+
+    static LevelLayoutLibrary* s_instance;
+};
+
+#endif // __LEVEL_LAYOUT_H__
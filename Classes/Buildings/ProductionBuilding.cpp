@@ -1,11 +1,22 @@
 ﻿#include "ProductionBuilding.h"
+#include "Core/BattleEventBus.h"
+#include "Core/CombatRules.h"
 #include "Core/Core.h"
+#include "Core/EconomyScheduler.h"
 #include "Utils/AnimationUtils.h"
+#include "Utils/AnimationLod.h"
 #include "Utils/EffectUtils.h"
 #include "Utils/AudioManager.h"
+#include <algorithm>
+#include <chrono>
 
 USING_NS_CC;
 
+namespace {
+// 配置未给出存储上限时，最多累积的批次数
+constexpr int kFallbackCapacityBatches = 100;
+}
+
 ProductionBuilding* ProductionBuilding::create(const ProductionBuildingConfig* config, int level) {
     ProductionBuilding* pRet = new(std::nothrow) ProductionBuilding();
     if (pRet && pRet->init(config, level)) {
@@ -16,6 +27,10 @@ ProductionBuilding* ProductionBuilding::create(const ProductionBuildingConfig* c
     return nullptr;
 }
 
+ProductionBuilding::~ProductionBuilding() {
+    EconomyScheduler::getInstance()->cancel(this);
+}
+
 bool ProductionBuilding::init(const ProductionBuildingConfig* config, int level) {
     if (!Node::init()) return false;
 
@@ -24,8 +39,8 @@ bool ProductionBuilding::init(const ProductionBuildingConfig* config, int level)
     if (_level < 0) _level = 0;
     if (_level > _config->MAXLEVEL) _level = _config->MAXLEVEL;
     
-    _currentHP = getCurrentMaxHP();
-    _lastProduceTime = 0.0f;
+    _currentHP = FixedMath::levelValue(_config->simHP, _level);
+    _produceTimestampMs = 0;
     _currentActionKey.clear();
     _pendingCollectAmount = 0;
     _collectType = ResourceType::COIN;
@@ -62,15 +77,31 @@ bool ProductionBuilding::init(const ProductionBuildingConfig* config, int level)
     }
 
     updateHealthBar(false);
-    this->scheduleUpdate();
 
     return true;
 }
 
+void ProductionBuilding::onEnter() {
+    Node::onEnter();
+    // 重新回到场景时补结算一次并恢复调度；尚未开始计时的建筑由放置/恢复流程结算
+    if (_produceTimestampMs > 0) {
+        settleProduction();
+    }
+}
+
+void ProductionBuilding::onExit() {
+    EconomyScheduler::getInstance()->cancel(this);
+    Node::onExit();
+}
+
 void ProductionBuilding::setCollectCallback(const std::function<void(ProductionBuilding*, ResourceType, int, const cocos2d::Vec2&)>& callback) {
     _collectCallback = callback;
 }
 
+void ProductionBuilding::setSettleCallback(const std::function<void(ProductionBuilding*)>& callback) {
+    _settleCallback = callback;
+}
+
 void ProductionBuilding::refreshHealthBarPosition() {
     if (!_healthBar || !_bodySprite) {
         return;
@@ -108,7 +139,7 @@ void ProductionBuilding::setLevel(int level) {
         return;
     }
     _level = level;
-    _currentHP = getCurrentMaxHP();
+    _currentHP = FixedMath::levelValue(_config->simHP, _level);
     updateHealthBar(false);
 }
 
@@ -162,69 +193,114 @@ int ProductionBuilding::getWidth() const {
     return _config->width;
 }
 
-void ProductionBuilding::update(float dt) {
-    produce(dt);
+int64_t ProductionBuilding::getWallClockMs() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
 }
 
-void ProductionBuilding::produce(float dt) {
-    if (!_config) {
-        return;
-    }
+void ProductionBuilding::setProduceTimestamp(int64_t timestampMs) {
+    _produceTimestampMs = timestampMs;
+}
 
-    float gold = getCurrentPRODUCE_GOLD();
-    float diamond = getCurrentPRODUCE_ELIXIR();
-    if (gold <= 0.0f && diamond <= 0.0f) {
-        return;
+int ProductionBuilding::getProducePerBatch() const {
+    return static_cast<int>(std::max(getCurrentPRODUCE_GOLD(), getCurrentPRODUCE_ELIXIR()));
+}
+
+int ProductionBuilding::getProduceCapacity() const {
+    float capacity = (getCollectType() == ResourceType::DIAMOND)
+        ? getCurrentSTORAGE_ELIXIR_CAPACITY()
+        : getCurrentSTORAGE_GOLD_CAPACITY();
+    if (capacity > 0.0f) {
+        return static_cast<int>(capacity);
     }
+    return getProducePerBatch() * kFallbackCapacityBatches;
+}
 
-    float currentTime = Director::getInstance()->getTotalFrames() / 60.0f;
-    if (_lastProduceTime <= 0.0f) {
-        _lastProduceTime = currentTime;
-        return;
+int ProductionBuilding::getAccruedAmount(int64_t nowMs) const {
+    int perBatch = getProducePerBatch();
+    if (perBatch <= 0 || _produceTimestampMs <= 0 || nowMs <= _produceTimestampMs) {
+        return 0;
     }
+    int64_t intervalMs = getProduceIntervalMs();
+    int64_t batches = (nowMs - _produceTimestampMs) / intervalMs;
+    int64_t amount = batches * perBatch;
+    return static_cast<int>(std::min<int64_t>(amount, getProduceCapacity()));
+}
 
-    float interval = getProduceInterval();
-    if (interval < 0.1f) {
-        interval = 0.1f;
+int ProductionBuilding::settleProduction(EconomyDelta* delta) {
+    if (!_config || getProducePerBatch() <= 0) {
+        return 0;
     }
 
-    if (currentTime - _lastProduceTime >= interval) {
-        _lastProduceTime = currentTime;
+    int64_t nowMs = getWallClockMs();
+    if (_produceTimestampMs <= 0 || _produceTimestampMs > nowMs) {
+        // 首次结算或系统时间回拨：从当前时刻重新计时
+        _produceTimestampMs = nowMs;
+    }
 
-        bool useCollect = isCollectorBuilding() && _collectCallback;
-        if (useCollect) {
-            if (gold > 0.0f) {
-                addPendingCollect(ResourceType::COIN, static_cast<int>(gold));
-            }
-            if (diamond > 0.0f) {
-                addPendingCollect(ResourceType::DIAMOND, static_cast<int>(diamond));
-            }
+    int amount = getAccruedAmount(nowMs);
+    bool useCollect = isCollectorBuilding() && _collectCallback;
+    if (useCollect) {
+        int previous = _pendingCollectAmount;
+        setPendingCollect(getCollectType(), amount);
+        if (amount > previous) {
             playProducePulse();
-            return;
         }
-
-        // 自动收集资源并播放产出动画
-        if (gold > 0.0f) {
-            Core::getInstance()->addResource(ResourceType::COIN, static_cast<int>(gold));
-            spawnProduceEffect(ResourceType::COIN);
+    }
+    else if (amount > 0) {
+        // 无收集入口的产出建筑直接入账
+        ResourceType type = getCollectType();
+        if (delta) {
+            delta->add(type, amount);
         }
-        if (diamond > 0.0f) {
-            Core::getInstance()->addResource(ResourceType::DIAMOND, static_cast<int>(diamond));
-            spawnProduceEffect(ResourceType::DIAMOND);
+        else {
+            Core::getInstance()->addResource(type, amount);
         }
+        spawnProduceEffect(type);
         playProducePulse();
+        consumeAccrued(amount, nowMs);
+        if (_settleCallback) {
+            _settleCallback(this);
+        }
+    }
+
+    scheduleNextSettle(nowMs);
+    return amount;
+}
+
+void ProductionBuilding::consumeAccrued(int amount, int64_t nowMs) {
+    // 计时起点只推进已结清的整批时间，保留不足一批的进度；存满时从当前时刻重新计时
+    int perBatch = getProducePerBatch();
+    if (amount >= getProduceCapacity() || perBatch <= 0) {
+        _produceTimestampMs = nowMs;
+        return;
     }
+    _produceTimestampMs += static_cast<int64_t>(amount / perBatch) * getProduceIntervalMs();
 }
 
-void ProductionBuilding::takeDamage(float damage) {
-    _currentHP -= damage;
-    if (_currentHP < 0) _currentHP = 0;
+void ProductionBuilding::scheduleNextSettle(int64_t nowMs) {
+    // 只登记下一批产出的到期时间，存满后不再调度，直到被收集
+    auto* scheduler = EconomyScheduler::getInstance();
+    if (getAccruedAmount(nowMs) >= getProduceCapacity()) {
+        scheduler->cancel(this);
+        return;
+    }
+    int64_t intervalMs = getProduceIntervalMs();
+    int64_t elapsed = std::max<int64_t>(0, nowMs - _produceTimestampMs);
+    scheduler->schedule(this, nowMs + intervalMs - (elapsed % intervalMs));
+}
+
+void ProductionBuilding::takeDamage(Fixed damage) {
+    CombatRules::applyDamage(_currentHP, damage);
     
     EffectUtils::playHitFlash(_bodySprite);
     updateHealthBar(true);
     
-    if (_currentHP <= 0) {
+    if (_currentHP <= Fixed()) {
         AudioManager::playBuildingCollapse();
+        if (getParent()) {
+            BattleEventBus::post(BattleEventType::BUILDING_DESTROYED, this);
+        }
         this->removeFromParent();
     }
 }
@@ -235,7 +311,7 @@ void ProductionBuilding::updateHealthBar(bool animate) {
     float maxHP = getCurrentMaxHP();
     float pct = 0.0f;
     if (maxHP > 0.00001f) {
-        pct = _currentHP / maxHP;
+        pct = _currentHP.toFloat() / maxHP;
     }
     if (pct < 0.0f) pct = 0.0f;
     if (pct > 1.0f) pct = 1.0f;
@@ -277,8 +353,10 @@ void ProductionBuilding::playAnimation(const std::string& animType, int frameCou
     _bodySprite->stopAllActions();
     
     if (loop) {
-        auto act = RepeatForever::create(Animate::create(anim));
-        _bodySprite->runAction(act);
+        auto act = AnimationLod::createLoop(anim);
+        if (act) {
+            _bodySprite->runAction(act);
+        }
     } else {
         auto sequence = Sequence::create(
             Animate::create(anim),
@@ -319,6 +397,10 @@ float ProductionBuilding::getProduceInterval() const {
     return kBaseInterval / speedMul;
 }
 
+int64_t ProductionBuilding::getProduceIntervalMs() const {
+    return static_cast<int64_t>(std::max(getProduceInterval(), 0.1f) * 1000.0f);
+}
+
 void ProductionBuilding::spawnProduceEffect(ResourceType type) {
     if (!_bodySprite) {
         return;
@@ -371,12 +453,9 @@ ResourceType ProductionBuilding::getCollectType() const {
     return ResourceType::COIN;
 }
 
-void ProductionBuilding::addPendingCollect(ResourceType type, int amount) {
-    if (amount <= 0) {
-        return;
-    }
+void ProductionBuilding::setPendingCollect(ResourceType type, int amount) {
     _collectType = type;
-    _pendingCollectAmount += amount;
+    _pendingCollectAmount = std::max(0, amount);
     updateCollectIcon();
 }
 
@@ -438,11 +517,14 @@ void ProductionBuilding::clearCollectIcon() {
 }
 
 void ProductionBuilding::collectPending() {
-    if (_pendingCollectAmount <= 0) {
+    // 收集时按当前时刻重新结算，避免图标刷新前的产出丢失
+    int64_t nowMs = getWallClockMs();
+    int amount = getAccruedAmount(nowMs);
+    if (amount <= 0) {
         return;
     }
-    int amount = _pendingCollectAmount;
     _pendingCollectAmount = 0;
+    consumeAccrued(amount, nowMs);
 
     Vec2 worldPos = this->convertToWorldSpace(Vec2::ZERO);
     if (_collectSprite) {
@@ -461,4 +543,5 @@ void ProductionBuilding::collectPending() {
     else {
         Core::getInstance()->addResource(_collectType, amount);
     }
+    scheduleNextSettle(nowMs);
 }
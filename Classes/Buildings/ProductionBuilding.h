@@ -3,23 +3,29 @@
 
 #include "cocos2d.h"
 #include "ProductionBuildingData.h"
+#include <cstdint>
 #include <functional>
 
 enum class ResourceType;
+struct EconomyDelta;
 
 class ProductionBuilding : public cocos2d::Node {
 public:
     static ProductionBuilding* create(const ProductionBuildingConfig* config, int level = 0);
+    virtual ~ProductionBuilding();
     virtual bool init(const ProductionBuildingConfig* config, int level = 0);
-    virtual void update(float dt) override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
 
-    void takeDamage(float damage);
+    void takeDamage(Fixed damage);
     
     int getLevel() const { return _level; }
     int getMaxLevel() const { return _config ? _config->MAXLEVEL : 0; }
     void setLevel(int level);
     
-    float getCurrentHP() const { return _currentHP; }
+    // 模拟用定点血量；getCurrentHP 只供界面显示
+    Fixed getHP() const { return _currentHP; }
+    float getCurrentHP() const { return _currentHP.toFloat(); }
     float getCurrentMaxHP() const;
     float getCurrentDP() const;
     float getCurrentPRODUCE_ELIXIR() const;
@@ -31,8 +37,21 @@ public:
     int getWidth() const;
 
     void setCollectCallback(const std::function<void(ProductionBuilding*, ResourceType, int, const cocos2d::Vec2&)>& callback);
+    // 自动入账推进了计时起点后回调（供存档同步计时起点）
+    void setSettleCallback(const std::function<void(ProductionBuilding*)>& callback);
     void refreshCollectIconPosition();
 
+    // ==================== 产出结算 ====================
+    // 产出按墙钟时间闭式计算：产量 = 每批产量 × 已过批次数，受存储上限截断。
+    // 不再逐帧更新，只在查看/收集/加载时结算，离线期间的产出在下次结算时一并计入。
+    // 下一批产出的刷新时间交给 EconomyScheduler 统一调度。
+    static int64_t getWallClockMs();
+    void setProduceTimestamp(int64_t timestampMs);
+    int64_t getProduceTimestamp() const { return _produceTimestampMs; }
+    // delta 非空时自动入账的产出累加到 delta，由调用方统一入账
+    int settleProduction(EconomyDelta* delta = nullptr);
+    int getAccruedAmount(int64_t nowMs) const;
+
     void refreshHealthBarPosition();
     
     // 获取建筑ID和名称
@@ -45,28 +64,33 @@ public:
 private:
     const ProductionBuildingConfig* _config;
     int _level;
-    float _currentHP;
-    float _lastProduceTime;
+    Fixed _currentHP;
+    int64_t _produceTimestampMs = 0;        // 上次结算的墙钟时间（毫秒），0 表示尚未开始
     cocos2d::Sprite* _bodySprite;
     cocos2d::Sprite* _healthBar;
     std::string _currentActionKey;
 
-    void produce(float dt);
+    int getProducePerBatch() const;
+    int getProduceCapacity() const;
+    void consumeAccrued(int amount, int64_t nowMs);
+    void scheduleNextSettle(int64_t nowMs);
     void updateHealthBar(bool animate = true);
     void playAnimation(const std::string& animType, int frameCount, float delay, bool loop);
     void stopCurrentAnimation();
     float getProduceInterval() const;
+    int64_t getProduceIntervalMs() const;
     void spawnProduceEffect(ResourceType type);
     void playProducePulse();
 
     bool isCollectorBuilding() const;
     ResourceType getCollectType() const;
-    void addPendingCollect(ResourceType type, int amount);
+    void setPendingCollect(ResourceType type, int amount);
     void updateCollectIcon();
     void clearCollectIcon();
     void collectPending();
 
     std::function<void(ProductionBuilding*, ResourceType, int, const cocos2d::Vec2&)> _collectCallback;
+    std::function<void(ProductionBuilding*)> _settleCallback;
     cocos2d::Sprite* _collectSprite = nullptr;
     cocos2d::EventListenerTouchOneByOne* _collectListener = nullptr;
     int _pendingCollectAmount = 0;
@@ -3,6 +3,7 @@
 
 #include "cocos2d.h"
 #include "Soldier/UnitData.h"
+#include "Utils/FixedMath.h"
 #include <vector>
 
 struct ProductionBuildingConfig {
@@ -31,6 +32,9 @@ struct ProductionBuildingConfig {
     std::string anim_produce = "produce";
     int anim_produce_frames = 1;
     float anim_produce_delay = 0.1f;
+
+    // 战斗模拟用的定点血量（BuildingManager 加载时换算）
+    std::vector<Fixed> simHP;
 };
 
 #endif // __PRODUCTION_BUILDING_DATA_H__
@@ -1,5 +1,8 @@
 ﻿#include "StorageBuilding.h"
+#include "Core/BattleEventBus.h"
+#include "Core/CombatRules.h"
 #include "Utils/AnimationUtils.h"
+#include "Utils/AnimationLod.h"
 #include "Utils/EffectUtils.h"
 #include "Utils/AudioManager.h"
 
@@ -23,7 +26,7 @@ bool StorageBuilding::init(const StorageBuildingConfig* config, int level) {
     if (_level < 0) _level = 0;
     if (_level > _config->MAXLEVEL) _level = _config->MAXLEVEL;
     
-    _currentHP = getCurrentMaxHP();
+    _currentHP = FixedMath::levelValue(_config->simHP, _level);
     _currentActionKey.clear();
 
     _bodySprite = Sprite::create(_config->spriteFrameName);
@@ -58,7 +61,6 @@ bool StorageBuilding::init(const StorageBuildingConfig* config, int level) {
     }
 
     updateHealthBar(false);
-    this->scheduleUpdate();
 
     return true;
 }
@@ -88,7 +90,7 @@ void StorageBuilding::setLevel(int level) {
         return;
     }
     _level = level;
-    _currentHP = getCurrentMaxHP();
+    _currentHP = FixedMath::levelValue(_config->simHP, _level);
     updateHealthBar(false);
 }
 
@@ -128,19 +130,17 @@ int StorageBuilding::getWidth() const {
     return _config->width;
 }
 
-void StorageBuilding::update(float dt) {
-    // Storage buildings are passive
-}
-
-void StorageBuilding::takeDamage(float damage) {
-    _currentHP -= damage;
-    if (_currentHP < 0) _currentHP = 0;
+void StorageBuilding::takeDamage(Fixed damage) {
+    CombatRules::applyDamage(_currentHP, damage);
     
     EffectUtils::playHitFlash(_bodySprite);
     updateHealthBar(true);
     
-    if (_currentHP <= 0) {
+    if (_currentHP <= Fixed()) {
         AudioManager::playBuildingCollapse();
+        if (getParent()) {
+            BattleEventBus::post(BattleEventType::BUILDING_DESTROYED, this);
+        }
         this->removeFromParent();
     }
 }
@@ -151,7 +151,7 @@ void StorageBuilding::updateHealthBar(bool animate) {
     float maxHP = getCurrentMaxHP();
     float pct = 0.0f;
     if (maxHP > 0.00001f) {
-        pct = _currentHP / maxHP;
+        pct = _currentHP.toFloat() / maxHP;
     }
     if (pct < 0.0f) pct = 0.0f;
     if (pct > 1.0f) pct = 1.0f;
@@ -193,8 +193,10 @@ void StorageBuilding::playAnimation(const std::string& animType, int frameCount,
     _bodySprite->stopAllActions();
     
     if (loop) {
-        auto act = RepeatForever::create(Animate::create(anim));
-        _bodySprite->runAction(act);
+        auto act = AnimationLod::createLoop(anim);
+        if (act) {
+            _bodySprite->runAction(act);
+        }
     } else {
         auto sequence = Sequence::create(
             Animate::create(anim),
@@ -8,15 +8,16 @@ class StorageBuilding : public cocos2d::Node {
 public:
     static StorageBuilding* create(const StorageBuildingConfig* config, int level = 0);
     virtual bool init(const StorageBuildingConfig* config, int level = 0);
-    virtual void update(float dt) override;
 
-    void takeDamage(float damage);
+    void takeDamage(Fixed damage);
     
     int getLevel() const { return _level; }
     int getMaxLevel() const { return _config ? _config->MAXLEVEL : 0; }
     void setLevel(int level);
     
-    float getCurrentHP() const { return _currentHP; }
+    // 模拟用定点血量；getCurrentHP 只供界面显示
+    Fixed getHP() const { return _currentHP; }
+    float getCurrentHP() const { return _currentHP.toFloat(); }
     float getCurrentMaxHP() const;
     float getCurrentDP() const;
     float getCurrentADD_STORAGE_ELIXIR_CAPACITY() const;
@@ -36,7 +37,7 @@ public:
 private:
     const StorageBuildingConfig* _config;
     int _level;
-    float _currentHP;
+    Fixed _currentHP;
     cocos2d::Sprite* _bodySprite;
     cocos2d::Sprite* _healthBar;
     std::string _currentActionKey;
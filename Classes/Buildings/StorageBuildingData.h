@@ -3,6 +3,7 @@
 
 #include "cocos2d.h"
 #include "Soldier/UnitData.h"
+#include "Utils/FixedMath.h"
 #include <vector>
 
 struct StorageBuildingConfig {
@@ -26,6 +27,9 @@ struct StorageBuildingConfig {
     std::string anim_idle = "idle";
     int anim_idle_frames = 1;
     float anim_idle_delay = 0.1f;
+
+    // 战斗模拟用的定点血量（BuildingManager 加载时换算）
+    std::vector<Fixed> simHP;
 };
 
 #endif // __STORAGE_BUILDING_DATA_H__
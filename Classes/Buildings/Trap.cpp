@@ -1,44 +1,14 @@
 ﻿#include "Trap.h"
+#include "Core/BattleEventBus.h"
 #include "Map/GridMap.h"
+#include "Map/BattleSpace.h"
 #include "Soldier/Soldier.h"
 #include "Utils/AudioManager.h"
-#include <cmath>
+#include "Utils/AnimationLod.h"
+#include "Utils/AnimationRegistry.h"
 
 USING_NS_CC;
 
-namespace {
-constexpr int kSpikeFrameStart = 1;
-constexpr int kSpikeFrameEnd = 14;
-constexpr float kSpikeFrameDelay = 0.08f;
-
-constexpr int kTrapFrameStart = 1;
-constexpr int kTrapFrameEnd = 4;
-constexpr float kTrapFrameDelay = 0.1f;
-
-constexpr float kSpikeDamageInterval = 0.5f;
-constexpr float kSpikeDamagePerTick = 18.0f;
-
-Animation* buildNumberedAnimation(const std::string& prefix, int start, int end, float delay) {
-    Vector<SpriteFrame*> frames;
-    for (int i = start; i <= end; ++i) {
-        std::string framePath = StringUtils::format("%s%d.png", prefix.c_str(), i);
-        auto texture = Director::getInstance()->getTextureCache()->addImage(framePath);
-        if (!texture) {
-            continue;
-        }
-        Size size = texture->getContentSize();
-        auto frame = SpriteFrame::createWithTexture(texture, Rect(0, 0, size.width, size.height));
-        if (frame) {
-            frames.pushBack(frame);
-        }
-    }
-    if (frames.empty()) {
-        return nullptr;
-    }
-    return Animation::createWithSpriteFrames(frames, delay);
-}
-} // namespace
-
 const std::vector<Soldier*>* TrapBase::s_enemySoldiers = nullptr;
 
 void TrapBase::setEnemySoldiers(const std::vector<Soldier*>* soldiers) {
@@ -60,12 +30,13 @@ void TrapBase::setGridContext(GridMap* gridMap, int gridX, int gridY, int width,
     _gridBound = true;
 }
 
-bool TrapBase::initTrapBase(const std::string& firstFrame,
-                            const std::string& framePrefix,
-                            int frameStart,
-                            int frameEnd,
-                            float frameDelay,
-                            bool loop) {
+void TrapBase::preloadAssets() {
+    auto* registry = AnimationRegistry::getInstance();
+    registry->preload(AnimSeq::SPIKE_TRAP);
+    registry->preload(AnimSeq::SNAP_TRAP);
+}
+
+bool TrapBase::initTrapBase(const std::string& firstFrame, AnimSeq idleSequence) {
     if (!Node::init()) {
         return false;
     }
@@ -80,88 +51,25 @@ bool TrapBase::initTrapBase(const std::string& firstFrame,
     _bodySprite->setName("bodySprite");
     this->addChild(_bodySprite);
 
-    auto anim = buildNumberedAnimation(framePrefix, frameStart, frameEnd, frameDelay);
+    auto anim = AnimationRegistry::getInstance()->get(idleSequence);
     if (anim && anim->getFrames().size() > 1) {
-        auto animate = Animate::create(anim);
-        if (loop) {
-            _bodySprite->runAction(RepeatForever::create(animate));
-        }
-        else {
-            _bodySprite->runAction(animate);
+        auto act = AnimationLod::createLoop(anim);
+        if (act) {
+            _bodySprite->runAction(act);
         }
     }
 
     return true;
 }
 
-Rect TrapBase::getTriggerRect() const {
+FixedRect TrapBase::getTriggerArea() const {
     if (!_gridMap || !_gridBound) {
-        return Rect::ZERO;
-    }
-    float cellSize = _gridMap->getCellSize();
-    return Rect(_gridX * cellSize, _gridY * cellSize, _gridWidth * cellSize, _gridHeight * cellSize);
-}
-
-Rect getWorldRectFromLocal(Node* node, const Rect& localRect) {
-    if (!node) {
-        return Rect::ZERO;
-    }
-    Vec2 bl = node->convertToWorldSpace(localRect.origin);
-    Vec2 tr = node->convertToWorldSpace(localRect.origin + Vec2(localRect.size.width, localRect.size.height));
-    float minX = std::min(bl.x, tr.x);
-    float minY = std::min(bl.y, tr.y);
-    float maxX = std::max(bl.x, tr.x);
-    float maxY = std::max(bl.y, tr.y);
-    return Rect(minX, minY, maxX - minX, maxY - minY);
-}
-
-Rect getWorldRectFromNodeBounds(Node* node) {
-    if (!node) {
-        return Rect::ZERO;
-    }
-    Rect localRect = node->getBoundingBox();
-    Node* parent = node->getParent();
-    Vec2 bl = parent ? parent->convertToWorldSpace(localRect.origin) : localRect.origin;
-    Vec2 tr = parent ? parent->convertToWorldSpace(localRect.origin + Vec2(localRect.size.width, localRect.size.height))
-                     : localRect.origin + Vec2(localRect.size.width, localRect.size.height);
-    float minX = std::min(bl.x, tr.x);
-    float minY = std::min(bl.y, tr.y);
-    float maxX = std::max(bl.x, tr.x);
-    float maxY = std::max(bl.y, tr.y);
-    return Rect(minX, minY, maxX - minX, maxY - minY);
-}
-
-Rect getLocalRectFromWorldRect(Node* node, const Rect& worldRect) {
-    if (!node) {
-        return Rect::ZERO;
-    }
-    Vec2 bl = node->convertToNodeSpace(worldRect.origin);
-    Vec2 tr = node->convertToNodeSpace(worldRect.origin + Vec2(worldRect.size.width, worldRect.size.height));
-    float minX = std::min(bl.x, tr.x);
-    float minY = std::min(bl.y, tr.y);
-    float maxX = std::max(bl.x, tr.x);
-    float maxY = std::max(bl.y, tr.y);
-    return Rect(minX, minY, maxX - minX, maxY - minY);
-}
-
-Vec2 TrapBase::getSoldierLocalPos(const Soldier* soldier) const {
-    if (!soldier || !_gridMap) {
-        return Vec2::ZERO;
+        return FixedRect();
     }
-    auto* parent = soldier->getParent();
-    Vec2 worldPos = parent ? parent->convertToWorldSpace(soldier->getPosition()) : soldier->getPosition();
-    return _gridMap->convertToNodeSpace(worldPos);
-}
-
-bool TrapBase::getSoldierGridPos(const Soldier* soldier, int& outX, int& outY) const {
-    if (!soldier || !_gridMap) {
-        return false;
-    }
-    Vec2 localPos = getSoldierLocalPos(soldier);
-    Vec2 gridPos = _gridMap->worldToGrid(localPos);
-    outX = static_cast<int>(gridPos.x);
-    outY = static_cast<int>(gridPos.y);
-    return true;
+    // 格子边界是静态几何，换算到战斗空间后量化；士兵位置直接用模拟定点坐标比较
+    Rect local = CombatRules::trapTriggerCells(getKind(), _gridX, _gridY, _gridWidth, _gridHeight,
+        _gridMap->getCellSize());
+    return FixedRect::fromRect(BattleSpace::fromNodeSpace(_gridMap, local));
 }
 
 void TrapBase::freeGridIfNeeded() {
@@ -174,6 +82,7 @@ void TrapBase::freeGridIfNeeded() {
 
 void TrapBase::onExit() {
     freeGridIfNeeded();
+    BattleSpace::forget(this);
     Node::onExit();
 }
 
@@ -188,17 +97,12 @@ SpikeTrap* SpikeTrap::create() {
 }
 
 bool SpikeTrap::init() {
-    if (!initTrapBase("buildings/spike/spike_1.png",
-        "buildings/spike/spike_",
-        kSpikeFrameStart,
-        kSpikeFrameEnd,
-        kSpikeFrameDelay,
-        true)) {
+    if (!initTrapBase("buildings/spike/spike_1.png", AnimSeq::SPIKE_TRAP)) {
         return false;
     }
 
     AudioManager::playSpikeAppear();
-    _damageTimer = 0.0f;
+    _damageTicks = 0;
     this->scheduleUpdate();
     return true;
 }
@@ -208,31 +112,23 @@ void SpikeTrap::update(float dt) {
         return;
     }
 
-    _damageTimer += dt;
-    if (_damageTimer < kSpikeDamageInterval) {
+    // 陷阱只挂在战斗的模拟时钟上（每步 1/60 秒），计时按模拟步数，不用 float 累加
+    if (++_damageTicks < CombatRules::kSpikeDamageIntervalTicks) {
         return;
     }
-    _damageTimer = 0.0f;
+    _damageTicks = 0;
 
-    Rect triggerRect = getTriggerRect();
-    Rect worldRect = getWorldRectFromLocal(_gridMap, triggerRect);
+    // 士兵节点本身没有尺寸，按锚点是否落在地刺区域内判定
+    FixedRect triggerRect = getTriggerArea();
     for (auto* soldier : *s_enemySoldiers) {
         if (!soldier || !soldier->getParent()) {
             continue;
         }
-        if (soldier->getCurrentHP() <= 0.0f) {
+        if (soldier->getHP() <= Fixed()) {
             continue;
         }
-        Rect soldierWorldRect = getWorldRectFromNodeBounds(soldier);
-        if (soldierWorldRect.size.width <= 0.0f || soldierWorldRect.size.height <= 0.0f) {
-            Vec2 worldPos = soldier->getParent()->convertToWorldSpace(soldier->getPosition());
-            if (worldRect.containsPoint(worldPos)) {
-                soldier->takeDamage(kSpikeDamagePerTick);
-            }
-            continue;
-        }
-        if (worldRect.intersectsRect(soldierWorldRect)) {
-            soldier->takeDamage(kSpikeDamagePerTick);
+        if (CombatRules::trapCatches(TrapKind::SPIKE, triggerRect, BattleSpace::simPositionOf(soldier))) {
+            soldier->takeDamage(CombatRules::kSpikeDamage);
         }
     }
 }
@@ -248,50 +144,41 @@ SnapTrap* SnapTrap::create() {
 }
 
 bool SnapTrap::init() {
-    if (!initTrapBase("buildings/trap/trap_1.png",
-        "buildings/trap/trap_",
-        kTrapFrameStart,
-        kTrapFrameStart,
-        kTrapFrameDelay,
-        false)) {
+    // 捕兽夹待机只显示首帧，触发时才播放合拢动画
+    if (!initTrapBase("buildings/trap/trap_1.png", AnimSeq::NONE)) {
         return false;
     }
 
     _triggered = false;
+    _closeTicks = 0;
     this->scheduleUpdate();
     return true;
 }
 
 void SnapTrap::update(float dt) {
-    if (_triggered || !_gridMap || !_gridBound || !s_enemySoldiers) {
+    if (_triggered) {
+        // 合拢动画只是表现，移除时机按模拟步数推进，回放与暂停/加速时保持一致
+        if (_closeTicks > 0 && --_closeTicks == 0) {
+            BattleEventBus::post(BattleEventType::BUILDING_DESTROYED, this);
+            this->removeFromParent();
+        }
+        return;
+    }
+    if (!_gridMap || !_gridBound || !s_enemySoldiers) {
         return;
     }
 
-    Rect triggerRect = getTriggerRect();
+    // 士兵所在格子与捕兽夹所在格子相同时触发
+    FixedRect cellRect = getTriggerArea();
     std::vector<Soldier*> victims;
     for (auto* soldier : *s_enemySoldiers) {
         if (!soldier || !soldier->getParent()) {
             continue;
         }
-        if (soldier->getCurrentHP() <= 0.0f) {
+        if (soldier->getHP() <= Fixed()) {
             continue;
         }
-
-        bool shouldTrigger = false;
-        Rect soldierWorldRect = getWorldRectFromNodeBounds(soldier);
-        if (soldierWorldRect.size.width > 0.0f && soldierWorldRect.size.height > 0.0f) {
-            Rect soldierLocalRect = getLocalRectFromWorldRect(_gridMap, soldierWorldRect);
-            shouldTrigger = triggerRect.intersectsRect(soldierLocalRect);
-        }
-        else {
-            int gridX = 0;
-            int gridY = 0;
-            if (getSoldierGridPos(soldier, gridX, gridY)) {
-                shouldTrigger = (gridX == _gridX && gridY == _gridY);
-            }
-        }
-
-        if (shouldTrigger) {
+        if (CombatRules::trapCatches(TrapKind::SNAP, cellRect, BattleSpace::simPositionOf(soldier))) {
             victims.push_back(soldier);
         }
     }
@@ -306,22 +193,23 @@ void SnapTrap::triggerOnSoldiers(const std::vector<Soldier*>& soldiers) {
     _triggered = true;
 
     AudioManager::playSnapTrap();
+    BattleEventBus::post(BattleEventType::TRAP_TRIGGERED, this, static_cast<int>(soldiers.size()));
     for (auto* soldier : soldiers) {
         if (soldier) {
-            soldier->takeDamage(soldier->getCurrentHP() + 1.0f);
+            soldier->takeDamage(CombatRules::lethalDamage(soldier->getHP()));
         }
     }
 
     if (_bodySprite) {
         _bodySprite->stopAllActions();
-        auto anim = buildNumberedAnimation("buildings/trap/trap_", kTrapFrameStart, kTrapFrameEnd, 0.06f);
+        auto anim = AnimationRegistry::getInstance()->get(AnimSeq::SNAP_TRAP);
         if (anim) {
             _bodySprite->runAction(Animate::create(anim));
-            float duration = anim->getDuration();
-            this->runAction(Sequence::create(DelayTime::create(duration), RemoveSelf::create(), nullptr));
+            _closeTicks = CombatRules::kSnapCloseTicks;
             return;
         }
     }
 
+    BattleEventBus::post(BattleEventType::BUILDING_DESTROYED, this);
     this->removeFromParent();
 }
@@ -2,6 +2,9 @@
 #define __TRAP_H__
 
 #include "cocos2d.h"
+#include "Core/CombatRules.h"
+#include "Utils/AnimationRegistry.h"
+#include "Utils/FixedMath.h"
 #include <vector>
 
 class GridMap;
@@ -12,17 +15,18 @@ public:
     static void setEnemySoldiers(const std::vector<Soldier*>* soldiers);
     static void clearEnemySoldiersIf(const std::vector<Soldier*>* soldiers);
     void setGridContext(GridMap* gridMap, int gridX, int gridY, int width, int height);
+    // 预载地刺与捕兽夹序列帧
+    static void preloadAssets();
+
+    virtual TrapKind getKind() const = 0;
+    // 仍可触发（捕兽夹触发后只等合拢动画播完）
+    virtual bool isArmed() const { return true; }
+    // 触发区域（战斗空间，定点），规则见 CombatRules::trapTriggerCells
+    FixedRect getTriggerArea() const;
 
 protected:
-    bool initTrapBase(const std::string& firstFrame,
-                      const std::string& framePrefix,
-                      int frameStart,
-                      int frameEnd,
-                      float frameDelay,
-                      bool loop);
-    cocos2d::Rect getTriggerRect() const;
-    cocos2d::Vec2 getSoldierLocalPos(const Soldier* soldier) const;
-    bool getSoldierGridPos(const Soldier* soldier, int& outX, int& outY) const;
+    // idleSequence 为待机循环动画，AnimSeq::NONE 表示静止
+    bool initTrapBase(const std::string& firstFrame, AnimSeq idleSequence);
     void freeGridIfNeeded();
 
     GridMap* _gridMap = nullptr;
@@ -45,9 +49,10 @@ public:
     static SpikeTrap* create();
     bool init() override;
     void update(float dt) override;
+    TrapKind getKind() const override { return TrapKind::SPIKE; }
 
 private:
-    float _damageTimer = 0.0f;
+    int _damageTicks = 0;   // 距上次伤害经过的模拟步数
 };
 
 class SnapTrap : public TrapBase {
@@ -55,9 +60,12 @@ public:
     static SnapTrap* create();
     bool init() override;
     void update(float dt) override;
+    TrapKind getKind() const override { return TrapKind::SNAP; }
+    bool isArmed() const override { return !_triggered; }
 
 private:
     bool _triggered = false;
+    int _closeTicks = 0;    // 合拢动画剩余的模拟步数，归零时移除
     void triggerOnSoldiers(const std::vector<Soldier*>& soldiers);
 };
 
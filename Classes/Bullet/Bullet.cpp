@@ -1,9 +1,11 @@
 ﻿// Bullet.cpp
 #include "Bullet.h"
+#include "Core/CombatRules.h"
+#include "Map/BattleSpace.h"
 
 USING_NS_CC;
 
-Bullet* Bullet::create(const std::string& spriteFrame, float damage, float speed) {
+Bullet* Bullet::create(const std::string& spriteFrame, Fixed damage, Fixed speed) {
     Bullet* pRet = new(std::nothrow) Bullet();
     if (pRet && pRet->init(spriteFrame, damage, speed)) {
         pRet->autorelease();
@@ -13,12 +15,12 @@ Bullet* Bullet::create(const std::string& spriteFrame, float damage, float speed
     return nullptr;
 }
 
-bool Bullet::init(const std::string& spriteFrame, float damage, float speed) {
+bool Bullet::init(const std::string& spriteFrame, Fixed damage, Fixed speed) {
     if (!Node::init()) return false;
 
     _damage = damage;
     _speed = speed;
-    _target = nullptr;
+    _target = EntityHandle();
     _rotateToTarget = true;
     _rotationOffsetDegrees = 0.0f;
 
@@ -33,16 +35,7 @@ bool Bullet::init(const std::string& spriteFrame, float damage, float speed) {
 }
 
 void Bullet::setTarget(cocos2d::Node* target) {
-    if (_target == target) {
-        return;
-    }
-    if (_target) {
-        _target->release();
-    }
-    _target = target;
-    if (_target) {
-        _target->retain();
-    }
+    _target = EntityTable::handleOf(target);
 }
 
 void Bullet::setRotateToTarget(bool rotate, float rotationOffsetDegrees) {
@@ -51,46 +44,33 @@ void Bullet::setRotateToTarget(bool rotate, float rotationOffsetDegrees) {
 }
 
 void Bullet::update(float dt) {
-    if (!_target || !_target->getParent()) {
+    Node* target = EntityTable::lookup(_target);
+    if (!target) {
         this->removeFromParent();
         return;
     }
 
-    auto* parent = this->getParent();
-    auto* targetParent = _target->getParent();
-    Vec2 targetWorld = targetParent
-        ? targetParent->convertToWorldSpace(_target->getPosition())
-        : _target->getPosition();
-    Vec2 targetPos = parent ? parent->convertToNodeSpace(targetWorld) : targetWorld;
-
-    Vec2 currentPos = this->getPosition();
-    Vec2 diff = targetPos - currentPos;
-    float distance = diff.length();
-
-    // Check if reached target
-    if (distance < 5.0f) {
+    // 飞行判定与位移全程定点，命中帧在各平台一致（与快进模拟共用同一规则）
+    FixedVec2 position = BattleSpace::simPositionOf(this);
+    FixedVec2 diff = BattleSpace::simPositionOf(target) - position;
+    if (CombatRules::advanceProjectile(position, position + diff, _speed, dt)) {
         onReachTarget();
         this->removeFromParent();
         return;
     }
-
-    // Move towards target
-    Vec2 direction = diff.getNormalized();
-    Vec2 newPos = currentPos + direction * _speed * dt;
-    this->setPosition(newPos);
+    BattleSpace::place(this, position);
 
     // Rotate bullet to face target
     if (_rotateToTarget && _sprite) {
-        float angle = CC_RADIANS_TO_DEGREES(atan2(diff.y, diff.x));
+        // 朝向只影响渲染，保留浮点
+        float angle = CC_RADIANS_TO_DEGREES(atan2(diff.y.toFloat(), diff.x.toFloat()));
         _sprite->setRotation(-angle + _rotationOffsetDegrees);
     }
 }
 
 void Bullet::onExit() {
-    if (_target) {
-        _target->release();
-        _target = nullptr;
-    }
+    _target = EntityHandle();
+    BattleSpace::forget(this);
     Node::onExit();
 }
 
@@ -3,23 +3,26 @@
 #define __BULLET_H__
 
 #include "cocos2d.h"
+#include "Core/EntityTable.h"
+#include "Utils/FixedMath.h"
 
 class Bullet : public cocos2d::Node {
 public:
-    static Bullet* create(const std::string& spriteFrame, float damage, float speed);
-    virtual bool init(const std::string& spriteFrame, float damage, float speed);
+    // 伤害与速度为模拟用定点值（速度单位：像素/秒）
+    static Bullet* create(const std::string& spriteFrame, Fixed damage, Fixed speed);
+    virtual bool init(const std::string& spriteFrame, Fixed damage, Fixed speed);
     virtual void update(float dt) override;
     void onExit() override;
 
     void setTarget(cocos2d::Node* target);
     void setRotateToTarget(bool rotate, float rotationOffsetDegrees = 0.0f);
-    float getDamage() const { return _damage; }
+    Fixed getDamage() const { return _damage; }
     
 protected:
     cocos2d::Sprite* _sprite;
-    cocos2d::Node* _target;
-    float _damage;
-    float _speed;
+    EntityHandle _target;          // 目标士兵句柄，士兵死亡后自动失效
+    Fixed _damage;
+    Fixed _speed;
     bool _rotateToTarget = true;
     float _rotationOffsetDegrees = 0.0f;
     
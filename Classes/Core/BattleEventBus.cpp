@@ -0,0 +1,75 @@
+﻿// BattleEventBus.cpp
+#include "BattleEventBus.h"
+#include "EntityTable.h"
+
+BattleEventBus* BattleEventBus::s_active = nullptr;
+
+void BattleEventBus::setActive(BattleEventBus* bus) {
+    s_active = bus;
+}
+
+void BattleEventBus::clearActiveIf(const BattleEventBus* bus) {
+    if (s_active == bus) {
+        s_active = nullptr;
+    }
+}
+
+void BattleEventBus::post(BattleEventType type, cocos2d::Node* node, int count) {
+    if (s_active) {
+        s_active->publish(type, node, count);
+    }
+}
+
+void BattleEventBus::subscribe(BattleEventType type, const Handler& handler) {
+    int index = static_cast<int>(type);
+    if (index < 0 || index >= static_cast<int>(BattleEventType::COUNT) || !handler) {
+        return;
+    }
+    _handlers[index].push_back(handler);
+}
+
+void BattleEventBus::publish(const BattleEvent& event) {
+    int index = static_cast<int>(event.type);
+    if (index < 0 || index >= static_cast<int>(BattleEventType::COUNT)) {
+        return;
+    }
+    // 移除类事件立即让实体句柄失效，同一帧内后续的目标校验即可看到；列表删除留到分发时
+    if (event.type == BattleEventType::UNIT_DIED || event.type == BattleEventType::BUILDING_DESTROYED) {
+        EntityTable::retireActive(event.node);
+    }
+    _queue.push_back(event);
+}
+
+void BattleEventBus::publish(BattleEventType type, cocos2d::Node* node, int count) {
+    BattleEvent event;
+    event.type = type;
+    event.node = node;
+    event.count = count;
+    publish(event);
+}
+
+int BattleEventBus::dispatch() {
+    if (_dispatching) {
+        return 0;
+    }
+    _dispatching = true;
+
+    // 处理器可能继续发布事件（如建筑摧毁后发布大本营摧毁），按下标遍历以免迭代器失效
+    size_t index = 0;
+    for (; index < _queue.size(); ++index) {
+        BattleEvent event = _queue[index];
+        for (const auto& handler : _handlers[static_cast<int>(event.type)]) {
+            handler(event);
+        }
+    }
+    _queue.clear();
+    _dispatching = false;
+    return static_cast<int>(index);
+}
+
+void BattleEventBus::clear() {
+    _queue.clear();
+    for (auto& handlers : _handlers) {
+        handlers.clear();
+    }
+}
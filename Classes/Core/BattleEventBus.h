@@ -0,0 +1,61 @@
+﻿// BattleEventBus.h
+#ifndef __BATTLE_EVENT_BUS_H__
+#define __BATTLE_EVENT_BUS_H__
+
+#include "cocos2d.h"
+#include <functional>
+#include <vector>
+
+// 战斗事件类型（也是订阅表下标）
+enum class BattleEventType {
+    UNIT_SPAWNED,           // 士兵上场（node 为士兵）
+    UNIT_DIED,              // 士兵死亡动画结束、即将移除（node 为士兵）
+    BUILDING_DESTROYED,     // 建筑/陷阱即将移除（node 为建筑）
+    TRAP_TRIGGERED,         // 陷阱触发（node 为陷阱，count 为受害人数）
+    BASE_DESTROYED,         // 大本营被摧毁（node 为大本营）
+    COUNT
+};
+
+struct BattleEvent {
+    BattleEventType type = BattleEventType::COUNT;
+    cocos2d::Node* node = nullptr;  // 只作标识；分发时节点可能已从场景移除，但仍被战斗场景持有
+    int count = 0;
+};
+
+/**
+ * 战斗事件总线
+ * 单位与建筑在状态变化处发布事件，事件先入队，由战斗场景在模拟步内固定的位置统一分发，
+ * 录制与回放在同一帧看到相同的事件顺序。计数与胜负条件随事件增量更新，不再逐帧扫描全部单位。
+ * 只在主线程使用。
+ */
+class BattleEventBus {
+public:
+    using Handler = std::function<void(const BattleEvent&)>;
+
+    static void setActive(BattleEventBus* bus);
+    static void clearActiveIf(const BattleEventBus* bus);
+
+    // 发布到当前战斗的总线，没有进行中的战斗时无操作
+    static void post(BattleEventType type, cocos2d::Node* node, int count = 0);
+
+    void subscribe(BattleEventType type, const Handler& handler);
+    void publish(const BattleEvent& event);
+    void publish(BattleEventType type, cocos2d::Node* node, int count = 0);
+
+    // 按发布顺序分发队列中的事件（处理期间新发布的事件也在本次分发），返回分发数量
+    int dispatch();
+
+    bool hasPending() const { return !_queue.empty(); }
+
+    // 清空队列与全部订阅
+    void clear();
+
+private:
+    static BattleEventBus* s_active;
+
+    std::vector<Handler> _handlers[static_cast<int>(BattleEventType::COUNT)];
+    std::vector<BattleEvent> _queue;
+    bool _dispatching = false;
+};
+
+#endif // __BATTLE_EVENT_BUS_H__
@@ -0,0 +1,181 @@
+﻿// CombatRules.cpp
+#include "CombatRules.h"
+#include "Soldier/UnitData.h"
+#include "Buildings/DefenseBuildingData.h"
+#include <algorithm>
+#include <string>
+
+USING_NS_CC;
+
+const Fixed CombatRules::kAttackRangeTolerance = Fixed::fromInt(6);
+const Fixed CombatRules::kSpikeDamage = Fixed::fromInt(18);
+
+namespace {
+// 最小移动步长（约 0.05），低于此值不切换为移动动画
+const Fixed kMinMoveStep = Fixed::fromRaw(3277);
+// 配置缺少有效速度时的默认移动速度
+const Fixed kDefaultMoveSpeed = Fixed::fromInt(60);
+// 士兵攻击间隔：缺少配置时的默认值与下限
+constexpr float kDefaultUnitAttackInterval = 0.4f;
+constexpr float kMinUnitAttackInterval = 0.2f;
+// 防御塔：缺少攻速配置时的开火间隔，火焰塔伤害间隔下限
+constexpr float kDefaultTowerAttackInterval = 0.5f;
+constexpr float kMinFireTickInterval = 0.15f;
+// 子弹与目标中心距离小于此值视为命中
+const Fixed kProjectileHitRadius = Fixed::fromInt(5);
+} // namespace
+
+// ===================================================
+// 士兵
+// ===================================================
+
+Fixed CombatRules::unitMaxHP(const UnitConfig* config, int level) {
+    Fixed hp = config ? FixedMath::levelValue(config->simHP, level) : Fixed();
+    return hp > Fixed() ? hp : Fixed::fromInt(1);
+}
+
+Fixed CombatRules::unitATK(const UnitConfig* config, int level) {
+    return config ? FixedMath::levelValue(config->simATK, level) : Fixed();
+}
+
+Fixed CombatRules::unitRange(const UnitConfig* config, int level) {
+    return config ? FixedMath::levelValue(config->simRANGE, level) : Fixed();
+}
+
+Fixed CombatRules::unitSpeed(const UnitConfig* config, int level) {
+    if (!config) {
+        return kDefaultMoveSpeed;
+    }
+    Fixed speed = FixedMath::levelValue(config->simSPEED, level);
+    if (speed <= Fixed()) {
+        speed = FixedMath::levelValue(config->simSPEED, 0);
+    }
+    return speed > Fixed() ? speed : kDefaultMoveSpeed;
+}
+
+float CombatRules::unitAttackInterval(const UnitConfig* config) {
+    float interval = config ? config->anim_attack_delay * config->anim_attack_frames : kDefaultUnitAttackInterval;
+    return std::max(interval, kMinUnitAttackInterval);
+}
+
+CombatRules::MoveStep CombatRules::stepToward(const FixedVec2& origin, const FixedVec2& targetPos,
+                                              Fixed dist, Fixed reach, Fixed speed, float dt) {
+    MoveStep result;
+    result.position = origin;
+    if (dist <= reach) {
+        return result;
+    }
+    // dt 为固定模拟步长，换算结果恒定
+    Fixed step = speed * Fixed::fromFloat(dt);
+    if (step <= Fixed()) {
+        return result;
+    }
+
+    FixedVec2 direction = (targetPos - origin).normalized();
+    Fixed remaining = dist - reach;
+    result.moved = true;
+    if (remaining <= kMinMoveStep) {
+        // 剩余距离很小也要补齐，否则会卡在攻击距离外
+        result.position = origin + direction * remaining;
+        return result;
+    }
+    Fixed move = std::min(step, remaining);
+    result.position = origin + direction * move;
+    result.walking = move > kMinMoveStep;
+    return result;
+}
+
+// ===================================================
+// 伤害
+// ===================================================
+
+bool CombatRules::applyDamage(Fixed& hp, Fixed damage) {
+    bool wasAlive = hp > Fixed();
+    hp -= damage;
+    if (hp < Fixed()) {
+        hp = Fixed();
+    }
+    return wasAlive && hp <= Fixed();
+}
+
+// ===================================================
+// 防御塔
+// ===================================================
+
+bool CombatRules::isFireTower(const DefenceBuildingConfig* config) {
+    if (!config) {
+        return false;
+    }
+    return config->name.find("FireTower") != std::string::npos
+        || config->spriteFrameName.find("FireTower") != std::string::npos;
+}
+
+Fixed CombatRules::towerATK(const DefenceBuildingConfig* config, int level) {
+    return config ? FixedMath::levelValue(config->simATK, level) : Fixed();
+}
+
+Fixed CombatRules::towerRange(const DefenceBuildingConfig* config, int level) {
+    return config ? FixedMath::levelValue(config->simATK_RANGE, level) : Fixed();
+}
+
+float CombatRules::towerAttackInterval(const DefenceBuildingConfig* config, int level) {
+    float interval = 0.0f;
+    if (config && level >= 0 && static_cast<size_t>(level) < config->ATK_SPEED.size()) {
+        interval = config->ATK_SPEED[level];
+    }
+    else if (config && !config->ATK_SPEED.empty()) {
+        interval = config->ATK_SPEED[0];
+    }
+    if (interval <= 0.0f) {
+        interval = kDefaultTowerAttackInterval;
+    }
+    if (isFireTower(config)) {
+        interval = std::max(interval, kMinFireTickInterval);
+    }
+    return interval;
+}
+
+bool CombatRules::firesProjectile(const DefenceBuildingConfig* config) {
+    return config && !config->bulletSpriteFrameName.empty() && config->bulletSpeed > 0.0f;
+}
+
+Fixed CombatRules::splashRadius(const DefenceBuildingConfig* config) {
+    if (!config || !config->bulletIsAOE || config->simBulletAOERange <= Fixed()) {
+        return Fixed();
+    }
+    return config->simBulletAOERange;
+}
+
+bool CombatRules::inRadius(const FixedVec2& center, const FixedVec2& pos, Fixed radius) {
+    return FixedMath::distance(center, pos) <= radius;
+}
+
+// ===================================================
+// 子弹
+// ===================================================
+
+bool CombatRules::advanceProjectile(FixedVec2& position, const FixedVec2& targetPos, Fixed speed, float dt) {
+    FixedVec2 diff = targetPos - position;
+    if (diff.length() < kProjectileHitRadius) {
+        return true;
+    }
+    // dt 为固定模拟步长，换算结果恒定
+    position = position + diff.normalized() * (speed * Fixed::fromFloat(dt));
+    return false;
+}
+
+// ===================================================
+// 陷阱
+// ===================================================
+
+Rect CombatRules::trapTriggerCells(TrapKind kind, int gridX, int gridY, int width, int height, float cellSize) {
+    if (kind == TrapKind::SNAP) {
+        width = 1;
+        height = 1;
+    }
+    return Rect(gridX * cellSize, gridY * cellSize, width * cellSize, height * cellSize);
+}
+
+bool CombatRules::trapCatches(TrapKind kind, const FixedRect& area, const FixedVec2& pos) {
+    return kind == TrapKind::SNAP ? area.coversPoint(pos) : area.containsPoint(pos);
+}
@@ -0,0 +1,97 @@
+﻿// CombatRules.h
+#ifndef __COMBAT_RULES_H__
+#define __COMBAT_RULES_H__
+
+#include "cocos2d.h"
+#include "Utils/FixedMath.h"
+
+struct UnitConfig;
+struct DefenceBuildingConfig;
+
+// 陷阱类型
+enum class TrapKind {
+    SPIKE,      // 地刺：占地内每隔一段时间造成伤害
+    SNAP        // 捕兽夹：踩中左下角格子即死，随后移除
+};
+
+/**
+ * 战斗规则
+ * 士兵、防御塔、子弹与陷阱的数值换算和判定只在这里实现一份：
+ * 实时战斗的节点（Soldier / DefenceBuilding / Bullet / TrapBase）与
+ * 快进模拟（AttackSimulator）调用同一组函数，规划结果按实际战斗的规则结算。
+ * 只做纯计算，不访问节点，可在工作线程调用。
+ */
+namespace CombatRules {
+// ---------- 士兵 ----------
+
+// 攻击判定的容差：距离不超过 射程 + 容差 时停下攻击，并保持当前目标
+extern const Fixed kAttackRangeTolerance;
+// 寻敌间隔，避免每帧全量扫描
+constexpr float kTargetRefreshInterval = 0.25f;
+// 士兵分离半径（像素）
+constexpr float kCrowdSeparationRadius = 18.0f;
+
+// 按等级取士兵属性（配置加载时已换算为定点）
+Fixed unitMaxHP(const UnitConfig* config, int level);       // 无效时为 1
+Fixed unitATK(const UnitConfig* config, int level);
+Fixed unitRange(const UnitConfig* config, int level);
+Fixed unitSpeed(const UnitConfig* config, int level);       // 本级无效取 0 级，仍无效用默认速度
+float unitAttackInterval(const UnitConfig* config);
+
+inline Fixed attackReach(Fixed range) { return range + kAttackRangeTolerance; }
+
+// 向目标推进一步的结果
+struct MoveStep {
+    FixedVec2 position;
+    bool moved = false;         // 是否需要写回位置
+    bool walking = false;       // 是否播放移动动画（步长过小时不切换，避免抖动）
+};
+
+// dist 为当前到目标的距离，reach 为停下攻击的距离；dt 为固定模拟步长
+MoveStep stepToward(const FixedVec2& origin, const FixedVec2& targetPos,
+                    Fixed dist, Fixed reach, Fixed speed, float dt);
+
+// ---------- 伤害 ----------
+
+// 扣血并截断到 0，返回这一击是否使目标由存活变为死亡
+bool applyDamage(Fixed& hp, Fixed damage);
+// 必杀伤害（捕兽夹）
+inline Fixed lethalDamage(Fixed hp) { return hp + Fixed::fromInt(1); }
+
+// ---------- 防御塔 ----------
+
+// 火焰塔：对射程内全部目标持续造成伤害
+bool isFireTower(const DefenceBuildingConfig* config);
+Fixed towerATK(const DefenceBuildingConfig* config, int level);
+Fixed towerRange(const DefenceBuildingConfig* config, int level);
+// 开火间隔（火焰塔为伤害间隔，有下限）
+float towerAttackInterval(const DefenceBuildingConfig* config, int level);
+// 是否发射子弹（否则伤害立即结算）
+bool firesProjectile(const DefenceBuildingConfig* config);
+// 范围伤害半径，0 表示单体伤害
+Fixed splashRadius(const DefenceBuildingConfig* config);
+
+inline bool canHit(bool flying, bool skyAble, bool groundAble) {
+    return flying ? skyAble : groundAble;
+}
+bool inRadius(const FixedVec2& center, const FixedVec2& pos, Fixed radius);
+
+// ---------- 子弹 ----------
+
+// 子弹朝目标推进一步；已进入命中半径时不移动并返回 true
+bool advanceProjectile(FixedVec2& position, const FixedVec2& targetPos, Fixed speed, float dt);
+
+// ---------- 陷阱 ----------
+
+constexpr int kSpikeDamageIntervalTicks = 30;   // 0.5 秒
+extern const Fixed kSpikeDamage;
+// 捕兽夹合拢动画 4 帧 x 0.06 秒，播完后移除
+constexpr int kSnapCloseTicks = 15;
+
+// 陷阱的触发格子（网格局部坐标）：地刺为整个占地，捕兽夹只看左下角一格
+cocos2d::Rect trapTriggerCells(TrapKind kind, int gridX, int gridY, int width, int height, float cellSize);
+// 士兵锚点是否触发陷阱：地刺为闭区间，捕兽夹按格子左闭右开（相邻格子不会同时命中）
+bool trapCatches(TrapKind kind, const FixedRect& area, const FixedVec2& pos);
+} // namespace CombatRules
+
+#endif // __COMBAT_RULES_H__
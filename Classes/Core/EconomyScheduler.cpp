@@ -0,0 +1,168 @@
+﻿#include "EconomyScheduler.h"
+#include "Buildings/ProductionBuilding.h"
+#include <algorithm>
+
+USING_NS_CC;
+
+namespace {
+// 过期项超过有效项的倍数时重建堆
+constexpr size_t kCompactRatio = 2;
+constexpr size_t kCompactMinSize = 32;
+
+struct LaterDue {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a.dueMs > b.dueMs;
+    }
+};
+}
+
+void EconomyDelta::add(ResourceType type, int amount) {
+    if (type == ResourceType::DIAMOND) {
+        diamond += amount;
+    }
+    else {
+        coin += amount;
+    }
+}
+
+EconomyScheduler* EconomyScheduler::s_instance = nullptr;
+
+EconomyScheduler* EconomyScheduler::getInstance() {
+    if (!s_instance) {
+        s_instance = new EconomyScheduler();
+    }
+    return s_instance;
+}
+
+void EconomyScheduler::schedule(ProductionBuilding* producer, int64_t dueMs) {
+    if (!producer) {
+        return;
+    }
+    // 旧登记不从堆中删除，只让代号失效，出堆时跳过
+    uint32_t generation = _nextGeneration++;
+    _generations[producer] = generation;
+    Entry entry;
+    entry.dueMs = dueMs;
+    entry.producer = producer;
+    entry.generation = generation;
+    _heap.push_back(entry);
+    std::push_heap(_heap.begin(), _heap.end(), LaterDue());
+
+    if (_heap.size() > kCompactMinSize && _heap.size() > _generations.size() * kCompactRatio) {
+        compact();
+    }
+    if (!_armed || dueMs < _armedDueMs) {
+        armTimer();
+    }
+}
+
+void EconomyScheduler::cancel(ProductionBuilding* producer) {
+    if (_generations.erase(producer) == 0) {
+        return;
+    }
+    if (_generations.empty()) {
+        _heap.clear();
+        disarmTimer();
+    }
+}
+
+void EconomyScheduler::setTickListener(const void* owner, const TickListener& listener) {
+    _listenerOwner = owner;
+    _listener = listener;
+}
+
+void EconomyScheduler::clearTickListenerIf(const void* owner) {
+    if (_listenerOwner == owner) {
+        _listenerOwner = nullptr;
+        _listener = nullptr;
+    }
+}
+
+void EconomyScheduler::onWake() {
+    // 一次性定时器触发后由引擎自行注销，这里只清理状态
+    _armed = false;
+    _wakeKey.clear();
+
+    int64_t nowMs = ProductionBuilding::getWallClockMs();
+    std::vector<ProductionBuilding*> due;
+    while (!_heap.empty() && _heap.front().dueMs <= nowMs) {
+        Entry entry = _heap.front();
+        std::pop_heap(_heap.begin(), _heap.end(), LaterDue());
+        _heap.pop_back();
+        if (!isLive(entry)) {
+            continue;
+        }
+        _generations.erase(entry.producer);
+        due.push_back(entry.producer);
+    }
+
+    // 结算过程中建筑会重新登记下一次到期时间
+    EconomyDelta delta;
+    for (auto* producer : due) {
+        producer->settleProduction(&delta);
+    }
+
+    auto* core = Core::getInstance();
+    if (delta.coin != 0) {
+        core->addResource(ResourceType::COIN, delta.coin);
+    }
+    if (delta.diamond != 0) {
+        core->addResource(ResourceType::DIAMOND, delta.diamond);
+    }
+    if (!due.empty() && _listener) {
+        _listener();
+    }
+
+    armTimer();
+}
+
+void EconomyScheduler::armTimer() {
+    dropStaleTop();
+    if (_heap.empty()) {
+        disarmTimer();
+        return;
+    }
+    int64_t dueMs = _heap.front().dueMs;
+    if (_armed && _armedDueMs == dueMs) {
+        return;
+    }
+    disarmTimer();
+
+    int64_t waitMs = std::max<int64_t>(0, dueMs - ProductionBuilding::getWallClockMs());
+    // 每次使用新的键：一次性定时器触发后会按键注销自身，避免误删新登记的定时器
+    _wakeKey = StringUtils::format("economy_wake_%u", ++_armSerial);
+    _armed = true;
+    _armedDueMs = dueMs;
+    Director::getInstance()->getScheduler()->schedule([this](float) {
+        onWake();
+    }, this, 0.0f, 0, static_cast<float>(waitMs) / 1000.0f, false, _wakeKey);
+}
+
+void EconomyScheduler::disarmTimer() {
+    if (_armed && !_wakeKey.empty()) {
+        Director::getInstance()->getScheduler()->unschedule(_wakeKey, this);
+    }
+    _armed = false;
+    _armedDueMs = 0;
+    _wakeKey.clear();
+}
+
+bool EconomyScheduler::isLive(const Entry& entry) const {
+    auto it = _generations.find(entry.producer);
+    return it != _generations.end() && it->second == entry.generation;
+}
+
+void EconomyScheduler::dropStaleTop() {
+    while (!_heap.empty() && !isLive(_heap.front())) {
+        std::pop_heap(_heap.begin(), _heap.end(), LaterDue());
+        _heap.pop_back();
+    }
+}
+
+void EconomyScheduler::compact() {
+    _heap.erase(std::remove_if(_heap.begin(), _heap.end(), [this](const Entry& entry) {
+        return !isLive(entry);
+    }), _heap.end());
+    std::make_heap(_heap.begin(), _heap.end(), LaterDue());
+}
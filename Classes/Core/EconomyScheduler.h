@@ -0,0 +1,78 @@
+﻿// EconomyScheduler.h
+#ifndef __ECONOMY_SCHEDULER_H__
+#define __ECONOMY_SCHEDULER_H__
+
+#include "Core/Core.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ProductionBuilding;
+
+// 一次经济结算中累积的资源增量，结算结束后统一入账
+struct EconomyDelta {
+    int coin = 0;
+    int diamond = 0;
+
+    void add(ResourceType type, int amount);
+    bool empty() const { return coin == 0 && diamond == 0; }
+};
+
+/**
+ * @brief 经济调度器
+ *
+ * 统一管理所有产出建筑的下一次结算时间（按到期时间排序的最小堆）。
+ * 只为最早到期的建筑登记一个一次性定时器，到期时批量结算：
+ * 资源增量合并为每种资源一次 Core::addResource，并只发出一次界面刷新通知。
+ * 两次产出之间没有任何逐帧回调。
+ */
+class EconomyScheduler {
+public:
+    using TickListener = std::function<void()>;
+
+    static EconomyScheduler* getInstance();
+
+    // 登记/更新建筑的下一次结算时间（墙钟毫秒）
+    void schedule(ProductionBuilding* producer, int64_t dueMs);
+    void cancel(ProductionBuilding* producer);
+
+    // 结算后的界面刷新通知（同一时刻只有一个监听者）
+    void setTickListener(const void* owner, const TickListener& listener);
+    void clearTickListenerIf(const void* owner);
+
+    size_t getScheduledCount() const { return _generations.size(); }
+
+private:
+    struct Entry {
+        int64_t dueMs = 0;
+        ProductionBuilding* producer = nullptr;
+        uint32_t generation = 0;
+    };
+
+    EconomyScheduler() = default;
+
+    void onWake();
+    void armTimer();
+    void disarmTimer();
+    bool isLive(const Entry& entry) const;
+    void dropStaleTop();
+    void compact();
+
+    std::vector<Entry> _heap;                                        // 按 dueMs 的最小堆，含惰性删除的过期项
+    std::unordered_map<ProductionBuilding*, uint32_t> _generations;  // 每个建筑当前有效的登记
+    uint32_t _nextGeneration = 1;
+
+    bool _armed = false;
+    int64_t _armedDueMs = 0;
+    uint32_t _armSerial = 0;
+    std::string _wakeKey;
+
+    const void* _listenerOwner = nullptr;
+    TickListener _listener;
+
+    static EconomyScheduler* s_instance;
+};
+
+#endif // __ECONOMY_SCHEDULER_H__
@@ -0,0 +1,142 @@
+﻿// EntityTable.cpp
+#include "EntityTable.h"
+
+EntityTable* EntityTable::s_active = nullptr;
+
+void EntityTable::setActive(EntityTable* table) {
+    s_active = table;
+}
+
+void EntityTable::clearActiveIf(const EntityTable* table) {
+    if (s_active == table) {
+        s_active = nullptr;
+    }
+}
+
+cocos2d::Node* EntityTable::lookup(EntityHandle handle) {
+    return s_active ? s_active->resolve(handle) : nullptr;
+}
+
+cocos2d::Node* EntityTable::lookup(EntityHandle handle, EntityKind kind) {
+    return s_active ? s_active->resolve(handle, kind) : nullptr;
+}
+
+EntityHandle EntityTable::handleOf(const cocos2d::Node* node) {
+    return s_active ? s_active->find(node) : EntityHandle();
+}
+
+void EntityTable::retireActive(const cocos2d::Node* node) {
+    if (s_active) {
+        s_active->retire(node);
+    }
+}
+
+EntityHandle EntityTable::allocate(EntityKind kind, cocos2d::Node* node, uint32_t listIndex) {
+    if (!node || kind == EntityKind::COUNT || _lookup.count(node) > 0) {
+        return EntityHandle();
+    }
+
+    uint32_t index = 0;
+    if (!_free.empty()) {
+        index = _free.back();
+        _free.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+    }
+
+    Slot& slot = _slots[index];
+    slot.node = node;
+    slot.listIndex = listIndex;
+    slot.serial = _spawnCount[static_cast<int>(kind)]++;
+    slot.kind = kind;
+    slot.alive = true;
+    _lookup[node] = index;
+
+    EntityHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+bool EntityTable::locate(const cocos2d::Node* node, uint32_t& listIndex) const {
+    auto it = _lookup.find(node);
+    if (it == _lookup.end()) {
+        return false;
+    }
+    listIndex = _slots[it->second].listIndex;
+    return true;
+}
+
+void EntityTable::release(const cocos2d::Node* node) {
+    auto it = _lookup.find(node);
+    if (it == _lookup.end()) {
+        return;
+    }
+    Slot& slot = _slots[it->second];
+    if (slot.alive) {
+        slot.generation++;
+    }
+    slot.node = nullptr;
+    slot.alive = false;
+    _free.push_back(it->second);
+    _lookup.erase(it);
+}
+
+void EntityTable::relocate(const cocos2d::Node* node, uint32_t listIndex) {
+    auto it = _lookup.find(node);
+    if (it != _lookup.end()) {
+        _slots[it->second].listIndex = listIndex;
+    }
+}
+
+EntityHandle EntityTable::find(const cocos2d::Node* node) const {
+    EntityHandle handle;
+    if (!node) {
+        return handle;
+    }
+    auto it = _lookup.find(node);
+    if (it == _lookup.end() || !_slots[it->second].alive) {
+        return handle;
+    }
+    handle.index = it->second;
+    handle.generation = _slots[it->second].generation;
+    return handle;
+}
+
+void EntityTable::retire(const cocos2d::Node* node) {
+    auto it = _lookup.find(node);
+    if (it == _lookup.end()) {
+        return;
+    }
+    Slot& slot = _slots[it->second];
+    if (slot.alive) {
+        slot.alive = false;
+        slot.generation++;
+    }
+}
+
+int EntityTable::getSerial(const cocos2d::Node* node) const {
+    auto it = _lookup.find(node);
+    return it != _lookup.end() ? _slots[it->second].serial : -1;
+}
+
+void EntityTable::clear() {
+    // 代数保留，清空前发出的句柄不会在下一场战斗中误命中
+    for (auto& slot : _slots) {
+        if (slot.alive) {
+            slot.generation++;
+        }
+        slot.node = nullptr;
+        slot.alive = false;
+    }
+    _free.clear();
+    for (uint32_t i = static_cast<uint32_t>(_slots.size()); i > 0; --i) {
+        _free.push_back(i - 1);
+    }
+    _lookup.clear();
+    for (auto& count : _spawnCount) {
+        count = 0;
+    }
+}
@@ -0,0 +1,120 @@
+﻿// EntityTable.h
+#ifndef __ENTITY_TABLE_H__
+#define __ENTITY_TABLE_H__
+
+#include "cocos2d.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 实体类别（每类有独立的出场序号）
+enum class EntityKind : uint8_t {
+    SOLDIER,
+    BUILDING,
+    COUNT
+};
+
+// 战斗实体句柄：槽位下标 + 代数；实体移除后代数递增，旧句柄自动失效
+struct EntityHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;    // 0 表示空句柄
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const EntityHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * 战斗实体句柄表
+ * 士兵与敌方建筑进入战斗时登记一个槽位，目标以句柄保存，不再对目标节点 retain/release。
+ * 句柄校验只比较槽位代数（O(1)）；实体摧毁/死亡时立即失效，
+ * 随后由战斗场景从存活列表中交换删除（O(1)，列表不再残留空槽）。
+ * 每个实体记录出场序号（与旧的只增不删列表下标一致），供状态哈希按稳定顺序遍历。
+ * 只在主线程使用。
+ */
+class EntityTable {
+public:
+    static void setActive(EntityTable* table);
+    static void clearActiveIf(const EntityTable* table);
+
+    // 在当前战斗的表中解析/查询/失效，没有进行中的战斗时返回空或无操作
+    static cocos2d::Node* lookup(EntityHandle handle);
+    static cocos2d::Node* lookup(EntityHandle handle, EntityKind kind);
+    static EntityHandle handleOf(const cocos2d::Node* node);
+    static void retireActive(const cocos2d::Node* node);
+
+    // 登记并追加到存活列表末尾
+    template <typename T>
+    EntityHandle insert(EntityKind kind, std::vector<T*>& list, T* node) {
+        EntityHandle handle = allocate(kind, node, static_cast<uint32_t>(list.size()));
+        if (!handle.isNull()) {
+            list.push_back(node);
+        }
+        return handle;
+    }
+
+    // 从存活列表中交换删除并回收槽位；node 不在表中时返回 false
+    template <typename T>
+    bool erase(std::vector<T*>& list, const cocos2d::Node* node) {
+        uint32_t listIndex = 0;
+        if (!locate(node, listIndex) || listIndex >= list.size() || list[listIndex] != node) {
+            return false;
+        }
+        release(node);
+        uint32_t last = static_cast<uint32_t>(list.size() - 1);
+        if (listIndex != last) {
+            list[listIndex] = list[last];
+            relocate(list[listIndex], listIndex);
+        }
+        list.pop_back();
+        return true;
+    }
+
+    cocos2d::Node* resolve(EntityHandle handle) const {
+        if (handle.index >= _slots.size()) {
+            return nullptr;
+        }
+        const Slot& slot = _slots[handle.index];
+        return (slot.alive && slot.generation == handle.generation) ? slot.node : nullptr;
+    }
+    cocos2d::Node* resolve(EntityHandle handle, EntityKind kind) const {
+        cocos2d::Node* node = resolve(handle);
+        return (node && _slots[handle.index].kind == kind) ? node : nullptr;
+    }
+
+    EntityHandle find(const cocos2d::Node* node) const;
+    // 立即使句柄失效（槽位保留到 erase，列表顺序不变）
+    void retire(const cocos2d::Node* node);
+    // 出场序号，不在表中时返回 -1
+    int getSerial(const cocos2d::Node* node) const;
+
+    // 登记中的实体数（含已失效、尚未从列表删除的）
+    size_t getCount() const { return _lookup.size(); }
+    void clear();
+
+private:
+    struct Slot {
+        cocos2d::Node* node = nullptr;
+        uint32_t generation = 1;
+        uint32_t listIndex = 0;         // 在所属存活列表中的下标
+        int serial = 0;
+        EntityKind kind = EntityKind::COUNT;
+        bool alive = false;
+    };
+
+    static EntityTable* s_active;
+
+    EntityHandle allocate(EntityKind kind, cocos2d::Node* node, uint32_t listIndex);
+    bool locate(const cocos2d::Node* node, uint32_t& listIndex) const;
+    void release(const cocos2d::Node* node);
+    void relocate(const cocos2d::Node* node, uint32_t listIndex);
+
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _free;
+    std::unordered_map<const cocos2d::Node*, uint32_t> _lookup;  // 节点 -> 槽位
+    int _spawnCount[static_cast<int>(EntityKind::COUNT)] = {};
+};
+
+#endif // __ENTITY_TABLE_H__
@@ -0,0 +1,259 @@
+﻿// BattleSpace.cpp
+#include "BattleSpace.h"
+#include "Utils/NodeUtils.h"
+#include <algorithm>
+
+USING_NS_CC;
+
+BattleSpace* BattleSpace::s_active = nullptr;
+
+namespace {
+Rect boundsOf(const Vec2& a, const Vec2& b) {
+    float minX = std::min(a.x, b.x);
+    float minY = std::min(a.y, b.y);
+    return Rect(minX, minY, std::max(a.x, b.x) - minX, std::max(a.y, b.y) - minY);
+}
+
+Rect transformRect(const Rect& rect, const AffineTransform& t) {
+    Vec2 bl = PointApplyAffineTransform(rect.origin, t);
+    Vec2 tr = PointApplyAffineTransform(Vec2(rect.getMaxX(), rect.getMaxY()), t);
+    return boundsOf(bl, tr);
+}
+
+// 无活动战斗空间时的退化路径：直接换算到世界坐标系
+AffineTransform worldTransformOf(const Node* node) {
+    return node ? node->getNodeToWorldAffineTransform() : AffineTransform::IDENTITY;
+}
+
+Rect bodyRectInParent(const Node* node, const Sprite* body) {
+    if (body) {
+        return RectApplyAffineTransform(body->getBoundingBox(), node->getNodeToParentAffineTransform());
+    }
+    return node->getBoundingBox();
+}
+
+// 节点到父节点变换去掉位置平移（保留缩放/旋转与锚点偏移），结果与实体位置无关
+AffineTransform linearPartOf(const Node* node) {
+    AffineTransform t = node->getNodeToParentAffineTransform();
+    Vec2 anchor = node->isIgnoreAnchorPointForPosition() ? Vec2::ZERO : node->getAnchorPointInPoints();
+    t.tx = -(t.a * anchor.x + t.c * anchor.y);
+    t.ty = -(t.b * anchor.x + t.d * anchor.y);
+    return t;
+}
+
+AffineTransform withoutTranslation(AffineTransform t) {
+    t.tx = 0.0f;
+    t.ty = 0.0f;
+    return t;
+}
+} // namespace
+
+// ===================================================
+// 活动实例
+// ===================================================
+
+void BattleSpace::setActive(BattleSpace* space) {
+    s_active = space;
+}
+
+void BattleSpace::clearActiveIf(const BattleSpace* space) {
+    if (s_active == space) {
+        s_active = nullptr;
+    }
+}
+
+void BattleSpace::setRoot(Node* root) {
+    _root = root;
+    clear();
+}
+
+void BattleSpace::clear() {
+    _spaces.clear();
+    _entities.clear();
+}
+
+void BattleSpace::forget(const Node* node) {
+    if (s_active && node) {
+        s_active->_entities.erase(node);
+        s_active->_spaces.erase(node);
+    }
+}
+
+// ===================================================
+// 缓存
+// ===================================================
+
+const BattleSpace::SpaceEntry& BattleSpace::spaceOf(const Node* node) {
+    if (!node || node == _root) {
+        return _rootSpace;
+    }
+
+    // 父链逐级缓存：本级局部变换与上一级空间都没变时直接沿用，相机只改根节点不会触发重算
+    const Node* parent = node->getParent();
+    const SpaceEntry* upper = parent ? &spaceOf(parent) : nullptr;
+    AffineTransform local = node->getNodeToParentAffineTransform();
+    SpaceEntry& entry = _spaces[node];
+    bool detached = !upper || upper->detached;
+    if (!detached && entry.epoch != 0 && !entry.detached && entry.parent == parent
+        && entry.upperEpoch == upper->epoch
+        && AffineTransformEqualToTransform(entry.localTransform, local)) {
+        return entry;
+    }
+
+    AffineTransform toBattle;
+    if (detached) {
+        // 不在根节点之下（例如挂在场景上的特效层）：经世界坐标换算，随相机变化，每次重算
+        toBattle = node->getNodeToWorldAffineTransform();
+        if (_root) {
+            toBattle = AffineTransformConcat(toBattle, _root->getWorldToNodeAffineTransform());
+        }
+    }
+    else {
+        toBattle = AffineTransformConcat(local, upper->toBattle);
+    }
+
+    bool changed = entry.epoch == 0 || !AffineTransformEqualToTransform(entry.toBattle, toBattle);
+    entry.detached = detached;
+    entry.parent = parent;
+    entry.upperEpoch = upper ? upper->epoch : 0;
+    entry.localTransform = local;
+    if (changed) {
+        entry.identity = AffineTransformEqualToTransform(toBattle, AffineTransform::IDENTITY);
+        entry.toBattle = toBattle;
+        entry.fromBattle = AffineTransformInvert(toBattle);
+        entry.epoch = ++_spaceEpoch;
+    }
+    return entry;
+}
+
+BattleSpace::EntityEntry& BattleSpace::entityOf(const Node* node) {
+    const Node* parent = node->getParent();
+    const SpaceEntry& space = spaceOf(parent);
+    EntityEntry& entry = _entities[node];
+    const Vec2& localPos = node->getPosition();
+    if (entry.valid && entry.parent == parent && entry.spaceEpoch == space.epoch && entry.localPos == localPos) {
+        return entry;
+    }
+
+    // 首次访问、实体移动或父空间变化：重新计算位置，包围盒延迟到用到时再算
+    entry.valid = true;
+    entry.parent = parent;
+    entry.spaceEpoch = space.epoch;
+    entry.localPos = localPos;
+    entry.position = space.identity ? localPos : PointApplyAffineTransform(localPos, space.toBattle);
+    return entry;
+}
+
+const FixedVec2& BattleSpace::resolveSimPosition(EntityEntry& entry) {
+    // 父节点与局部位置都没被外部改动时沿用 place 记录的定点位置，不再从 float 反推
+    if (!entry.simValid || entry.simParent != entry.parent || entry.simLocalPos != entry.localPos) {
+        entry.simValid = true;
+        entry.simParent = entry.parent;
+        entry.simLocalPos = entry.localPos;
+        entry.simPosition = FixedVec2::fromVec2(entry.position);
+    }
+    return entry.simPosition;
+}
+
+const FixedRect& BattleSpace::extentOf(const Node* node, EntityEntry& entry) {
+    // 主体精灵只查找一次（按名字/尺寸遍历子节点代价较高），之后只比对变换与尺寸
+    if (!entry.bodyResolved) {
+        entry.body = NodeUtils::findBodySprite(node);
+        entry.bodyResolved = true;
+        entry.hasExtent = false;
+    }
+
+    const SpaceEntry& space = spaceOf(entry.parent);
+    AffineTransform nodeLinear = linearPartOf(node);
+    AffineTransform bodyTransform = entry.body ? entry.body->getNodeToParentAffineTransform()
+                                               : AffineTransform::IDENTITY;
+    Size bodySize = entry.body ? entry.body->getContentSize() : node->getContentSize();
+    if (entry.hasExtent && entry.extentEpoch == space.epoch
+        && AffineTransformEqualToTransform(entry.nodeLinear, nodeLinear)
+        && AffineTransformEqualToTransform(entry.bodyTransform, bodyTransform)
+        && entry.bodySize.equals(bodySize)) {
+        return entry.extent;
+    }
+
+    Rect bodyRect = entry.body ? entry.body->getBoundingBox() : Rect(Vec2::ZERO, node->getContentSize());
+    Rect relative = RectApplyAffineTransform(bodyRect, nodeLinear);
+    if (!space.identity) {
+        relative = transformRect(relative, withoutTranslation(space.toBattle));
+    }
+    entry.extentEpoch = space.epoch;
+    entry.nodeLinear = nodeLinear;
+    entry.bodyTransform = bodyTransform;
+    entry.bodySize = bodySize;
+    entry.extent = FixedRect::fromRect(relative);
+    entry.hasExtent = true;
+    return entry.extent;
+}
+
+// ===================================================
+// 查询
+// ===================================================
+
+Vec2 BattleSpace::positionOf(const Node* node) {
+    if (!node) {
+        return Vec2::ZERO;
+    }
+    if (!s_active) {
+        return PointApplyAffineTransform(node->getPosition(), worldTransformOf(node->getParent()));
+    }
+    return s_active->entityOf(node).position;
+}
+
+FixedVec2 BattleSpace::simPositionOf(const Node* node) {
+    if (!node) {
+        return FixedVec2();
+    }
+    if (!s_active) {
+        return FixedVec2::fromVec2(positionOf(node));
+    }
+    return s_active->resolveSimPosition(s_active->entityOf(node));
+}
+
+FixedRect BattleSpace::simFootprintOf(const Node* node) {
+    if (!node) {
+        return FixedRect();
+    }
+    if (!s_active) {
+        Rect parentRect = bodyRectInParent(node, NodeUtils::findBodySprite(node));
+        return FixedRect::fromRect(transformRect(parentRect, worldTransformOf(node->getParent())));
+    }
+    EntityEntry& entry = s_active->entityOf(node);
+    const FixedVec2& position = s_active->resolveSimPosition(entry);
+    return s_active->extentOf(node, entry).offsetBy(position);
+}
+
+void BattleSpace::place(Node* node, const FixedVec2& battlePos) {
+    if (!node) {
+        return;
+    }
+    node->setPosition(toNodeSpace(node->getParent(), battlePos.toVec2()));
+    if (!s_active) {
+        return;
+    }
+    // 渲染位置只是定点位置的近似，模拟位置以这里记录的值为准
+    EntityEntry& entry = s_active->entityOf(node);
+    entry.simValid = true;
+    entry.simParent = entry.parent;
+    entry.simLocalPos = entry.localPos;
+    entry.simPosition = battlePos;
+}
+
+Rect BattleSpace::fromNodeSpace(const Node* node, const Rect& localRect) {
+    if (!s_active) {
+        return transformRect(localRect, worldTransformOf(node));
+    }
+    const SpaceEntry& space = s_active->spaceOf(node);
+    return space.identity ? localRect : transformRect(localRect, space.toBattle);
+}
+
+Vec2 BattleSpace::toNodeSpace(const Node* node, const Vec2& battlePos) {
+    if (!s_active) {
+        return PointApplyAffineTransform(battlePos, AffineTransformInvert(worldTransformOf(node)));
+    }
+    const SpaceEntry& space = s_active->spaceOf(node);
+    return space.identity ? battlePos : PointApplyAffineTransform(battlePos, space.fromBattle);
+}
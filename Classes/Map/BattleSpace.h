@@ -0,0 +1,101 @@
+﻿// BattleSpace.h
+#ifndef __BATTLE_SPACE_H__
+#define __BATTLE_SPACE_H__
+
+#include "cocos2d.h"
+#include "Utils/FixedMath.h"
+#include <unordered_map>
+
+/**
+ * 战斗坐标空间
+ * 士兵、建筑、子弹、陷阱挂在不同父节点下，所有战斗距离/重叠判定统一换算到
+ * 根节点（战斗场景中为 GridMap）的局部坐标系。
+ * - 每个父节点到战斗空间的仿射变换沿父链相乘得到并缓存，父节点自身变换改变时才重算
+ *   （相机平移/缩放只改根节点，不影响缓存）
+ * - 每个实体的战斗坐标按实体缓存，只有局部位置或父空间改变时才重新计算；不再按帧整体清空
+ * - 模拟只使用定点坐标：经 place 移动的实体保存权威的定点位置，渲染位置由它派生；
+ *   主体包围盒保存为相对锚点的定点外扩，只随缩放/主体精灵变化重算，移动时不重算
+ * 缓存属于战斗场景（setActive 注册），实体离开场景时用 forget 移除条目。
+ * 没有活动的战斗空间时退化为世界坐标系且不缓存。
+ */
+class BattleSpace {
+public:
+    static void setActive(BattleSpace* space);
+    static void clearActiveIf(const BattleSpace* space);
+
+    // 以下查询走当前战斗的缓存
+    // 实体锚点在战斗空间中的渲染位置（特效/朝向等表现用）
+    static cocos2d::Vec2 positionOf(const cocos2d::Node* node);
+
+    // 实体的模拟位置：经 place 移动过的实体直接返回记录的定点坐标；
+    // 位置由外部设置（出生、复用、建筑摆放）时从渲染位置量化一次
+    static FixedVec2 simPositionOf(const cocos2d::Node* node);
+    // 主体精灵（无主体精灵时为节点自身）的包围盒 = 模拟位置 + 相对锚点的定点外扩
+    static FixedRect simFootprintOf(const cocos2d::Node* node);
+    // 把实体移到战斗空间中的定点位置，渲染位置随之更新
+    static void place(cocos2d::Node* node, const FixedVec2& battlePos);
+
+    // node 局部坐标 <-> 战斗空间
+    static cocos2d::Rect fromNodeSpace(const cocos2d::Node* node, const cocos2d::Rect& localRect);
+    static cocos2d::Vec2 toNodeSpace(const cocos2d::Node* node, const cocos2d::Vec2& battlePos);
+
+    // 实体离开场景时移除缓存条目（节点地址之后可能被复用）
+    static void forget(const cocos2d::Node* node);
+
+    void setRoot(cocos2d::Node* root);
+    cocos2d::Node* getRoot() const { return _root; }
+    void clear();
+
+private:
+    struct SpaceEntry {
+        bool identity = true;
+        bool detached = false;                      // 不在根节点之下，经世界坐标换算
+        const cocos2d::Node* parent = nullptr;      // 校验用：父节点、局部变换与上一级空间未变则缓存有效
+        unsigned int upperEpoch = 0;
+        cocos2d::AffineTransform localTransform = cocos2d::AffineTransform::IDENTITY;
+        cocos2d::AffineTransform toBattle = cocos2d::AffineTransform::IDENTITY;
+        cocos2d::AffineTransform fromBattle = cocos2d::AffineTransform::IDENTITY;
+        unsigned int epoch = 0;                     // 每次变换改变时递增
+    };
+
+    struct EntityEntry {
+        bool valid = false;
+        const cocos2d::Node* parent = nullptr;
+        unsigned int spaceEpoch = 0;                // 父空间重算后位置随之失效
+        cocos2d::Vec2 localPos;
+        cocos2d::Vec2 position;
+        bool simValid = false;                      // 父节点与局部位置仍是记录模拟位置时的值
+        const cocos2d::Node* simParent = nullptr;
+        cocos2d::Vec2 simLocalPos;
+        FixedVec2 simPosition;
+        bool hasExtent = false;
+        bool bodyResolved = false;
+        const cocos2d::Sprite* body = nullptr;
+        unsigned int extentEpoch = 0;               // 外扩的失效条件：父空间、节点线性变换、主体精灵变换与尺寸
+        cocos2d::AffineTransform nodeLinear = cocos2d::AffineTransform::IDENTITY;
+        cocos2d::AffineTransform bodyTransform = cocos2d::AffineTransform::IDENTITY;
+        cocos2d::Size bodySize;
+        FixedRect extent;                           // 相对锚点
+    };
+
+    static BattleSpace* s_active;
+
+    static SpaceEntry makeRootSpace() {
+        SpaceEntry entry;
+        entry.epoch = 1;
+        return entry;
+    }
+
+    const SpaceEntry& spaceOf(const cocos2d::Node* node);
+    EntityEntry& entityOf(const cocos2d::Node* node);
+    const FixedVec2& resolveSimPosition(EntityEntry& entry);
+    const FixedRect& extentOf(const cocos2d::Node* node, EntityEntry& entry);
+
+    cocos2d::Node* _root = nullptr;
+    SpaceEntry _rootSpace = makeRootSpace();
+    unsigned int _spaceEpoch = 1;               // 1 留给根空间
+    std::unordered_map<const cocos2d::Node*, SpaceEntry> _spaces;
+    std::unordered_map<const cocos2d::Node*, EntityEntry> _entities;
+};
+
+#endif // __BATTLE_SPACE_H__
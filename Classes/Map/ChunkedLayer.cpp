@@ -0,0 +1,138 @@
+﻿// ChunkedLayer.cpp
+#include "ChunkedLayer.h"
+#include <algorithm>
+#include <cmath>
+
+USING_NS_CC;
+
+ChunkedLayer* ChunkedLayer::create(const Size& mapSize, float chunkSize, bool dynamicChildren) {
+    ChunkedLayer* pRet = new(std::nothrow) ChunkedLayer();
+    if (pRet && pRet->init(mapSize, chunkSize, dynamicChildren)) {
+        pRet->autorelease();
+        return pRet;
+    }
+    delete pRet;
+    return nullptr;
+}
+
+bool ChunkedLayer::init(const Size& mapSize, float chunkSize, bool dynamicChildren) {
+    if (!Node::init()) return false;
+
+    _chunkSize = std::max(1.0f, chunkSize);
+    _chunkCols = std::max(1, static_cast<int>(std::ceil(mapSize.width / _chunkSize)));
+    _chunkRows = std::max(1, static_cast<int>(std::ceil(mapSize.height / _chunkSize)));
+    _dynamicChildren = dynamicChildren;
+    _chunkChildren.resize(static_cast<size_t>(_chunkCols) * _chunkRows);
+
+    return true;
+}
+
+void ChunkedLayer::addChild(Node* child, int localZOrder, int tag) {
+    Node::addChild(child, localZOrder, tag);
+    _chunksDirty = true;
+}
+
+void ChunkedLayer::addChild(Node* child, int localZOrder, const std::string& name) {
+    Node::addChild(child, localZOrder, name);
+    _chunksDirty = true;
+}
+
+void ChunkedLayer::removeChild(Node* child, bool cleanup) {
+    Node::removeChild(child, cleanup);
+    _chunksDirty = true;
+}
+
+void ChunkedLayer::removeAllChildrenWithCleanup(bool cleanup) {
+    Node::removeAllChildrenWithCleanup(cleanup);
+    _chunksDirty = true;
+}
+
+void ChunkedLayer::setCullRect(const Rect& rect, float margin) {
+    _cullRect = Rect(rect.origin.x - margin, rect.origin.y - margin,
+                     rect.size.width + margin * 2.0f, rect.size.height + margin * 2.0f);
+    _cullEnabled = true;
+}
+
+void ChunkedLayer::clearCullRect() {
+    _cullEnabled = false;
+}
+
+int ChunkedLayer::chunkCoord(float value, int count) const {
+    int coord = static_cast<int>(std::floor(value / _chunkSize));
+    return std::max(0, std::min(count - 1, coord));
+}
+
+void ChunkedLayer::rebuildChunks() {
+    for (auto& bucket : _chunkChildren) {
+        bucket.clear();
+    }
+    _dynamicIndices.clear();
+
+    const int childCount = static_cast<int>(_children.size());
+    for (int i = 0; i < childCount; ++i) {
+        Node* child = _children.at(i);
+        if (_dynamicChildren || child->getLocalZOrder() != 0) {
+            _dynamicIndices.push_back(i);
+            continue;
+        }
+        const Vec2& pos = child->getPosition();
+        int cx = chunkCoord(pos.x, _chunkCols);
+        int cy = chunkCoord(pos.y, _chunkRows);
+        _chunkChildren[static_cast<size_t>(cy) * _chunkCols + cx].push_back(i);
+    }
+    _chunksDirty = false;
+}
+
+void ChunkedLayer::collectVisibleChildren() {
+    _visibleIndices.clear();
+
+    const int minCx = chunkCoord(_cullRect.getMinX(), _chunkCols);
+    const int maxCx = chunkCoord(_cullRect.getMaxX(), _chunkCols);
+    const int minCy = chunkCoord(_cullRect.getMinY(), _chunkRows);
+    const int maxCy = chunkCoord(_cullRect.getMaxY(), _chunkRows);
+    for (int cy = minCy; cy <= maxCy; ++cy) {
+        for (int cx = minCx; cx <= maxCx; ++cx) {
+            const auto& bucket = _chunkChildren[static_cast<size_t>(cy) * _chunkCols + cx];
+            _visibleIndices.insert(_visibleIndices.end(), bucket.begin(), bucket.end());
+        }
+    }
+    for (int index : _dynamicIndices) {
+        if (_cullRect.containsPoint(_children.at(index)->getPosition())) {
+            _visibleIndices.push_back(index);
+        }
+    }
+
+    // 恢复 _children 的排序顺序，保证遮挡关系与未裁剪时一致
+    std::sort(_visibleIndices.begin(), _visibleIndices.end());
+}
+
+void ChunkedLayer::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) {
+    if (!_cullEnabled) {
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+    if (!_visible) {
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+
+    auto* director = Director::getInstance();
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+
+    if (_reorderChildDirty) {
+        _chunksDirty = true;
+    }
+    sortAllChildren();
+    if (_chunksDirty) {
+        rebuildChunks();
+    }
+    collectVisibleChildren();
+
+    for (int index : _visibleIndices) {
+        _children.at(index)->visit(renderer, _modelViewTransform, flags);
+    }
+
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
@@ -0,0 +1,70 @@
+﻿// ChunkedLayer.h
+#ifndef __CHUNKED_LAYER_H__
+#define __CHUNKED_LAYER_H__
+
+#include "cocos2d.h"
+#include <vector>
+
+/**
+ * @brief 按分块做视口裁剪的容器层
+ *
+ * 子节点仍是本层的直接子节点（外部遍历 getChildren() 的逻辑不受影响），
+ * 只是 visit() 时跳过不在裁剪矩形内的子节点。
+ * - 静态子节点（localZOrder == 0，如建筑、陷阱）按位置归入固定大小的分块，
+ *   只有与裁剪矩形相交的分块会被访问；
+ * - 其余子节点（子弹、特效等），或 dynamicChildren 模式下的全部子节点，
+ *   每帧按位置逐个判定。
+ * 未设置裁剪矩形时行为与普通 Node 完全一致。
+ */
+class ChunkedLayer : public cocos2d::Node {
+public:
+    /**
+     * @param mapSize 地图像素尺寸（决定分块数量）
+     * @param chunkSize 分块边长（像素）
+     * @param dynamicChildren 子节点是否持续移动（如士兵层）
+     */
+    static ChunkedLayer* create(const cocos2d::Size& mapSize, float chunkSize, bool dynamicChildren);
+    virtual bool init(const cocos2d::Size& mapSize, float chunkSize, bool dynamicChildren);
+
+    using cocos2d::Node::addChild;
+    virtual void addChild(cocos2d::Node* child, int localZOrder, int tag) override;
+    virtual void addChild(cocos2d::Node* child, int localZOrder, const std::string& name) override;
+    virtual void removeChild(cocos2d::Node* child, bool cleanup = true) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+
+    virtual void visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
+
+    /**
+     * @brief 设置裁剪矩形（本层坐标系），margin 为子节点尺寸预留的外扩距离
+     */
+    void setCullRect(const cocos2d::Rect& rect, float margin);
+    void clearCullRect();
+
+    /**
+     * @brief 静态子节点被移动后调用，下一帧重新归块
+     * GridMap::occupyCell/occupyCells 会对建筑所在层自动调用；移除走 removeChild，同样会标脏
+     */
+    void markChunksDirty() { _chunksDirty = true; }
+
+    int getVisitedChildCount() const { return static_cast<int>(_visibleIndices.size()); }
+
+private:
+    int _chunkCols = 1;
+    int _chunkRows = 1;
+    float _chunkSize = 256.0f;
+    bool _dynamicChildren = false;
+
+    bool _cullEnabled = false;
+    cocos2d::Rect _cullRect;
+
+    bool _chunksDirty = true;
+    std::vector<std::vector<int>> _chunkChildren;   // 分块 -> 子节点下标（_children 排序后的下标）
+    std::vector<int> _dynamicIndices;
+    std::vector<int> _visibleIndices;
+
+    int chunkCoord(float value, int count) const;
+    void rebuildChunks();
+    void collectVisibleChildren();
+};
+
+#endif // __CHUNKED_LAYER_H__
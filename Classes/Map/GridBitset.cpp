@@ -0,0 +1,88 @@
+﻿// GridBitset.cpp
+#include "GridBitset.h"
+#include <algorithm>
+
+namespace {
+constexpr int kBitsPerWord = 64;
+
+// 生成覆盖[begin, end)位区间的字内掩码（0 <= begin < end <= 64）
+uint64_t makeWordMask(int begin, int end) {
+    uint64_t high = (end >= kBitsPerWord) ? ~0ULL : ((1ULL << end) - 1ULL);
+    uint64_t low = (1ULL << begin) - 1ULL;
+    return high & ~low;
+}
+} // namespace
+
+void GridBitset::reset(int width, int height) {
+    _width = std::max(0, width);
+    _height = std::max(0, height);
+    _wordsPerRow = (_width + kBitsPerWord - 1) / kBitsPerWord;
+    _words.assign(static_cast<size_t>(_wordsPerRow) * static_cast<size_t>(_height), 0ULL);
+}
+
+void GridBitset::set(int x, int y, bool blocked) {
+    uint64_t& word = _words[static_cast<size_t>(y) * _wordsPerRow + x / kBitsPerWord];
+    const uint64_t bit = 1ULL << (x % kBitsPerWord);
+    if (blocked) {
+        word |= bit;
+    }
+    else {
+        word &= ~bit;
+    }
+}
+
+bool GridBitset::test(int x, int y) const {
+    const uint64_t word = _words[static_cast<size_t>(y) * _wordsPerRow + x / kBitsPerWord];
+    return (word >> (x % kBitsPerWord)) & 1ULL;
+}
+
+bool GridBitset::isRowRangeBlocked(int y, int x, int width) const {
+    const uint64_t* row = &_words[static_cast<size_t>(y) * _wordsPerRow];
+    const int end = x + width;
+    for (int bit = x; bit < end;) {
+        const int wordIndex = bit / kBitsPerWord;
+        const int wordBegin = bit % kBitsPerWord;
+        const int wordEnd = std::min(kBitsPerWord, wordBegin + (end - bit));
+        if (row[wordIndex] & makeWordMask(wordBegin, wordEnd)) {
+            return true;
+        }
+        bit += wordEnd - wordBegin;
+    }
+    return false;
+}
+
+bool GridBitset::anyInRect(int x, int y, int width, int height) const {
+    if (x < 0 || y < 0 || x + width > _width || y + height > _height) {
+        return true;
+    }
+    for (int j = y; j < y + height; ++j) {
+        if (isRowRangeBlocked(j, x, width)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GridBitset::fillRect(int x, int y, int width, int height) {
+    const int minX = std::max(0, x);
+    const int maxX = std::min(_width, x + width);
+    const int minY = std::max(0, y);
+    const int maxY = std::min(_height, y + height);
+    for (int j = minY; j < maxY; ++j) {
+        uint64_t* row = &_words[static_cast<size_t>(j) * _wordsPerRow];
+        for (int bit = minX; bit < maxX;) {
+            const int wordBegin = bit % kBitsPerWord;
+            const int wordEnd = std::min(kBitsPerWord, wordBegin + (maxX - bit));
+            row[bit / kBitsPerWord] |= makeWordMask(wordBegin, wordEnd);
+            bit += wordEnd - wordBegin;
+        }
+    }
+}
+
+bool GridBitset::tryOccupy(int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0 || anyInRect(x, y, width, height)) {
+        return false;
+    }
+    fillRect(x, y, width, height);
+    return true;
+}
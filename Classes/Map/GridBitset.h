@@ -0,0 +1,45 @@
+﻿// GridBitset.h
+#ifndef __GRID_BITSET_H__
+#define __GRID_BITSET_H__
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 网格占用位图
+ *
+ * 每行 ceil(W/64) 个64位字，置位表示该格不可放置。矩形检测逐行按字做掩码，
+ * 代价为 O(行数 × 字数)。GridMap 用它维护阻挡格；纯数据、不依赖节点，
+ * 也可以在任务线程上单独使用（如快照加载时的占地校验）。
+ */
+class GridBitset {
+public:
+    GridBitset() = default;
+    GridBitset(int width, int height) { reset(width, height); }
+
+    // 重新分配并清空
+    void reset(int width, int height);
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+
+    void set(int x, int y, bool blocked);
+    bool test(int x, int y) const;
+
+    // 矩形越界或与已置位格子重叠时返回 true
+    bool anyInRect(int x, int y, int width, int height) const;
+    void fillRect(int x, int y, int width, int height);
+
+    // 矩形在界内且完全空闲时置位并返回 true，否则不修改
+    bool tryOccupy(int x, int y, int width, int height);
+
+private:
+    int _width = 0;
+    int _height = 0;
+    int _wordsPerRow = 0;
+    std::vector<uint64_t> _words;
+
+    bool isRowRangeBlocked(int y, int x, int width) const;
+};
+
+#endif // __GRID_BITSET_H__
@@ -1,8 +1,37 @@
 ﻿// GridMap.cpp
 #include "GridMap.h"
+#include "Map/ChunkedLayer.h"
+#include "Utils/GridPatternUtils.h"
+#include <algorithm>
 
 USING_NS_CC;
 
+namespace {
+constexpr int kCellOverlayZOrder = 40;
+
+// 按内存字节序 R,G,B,A 打包纹素
+uint32_t packTexel(const Color4F& color) {
+    Color4B c(color);
+    uint32_t texel = 0;
+    auto* bytes = reinterpret_cast<unsigned char*>(&texel);
+    bytes[0] = c.r;
+    bytes[1] = c.g;
+    bytes[2] = c.b;
+    bytes[3] = c.a;
+    return texel;
+}
+
+// 静态建筑在分块层中按位置归块：放置/移动后让所在层下一帧重新归块
+void markChunksDirty(Node* building) {
+    if (!building) {
+        return;
+    }
+    if (auto* layer = dynamic_cast<ChunkedLayer*>(building->getParent())) {
+        layer->markChunksDirty();
+    }
+}
+} // namespace
+
 GridMap* GridMap::create(int width, int height, float cellSize) {
     GridMap* pRet = new(std::nothrow) GridMap();
     if (pRet && pRet->init(width, height, cellSize)) {
@@ -22,68 +51,240 @@ bool GridMap::init(int width, int height, float cellSize) {
 
     initCells();
 
-    _gridLines = DrawNode::create();
-    this->addChild(_gridLines);
-    _gridLines->setVisible(false);
+    setCellOverlayColors(Color4F(0.0f, 0.5f, 0.0f, 0.2f),
+                         Color4F(0.5f, 0.5f, 0.5f, 0.3f),
+                         Color4F(0.3f, 0.3f, 0.3f, 0.3f));
 
     return true;
 }
 
 void GridMap::initCells() {
-    _cells.resize(_gridHeight);
-    _buildings.resize(_gridHeight);
-    for (int y = 0; y < _gridHeight; ++y) {
-        _cells[y].resize(_gridWidth, CellType::EMPTY);
-        _buildings[y].resize(_gridWidth, nullptr);
-    }
+    const size_t cellCount = static_cast<size_t>(_gridWidth) * static_cast<size_t>(_gridHeight);
+    _cells.assign(cellCount, CellType::EMPTY);
+    _buildings.assign(cellCount, nullptr);
+
+    _blockedBits.reset(_gridWidth, _gridHeight);
 
     // Mark borders as forbidden (optional)
     for (int y = 0; y < _gridHeight; ++y) {
         for (int x = 0; x < _gridWidth; ++x) {
-            if (x < 2 || x >= _gridWidth - 2 || y < 2 || y >= _gridHeight - 2) {
-                _cells[y][x] = CellType::FORBIDDEN;
+            if (isBorderCell(x, y, _gridWidth, _gridHeight)) {
+                setCell(x, y, CellType::FORBIDDEN, nullptr);
             }
         }
     }
+    _blockedSumsDirty = true;
 }
 
-bool GridMap::canPlaceBuilding(int x, int y, int width, int height) {
-    // Check bounds
-    if (x < 0 || y < 0 || x + width > _gridWidth || y + height > _gridHeight) {
-        return false;
-    }
+void GridMap::setCell(int x, int y, CellType type, Node* building) {
+    const int index = cellIndex(x, y);
+    _cells[index] = type;
+    _buildings[index] = building;
+    _blockedBits.set(x, y, type != CellType::EMPTY);
+}
+
+bool GridMap::isBorderCell(int x, int y, int width, int height) {
+    return x < 2 || x >= width - 2 || y < 2 || y >= height - 2;
+}
 
-    // Check all cells - 使用正确的行优先索引 [y][x]
-    for (int j = y; j < y + height; ++j) {
-        for (int i = x; i < x + width; ++i) {
-            if (_cells[j][i] != CellType::EMPTY) {
-                return false;
+void GridMap::initBlockedBits(int width, int height, GridBitset& out) {
+    out.reset(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (isBorderCell(x, y, width, height)) {
+                out.set(x, y, true);
             }
         }
     }
-    return true;
+}
+
+bool GridMap::canPlaceBuilding(int x, int y, int width, int height) const {
+    // 越界或任一格被阻挡即不可放置（位图逐行按64位字检测）
+    return !_blockedBits.anyInRect(x, y, width, height);
 }
 
 void GridMap::occupyCell(int x, int y, int width, int height, Node* building) {
-    for (int j = y; j < y + height; ++j) {
-        for (int i = x; i < x + width; ++i) {
-            if (i >= 0 && i < _gridWidth && j >= 0 && j < _gridHeight) {
-                _cells[j][i] = CellType::OCCUPIED;
-                _buildings[j][i] = building;
+    const int minX = std::max(0, x);
+    const int minY = std::max(0, y);
+    const int maxX = std::min(_gridWidth, x + width);
+    const int maxY = std::min(_gridHeight, y + height);
+    for (int j = minY; j < maxY; ++j) {
+        for (int i = minX; i < maxX; ++i) {
+            setCell(i, j, CellType::OCCUPIED, building);
+        }
+    }
+    _blockedSumsDirty = true;
+    refreshCellOverlay(minX, minY, maxX - minX, maxY - minY);
+    markChunksDirty(building);
+}
+
+void GridMap::occupyCells(const std::vector<GridFootprint>& footprints) {
+    int minX = _gridWidth;
+    int minY = _gridHeight;
+    int maxX = 0;
+    int maxY = 0;
+    for (const auto& footprint : footprints) {
+        const int x0 = std::max(0, footprint.x);
+        const int y0 = std::max(0, footprint.y);
+        const int x1 = std::min(_gridWidth, footprint.x + footprint.width);
+        const int y1 = std::min(_gridHeight, footprint.y + footprint.height);
+        for (int j = y0; j < y1; ++j) {
+            for (int i = x0; i < x1; ++i) {
+                setCell(i, j, CellType::OCCUPIED, footprint.building);
             }
         }
+        markChunksDirty(footprint.building);
+        if (x0 < x1 && y0 < y1) {
+            minX = std::min(minX, x0);
+            minY = std::min(minY, y0);
+            maxX = std::max(maxX, x1);
+            maxY = std::max(maxY, y1);
+        }
+    }
+    _blockedSumsDirty = true;
+    if (minX < maxX && minY < maxY) {
+        refreshCellOverlay(minX, minY, maxX - minX, maxY - minY);
     }
 }
 
 void GridMap::freeCell(int x, int y, int width, int height) {
-    for (int j = y; j < y + height; ++j) {
-        for (int i = x; i < x + width; ++i) {
-            if (i >= 0 && i < _gridWidth && j >= 0 && j < _gridHeight) {
-                _cells[j][i] = CellType::EMPTY;
-                _buildings[j][i] = nullptr;
+    const int minX = std::max(0, x);
+    const int minY = std::max(0, y);
+    const int maxX = std::min(_gridWidth, x + width);
+    const int maxY = std::min(_gridHeight, y + height);
+    for (int j = minY; j < maxY; ++j) {
+        for (int i = minX; i < maxX; ++i) {
+            setCell(i, j, CellType::EMPTY, nullptr);
+        }
+    }
+    _blockedSumsDirty = true;
+    refreshCellOverlay(minX, minY, maxX - minX, maxY - minY);
+}
+
+CellType GridMap::getCellType(int x, int y) const {
+    if (x < 0 || y < 0 || x >= _gridWidth || y >= _gridHeight) {
+        return CellType::FORBIDDEN;
+    }
+    return _cells[cellIndex(x, y)];
+}
+
+bool GridMap::isCellBlocked(int x, int y) const {
+    return getCellType(x, y) != CellType::EMPTY;
+}
+
+Node* GridMap::getBuildingAt(int x, int y) const {
+    if (x < 0 || y < 0 || x >= _gridWidth || y >= _gridHeight) {
+        return nullptr;
+    }
+    return _buildings[cellIndex(x, y)];
+}
+
+void GridMap::collectBuildingsAround(int x, int y, int side, int below, std::vector<Node*>& out) const {
+    out.clear();
+    auto append = [&out](Node* building) {
+        if (building && std::find(out.begin(), out.end(), building) == out.end()) {
+            out.push_back(building);
+        }
+    };
+
+    append(getBuildingAt(x, y));
+    for (int j = y; j >= y - below; --j) {
+        for (int i = x - side; i <= x + side; ++i) {
+            append(getBuildingAt(i, j));
+        }
+    }
+}
+
+void GridMap::rebuildBlockedSums() const {
+    const int stride = _gridWidth + 1;
+    _blockedSums.assign(static_cast<size_t>(stride) * static_cast<size_t>(_gridHeight + 1), 0);
+    for (int y = 0; y < _gridHeight; ++y) {
+        int rowSum = 0;
+        for (int x = 0; x < _gridWidth; ++x) {
+            rowSum += (_cells[cellIndex(x, y)] != CellType::EMPTY) ? 1 : 0;
+            _blockedSums[(y + 1) * stride + (x + 1)] = _blockedSums[y * stride + (x + 1)] + rowSum;
+        }
+    }
+    _blockedSumsDirty = false;
+}
+
+int GridMap::sumBlocked(int x, int y, int width, int height) const {
+    const int stride = _gridWidth + 1;
+    const int x1 = x + width;
+    const int y1 = y + height;
+    return _blockedSums[y1 * stride + x1]
+        - _blockedSums[y * stride + x1]
+        - _blockedSums[y1 * stride + x]
+        + _blockedSums[y * stride + x];
+}
+
+int GridMap::countBlockedCells(int x, int y, int width, int height) const {
+    const int minX = std::max(0, x);
+    const int minY = std::max(0, y);
+    const int maxX = std::min(_gridWidth, x + width);
+    const int maxY = std::min(_gridHeight, y + height);
+    if (minX >= maxX || minY >= maxY) {
+        return 0;
+    }
+    if (_blockedSumsDirty) {
+        rebuildBlockedSums();
+    }
+    return sumBlocked(minX, minY, maxX - minX, maxY - minY);
+}
+
+bool GridMap::findNearestFreeSpot(int x, int y, int width, int height, int* outX, int* outY) const {
+    if (width <= 0 || height <= 0 || width > _gridWidth || height > _gridHeight) {
+        return false;
+    }
+    if (_blockedSumsDirty) {
+        rebuildBlockedSums();
+    }
+
+    const int maxX = _gridWidth - width;
+    const int maxY = _gridHeight - height;
+    const int startX = std::max(0, std::min(x, maxX));
+    const int startY = std::max(0, std::min(y, maxY));
+    const int maxRadius = std::max(std::max(startX, maxX - startX), std::max(startY, maxY - startY));
+
+    // 按切比雪夫距离逐环扩展，每个候选位置 O(1) 判定。
+    // 第 r 环上的点欧氏距离平方至少为 r²，找到候选后继续扩展到 r² 不小于当前最优为止，
+    // 保证返回的是欧氏距离最近的位置而不只是最内环中的一个
+    int bestX = -1;
+    int bestY = -1;
+    int bestDist = 0;
+    for (int radius = 0; radius <= maxRadius; ++radius) {
+        if (bestX >= 0 && radius * radius >= bestDist) {
+            break;
+        }
+        const int y0 = std::max(0, startY - radius);
+        const int y1 = std::min(maxY, startY + radius);
+        for (int cy = y0; cy <= y1; ++cy) {
+            const bool edgeRow = (cy == startY - radius || cy == startY + radius);
+            const int step = edgeRow ? 1 : radius * 2;
+            for (int cx = startX - radius; cx <= startX + radius; cx += step) {
+                if (cx < 0 || cx > maxX) {
+                    continue;
+                }
+                if (sumBlocked(cx, cy, width, height) != 0) {
+                    continue;
+                }
+                const int dx = cx - startX;
+                const int dy = cy - startY;
+                const int dist = dx * dx + dy * dy;
+                if (bestX < 0 || dist < bestDist) {
+                    bestX = cx;
+                    bestY = cy;
+                    bestDist = dist;
+                }
             }
         }
     }
+    if (bestX < 0) {
+        return false;
+    }
+    if (outX) *outX = bestX;
+    if (outY) *outY = bestY;
+    return true;
 }
 
 Vec2 GridMap::gridToWorld(int x, int y) {
@@ -97,26 +298,96 @@ Vec2 GridMap::worldToGrid(Vec2 pos) {
 }
 
 void GridMap::showGrid(bool show) {
-    if (show) {
+    if (show && !_gridLines) {
         drawGridLines();
     }
-    _gridLines->setVisible(show);
+    if (_gridLines) {
+        _gridLines->setVisible(show);
+    }
 }
 
 void GridMap::drawGridLines() {
-    if (!_gridLines) return;
+    // Single repeating cell texture; created once, toggling is just visibility
+    _gridLines = GridPatternUtils::createGridLineSprite(
+        _gridWidth, _gridHeight, _cellSize, Color4F(0.5f, 0.5f, 0.5f, 0.5f), 0.0f, 0.0f);
+    if (_gridLines) {
+        this->addChild(_gridLines);
+    }
+}
 
-    _gridLines->clear();
+void GridMap::setCellOverlayColors(const Color4F& empty, const Color4F& occupied, const Color4F& forbidden) {
+    uint32_t palette[3] = { packTexel(empty), packTexel(occupied), packTexel(forbidden) };
+    if (std::equal(palette, palette + 3, _overlayPalette)) {
+        return;
+    }
+    std::copy(palette, palette + 3, _overlayPalette);
+    if (_cellOverlay) {
+        refreshCellOverlay(0, 0, _gridWidth, _gridHeight);
+    }
+}
 
-    // Draw vertical lines
-    for (int x = 0; x <= _gridWidth; ++x) {
-        float xPos = x * _cellSize;
-        _gridLines->drawLine(Vec2(xPos, 0), Vec2(xPos, _gridHeight * _cellSize), Color4F(0.5f, 0.5f, 0.5f, 0.5f));
+void GridMap::showCellOverlay(bool show) {
+    if (show && !_cellOverlay) {
+        createCellOverlay();
+    }
+    if (_cellOverlay) {
+        _cellOverlay->setVisible(show);
     }
+}
 
-    // Draw horizontal lines
-    for (int y = 0; y <= _gridHeight; ++y) {
-        float yPos = y * _cellSize;
-        _gridLines->drawLine(Vec2(0, yPos), Vec2(_gridWidth * _cellSize, yPos), Color4F(0.5f, 0.5f, 0.5f, 0.5f));
+void GridMap::createCellOverlay() {
+    if (_gridWidth <= 0 || _gridHeight <= 0) {
+        return;
+    }
+
+    _overlayTexels.resize(static_cast<size_t>(_gridWidth) * static_cast<size_t>(_gridHeight));
+    for (int y = 0; y < _gridHeight; ++y) {
+        uint32_t* row = &_overlayTexels[static_cast<size_t>(_gridHeight - 1 - y) * _gridWidth];
+        for (int x = 0; x < _gridWidth; ++x) {
+            row[x] = _overlayPalette[static_cast<int>(_cells[cellIndex(x, y)])];
+        }
+    }
+
+    auto texture = new (std::nothrow) Texture2D();
+    if (!texture) {
+        return;
+    }
+    texture->initWithData(_overlayTexels.data(), _overlayTexels.size() * sizeof(uint32_t),
+        Texture2D::PixelFormat::RGBA8888, _gridWidth, _gridHeight,
+        Size(static_cast<float>(_gridWidth), static_cast<float>(_gridHeight)));
+    texture->setAliasTexParameters();
+
+    _cellOverlay = Sprite::createWithTexture(texture);
+    texture->release();
+    if (!_cellOverlay) {
+        _overlayTexels.clear();
+        return;
+    }
+    _cellTexture = texture;
+    _cellOverlay->setAnchorPoint(Vec2::ZERO);
+    _cellOverlay->setPosition(Vec2::ZERO);
+    _cellOverlay->setScale(_cellSize);
+    _cellOverlay->setVisible(false);
+    this->addChild(_cellOverlay, kCellOverlayZOrder);
+}
+
+void GridMap::refreshCellOverlay(int x, int y, int width, int height) {
+    if (!_cellOverlay || !_cellTexture || width <= 0 || height <= 0) {
+        return;
+    }
+
+    // 纹理行序与地图行序相反：地图 [y, y+height) 对应纹理 [H-y-height, H-y)
+    const int texTop = _gridHeight - y - height;
+    _overlayUploadBuffer.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    for (int row = 0; row < height; ++row) {
+        const int gridY = _gridHeight - 1 - (texTop + row);
+        uint32_t* texRow = &_overlayTexels[static_cast<size_t>(texTop + row) * _gridWidth];
+        uint32_t* uploadRow = &_overlayUploadBuffer[static_cast<size_t>(row) * width];
+        for (int col = 0; col < width; ++col) {
+            const uint32_t texel = _overlayPalette[static_cast<int>(_cells[cellIndex(x + col, gridY)])];
+            texRow[x + col] = texel;
+            uploadRow[col] = texel;
+        }
     }
+    _cellTexture->updateWithData(_overlayUploadBuffer.data(), x, texTop, width, height);
 }
@@ -3,10 +3,21 @@
 #define __GRID_MAP_H__
 
 #include "cocos2d.h"
+#include "Map/GridBitset.h"
+#include <cstdint>
 #include <vector>
 
 class Building;
 
+// 一个建筑的占地（批量占用用）
+struct GridFootprint {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    cocos2d::Node* building = nullptr;
+};
+
 enum class CellType {
     EMPTY = 0,
     OCCUPIED = 1,
@@ -19,15 +30,56 @@ public:
     virtual bool init(int width, int height, float cellSize);
 
     // Core methods
-    bool canPlaceBuilding(int x, int y, int width, int height);
+    bool canPlaceBuilding(int x, int y, int width, int height) const;
     void occupyCell(int x, int y, int width, int height, cocos2d::Node* building);
     void freeCell(int x, int y, int width, int height);
+    // 批量占用：逐格写入后只标脏一次，覆盖层按整体包围盒上传一次
+    void occupyCells(const std::vector<GridFootprint>& footprints);
     cocos2d::Vec2 gridToWorld(int x, int y);
     cocos2d::Vec2 worldToGrid(cocos2d::Vec2 pos);
 
+    // Cell queries
+    CellType getCellType(int x, int y) const;
+    bool isCellBlocked(int x, int y) const;
+    int countBlockedCells(int x, int y, int width, int height) const;
+
+    // 格子 -> 占用建筑（空格、禁放格或越界返回 nullptr；不持有引用，调用方自行确认仍在场景中）
+    cocos2d::Node* getBuildingAt(int x, int y) const;
+
+    /**
+     * @brief 收集 (x, y) 附近格子上的建筑，用于拾取（去重，所在格的建筑排在最前）
+     *
+     * 建筑精灵通常高出占地，光标落在精灵上半部时所在格可能是空的，
+     * 因此再向下看 below 行、左右各 side 列；查询范围固定，与地图大小和建筑数量无关。
+     */
+    void collectBuildingsAround(int x, int y, int side, int below, std::vector<cocos2d::Node*>& out) const;
+
+    /**
+     * @brief 查找左下角距离(x, y)最近（欧氏距离）的可放置位置（按环形由近及远搜索）
+     * @param outX/outY 找到时输出左下角格子坐标
+     * @return 是否找到可放置位置
+     */
+    bool findNearestFreeSpot(int x, int y, int width, int height, int* outX, int* outY) const;
+
     // Debug rendering
     void showGrid(bool show);
 
+    /**
+     * @brief 显示/隐藏格子状态覆盖层（每格一个纹素，单个精灵绘制）
+     *
+     * 首次显示时整图上传一次纹理，之后仅在 occupyCell/freeCell 时
+     * 上传发生变化的子区域。
+     */
+    void showCellOverlay(bool show);
+    void setCellOverlayColors(const cocos2d::Color4F& empty,
+                              const cocos2d::Color4F& occupied,
+                              const cocos2d::Color4F& forbidden);
+
+    // 阻挡位图（只读）；initBlockedBits 生成同尺寸空地图的初始位图（仅边界禁放）
+    const GridBitset& getBlockedBits() const { return _blockedBits; }
+    static void initBlockedBits(int width, int height, GridBitset& out);
+    static bool isBorderCell(int x, int y, int width, int height);
+
     int getGridWidth() const { return _gridWidth; }
     int getGridHeight() const { return _gridHeight; }
     float getCellSize() const { return _cellSize; }
@@ -36,12 +88,36 @@ private:
     int _gridWidth;
     int _gridHeight;
     float _cellSize;
-    std::vector<std::vector<CellType>> _cells;
-    std::vector<std::vector<cocos2d::Node*>> _buildings;
-    cocos2d::DrawNode* _gridLines;
+
+    // 行优先连续存储：index = y * _gridWidth + x
+    std::vector<CellType> _cells;
+    std::vector<cocos2d::Node*> _buildings;
+
+    // 阻挡位图：置位表示该格不可放置
+    GridBitset _blockedBits;
+
+    // 阻挡格前缀和（(W+1)x(H+1)），写操作后惰性重建，供区域计数与空位搜索使用
+    mutable std::vector<int> _blockedSums;
+    mutable bool _blockedSumsDirty = true;
+
+    cocos2d::Sprite* _gridLines = nullptr;
+
+    // 格子状态覆盖层：RGBA纹素按调色板写入，纹理第0行对应地图最上方一行
+    cocos2d::Sprite* _cellOverlay = nullptr;
+    cocos2d::Texture2D* _cellTexture = nullptr;
+    std::vector<uint32_t> _overlayTexels;
+    std::vector<uint32_t> _overlayUploadBuffer;
+    uint32_t _overlayPalette[3] = { 0, 0, 0 };
 
     void initCells();
     void drawGridLines();
+    void createCellOverlay();
+    void refreshCellOverlay(int x, int y, int width, int height);
+
+    int cellIndex(int x, int y) const { return y * _gridWidth + x; }
+    void setCell(int x, int y, CellType type, cocos2d::Node* building);
+    void rebuildBlockedSums() const;
+    int sumBlocked(int x, int y, int width, int height) const;
 };
 
 #endif // __GRID_MAP_H__
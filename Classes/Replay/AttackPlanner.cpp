@@ -0,0 +1,703 @@
+#include "Replay/AttackPlanner.h"
+#include "Soldier/UnitManager.h"
+#include "Buildings/DefenceBuilding.h"
+#include "Buildings/ProductionBuilding.h"
+#include "Buildings/StorageBuilding.h"
+#include "Buildings/Trap.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace cocos2d;
+
+namespace {
+constexpr int kTicksPerSecond = 60;             // 与战斗模拟时钟一致
+constexpr float kTickDt = 1.0f / kTicksPerSecond;
+constexpr int kDeployGapTicks = 3;              // 同一部署点相邻两次部署的间隔
+const Fixed kUnitHalfSize = Fixed::fromInt(8);  // 士兵近似包围盒半边长（没有主体精灵可量）
+constexpr int kSimsPerWorker = 8;               // 自动批大小：每个线程分到的模拟数
+constexpr int kMinBatch = 16;
+constexpr int kSimGrain = 2;                    // 并行分块大小（单次模拟已足够重）
+constexpr float kExploreRatio = 0.3f;           // 找到可行方案后仍保留的纯随机采样比例
+constexpr int kMutateCellRadius = 2;            // 变异时部署点的最大偏移（格）
+constexpr int kMutateTickRange = 60;            // 变异时部署时间的最大偏移（逻辑帧）
+
+struct DeployGroup {
+    int gridX = 0;
+    int gridY = 0;
+    int tick = 0;
+};
+
+// 采样空间中的一个点：若干部署点 + 每个待部署士兵所属的部署点
+struct Candidate {
+    std::vector<DeployGroup> groups;
+    std::vector<int> assignment;
+};
+
+struct RankedPlan {
+    Candidate candidate;
+    AttackPlan plan;
+};
+
+int randomInt(std::mt19937& rng, int lo, int hi) {
+    if (hi <= lo) {
+        return lo;
+    }
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+// 按兵种展开成待部署槽位（值为 input.units 的下标）
+std::vector<int> expandSlots(const AttackPlannerInput& input) {
+    std::vector<int> slots;
+    for (size_t i = 0; i < input.units.size(); ++i) {
+        auto it = input.counts.find(input.units[i].unitId);
+        int count = it != input.counts.end() ? it->second : 0;
+        for (int n = 0; n < count; ++n) {
+            slots.push_back(static_cast<int>(i));
+        }
+    }
+    return slots;
+}
+
+DeployGroup randomGroup(std::mt19937& rng, const AttackPlannerInput& input, int maxTick) {
+    DeployGroup group;
+    group.gridX = randomInt(rng, input.minGridX, input.maxGridX);
+    group.gridY = randomInt(rng, input.minGridY, input.maxGridY);
+    group.tick = randomInt(rng, 0, maxTick);
+    return group;
+}
+
+Candidate randomCandidate(std::mt19937& rng, const AttackPlannerInput& input,
+                          const AttackPlannerSettings& settings, size_t slotCount, int maxTick) {
+    Candidate candidate;
+    int groups = randomInt(rng, 1, std::max(1, settings.maxGroups));
+    for (int g = 0; g < groups; ++g) {
+        candidate.groups.push_back(randomGroup(rng, input, maxTick));
+    }
+    candidate.assignment.resize(slotCount);
+    for (auto& group : candidate.assignment) {
+        group = randomInt(rng, 0, groups - 1);
+    }
+    return candidate;
+}
+
+Candidate mutateCandidate(const Candidate& base, std::mt19937& rng,
+                          const AttackPlannerInput& input, int maxTick) {
+    Candidate candidate = base;
+    int ops = randomInt(rng, 1, 2);
+    for (int op = 0; op < ops; ++op) {
+        int groupCount = static_cast<int>(candidate.groups.size());
+        DeployGroup& group = candidate.groups[randomInt(rng, 0, groupCount - 1)];
+        switch (randomInt(rng, 0, 2)) {
+        case 0:
+            group.gridX = std::min(input.maxGridX, std::max(input.minGridX,
+                group.gridX + randomInt(rng, -kMutateCellRadius, kMutateCellRadius)));
+            group.gridY = std::min(input.maxGridY, std::max(input.minGridY,
+                group.gridY + randomInt(rng, -kMutateCellRadius, kMutateCellRadius)));
+            break;
+        case 1:
+            group.tick = std::min(maxTick, std::max(0,
+                group.tick + randomInt(rng, -kMutateTickRange, kMutateTickRange)));
+            break;
+        default:
+            if (!candidate.assignment.empty()) {
+                int slot = randomInt(rng, 0, static_cast<int>(candidate.assignment.size()) - 1);
+                candidate.assignment[slot] = randomInt(rng, 0, groupCount - 1);
+            }
+            break;
+        }
+    }
+    return candidate;
+}
+
+std::vector<ReplayDeployEvent> buildEvents(const Candidate& candidate, const std::vector<int>& slots,
+                                           const AttackPlannerInput& input) {
+    std::vector<ReplayDeployEvent> events;
+    events.reserve(slots.size());
+    std::vector<int> issued(candidate.groups.size(), 0);
+    for (size_t s = 0; s < slots.size(); ++s) {
+        int groupIndex = candidate.assignment[s];
+        const DeployGroup& group = candidate.groups[groupIndex];
+        const PlannerUnit& unit = input.units[slots[s]];
+        ReplayDeployEvent event;
+        event.tick = group.tick + issued[groupIndex]++ * kDeployGapTicks;
+        event.time = static_cast<float>(event.tick) / kTicksPerSecond;
+        event.unitId = unit.unitId;
+        event.level = unit.level;
+        event.gridX = group.gridX;
+        event.gridY = group.gridY;
+        events.push_back(event);
+    }
+    std::stable_sort(events.begin(), events.end(),
+        [](const ReplayDeployEvent& a, const ReplayDeployEvent& b) { return a.tick < b.tick; });
+    return events;
+}
+
+bool sameEvents(const std::vector<ReplayDeployEvent>& a, const std::vector<ReplayDeployEvent>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].tick != b[i].tick || a[i].unitId != b[i].unitId
+            || a[i].gridX != b[i].gridX || a[i].gridY != b[i].gridY) {
+            return false;
+        }
+    }
+    return true;
+}
+
+FixedRect unitFootprint(const FixedVec2& position) {
+    return { position.x - kUnitHalfSize, position.y - kUnitHalfSize,
+             position.x + kUnitHalfSize, position.y + kUnitHalfSize };
+}
+
+Fixed unitDistance(const AttackSimUnit& unit, const PlannerBuilding& building) {
+    return TargetSelection::measureDistance(unit.position, unitFootprint(unit.position),
+        building.target.position, building.target.footprint, unit.stats->remote);
+}
+
+const PlannerUnit* findUnit(const AttackPlannerInput& input, int unitId) {
+    for (const auto& unit : input.units) {
+        if (unit.unitId == unitId) {
+            return &unit;
+        }
+    }
+    return nullptr;
+}
+
+// 插入到按得分降序的榜单中，去掉完全相同的方案
+void offerPlan(std::vector<RankedPlan>& best, const Candidate& candidate, AttackPlan&& plan, int keep) {
+    for (const auto& entry : best) {
+        if (sameEvents(entry.plan.events, plan.events)) {
+            return;
+        }
+    }
+    if (static_cast<int>(best.size()) >= keep && plan.score <= best.back().plan.score) {
+        return;
+    }
+    RankedPlan ranked;
+    ranked.candidate = candidate;
+    ranked.plan = std::move(plan);
+    auto pos = std::upper_bound(best.begin(), best.end(), ranked.plan.score,
+        [](float score, const RankedPlan& entry) { return score > entry.plan.score; });
+    best.insert(pos, std::move(ranked));
+    if (static_cast<int>(best.size()) > keep) {
+        best.pop_back();
+    }
+}
+} // namespace
+
+// ===================================================
+// 快进模拟
+// ===================================================
+
+AttackSimulator& AttackSimulator::forThisThread() {
+    // 每个工作线程一个实例，缓冲随线程复用
+    static thread_local AttackSimulator simulator;
+    return simulator;
+}
+
+AttackPlan AttackSimulator::run(const AttackPlannerInput& input, std::vector<ReplayDeployEvent> events) {
+    AttackPlan result;
+    result.events = std::move(events);
+
+    const size_t buildingCount = input.buildings.size();
+    std::vector<Fixed>& hp = _hp;
+    hp.resize(buildingCount);
+    _damage.assign(buildingCount, 0.0f);
+    _towers.assign(buildingCount, AttackSimTower());
+    _trapTicks.assign(input.traps.size(), 0);
+    _projectiles.clear();
+    _hits.clear();
+    float totalHp = 0.0f;
+    int alive = 0;
+    for (size_t i = 0; i < buildingCount; ++i) {
+        hp[i] = input.buildings[i].hp;
+        totalHp += hp[i].toFloat();
+        if (hp[i] > Fixed()) {
+            alive++;
+        }
+    }
+
+    std::vector<AttackSimUnit>& units = _units;
+    units.clear();
+    _crowd.setup(input.mapBounds, CombatRules::kCrowdSeparationRadius);
+    const int tickLimit = static_cast<int>(input.timeLimit * kTicksPerSecond);
+    size_t nextEvent = 0;
+    bool baseDown = false;
+    int tick = 0;
+
+    auto damageBuilding = [&](int index, Fixed damage, const FixedVec2& from) {
+        if (hp[index] <= Fixed()) {
+            return;
+        }
+        Fixed before = hp[index];
+        bool destroyed = CombatRules::applyDamage(hp[index], damage);
+        float dealt = (before - hp[index]).toFloat();
+        _damage[index] += dealt;
+        if (_recordHits) {
+            AttackHit hit;
+            hit.position = from.toVec2();
+            hit.building = index;
+            hit.damage = dealt;
+            _hits.push_back(hit);
+        }
+        if (destroyed) {
+            alive--;
+            result.destroyed++;
+            baseDown = baseDown || input.buildings[index].isBase;
+        }
+    };
+    auto damageUnit = [&](AttackSimUnit& unit, Fixed damage) {
+        if (CombatRules::applyDamage(unit.hp, damage)) {
+            result.dead++;
+        }
+    };
+    auto canHit = [](const PlannerBuilding& tower, const AttackSimUnit& unit) {
+        return unit.hp > Fixed() && CombatRules::canHit(unit.stats->flying, tower.skyAble, tower.groundAble);
+    };
+    auto splash = [&](const PlannerBuilding& tower, const FixedVec2& center, Fixed damage) {
+        for (auto& unit : units) {
+            if (canHit(tower, unit) && CombatRules::inRadius(center, unit.position, tower.splashRadius)) {
+                damageUnit(unit, damage);
+            }
+        }
+    };
+
+    while (tick < tickLimit) {
+        tick++;
+
+        // 1. 部署：录制中第 tick 帧之后部署的士兵从下一帧开始行动
+        while (nextEvent < result.events.size() && result.events[nextEvent].tick < tick) {
+            const auto& event = result.events[nextEvent++];
+            const PlannerUnit* stats = findUnit(input, event.unitId);
+            if (!stats) {
+                continue;
+            }
+            AttackSimUnit unit;
+            unit.stats = stats;
+            unit.hp = stats->hp;
+            // 与 GridMap::gridToWorld 相同的出生点，再量化为定点
+            unit.position = FixedVec2::fromVec2(Vec2((event.gridX + 0.5f) * input.cellSize,
+                                                     (event.gridY + 0.5f) * input.cellSize));
+            units.push_back(unit);
+            result.deployed++;
+        }
+
+        // 2. 存活士兵互相推开
+        _positions.clear();
+        _flying.clear();
+        _separated.clear();
+        for (size_t u = 0; u < units.size(); ++u) {
+            if (units[u].hp > Fixed()) {
+                _separated.push_back(static_cast<int>(u));
+                _positions.push_back(units[u].position);
+                _flying.push_back(units[u].stats->flying ? 1 : 0);
+            }
+        }
+        _crowd.separate(_positions, _flying, kTickDt);
+        for (size_t k = 0; k < _separated.size(); ++k) {
+            units[_separated[k]].position = _positions[k];
+        }
+
+        // 3. 批量寻敌：只处理寻敌计时到期的士兵与失去目标的防御塔
+        _buildingTargets.clear();
+        _buildingIndex.clear();
+        for (size_t i = 0; i < buildingCount; ++i) {
+            if (hp[i] > Fixed()) {
+                _buildingTargets.push_back(input.buildings[i].target);
+                _buildingTargets.back().key = i + 1;
+                _buildingIndex.push_back(static_cast<int>(i));
+            }
+        }
+        for (auto& unit : units) {
+            if (unit.hp <= Fixed() || unit.retargetTimer > 0.0f) {
+                continue;
+            }
+            SoldierTargetQuery query;
+            query.position = unit.position;
+            query.footprint = unitFootprint(unit.position);
+            query.range = unit.stats->range;
+            query.keepRange = CombatRules::attackReach(query.range);
+            query.remote = unit.stats->remote;
+            query.wantDefense = unit.stats->wantDefense;
+            query.wantResource = unit.stats->wantResource;
+            query.hasCurrent = unit.target >= 0 && hp[unit.target] > Fixed();
+            if (query.hasCurrent) {
+                query.current = input.buildings[unit.target].target;
+                query.current.key = unit.target + 1;
+            }
+            TargetDecision decision = TargetSelection::selectBuilding(query,
+                _buildingTargets.data(), _buildingTargets.size());
+            if (decision.change && decision.index >= 0) {
+                unit.target = _buildingIndex[decision.index];
+            }
+            unit.retargetTimer = CombatRules::kTargetRefreshInterval;
+        }
+
+        _soldierTargets.resize(units.size());
+        for (size_t u = 0; u < units.size(); ++u) {
+            SoldierTarget& target = _soldierTargets[u];
+            target.alive = units[u].hp > Fixed();
+            target.flying = units[u].stats->flying;
+            target.position = target.alive ? units[u].position : FixedVec2();
+        }
+        for (size_t i = 0; i < buildingCount; ++i) {
+            const PlannerBuilding& tower = input.buildings[i];
+            AttackSimTower& state = _towers[i];
+            if (!tower.target.isDefense || tower.hitsAllInRange || hp[i] <= Fixed()) {
+                continue;
+            }
+            if (state.target >= 0 && canHit(tower, units[state.target])) {
+                continue;
+            }
+            TowerTargetQuery query;
+            query.position = tower.target.position;
+            query.range = tower.range;
+            query.skyAble = tower.skyAble;
+            query.groundAble = tower.groundAble;
+            state.target = TargetSelection::selectSoldier(query, _soldierTargets.data(), _soldierTargets.size());
+        }
+
+        // 4. 防御塔
+        for (size_t i = 0; i < buildingCount; ++i) {
+            const PlannerBuilding& tower = input.buildings[i];
+            if (!tower.target.isDefense || hp[i] <= Fixed()) {
+                continue;
+            }
+            AttackSimTower& state = _towers[i];
+            if (state.cooldown > 0.0f) {
+                state.cooldown -= kTickDt;
+            }
+
+            if (tower.hitsAllInRange) {
+                // 火焰塔：射程内全部目标按伤害间隔持续受伤
+                _fireTargets.clear();
+                for (size_t u = 0; u < units.size(); ++u) {
+                    if (canHit(tower, units[u])
+                        && CombatRules::inRadius(tower.target.position, units[u].position, tower.range)) {
+                        _fireTargets.push_back(static_cast<int>(u));
+                    }
+                }
+                if (_fireTargets.empty()) {
+                    state.fireTimer = 0.0f;
+                    continue;
+                }
+                state.fireTimer += kTickDt;
+                while (state.fireTimer >= tower.attackInterval) {
+                    state.fireTimer -= tower.attackInterval;
+                    for (int u : _fireTargets) {
+                        if (canHit(tower, units[u])) {
+                            damageUnit(units[u], tower.atk);
+                        }
+                    }
+                }
+                continue;
+            }
+
+            if (state.target >= 0 && !canHit(tower, units[state.target])) {
+                state.target = -1;
+            }
+            if (state.target < 0) {
+                continue;
+            }
+            AttackSimUnit& victim = units[state.target];
+            if (FixedMath::distance(tower.target.position, victim.position) > tower.range) {
+                state.target = -1;
+                continue;
+            }
+            if (state.cooldown > 0.0f) {
+                continue;
+            }
+            state.cooldown = tower.attackInterval;
+            if (tower.bulletSpeed > Fixed()) {
+                AttackSimProjectile projectile;
+                projectile.position = tower.target.position;
+                projectile.target = state.target;
+                projectile.tower = static_cast<int>(i);
+                projectile.damage = tower.atk;
+                _projectiles.push_back(projectile);
+            }
+            else if (tower.splashRadius > Fixed()) {
+                splash(tower, victim.position, tower.atk);
+            }
+            else {
+                damageUnit(victim, tower.atk);
+            }
+        }
+
+        // 陷阱
+        for (size_t t = 0; t < input.traps.size(); ++t) {
+            const PlannerTrap& trap = input.traps[t];
+            int& ticks = _trapTicks[t];
+            if (ticks < 0) {
+                continue;
+            }
+            if (trap.kind == TrapKind::SPIKE) {
+                if (++ticks < CombatRules::kSpikeDamageIntervalTicks) {
+                    continue;
+                }
+                ticks = 0;
+                for (auto& unit : units) {
+                    if (unit.hp > Fixed() && CombatRules::trapCatches(trap.kind, trap.area, unit.position)) {
+                        damageUnit(unit, CombatRules::kSpikeDamage);
+                    }
+                }
+                continue;
+            }
+            for (auto& unit : units) {
+                if (unit.hp > Fixed() && CombatRules::trapCatches(trap.kind, trap.area, unit.position)) {
+                    damageUnit(unit, CombatRules::lethalDamage(unit.hp));
+                    ticks = -1;
+                }
+            }
+        }
+
+        // 5. 士兵：攻击范围内出手，否则向目标推进
+        int aliveUnits = 0;
+        for (auto& unit : units) {
+            if (unit.hp <= Fixed()) {
+                continue;
+            }
+            aliveUnits++;
+            unit.attackTimer += kTickDt;
+            if (unit.target >= 0 && hp[unit.target] <= Fixed()) {
+                // 目标被摧毁：下一步立即重新寻敌
+                unit.target = -1;
+                unit.retargetTimer = 0.0f;
+            }
+            unit.retargetTimer -= kTickDt;
+            if (unit.target < 0) {
+                continue;
+            }
+
+            const PlannerBuilding& target = input.buildings[unit.target];
+            Fixed dist = unitDistance(unit, target);
+            Fixed reach = CombatRules::attackReach(unit.stats->range);
+            if (dist <= reach) {
+                if (unit.attackTimer >= unit.stats->attackInterval) {
+                    unit.attackTimer = 0.0f;
+                    damageBuilding(unit.target, unit.stats->atk, unit.position);
+                }
+                continue;
+            }
+            CombatRules::MoveStep step = CombatRules::stepToward(unit.position, target.target.position,
+                dist, reach, unit.stats->speed, kTickDt);
+            if (step.moved) {
+                unit.position = step.position;
+            }
+        }
+
+        // 6. 子弹：目标死亡后仍飞向其最后位置，落地时按规则结算
+        size_t flying = 0;
+        for (size_t p = 0; p < _projectiles.size(); ++p) {
+            AttackSimProjectile projectile = _projectiles[p];
+            const PlannerBuilding& tower = input.buildings[projectile.tower];
+            AttackSimUnit& victim = units[projectile.target];
+            if (!CombatRules::advanceProjectile(projectile.position, victim.position, tower.bulletSpeed, kTickDt)) {
+                _projectiles[flying++] = projectile;
+                continue;
+            }
+            if (tower.splashRadius > Fixed()) {
+                splash(tower, projectile.position, projectile.damage);
+            }
+            else if (canHit(tower, victim)) {
+                damageUnit(victim, projectile.damage);
+            }
+        }
+        _projectiles.resize(flying);
+
+        if (baseDown || alive <= 0) {
+            result.win = true;
+            break;
+        }
+        if (aliveUnits == 0 && nextEvent >= result.events.size()) {
+            break;
+        }
+    }
+
+    result.duration = static_cast<float>(std::min(tick, tickLimit)) / kTicksPerSecond;
+    if (result.win) {
+        // 与战斗结算一致：按阵亡比例评星
+        float deadRatio = result.deployed > 0
+            ? static_cast<float>(result.dead) / static_cast<float>(result.deployed)
+            : 0.0f;
+        result.stars = deadRatio <= 0.34f ? 3 : (deadRatio <= 0.67f ? 2 : 1);
+    }
+
+    // 评分：摧毁血量占比为主；胜利后再比较存活率（决定星级）与用时
+    float remainingHp = 0.0f;
+    for (Fixed value : hp) {
+        remainingHp += std::max(0.0f, value.toFloat());
+    }
+    float damageRatio = totalHp > 0.0f ? 1.0f - remainingHp / totalHp : 0.0f;
+    result.score = damageRatio * 1000.0f;
+    if (result.win) {
+        float survival = result.deployed > 0
+            ? 1.0f - static_cast<float>(result.dead) / static_cast<float>(result.deployed)
+            : 0.0f;
+        result.score += 2000.0f + survival * 500.0f + (input.timeLimit - result.duration) * 2.0f;
+    }
+    return result;
+}
+
+// ===================================================
+// 规划数据
+// ===================================================
+
+bool AttackPlanner::describeBuilding(Node* building, PlannerBuilding& out) {
+    out = PlannerBuilding();
+    if (!TargetSelection::describeBuilding(building, out.target)) {
+        return false;
+    }
+
+    if (auto* defence = dynamic_cast<DefenceBuilding*>(building)) {
+        describeDefence(defence->getConfig(), defence->getLevel(), out);
+        out.hp = defence->getHP();
+    }
+    else if (auto* production = dynamic_cast<ProductionBuilding*>(building)) {
+        out.hp = production->getHP();
+    }
+    else if (auto* storage = dynamic_cast<StorageBuilding*>(building)) {
+        out.hp = storage->getHP();
+    }
+    return out.hp > Fixed();
+}
+
+void AttackPlanner::describeDefence(const DefenceBuildingConfig* config, int level, PlannerBuilding& out) {
+    out.target.isDefense = true;
+    out.atk = CombatRules::towerATK(config, level);
+    out.range = CombatRules::towerRange(config, level);
+    out.attackInterval = CombatRules::towerAttackInterval(config, level);
+    out.splashRadius = CombatRules::splashRadius(config);
+    out.bulletSpeed = CombatRules::firesProjectile(config) ? config->simBulletSpeed : Fixed();
+    out.hitsAllInRange = CombatRules::isFireTower(config);
+    out.skyAble = config && config->SKY_ABLE;
+    out.groundAble = config && config->GROUND_ABLE;
+}
+
+bool AttackPlanner::describeTrap(Node* node, PlannerTrap& out) {
+    auto* trap = dynamic_cast<TrapBase*>(node);
+    if (!trap || !trap->getParent() || !trap->isArmed()) {
+        return false;
+    }
+    out.kind = trap->getKind();
+    out.area = trap->getTriggerArea();
+    return !out.area.isEmpty();
+}
+
+bool AttackPlanner::describeUnit(int unitId, int level, PlannerUnit& out) {
+    const UnitConfig* config = UnitManager::getInstance()->getConfig(unitId);
+    if (!config) {
+        return false;
+    }
+
+    out = PlannerUnit();
+    out.unitId = unitId;
+    out.level = level;
+    out.hp = CombatRules::unitMaxHP(config, level);
+    out.atk = CombatRules::unitATK(config, level);
+    out.range = CombatRules::unitRange(config, level);
+    out.speed = CombatRules::unitSpeed(config, level);
+    out.attackInterval = CombatRules::unitAttackInterval(config);
+    out.remote = config->ISREMOTE;
+    out.flying = config->ISFLY;
+    out.wantDefense = config->aiType == TargetPriority::DEFENSE;
+    out.wantResource = config->aiType == TargetPriority::RESOURCE;
+    return true;
+}
+
+// ===================================================
+// 规划
+// ===================================================
+
+AttackPlannerResult AttackPlanner::plan(const AttackPlannerInput& input, const AttackPlannerSettings& settings) {
+    AttackPlannerResult result;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start]() {
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+
+    const std::vector<int> slots = expandSlots(input);
+    if (slots.empty() || input.buildings.empty()) {
+        return result;
+    }
+
+    auto* jobs = JobSystem::getInstance();
+    const int batch = settings.batchSize > 0
+        ? settings.batchSize
+        : std::max(kMinBatch, (jobs->getWorkerCount() + 1) * kSimsPerWorker);
+    const int keep = std::max(1, settings.keepPlans);
+    const int maxTick = static_cast<int>(settings.deployWindow * kTicksPerSecond);
+    const int exploreCount = static_cast<int>(batch * kExploreRatio);
+
+    std::mt19937 rng(settings.seed);
+    std::vector<RankedPlan> best;
+    std::vector<Candidate> candidates(batch);
+    std::vector<AttackPlan> outcomes(batch);
+
+    do {
+        // 采样在本线程串行完成（结果只取决于种子），模拟并行执行
+        for (int i = 0; i < batch; ++i) {
+            if (best.empty() || i < exploreCount) {
+                candidates[i] = randomCandidate(rng, input, settings, slots.size(), maxTick);
+            }
+            else {
+                candidates[i] = mutateCandidate(best[i % best.size()].candidate, rng, input, maxTick);
+            }
+        }
+
+        jobs->parallelFor(batch, kSimGrain, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                auto& simulator = AttackSimulator::forThisThread();
+                simulator.setRecordHits(false);
+                outcomes[i] = simulator.run(input, buildEvents(candidates[i], slots, input));
+            }
+        });
+
+        for (int i = 0; i < batch; ++i) {
+            offerPlan(best, candidates[i], std::move(outcomes[i]), keep);
+        }
+        result.rounds++;
+        result.simulations += batch;
+    } while (elapsedMs() < static_cast<float>(settings.budgetMs));
+
+    for (auto& entry : best) {
+        result.plans.push_back(std::move(entry.plan));
+    }
+    result.elapsedMs = elapsedMs();
+    CCLOG("[自动部署] %d 轮 %d 次模拟，用时 %.0fms，最优: %s",
+        result.rounds, result.simulations, result.elapsedMs,
+        result.plans.empty() ? "无" : describePlan(result.plans.front()).c_str());
+    return result;
+}
+
+void AttackPlanner::planAsync(const AttackPlannerInput& input, const AttackPlannerSettings& settings,
+                              const std::function<void(const AttackPlannerResult&)>& onDone) {
+    JobFuture<AttackPlannerResult>::run("attackPlanner", [input, settings]() {
+        return plan(input, settings);
+    }).then(onDone);
+}
+
+std::vector<std::vector<ReplayDeployEvent>> AttackPlanner::sampleArmies(const AttackPlannerInput& input,
+                                                                        const AttackPlannerSettings& settings,
+                                                                        int count) {
+    std::vector<std::vector<ReplayDeployEvent>> armies;
+    const std::vector<int> slots = expandSlots(input);
+    if (slots.empty()) {
+        return armies;
+    }
+    const int maxTick = static_cast<int>(settings.deployWindow * kTicksPerSecond);
+    std::mt19937 rng(settings.seed);
+    for (int i = 0; i < count; ++i) {
+        armies.push_back(buildEvents(randomCandidate(rng, input, settings, slots.size(), maxTick), slots, input));
+    }
+    return armies;
+}
+
+std::string AttackPlanner::describePlan(const AttackPlan& plan) {
+    return StringUtils::format("%s, destroyed %d, lost %d/%d, %.1fs (score %.0f)",
+        plan.win ? "Win" : "Fail", plan.destroyed, plan.dead, plan.deployed, plan.duration, plan.score);
+}
@@ -0,0 +1,202 @@
+#ifndef __ATTACK_PLANNER_H__
+#define __ATTACK_PLANNER_H__
+
+#include "cocos2d.h"
+#include "Core/CombatRules.h"
+#include "Replay/ReplayManager.h"
+#include "Soldier/CrowdSeparation.h"
+#include "Soldier/TargetingSystem.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// ===================================================
+// 规划输入（纯数据，可在工作线程读取）
+// 数值与实时战斗相同，均为定点（由 CombatRules 按配置与等级换算）
+// ===================================================
+
+// 敌方建筑
+struct PlannerBuilding {
+    BuildingTarget target;          // 战斗空间位置、包围盒与类型（与士兵寻敌共用）
+    Fixed hp;                       // 当前血量
+    bool isBase = false;            // 摧毁即胜利
+    // 以下只对防御建筑有效
+    Fixed atk;
+    Fixed range;
+    float attackInterval = 0.5f;    // 开火间隔（火焰塔为伤害间隔）
+    Fixed splashRadius;             // >0 时按落点范围伤害
+    Fixed bulletSpeed;              // 0 表示伤害立即结算
+    bool hitsAllInRange = false;    // 火焰塔：射程内全部受伤
+    bool skyAble = false;
+    bool groundAble = false;
+};
+
+// 陷阱
+struct PlannerTrap {
+    TrapKind kind = TrapKind::SPIKE;
+    FixedRect area;                 // 触发区域（战斗空间）
+};
+
+// 可部署兵种
+struct PlannerUnit {
+    int unitId = 0;
+    int level = 0;
+    Fixed hp;
+    Fixed atk;
+    Fixed speed;
+    Fixed range;
+    float attackInterval = 0.4f;
+    bool remote = false;
+    bool flying = false;
+    bool wantDefense = false;
+    bool wantResource = false;
+};
+
+struct AttackPlannerInput {
+    std::vector<PlannerBuilding> buildings;
+    std::vector<PlannerTrap> traps;             // 未触发的陷阱
+    std::vector<PlannerUnit> units;             // 兵种属性
+    std::map<int, int> counts;                  // 兵种ID -> 可部署数量
+    int minGridX = 0;                           // 部署范围（格子，闭区间）
+    int maxGridX = 0;
+    int minGridY = 0;
+    int maxGridY = 0;
+    float cellSize = 32.0f;
+    cocos2d::Rect mapBounds;                    // 战斗地图范围（士兵分离的活动范围）
+    float timeLimit = 160.0f;                   // 剩余战斗时间（秒）
+};
+
+struct AttackPlannerSettings {
+    int budgetMs = 1500;            // 墙钟预算（到时停止采样，已开始的一轮会跑完）
+    int batchSize = 0;              // 每轮模拟数，0 表示按工作线程数自动选择
+    int keepPlans = 3;              // 返回的最优方案数
+    int maxGroups = 4;              // 单个方案最多的部署点数
+    float deployWindow = 8.0f;      // 部署时间采样范围（秒）
+    uint32_t seed = 1;
+};
+
+// 一个部署方案及其模拟结果
+struct AttackPlan {
+    std::vector<ReplayDeployEvent> events;      // tick 从 0 起算（相对规划开始）
+    float score = 0.0f;
+    bool win = false;
+    int destroyed = 0;                          // 摧毁建筑数
+    int deployed = 0;
+    int dead = 0;
+    int stars = 0;                              // 按战斗结算规则估算的星数（失败为 0）
+    float duration = 0.0f;                      // 结束时间（秒）
+};
+
+// 士兵命中建筑的一次记录（用于弱点热力图）
+struct AttackHit {
+    cocos2d::Vec2 position;                     // 出手士兵所在位置（战斗空间）
+    int building = -1;                          // input.buildings 下标
+    float damage = 0.0f;
+};
+
+// 快进模拟中的士兵
+struct AttackSimUnit {
+    const PlannerUnit* stats = nullptr;
+    FixedVec2 position;
+    Fixed hp;
+    int target = -1;                            // input.buildings 下标
+    float attackTimer = 0.0f;
+    float retargetTimer = 0.0f;
+};
+
+// 快进模拟中的防御塔状态
+struct AttackSimTower {
+    int target = -1;                            // 士兵下标
+    float cooldown = 0.0f;
+    float fireTimer = 0.0f;                     // 火焰塔伤害计时
+};
+
+// 快进模拟中飞行的子弹
+struct AttackSimProjectile {
+    FixedVec2 position;
+    int target = -1;                            // 士兵下标（死亡后仍飞向其最后位置）
+    int tower = -1;                             // 发射的防御塔
+    Fixed damage;
+};
+
+/**
+ * 快进攻击模拟器（无节点）
+ * 按战斗场景的模拟步（60Hz）推进，每步的阶段顺序与 BattleScene::stepSimulation 一致：
+ * 部署 → 士兵分离 → 批量寻敌 → 防御塔与陷阱 → 士兵 → 子弹。
+ * 寻敌（TargetSelection）、分离（CrowdSeparation::separate）、移动、伤害、子弹与陷阱判定
+ * 调用实时战斗的同一份实现（见 CombatRules），不另写一套规则。
+ * 与实时战斗的差别只在没有节点的部分：士兵包围盒用固定尺寸近似，死亡即离场（不等死亡动画）。
+ * 内部缓冲在多次模拟之间复用，避免每次模拟重新分配；
+ * 实例不可跨线程共享，并行时每个线程使用 forThisThread()。
+ */
+class AttackSimulator {
+public:
+    static AttackSimulator& forThisThread();
+
+    // 是否记录每次命中（热力图用，规划时关闭）
+    void setRecordHits(bool record) { _recordHits = record; }
+
+    AttackPlan run(const AttackPlannerInput& input, std::vector<ReplayDeployEvent> events);
+
+    // 上一次 run() 各建筑受到的伤害（按 input.buildings 顺序，不超过其血量）
+    const std::vector<float>& getBuildingDamage() const { return _damage; }
+    const std::vector<AttackHit>& getHits() const { return _hits; }
+
+private:
+    std::vector<Fixed> _hp;
+    std::vector<float> _damage;
+    std::vector<AttackSimUnit> _units;
+    std::vector<AttackSimTower> _towers;
+    std::vector<AttackSimProjectile> _projectiles;
+    std::vector<int> _trapTicks;                // 每个陷阱距上次伤害的步数，-1 表示已触发
+    std::vector<AttackHit> _hits;
+    // 寻敌与分离的快照缓冲
+    std::vector<BuildingTarget> _buildingTargets;
+    std::vector<int> _buildingIndex;
+    std::vector<SoldierTarget> _soldierTargets;
+    std::vector<FixedVec2> _positions;
+    std::vector<unsigned char> _flying;
+    std::vector<int> _separated;
+    std::vector<int> _fireTargets;
+    CrowdSeparation _crowd;
+    bool _recordHits = false;
+};
+
+struct AttackPlannerResult {
+    std::vector<AttackPlan> plans;              // 按得分从高到低
+    int simulations = 0;
+    int rounds = 0;
+    float elapsedMs = 0.0f;
+};
+
+/**
+ * 自动部署规划器（蒙特卡洛）
+ * 在部署范围内随机采样方案（部署点、时间、兵种分配），对每个方案用
+ * AttackSimulator 做一次快进模拟，之后的轮次在当前最优方案附近变异。
+ * 每轮的模拟在任务系统上并行执行，直到墙钟预算耗尽。相同的输入与种子、相同的轮数得到相同的方案。
+ */
+namespace AttackPlanner {
+// 生成规划数据；只能在主线程调用
+bool describeBuilding(cocos2d::Node* building, PlannerBuilding& out);
+bool describeTrap(cocos2d::Node* trap, PlannerTrap& out);
+bool describeUnit(int unitId, int level, PlannerUnit& out);
+// 按配置填写防御属性（实时建筑与基地快照共用）
+void describeDefence(const DefenceBuildingConfig* config, int level, PlannerBuilding& out);
+
+// 阻塞执行（在调用线程上采样，模拟分块并行）
+AttackPlannerResult plan(const AttackPlannerInput& input, const AttackPlannerSettings& settings);
+
+// 在任务系统上执行，完成后在主线程回调
+void planAsync(const AttackPlannerInput& input, const AttackPlannerSettings& settings,
+               const std::function<void(const AttackPlannerResult&)>& onDone);
+
+// 随机生成 count 套部署方案（用于布局评估等不需要寻优的场景）
+std::vector<std::vector<ReplayDeployEvent>> sampleArmies(const AttackPlannerInput& input,
+                                                         const AttackPlannerSettings& settings, int count);
+
+std::string describePlan(const AttackPlan& plan);
+} // namespace AttackPlanner
+
+#endif // __ATTACK_PLANNER_H__
@@ -0,0 +1,139 @@
+#include "Replay/BattleStateHash.h"
+#include "Replay/ReplayManager.h"
+#include "Map/BattleSpace.h"
+#include "Soldier/Soldier.h"
+#include "Buildings/DefenceBuilding.h"
+#include "Buildings/ProductionBuilding.h"
+#include "Buildings/StorageBuilding.h"
+#include "Core/EntityTable.h"
+#include <algorithm>
+#include <unordered_map>
+
+using namespace cocos2d;
+
+namespace {
+constexpr uint64_t kFnvOffset = 1469598103934665603ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+void mix(uint64_t& hash, int64_t value) {
+    uint64_t bits = static_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (bits >> (i * 8)) & 0xFF;
+        hash *= kFnvPrime;
+    }
+}
+
+// 摘要里的血量按四舍五入取整，只用于差异描述；哈希直接混入定点原值
+int roundHp(Fixed hp) {
+    return (hp + Fixed::fromRaw(Fixed::kOne / 2)).floorToInt();
+}
+
+Fixed getBuildingHP(Node* building) {
+    if (auto* defence = dynamic_cast<DefenceBuilding*>(building)) {
+        return defence->getHP();
+    }
+    if (auto* production = dynamic_cast<ProductionBuilding*>(building)) {
+        return production->getHP();
+    }
+    if (auto* storage = dynamic_cast<StorageBuilding*>(building)) {
+        return storage->getHP();
+    }
+    return Fixed();
+}
+
+// 存活实体按出场序号排序：列表交换删除后顺序会变，序号与原先只增不删的列表下标一致
+template <typename T>
+std::vector<std::pair<int, T*>> orderBySerial(const std::vector<T*>& list, const EntityTable& entities) {
+    std::vector<std::pair<int, T*>> ordered;
+    ordered.reserve(list.size());
+    for (auto* node : list) {
+        if (node && node->getParent()) {
+            ordered.emplace_back(entities.getSerial(node), node);
+        }
+    }
+    std::sort(ordered.begin(), ordered.end(),
+        [](const std::pair<int, T*>& a, const std::pair<int, T*>& b) { return a.first < b.first; });
+    return ordered;
+}
+} // namespace
+
+ReplayStateHash BattleStateHash::capture(int tick, uint64_t previousHash,
+                                         const std::vector<Soldier*>& soldiers,
+                                         const std::vector<Node*>& buildings,
+                                         const EntityTable& entities) {
+    ReplayStateHash state;
+    state.tick = tick;
+
+    auto orderedSoldiers = orderBySerial(soldiers, entities);
+    auto orderedBuildings = orderBySerial(buildings, entities);
+
+    // 目标以出场序号参与哈希，指针值在两次运行间不可比
+    std::unordered_map<const Node*, int> buildingIndex;
+    std::unordered_map<const Node*, int> soldierIndex;
+    buildingIndex.reserve(orderedBuildings.size());
+    soldierIndex.reserve(orderedSoldiers.size());
+    for (const auto& entry : orderedBuildings) {
+        buildingIndex[entry.second] = entry.first;
+    }
+    for (const auto& entry : orderedSoldiers) {
+        soldierIndex[entry.second] = entry.first;
+    }
+    auto lookup = [](const std::unordered_map<const Node*, int>& index, const Node* node) {
+        auto it = index.find(node);
+        return it != index.end() ? it->second : -1;
+    };
+
+    uint64_t hash = kFnvOffset;
+    mix(hash, static_cast<int64_t>(previousHash));
+    mix(hash, tick);
+
+    for (const auto& entry : orderedSoldiers) {
+        Soldier* soldier = entry.second;
+        // 模拟状态全是定点数，直接混入原始值，不再量化浮点坐标
+        FixedVec2 pos = BattleSpace::simPositionOf(soldier);
+        Fixed hp = soldier->getHP();
+        mix(hash, static_cast<int64_t>(entry.first));
+        mix(hash, soldier->getUnitId());
+        mix(hash, pos.x.raw);
+        mix(hash, pos.y.raw);
+        mix(hash, hp.raw);
+        mix(hash, lookup(buildingIndex, soldier->getTarget()));
+        state.soldiers++;
+        state.soldierHp += roundHp(hp);
+    }
+
+    for (const auto& entry : orderedBuildings) {
+        Node* building = entry.second;
+        Fixed hp = getBuildingHP(building);
+        mix(hash, static_cast<int64_t>(entry.first));
+        mix(hash, hp.raw);
+        if (auto* defence = dynamic_cast<DefenceBuilding*>(building)) {
+            mix(hash, lookup(soldierIndex, defence->getTarget()));
+        }
+        state.buildings++;
+        state.buildingHp += roundHp(hp);
+    }
+
+    state.hash = hash;
+    return state;
+}
+
+std::string BattleStateHash::describeDiff(const ReplayStateHash& expected, const ReplayStateHash& actual) {
+    std::string diff = StringUtils::format("tick %d (%.2fs)", expected.tick,
+        static_cast<float>(expected.tick) / kTicksPerSecond);
+    auto field = [&diff](const char* name, int want, int got) {
+        if (want != got) {
+            diff += StringUtils::format(" %s %d->%d", name, want, got);
+        }
+    };
+    field("soldiers", expected.soldiers, actual.soldiers);
+    field("soldierHP", expected.soldierHp, actual.soldierHp);
+    field("buildings", expected.buildings, actual.buildings);
+    field("buildingHP", expected.buildingHp, actual.buildingHp);
+    if (expected.soldiers == actual.soldiers && expected.soldierHp == actual.soldierHp
+        && expected.buildings == actual.buildings && expected.buildingHp == actual.buildingHp) {
+        // 计数与血量一致时差异来自位置或目标选择
+        diff += " positions/targets differ";
+    }
+    return diff;
+}
@@ -0,0 +1,33 @@
+#ifndef __BATTLE_STATE_HASH_H__
+#define __BATTLE_STATE_HASH_H__
+
+#include "cocos2d.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class EntityTable;
+class Soldier;
+struct ReplayStateHash;
+
+/**
+ * 战斗状态哈希
+ * 每隔固定逻辑帧对战斗状态（定点坐标与血量、目标、存活实体集合）做一次滚动哈希，
+ * 录制时写入回放，回放时逐个比对，定位第一个与原始对局分叉的逻辑帧。
+ */
+namespace BattleStateHash {
+constexpr int kTicksPerSecond = 60;     // 逻辑帧频率（与战斗时间换算）
+constexpr int kDefaultInterval = 30;    // 默认每 30 个逻辑帧记录一次
+
+// 采集当前状态；previousHash 为上一个检查点的哈希，使结果沿时间链式累积。
+// 实体按句柄表中的出场序号遍历，与列表当前顺序无关
+ReplayStateHash capture(int tick, uint64_t previousHash,
+                        const std::vector<Soldier*>& soldiers,
+                        const std::vector<cocos2d::Node*>& buildings,
+                        const EntityTable& entities);
+
+// 生成两个检查点的差异描述（用于分叉报告）
+std::string describeDiff(const ReplayStateHash& expected, const ReplayStateHash& actual);
+} // namespace BattleStateHash
+
+#endif // __BATTLE_STATE_HASH_H__
@@ -0,0 +1,299 @@
+#include "Replay/LayoutEvaluator.h"
+#include "Buildings/BuildingManager.h"
+#include "Scenes/BattleScene.h"
+#include "Share/SnapshotPlacement.h"
+#include "Soldier/UnitManager.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+using namespace cocos2d;
+
+namespace {
+constexpr int kEvalGrain = 2;   // 并行分块大小
+constexpr int kSpikeTrapType = 11;
+constexpr int kSnapTrapType = 12;
+
+// 单场模拟的结果槽位（并行时每场只写自己的槽位）
+struct AttackOutcome {
+    int stars = 0;
+    bool win = false;
+    std::vector<float> damage;
+    std::vector<float> heat;
+};
+
+void addBuilding(LayoutTarget& out, const PlannerBuilding& data, const std::string& name,
+                 int battleX, int battleY, int width, int height) {
+    out.input.buildings.push_back(data);
+    LayoutBuildingReport report;
+    report.name = name;
+    report.gridX = battleX - out.offsetX;
+    report.gridY = battleY - out.offsetY;
+    report.width = width;
+    report.height = height;
+    out.buildings.push_back(report);
+}
+
+PlannerBuilding placeAt(int gridX, int gridY, int width, int height, float cellSize) {
+    PlannerBuilding data;
+    Rect footprint(gridX * cellSize, gridY * cellSize, width * cellSize, height * cellSize);
+    data.target.footprint = FixedRect::fromRect(footprint);
+    data.target.position = FixedVec2::fromVec2(Vec2(footprint.getMidX(), footprint.getMidY()));
+    return data;
+}
+
+// 陷阱类型与 BaseScene 的商店类型一致
+bool describeSavedTrap(const BuildingOption& option, const PlacedSnapshotBuilding& placed,
+                       float cellSize, PlannerTrap& out) {
+    if (option.type == kSpikeTrapType) {
+        out.kind = TrapKind::SPIKE;
+    }
+    else if (option.type == kSnapTrapType) {
+        out.kind = TrapKind::SNAP;
+    }
+    else {
+        return false;
+    }
+    out.area = FixedRect::fromRect(CombatRules::trapTriggerCells(out.kind, placed.gridX, placed.gridY,
+                                                                 placed.width, placed.height, cellSize));
+    return !out.area.isEmpty();
+}
+} // namespace
+
+bool LayoutEvaluator::describeSnapshot(const BaseSnapshot& snapshot, const std::map<int, int>& army,
+                                       int baseGridWidth, int baseGridHeight, LayoutTarget& out,
+                                       std::string* error) {
+    out = LayoutTarget();
+    out.gridWidth = baseGridWidth;
+    out.gridHeight = baseGridHeight;
+
+    // 与战斗中生成节点使用同一份摆放结果；有建筑会被战斗丢弃的布局不评估
+    GridBitset blocked;
+    GridMap::initBlockedBits(BattleConfig::GRID_WIDTH, BattleConfig::GRID_HEIGHT, blocked);
+    SnapshotPlacement placement = SnapshotPlacement::compute(snapshot, blocked);
+    if (!placement.isClean()) {
+        CCLOG("[布局评估] 布局无效：越界 %d 个，重叠 %d 个", placement.outOfBounds, placement.overlapped);
+        if (error) {
+            *error = StringUtils::format("%d building(s) out of bounds, %d overlapping",
+                placement.outOfBounds, placement.overlapped);
+        }
+        return false;
+    }
+    out.offsetX = placement.offsetX;
+    out.offsetY = placement.offsetY;
+
+    auto* manager = BuildingManager::getInstance();
+    const float cellSize = BattleConfig::CELL_SIZE;
+    for (const auto& placed : placement.buildings) {
+        PlannerBuilding data = placeAt(placed.gridX, placed.gridY, placed.width, placed.height, cellSize);
+        std::string name;
+        if (placed.role != PlacedSnapshotBuilding::Role::SAVED) {
+            const auto* config = manager->getProductionConfig(placed.configId);
+            if (!config) {
+                continue;
+            }
+            data.hp = FixedMath::levelValue(config->simHP, placed.level);
+            data.target.isResource = true;
+            data.isBase = placed.role == PlacedSnapshotBuilding::Role::BASE;
+            name = config->name;
+        }
+        else {
+            const auto& option = placed.saved->option;
+            name = option.name;
+            switch (option.category) {
+            case BuildingCategory::Defence: {
+                const auto* config = manager->getDefenceConfig(option.configId);
+                if (!config) {
+                    continue;
+                }
+                data.hp = FixedMath::levelValue(config->simHP, placed.level);
+                AttackPlanner::describeDefence(config, placed.level, data);
+                break;
+            }
+            case BuildingCategory::Production: {
+                const auto* config = manager->getProductionConfig(option.configId);
+                if (!config) {
+                    continue;
+                }
+                data.hp = FixedMath::levelValue(config->simHP, placed.level);
+                data.target.isResource = true;
+                break;
+            }
+            case BuildingCategory::Storage: {
+                const auto* config = manager->getStorageConfig(option.configId);
+                if (!config) {
+                    continue;
+                }
+                data.hp = FixedMath::levelValue(config->simHP, placed.level);
+                data.target.isResource = true;
+                break;
+            }
+            case BuildingCategory::Trap: {
+                // 陷阱不计入建筑报告，只参与模拟
+                PlannerTrap trap;
+                if (describeSavedTrap(option, placed, cellSize, trap)) {
+                    out.input.traps.push_back(trap);
+                }
+                continue;
+            }
+            default:
+                continue;
+            }
+        }
+        if (data.hp > Fixed()) {
+            addBuilding(out, data, name, placed.gridX, placed.gridY, placed.width, placed.height);
+        }
+    }
+
+    for (const auto& entry : army) {
+        PlannerUnit unit;
+        if (entry.second > 0 && AttackPlanner::describeUnit(entry.first,
+                UnitManager::getInstance()->getUnitLevel(entry.first), unit)) {
+            out.input.units.push_back(unit);
+            out.input.counts[entry.first] = entry.second;
+        }
+    }
+
+    out.input.minGridX = BattleConfig::DEPLOY_MIN_X;
+    out.input.maxGridX = BattleConfig::DEPLOY_MAX_X;
+    out.input.minGridY = BattleConfig::DEPLOY_MIN_Y;
+    out.input.maxGridY = BattleConfig::DEPLOY_MAX_Y;
+    out.input.cellSize = cellSize;
+    out.input.mapBounds = Rect(0.0f, 0.0f, BattleConfig::GRID_WIDTH * cellSize, BattleConfig::GRID_HEIGHT * cellSize);
+    out.input.timeLimit = BattleConfig::BATTLE_TIME_LIMIT;
+    return !out.input.buildings.empty() && !out.input.units.empty();
+}
+
+std::vector<std::vector<ReplayDeployEvent>> LayoutEvaluator::buildCorpus(const LayoutTarget& target,
+                                                                         const std::vector<BattleReplay>& replays,
+                                                                         int generated, uint32_t seed) {
+    std::vector<std::vector<ReplayDeployEvent>> attacks;
+    for (const auto& replay : replays) {
+        if (replay.defenseMode || replay.events.empty()) {
+            continue;
+        }
+        // 旧回放没有逻辑帧，按时间换算
+        std::vector<ReplayDeployEvent> events = replay.events;
+        for (auto& event : events) {
+            if (event.tick < 0) {
+                event.tick = static_cast<int>(std::lround(event.time * BattleConfig::SIM_TICKS_PER_SECOND));
+            }
+        }
+        attacks.push_back(std::move(events));
+    }
+
+    AttackPlannerSettings settings;
+    settings.seed = seed;
+    auto armies = AttackPlanner::sampleArmies(target.input, settings, generated);
+    for (auto& army : armies) {
+        attacks.push_back(std::move(army));
+    }
+    return attacks;
+}
+
+LayoutEvaluation LayoutEvaluator::evaluate(const LayoutTarget& target,
+                                           const std::vector<std::vector<ReplayDeployEvent>>& attacks) {
+    auto start = std::chrono::steady_clock::now();
+    LayoutEvaluation evaluation;
+    evaluation.buildings = target.buildings;
+    evaluation.gridWidth = target.gridWidth;
+    evaluation.gridHeight = target.gridHeight;
+    evaluation.attacks = static_cast<int>(attacks.size());
+    const size_t cellCount = static_cast<size_t>(std::max(0, target.gridWidth * target.gridHeight));
+    evaluation.heat.assign(cellCount, 0.0f);
+    if (attacks.empty() || target.input.buildings.empty()) {
+        return evaluation;
+    }
+
+    std::vector<AttackOutcome> outcomes(attacks.size());
+    const float cellSize = target.input.cellSize;
+    JobSystem::getInstance()->parallelFor(static_cast<int>(attacks.size()), kEvalGrain, [&](int begin, int end) {
+        auto& simulator = AttackSimulator::forThisThread();
+        simulator.setRecordHits(true);
+        for (int i = begin; i < end; ++i) {
+            AttackPlan plan = simulator.run(target.input, attacks[i]);
+            AttackOutcome& outcome = outcomes[i];
+            outcome.stars = plan.stars;
+            outcome.win = plan.win;
+            outcome.damage = simulator.getBuildingDamage();
+            outcome.heat.assign(cellCount, 0.0f);
+            for (const auto& hit : simulator.getHits()) {
+                int x = static_cast<int>(std::floor(hit.position.x / cellSize)) - target.offsetX;
+                int y = static_cast<int>(std::floor(hit.position.y / cellSize)) - target.offsetY;
+                if (x >= 0 && y >= 0 && x < target.gridWidth && y < target.gridHeight) {
+                    outcome.heat[static_cast<size_t>(y * target.gridWidth + x)] += hit.damage;
+                }
+            }
+        }
+    });
+
+    // 按语料顺序串行汇总，结果与线程数无关
+    int totalStars = 0;
+    int wins = 0;
+    std::vector<int> destroyed(target.input.buildings.size(), 0);
+    for (const auto& outcome : outcomes) {
+        totalStars += outcome.stars;
+        wins += outcome.win ? 1 : 0;
+        for (size_t b = 0; b < outcome.damage.size(); ++b) {
+            const float maxHp = target.input.buildings[b].hp.toFloat();
+            if (maxHp <= 0.0f) {
+                continue;
+            }
+            evaluation.buildings[b].avgDamageRatio += outcome.damage[b] / maxHp;
+            if (outcome.damage[b] >= maxHp) {
+                destroyed[b]++;
+            }
+        }
+        for (size_t c = 0; c < cellCount; ++c) {
+            evaluation.heat[c] += outcome.heat[c];
+        }
+    }
+
+    const float count = static_cast<float>(outcomes.size());
+    evaluation.averageStars = totalStars / count;
+    evaluation.attackerWinRate = wins / count;
+    for (size_t b = 0; b < evaluation.buildings.size(); ++b) {
+        evaluation.buildings[b].avgDamageRatio /= count;
+        evaluation.buildings[b].destroyRate = destroyed[b] / count;
+    }
+    float peak = evaluation.heat.empty() ? 0.0f : *std::max_element(evaluation.heat.begin(), evaluation.heat.end());
+    if (peak > 0.0f) {
+        for (auto& value : evaluation.heat) {
+            value /= peak;
+        }
+    }
+
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    evaluation.elapsedMs = elapsed.count();
+    CCLOG("[布局评估] %s", buildSummary(evaluation, static_cast<int>(evaluation.buildings.size())).c_str());
+    return evaluation;
+}
+
+void LayoutEvaluator::evaluateAsync(const LayoutTarget& target,
+                                    const std::vector<std::vector<ReplayDeployEvent>>& attacks,
+                                    const std::function<void(const LayoutEvaluation&)>& onDone) {
+    JobFuture<LayoutEvaluation>::run("layoutEvaluate", [target, attacks]() {
+        return evaluate(target, attacks);
+    }).then(onDone);
+}
+
+std::string LayoutEvaluator::buildSummary(const LayoutEvaluation& evaluation, int weakest) {
+    std::string summary = StringUtils::format("%d attacks: avg %.2f stars conceded, attacker wins %.0f%% (%.0fms)",
+        evaluation.attacks, evaluation.averageStars, evaluation.attackerWinRate * 100.0f, evaluation.elapsedMs);
+
+    std::vector<size_t> order(evaluation.buildings.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&evaluation](size_t a, size_t b) {
+        return evaluation.buildings[a].avgDamageRatio > evaluation.buildings[b].avgDamageRatio;
+    });
+    int shown = std::min(weakest, static_cast<int>(order.size()));
+    for (int i = 0; i < shown; ++i) {
+        const auto& building = evaluation.buildings[order[i]];
+        summary += StringUtils::format("\n%s (%d,%d): %.0f%% dmg, destroyed %.0f%%",
+            building.name.c_str(), building.gridX, building.gridY,
+            building.avgDamageRatio * 100.0f, building.destroyRate * 100.0f);
+    }
+    return summary;
+}
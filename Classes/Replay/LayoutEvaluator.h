@@ -0,0 +1,74 @@
+#ifndef __LAYOUT_EVALUATOR_H__
+#define __LAYOUT_EVALUATOR_H__
+
+#include "Replay/AttackPlanner.h"
+#include "Share/BattleShareManager.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// 单个建筑的评估结果（坐标为基地网格）
+struct LayoutBuildingReport {
+    std::string name;
+    int gridX = 0;
+    int gridY = 0;
+    int width = 0;
+    int height = 0;
+    float avgDamageRatio = 0.0f;    // 平均受伤比例（0~1）
+    float destroyRate = 0.0f;       // 被摧毁的对局占比
+};
+
+// 待评估的布局（由基地快照换算到战斗地图）
+struct LayoutTarget {
+    AttackPlannerInput input;                   // 建筑、兵力与部署范围
+    std::vector<LayoutBuildingReport> buildings;// 与 input.buildings 一一对应
+    int offsetX = 0;                            // 战斗网格 = 基地网格 + offset
+    int offsetY = 0;
+    int gridWidth = 0;                          // 基地网格尺寸（热力图大小）
+    int gridHeight = 0;
+};
+
+struct LayoutEvaluation {
+    std::vector<LayoutBuildingReport> buildings;
+    int attacks = 0;
+    float averageStars = 0.0f;      // 平均失星
+    float attackerWinRate = 0.0f;
+    float elapsedMs = 0.0f;
+    int gridWidth = 0;
+    int gridHeight = 0;
+    std::vector<float> heat;        // 每格归一化热度（0~1）：进攻方在此处站位造成的伤害
+};
+
+/**
+ * 基地布局压力评估
+ * 把基地快照按 SnapshotPlacement（与 BattleScene 生成布局共用）换算到战斗地图，
+ * 用一组进攻方案（回放语料 + 随机生成的兵力）在任务系统上并行快进模拟，
+ * 汇总各建筑受伤情况、平均失星与弱点热力图。
+ * 模拟器按线程复用（AttackSimulator::forThisThread），数十场模拟可在数秒内完成。
+ */
+namespace LayoutEvaluator {
+// 生成评估目标；army 为进攻兵力（兵种ID -> 数量），只能在主线程调用。
+// 有建筑越界或重叠的布局返回 false，error 说明原因
+bool describeSnapshot(const BaseSnapshot& snapshot, const std::map<int, int>& army,
+                      int baseGridWidth, int baseGridHeight, LayoutTarget& out,
+                      std::string* error = nullptr);
+
+// 组装进攻语料：回放中的部署事件 + generated 套随机方案
+std::vector<std::vector<ReplayDeployEvent>> buildCorpus(const LayoutTarget& target,
+                                                        const std::vector<BattleReplay>& replays,
+                                                        int generated, uint32_t seed);
+
+LayoutEvaluation evaluate(const LayoutTarget& target,
+                          const std::vector<std::vector<ReplayDeployEvent>>& attacks);
+
+// 在任务系统上执行，完成后在主线程回调
+void evaluateAsync(const LayoutTarget& target,
+                   const std::vector<std::vector<ReplayDeployEvent>>& attacks,
+                   const std::function<void(const LayoutEvaluation&)>& onDone);
+
+// 一行总结 + 最薄弱的 weakest 个建筑
+std::string buildSummary(const LayoutEvaluation& evaluation, int weakest);
+} // namespace LayoutEvaluator
+
+#endif // __LAYOUT_EVALUATOR_H__
@@ -3,11 +3,13 @@
 #include "json/stringbuffer.h"
 #include "json/writer.h"
 #include "cocos2d.h"
+#include <cstdlib>
 
 using namespace cocos2d;
 
 namespace {
-constexpr int kReplayVersion = 1;
+// 任务线程内 JSON 节点使用线程私有临时内存区的大小
+constexpr size_t kJsonScratchBytes = 32 * 1024;
 
 int readInt(const rapidjson::Value& obj, const char* key, int fallback) {
     auto it = obj.FindMember(key);
@@ -63,7 +65,8 @@ bool readBool(const rapidjson::Value& obj, const char* key, bool fallback) {
 }
 
 std::string serializeReplay(const BattleReplay& replay) {
-    rapidjson::Document doc;
+    rapidjson::MemoryPoolAllocator<> allocator(JobSystem::scratch().allocate(kJsonScratchBytes), kJsonScratchBytes);
+    rapidjson::Document doc(&allocator);
     doc.SetObject();
     auto& alloc = doc.GetAllocator();
 
@@ -90,6 +93,7 @@ std::string serializeReplay(const BattleReplay& replay) {
     for (const auto& event : replay.events) {
         rapidjson::Value item(rapidjson::kObjectType);
         item.AddMember("t", event.time, alloc);
+        item.AddMember("tick", event.tick, alloc);
         item.AddMember("id", event.unitId, alloc);
         item.AddMember("x", event.gridX, alloc);
         item.AddMember("y", event.gridY, alloc);
@@ -98,6 +102,21 @@ std::string serializeReplay(const BattleReplay& replay) {
     }
     doc.AddMember("events", events, alloc);
 
+    doc.AddMember("hashInterval", replay.stateHashInterval, alloc);
+    rapidjson::Value hashes(rapidjson::kArrayType);
+    for (const auto& state : replay.stateHashes) {
+        rapidjson::Value item(rapidjson::kObjectType);
+        std::string hex = StringUtils::format("%016llx", static_cast<unsigned long long>(state.hash));
+        item.AddMember("tick", state.tick, alloc);
+        item.AddMember("h", rapidjson::Value(hex.c_str(), alloc), alloc);
+        item.AddMember("s", state.soldiers, alloc);
+        item.AddMember("sh", state.soldierHp, alloc);
+        item.AddMember("b", state.buildings, alloc);
+        item.AddMember("bh", state.buildingHp, alloc);
+        hashes.PushBack(item, alloc);
+    }
+    doc.AddMember("hashes", hashes, alloc);
+
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     doc.Accept(writer);
@@ -108,14 +127,15 @@ bool parseReplay(const std::string& json, BattleReplay* outReplay) {
     if (!outReplay) {
         return false;
     }
-    rapidjson::Document doc;
+    rapidjson::MemoryPoolAllocator<> allocator(JobSystem::scratch().allocate(kJsonScratchBytes), kJsonScratchBytes);
+    rapidjson::Document doc(&allocator);
     doc.Parse(json.c_str());
     if (doc.HasParseError() || !doc.IsObject()) {
         return false;
     }
 
     BattleReplay replay;
-    replay.version = readInt(doc, "version", kReplayVersion);
+    replay.version = readInt(doc, "version", 1);
     replay.levelId = readInt(doc, "levelId", 1);
     replay.defenseMode = readBool(doc, "defenseMode", false);
     replay.allowDefaultUnits = readBool(doc, "allowDefaultUnits", true);
@@ -145,6 +165,7 @@ bool parseReplay(const std::string& json, BattleReplay* outReplay) {
             }
             ReplayDeployEvent event;
             event.time = readFloat(item, "t", 0.0f);
+            event.tick = readInt(item, "tick", -1);
             event.unitId = readInt(item, "id", 0);
             event.gridX = readInt(item, "x", 0);
             event.gridY = readInt(item, "y", 0);
@@ -155,6 +176,23 @@ bool parseReplay(const std::string& json, BattleReplay* outReplay) {
         }
     }
 
+    replay.stateHashInterval = readInt(doc, "hashInterval", 0);
+    if (doc.HasMember("hashes") && doc["hashes"].IsArray()) {
+        for (const auto& item : doc["hashes"].GetArray()) {
+            if (!item.IsObject() || !item.HasMember("h") || !item["h"].IsString()) {
+                continue;
+            }
+            ReplayStateHash state;
+            state.tick = readInt(item, "tick", 0);
+            state.hash = std::strtoull(item["h"].GetString(), nullptr, 16);
+            state.soldiers = readInt(item, "s", 0);
+            state.soldierHp = readInt(item, "sh", 0);
+            state.buildings = readInt(item, "b", 0);
+            state.buildingHp = readInt(item, "bh", 0);
+            replay.stateHashes.push_back(state);
+        }
+    }
+
     *outReplay = replay;
     return true;
 }
@@ -174,45 +212,63 @@ void ReplayManager::setLastReplay(const BattleReplay& replay) {
     _hasLastReplay = true;
 }
 
-bool ReplayManager::hasLastReplay() {
-    if (_hasLastReplay) {
-        return true;
-    }
-    return loadLastReplay();
+bool ReplayManager::hasLastReplay() const {
+    return _hasLastReplay;
 }
 
-const BattleReplay* ReplayManager::getLastReplay() {
-    if (!_hasLastReplay) {
-        loadLastReplay();
-    }
+const BattleReplay* ReplayManager::getLastReplay() const {
     return _hasLastReplay ? &_lastReplay : nullptr;
 }
 
+void ReplayManager::queueIoJob(const char* name, std::function<void()> task) {
+    // 只在主线程调用：每个任务依赖上一个，保证同一文件的读写顺序
+    _ioChain = JobSystem::getInstance()->submit(name, std::move(task), { _ioChain });
+}
+
 bool ReplayManager::saveLastReplay() {
     if (!_hasLastReplay) {
         return false;
     }
     std::string path = buildReplayPath();
-    std::string data = serializeReplay(_lastReplay);
-    return FileUtils::getInstance()->writeStringToFile(data, path);
+    BattleReplay replay = _lastReplay;
+    queueIoJob("replay.save", [path, replay]() {
+        std::string error;
+        if (!JobIO::writeFile(path, serializeReplay(replay), &error)) {
+            CCLOG("[回放] 写入失败: %s", error.c_str());
+        }
+    });
+    return true;
 }
 
-bool ReplayManager::loadLastReplay() {
-    std::string path = buildReplayPath();
-    if (!FileUtils::getInstance()->isFileExist(path)) {
-        return false;
+void ReplayManager::preloadLastReplay(const LoadCallback& onDone) {
+    if (_hasLastReplay || _lastReplayChecked) {
+        if (onDone) {
+            onDone(getLastReplay());
+        }
+        return;
     }
-    std::string json = FileUtils::getInstance()->getStringFromFile(path);
-    if (json.empty()) {
-        return false;
+    if (onDone) {
+        _preloadWaiters.push_back(onDone);
     }
-    BattleReplay replay;
-    if (!parseReplay(json, &replay)) {
-        return false;
+    if (_preloading) {
+        return;
     }
-    _lastReplay = replay;
-    _hasLastReplay = true;
-    return true;
+    // 读取排在已提交的写入之后，不会读到写了一半的文件
+    _preloading = true;
+    importReplayAsync(buildReplayPath(), [this](bool ok, const BattleReplay& replay) {
+        _preloading = false;
+        _lastReplayChecked = true;
+        // 预读期间若已有新战斗的回放则以新回放为准
+        if (ok && !_hasLastReplay) {
+            _lastReplay = replay;
+            _hasLastReplay = true;
+        }
+        std::vector<LoadCallback> waiters;
+        waiters.swap(_preloadWaiters);
+        for (const auto& waiter : waiters) {
+            waiter(getLastReplay());
+        }
+    });
 }
 
 std::string ReplayManager::getLastReplayPath() const {
@@ -220,16 +276,24 @@ std::string ReplayManager::getLastReplayPath() const {
 }
 
 std::string ReplayManager::buildReplayPath() const {
+    if (!_replayPath.empty()) {
+        return _replayPath;
+    }
     auto* fileUtils = FileUtils::getInstance();
     std::string base = fileUtils->getWritablePath();
     std::string dir = base + "replays/";
     fileUtils->createDirectory(dir);
-    return dir + "last_replay.json";
+    _replayPath = dir + "last_replay.json";
+    return _replayPath;
 }
 
-bool ReplayManager::exportReplayTo(const std::string& path, const BattleReplay& replay) {
+void ReplayManager::exportReplayAsync(const std::string& path, const BattleReplay& replay,
+                                      const ExportCallback& onDone) {
     if (path.empty()) {
-        return false;
+        if (onDone) {
+            onDone(false);
+        }
+        return;
     }
     auto* fileUtils = FileUtils::getInstance();
     std::string dir;
@@ -240,21 +304,40 @@ bool ReplayManager::exportReplayTo(const std::string& path, const BattleReplay&
     if (!dir.empty() && !fileUtils->isDirectoryExist(dir)) {
         fileUtils->createDirectory(dir);
     }
-    std::string data = serializeReplay(replay);
-    return fileUtils->writeStringToFile(data, path);
+    queueIoJob("replay.export", [path, replay, onDone]() {
+        std::string error;
+        bool ok = JobIO::writeFile(path, serializeReplay(replay), &error);
+        if (!ok) {
+            CCLOG("[回放] 导出失败: %s", error.c_str());
+        }
+        if (onDone) {
+            JobSystem::runOnMainThread([onDone, ok]() {
+                onDone(ok);
+            });
+        }
+    });
 }
 
-bool ReplayManager::importReplayFrom(const std::string& path, BattleReplay* outReplay) const {
-    if (!outReplay || path.empty()) {
-        return false;
-    }
-    auto* fileUtils = FileUtils::getInstance();
-    if (!fileUtils->isFileExist(path)) {
-        return false;
-    }
-    std::string data = fileUtils->getStringFromFile(path);
-    if (data.empty()) {
-        return false;
+void ReplayManager::importReplayAsync(const std::string& path, const ImportCallback& onDone) {
+    if (path.empty()) {
+        if (onDone) {
+            onDone(false, BattleReplay());
+        }
+        return;
     }
-    return parseReplay(data, outReplay);
+    queueIoJob("replay.import", [path, onDone]() {
+        std::string data;
+        auto replay = std::make_shared<BattleReplay>();
+        std::string error;
+        bool ok = JobIO::readFile(path, data, &error);
+        if (!ok) {
+            CCLOG("[回放] 导入失败: %s", error.c_str());
+        }
+        ok = ok && !data.empty() && parseReplay(data, replay.get());
+        if (onDone) {
+            JobSystem::runOnMainThread([onDone, ok, replay]() {
+                onDone(ok, *replay);
+            });
+        }
+    });
 }
@@ -1,21 +1,39 @@
 #ifndef __REPLAY_MANAGER_H__
 #define __REPLAY_MANAGER_H__
 
+#include "Utils/JobSystem.h"
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
 
 struct ReplayDeployEvent {
     float time = 0.0f;
+    int tick = -1;                  // 部署时已完成的模拟帧数（旧录像为 -1，按 time 换算）
     int unitId = 0;
     int gridX = 0;
     int gridY = 0;
     int level = 0;
 };
 
+// 战斗状态检查点（见 BattleStateHash）
+struct ReplayStateHash {
+    int tick = 0;                   // 逻辑帧
+    uint64_t hash = 0;              // 截至该帧的滚动哈希
+    int soldiers = 0;               // 存活士兵数
+    int soldierHp = 0;              // 士兵血量总和
+    int buildings = 0;              // 存活建筑数
+    int buildingHp = 0;             // 建筑血量总和
+};
+
+// 回放格式版本
+constexpr int kReplayVersion = 2;
+// 检查点哈希自该版本起基于定点模拟状态，更早录制的回放不再比对检查点
+constexpr int kStateHashMinVersion = 2;
+
 struct BattleReplay {
-    int version = 1;
+    int version = kReplayVersion;
     int levelId = 1;
     bool defenseMode = false;
     bool allowDefaultUnits = true;
@@ -26,29 +44,49 @@ struct BattleReplay {
     float duration = 0.0f;
     std::map<int, int> deployableUnits;
     std::vector<ReplayDeployEvent> events;
+    int stateHashInterval = 0;      // 检查点间隔（逻辑帧），0 表示未记录
+    std::vector<ReplayStateHash> stateHashes;
 };
 
+/**
+ * 回放管理器
+ * 序列化与文件读写都在任务系统的工作线程完成，结果通过主线程回调返回；
+ * 同一管理器内的写入按提交顺序串行落盘。
+ */
 class ReplayManager {
 public:
+    using ExportCallback = std::function<void(bool ok)>;
+    using ImportCallback = std::function<void(bool ok, const BattleReplay& replay)>;
+    using LoadCallback = std::function<void(const BattleReplay* replay)>;
+
     static ReplayManager* getInstance();
 
     void setLastReplay(const BattleReplay& replay);
-    bool hasLastReplay();
-    const BattleReplay* getLastReplay();
-    bool saveLastReplay();
-    bool loadLastReplay();
+    // 只查询缓存，不读文件；预读完成前为空
+    bool hasLastReplay() const;
+    const BattleReplay* getLastReplay() const;
+    bool saveLastReplay();              // 排队异步写入，返回是否已排队
+    // 后台预读上一次的回放，完成后在主线程回调（没有回放时为 nullptr）；
+    // 已有结果（包括确认文件不存在）时立即回调，不会重复读取
+    void preloadLastReplay(const LoadCallback& onDone = nullptr);
     std::string getLastReplayPath() const;
-    bool exportReplayTo(const std::string& path, const BattleReplay& replay);
-    bool importReplayFrom(const std::string& path, BattleReplay* outReplay) const;
+    void exportReplayAsync(const std::string& path, const BattleReplay& replay, const ExportCallback& onDone);
+    void importReplayAsync(const std::string& path, const ImportCallback& onDone);
 
 private:
     ReplayManager() = default;
     ~ReplayManager() = default;
 
     std::string buildReplayPath() const;
+    void queueIoJob(const char* name, std::function<void()> task);
 
     BattleReplay _lastReplay;
     bool _hasLastReplay = false;
+    bool _lastReplayChecked = false;        // 已读过回放文件（含读取失败），不再重复读取
+    bool _preloading = false;
+    std::vector<LoadCallback> _preloadWaiters;
+    mutable std::string _replayPath;        // 缓存的回放路径（目录只创建一次）
+    JobSystem::JobHandle _ioChain;          // 回放读写任务链
 
     static ReplayManager* s_instance;
 };
@@ -126,6 +126,68 @@ void SaveManager::init() {
     std::string dbPath = FileUtils::getInstance()->getWritablePath() + "voidkings_saves.db";
     localStorageInit(dbPath);
     _initialized = true;
+
+    // 后台预读全部存档槽，打开存档菜单时直接命中内存镜像
+    queueStorageJob("save.prefetch", [this]() {
+        for (int slot = 1; slot <= kSlotCount; ++slot) {
+            std::string data;
+            bool exists = false;
+            {
+                std::lock_guard<std::mutex> lock(_storageMutex);
+                exists = localStorageGetItem(makeSlotKey(slot), &data) && !data.empty();
+            }
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+            auto& entry = _slotCache[slot];
+            if (!entry.loaded) {
+                entry.loaded = true;
+                entry.exists = exists;
+                entry.data = exists ? data : "";
+            }
+        }
+    });
+}
+
+void SaveManager::queueStorageJob(const char* name, std::function<void()> task) {
+    // 只在主线程调用：每个任务依赖上一个，保证写入/删除按调用顺序落盘
+    _storageChain = JobSystem::getInstance()->submit(name, std::move(task), { _storageChain });
+}
+
+void SaveManager::flush() {
+    JobSystem::getInstance()->wait(_storageChain);
+}
+
+bool SaveManager::readSlotData(int slot, std::string* outData) const {
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        auto it = _slotCache.find(slot);
+        if (it != _slotCache.end() && it->second.loaded) {
+            if (!it->second.exists) {
+                return false;
+            }
+            *outData = it->second.data;
+            return true;
+        }
+    }
+
+    // 预读尚未完成时同步读取一次，结果同样写入镜像
+    std::string data;
+    bool exists = false;
+    {
+        std::lock_guard<std::mutex> lock(_storageMutex);
+        exists = localStorageGetItem(getSlotKey(slot), &data) && !data.empty();
+    }
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    auto& entry = _slotCache[slot];
+    if (!entry.loaded) {
+        entry.loaded = true;
+        entry.exists = exists;
+        entry.data = exists ? data : "";
+    }
+    if (!entry.exists) {
+        return false;
+    }
+    *outData = entry.data;
+    return true;
 }
 
 bool SaveManager::isValidSlot(int slot) const {
@@ -222,6 +284,7 @@ bool SaveManager::saveSlot(int slot) {
         item.AddMember("gridX", saved.gridX, alloc);
         item.AddMember("gridY", saved.gridY, alloc);
         item.AddMember("level", saved.level, alloc);
+        item.AddMember("produceTimestampMs", static_cast<int64_t>(saved.produceTimestampMs), alloc);
 
         rapidjson::Value option(rapidjson::kObjectType);
         option.AddMember("type", saved.option.type, alloc);
@@ -245,7 +308,20 @@ bool SaveManager::saveSlot(int slot) {
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     doc.Accept(writer);
 
-    localStorageSetItem(getSlotKey(slot), buffer.GetString());
+    // 先更新内存镜像，数据库写入交给后台任务
+    std::string data = buffer.GetString();
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        auto& entry = _slotCache[slot];
+        entry.loaded = true;
+        entry.exists = true;
+        entry.data = data;
+    }
+    std::string key = getSlotKey(slot);
+    queueStorageJob("save.write", [this, key, data]() {
+        std::lock_guard<std::mutex> lock(_storageMutex);
+        localStorageSetItem(key, data);
+    });
     return true;
 }
 
@@ -263,7 +339,7 @@ bool SaveManager::loadSlot(int slot) {
     init();
 
     std::string jsonData;
-    if (!localStorageGetItem(getSlotKey(slot), &jsonData) || jsonData.empty()) {
+    if (!readSlotData(slot, &jsonData)) {
         resetGameState();
         return false;
     }
@@ -355,6 +431,7 @@ bool SaveManager::loadSlot(int slot) {
                 saved.gridX = readInt(item, "gridX", 0);
                 saved.gridY = readInt(item, "gridY", 0);
                 saved.level = readInt(item, "level", 0);
+                saved.produceTimestampMs = readInt64(item, "produceTimestampMs", 0);
 
                 if (item.HasMember("option") && item["option"].IsObject()) {
                     const auto& option = item["option"];
@@ -383,7 +460,18 @@ bool SaveManager::deleteSlot(int slot) {
         return false;
     }
     init();
-    localStorageRemoveItem(getSlotKey(slot));
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        auto& entry = _slotCache[slot];
+        entry.loaded = true;
+        entry.exists = false;
+        entry.data.clear();
+    }
+    std::string key = getSlotKey(slot);
+    queueStorageJob("save.delete", [this, key]() {
+        std::lock_guard<std::mutex> lock(_storageMutex);
+        localStorageRemoveItem(key);
+    });
     if (_activeSlot == slot) {
         _activeSlot = 0;
     }
@@ -396,7 +484,7 @@ bool SaveManager::hasSlot(int slot) const {
     }
     const_cast<SaveManager*>(this)->init();
     std::string jsonData;
-    return localStorageGetItem(getSlotKey(slot), &jsonData) && !jsonData.empty();
+    return readSlotData(slot, &jsonData);
 }
 
 void SaveManager::setActiveSlot(int slot) {
@@ -420,7 +508,7 @@ SaveSlotInfo SaveManager::getSlotInfo(int slot) const {
     const_cast<SaveManager*>(this)->init();
 
     std::string jsonData;
-    if (!localStorageGetItem(getSlotKey(slot), &jsonData) || jsonData.empty()) {
+    if (!readSlotData(slot, &jsonData)) {
         info.exists = false;
         info.summary = "Empty";
         return info;
@@ -1,6 +1,9 @@
 #ifndef __SAVE_MANAGER_H__
 #define __SAVE_MANAGER_H__
 
+#include "Utils/JobSystem.h"
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -27,7 +30,17 @@ public:
     SaveSlotInfo getSlotInfo(int slot) const;
     std::vector<SaveSlotInfo> listSlots() const;
 
+    // 等待所有排队的存储写入落盘（退出程序前调用）
+    void flush();
+
 private:
+    // 存档槽内存镜像：写入先更新镜像再异步落盘，读取优先命中镜像
+    struct SlotCache {
+        bool loaded = false;
+        bool exists = false;
+        std::string data;
+    };
+
     SaveManager() = default;
     ~SaveManager() = default;
 
@@ -35,10 +48,17 @@ private:
     std::string getSlotKey(int slot) const;
     void resetGameState() const;
     std::string buildSummary() const;
+    bool readSlotData(int slot, std::string* outData) const;
+    void queueStorageJob(const char* name, std::function<void()> task);
 
     bool _initialized = false;
     int _activeSlot = 0;
 
+    mutable std::mutex _cacheMutex;             // 保护 _slotCache
+    mutable std::map<int, SlotCache> _slotCache;
+    mutable std::mutex _storageMutex;           // LocalStorage 非线程安全，所有访问串行
+    JobSystem::JobHandle _storageChain;         // 存储任务按提交顺序串成链
+
     static SaveManager* s_instance;
 };
 
@@ -18,6 +18,9 @@
 #include "Buildings/Trap.h"
 #include "UI/TrainPanel.h"
 #include "Core/Core.h"
+#include "Core/EconomyScheduler.h"
+#include "Replay/LayoutEvaluator.h"
+#include "Replay/ReplayManager.h"
 #include "BattleScene.h"
 #include "Share/BattleShareManager.h"
 #include "Save/SaveManager.h"
@@ -53,15 +56,24 @@ constexpr float kHoverSellWidth = 78.0f;
 constexpr float kHoverSellHeight = 18.0f;
 constexpr float kHoverSellGap = 6.0f;
 constexpr float kHoverPanelOffsetX = 16.0f;
+// 拾取时在光标所在格左右各看 1 列、向下看 3 行（覆盖高出占地的建筑精灵）
+constexpr int kPickSideCells = 1;
+constexpr int kPickBelowCells = 3;
 constexpr float kUpgradeCostFactor = 0.6f;
 constexpr float kSellRefundRate = 0.5f;
 constexpr int kSpikeTrapType = 11;
 constexpr int kSnapTrapType = 12;
+constexpr int kBaseGridWidth = 80;
+constexpr int kBaseGridHeight = 80;
 constexpr int kBaseAnchorX = 36;
 constexpr int kBaseAnchorY = 36;
 constexpr int kBarracksAnchorX = 30;
 constexpr int kBarracksAnchorY = 36;
 constexpr int kSavedBuildingTagBase = 10000;
+constexpr int kLayoutEvalGenerated = 48;           // 布局评估随机生成的进攻方案数
+constexpr uint32_t kLayoutEvalSeed = 20240601;
+constexpr float kLayoutHeatmapDuration = 15.0f;    // 弱点热力图显示时长（秒）
+const char* kLayoutHeatmapName = "layoutHeatmap";
 
 Vec2 s_baseAnchor(static_cast<float>(kBaseAnchorX), static_cast<float>(kBaseAnchorY));
 Vec2 s_barracksAnchor(static_cast<float>(kBarracksAnchorX), static_cast<float>(kBarracksAnchorY));
@@ -197,6 +209,27 @@ bool BaseScene::init() {
     return true;
 }
 
+void BaseScene::onEnter() {
+    Scene::onEnter();
+    // 经济调度器批量结算后只通知一次，统一刷新资源显示
+    EconomyScheduler::getInstance()->setTickListener(this, [this]() {
+        if (_uiPanel) {
+            _uiPanel->updateResourceDisplay(
+                Core::getInstance()->getResource(ResourceType::COIN),
+                Core::getInstance()->getResource(ResourceType::DIAMOND)
+            );
+        }
+        if (_hoverInfoPanel && _hoverInfoPanel->isVisible() && _hoveredBuilding) {
+            updateUpgradeUI(_hoveredBuilding);
+        }
+    });
+}
+
+void BaseScene::onExit() {
+    EconomyScheduler::getInstance()->clearTickListenerIf(this);
+    Scene::onExit();
+}
+
 const std::vector<BaseSavedBuilding>& BaseScene::getSavedBuildings() {
     return s_savedBuildings;
 }
@@ -209,6 +242,14 @@ Vec2 BaseScene::getBarracksAnchorGrid() {
     return s_barracksAnchor;
 }
 
+int BaseScene::getBaseGridWidth() {
+    return kBaseGridWidth;
+}
+
+int BaseScene::getBaseGridHeight() {
+    return kBaseGridHeight;
+}
+
 int BaseScene::getBarracksLevel() {
     return s_barracksLevel;
 }
@@ -237,7 +278,7 @@ void BaseScene::initGridMap() {
     auto origin = Director::getInstance()->getVisibleOrigin();
 
     // 创建网格地图（80x80格子，每格32像素 - 4倍于原来的40x40）
-    _gridMap = GridMap::create(80, 80, 32.0f);
+    _gridMap = GridMap::create(kBaseGridWidth, kBaseGridHeight, 32.0f);
     
     // 计算初始位置：将视图中心对准地图中心（建筑区域）
     // 建筑放置在(36,36)附近，将视图移动使其可见
@@ -257,16 +298,34 @@ void BaseScene::initGridMap() {
     this->addChild(_gridMap, 0);
     _gridMap->showGrid(GameSettings::getShowGrid());
 
-    // 创建建筑层（作为GridMap的子节点）
-    _buildingLayer = Node::create();
+    // 创建建筑层（作为GridMap的子节点，按分块做视口裁剪）
+    auto* buildingLayer = MapCamera::createLayerForMap(_gridMap, false);
+    _buildingLayer = buildingLayer;
     _gridMap->addChild(_buildingLayer, 10);
 
     // 创建网格背景组件
-    _gridBackground = GridBackground::create(80, 80, 32.0f);
+    _gridBackground = GridBackground::create(kBaseGridWidth, kBaseGridHeight, 32.0f);
     if (_gridBackground) {
         _gridMap->addChild(_gridBackground, -1);
     }
 
+    // 视角控制：缩放下限保证地图始终铺满屏幕
+    Rect viewport(origin.x, origin.y, visibleSize.width, visibleSize.height);
+    float mapWidth = _gridMap->getGridWidth() * cellSize;
+    float mapHeight = _gridMap->getGridHeight() * cellSize;
+    float minZoom = std::min(1.0f, std::max(visibleSize.width / mapWidth, visibleSize.height / mapHeight));
+    _mapCamera = MapCamera::create(_gridMap, viewport, minZoom, 1.5f);
+    if (_mapCamera) {
+        _mapCamera->addCulledLayer(buildingLayer);
+        _mapCamera->addAnimationLodLayer(buildingLayer);
+        _mapCamera->setInputFilter([this]() {
+            return !(_trainPanel && _trainPanel->isShowing())
+                && !(_buildShopPanel && _buildShopPanel->isShowing())
+                && !_asyncPanelVisible;
+        });
+        this->addChild(_mapCamera);
+    }
+
     CCLOG("[基地场景] 网格地图初始化完成（80x80格子），视图已居中到建筑区域");
 }
 
@@ -405,7 +464,7 @@ void BaseScene::showAsyncPanel() {
     }
     _asyncPanel->setVisible(true);
     _asyncPanelVisible = true;
-    updateAsyncStatus("Drop opponent target_base_snapshot.json / target_replay.json into the share folder.");
+    updateAsyncStatus("Drop opponent target_base_snapshot.vkb (or .json) / target_replay.json into the share folder.");
 }
 
 void BaseScene::hideAsyncPanel() {
@@ -514,7 +573,7 @@ void BaseScene::setupAsyncPanel() {
         card->addChild(pathLabel, 2);
     }
 
-    auto note = makeLabel("Place opponent target_base_snapshot.json / target_replay.json into the directory above.", 15,
+    auto note = makeLabel("Place opponent target_base_snapshot.vkb (or .json) / target_replay.json into the directory above.", 15,
         Color3B(185, 185, 185));
     if (note) {
         note->setAnchorPoint(Vec2(0, 0.5f));
@@ -552,7 +611,15 @@ void BaseScene::setupAsyncPanel() {
             baseBox->addChild(baseTitle, 2);
         }
 
-        auto baseDesc = makeLabel("Export my_base_snapshot.json to share your layout; load target_base_snapshot.json to attack imported bases.",
+        auto evaluateBtn = createAsyncButton("EVALUATE", [this]() {
+            handleEvaluateLayout();
+            }, Size(160.0f, 34.0f), Color4B(128, 64, 60, 255), Color4B(108, 52, 48, 255));
+        if (evaluateBtn) {
+            evaluateBtn->setPosition(Vec2(sectionWidth - 90.0f, h - 24.0f));
+            baseBox->addChild(evaluateBtn, 2);
+        }
+
+        auto baseDesc = makeLabel("Export my_base_snapshot.vkb (plus a delta against the last export) to share your layout; load target_base_snapshot.vkb to attack imported bases.",
             15, Color3B(215, 215, 215));
         if (baseDesc) {
             baseDesc->setAnchorPoint(Vec2(0, 1.0f));
@@ -703,77 +770,212 @@ Button* BaseScene::createAsyncButton(const std::string& text,
     return button;
 }
 
+// 分享文件的读写在任务线程完成，回调回到主线程；
+// 回调前保持场景引用，场景已退出时只释放引用不做切换
 void BaseScene::handleExportBase() {
     auto* shareMgr = BattleShareManager::getInstance();
     if (!shareMgr) {
         updateAsyncStatus("Share manager unavailable.");
         return;
     }
-    std::string path;
-    if (shareMgr->exportPlayerBaseSnapshot(&path)) {
-        updateAsyncStatus("Base snapshot exported to: " + path);
+    updateAsyncStatus("Exporting base snapshot...");
+    this->retain();
+    shareMgr->exportPlayerBaseSnapshot([this](bool ok, const std::string& path) {
+        if (isRunning()) {
+            if (ok) {
+                updateAsyncStatus("Base snapshot exported to: " + path);
+            }
+            else {
+                updateAsyncStatus("Export failed. Please confirm the base is loaded.");
+            }
+        }
+        this->release();
+    });
+}
+
+// 布局评估：当前基地快照 × 进攻语料（最近回放 + 随机兵力），模拟在任务系统上并行
+void BaseScene::handleEvaluateLayout() {
+    auto* shareMgr = BattleShareManager::getInstance();
+    if (!shareMgr || !_gridMap) {
+        updateAsyncStatus("Share manager unavailable.");
+        return;
     }
-    else {
-        updateAsyncStatus("Export failed. Please confirm the base is loaded.");
+
+    auto* unitMgr = UnitManager::getInstance();
+    if (unitMgr->getAllUnitIds().empty()) {
+        unitMgr->loadConfig("res/units_config.json");
     }
+    // 最近回放在后台读取，读完后再组装语料
+    this->retain();
+    ReplayManager::getInstance()->preloadLastReplay([this](const BattleReplay* replay) {
+        if (isRunning()) {
+            evaluateLayoutWith(replay);
+        }
+        this->release();
+    });
 }
 
-void BaseScene::handleImportBaseAttack() {
+void BaseScene::evaluateLayoutWith(const BattleReplay* replay) {
     auto* shareMgr = BattleShareManager::getInstance();
-    if (!shareMgr) {
-        updateAsyncStatus("Share manager unavailable.");
+    auto* unitMgr = UnitManager::getInstance();
+    std::map<int, int> army = unitMgr->getTrainedUnits();
+    std::vector<BattleReplay> replays;
+    if (replay) {
+        replays.push_back(*replay);
+        if (army.empty()) {
+            army = replay->deployableUnits;
+        }
+    }
+    if (army.empty()) {
+        // 与 BattleScene 默认兵力一致
+        auto unitIds = unitMgr->getAllUnitIds();
+        const int defaultCounts[] = { 10, 5, 8 };
+        for (int i = 0; i < static_cast<int>(unitIds.size()) && i < 3; ++i) {
+            army[unitIds[i]] = defaultCounts[i];
+        }
+    }
+
+    LayoutTarget target;
+    std::string error;
+    if (!LayoutEvaluator::describeSnapshot(shareMgr->captureCurrentBase(), army,
+            _gridMap->getGridWidth(), _gridMap->getGridHeight(), target, &error)) {
+        updateAsyncStatus(error.empty()
+            ? "Nothing to evaluate. Please confirm the base and units are loaded."
+            : "Layout cannot be evaluated: " + error);
         return;
     }
-    BaseSnapshot snapshot;
-    if (!shareMgr->loadIncomingSnapshot(&snapshot)) {
-        updateAsyncStatus("Failed to load target_base_snapshot.json.");
+    auto attacks = LayoutEvaluator::buildCorpus(target, replays, kLayoutEvalGenerated, kLayoutEvalSeed);
+    updateAsyncStatus(StringUtils::format("Evaluating layout against %d attacks...", static_cast<int>(attacks.size())));
+
+    this->retain();
+    LayoutEvaluator::evaluateAsync(target, attacks, [this](const LayoutEvaluation& evaluation) {
+        if (isRunning()) {
+            updateAsyncStatus(LayoutEvaluator::buildSummary(evaluation, 1));
+            for (const auto& building : evaluation.buildings) {
+                CCLOG("[布局评估] %s (%d,%d) 平均受伤 %.0f%% 摧毁率 %.0f%%",
+                    building.name.c_str(), building.gridX, building.gridY,
+                    building.avgDamageRatio * 100.0f, building.destroyRate * 100.0f);
+            }
+            showLayoutHeatmap(evaluation);
+        }
+        this->release();
+    });
+}
+
+void BaseScene::showLayoutHeatmap(const LayoutEvaluation& evaluation) {
+    if (!_gridMap) {
         return;
     }
-    shareMgr->setActiveTargetSnapshot(snapshot);
-    auto deployUnits = UnitManager::getInstance()->getTrainedUnits();
-    bool allowDefault = deployUnits.empty();
-    auto scene = BattleScene::createSnapshotScene(snapshot, deployUnits, allowDefault);
-    if (!scene) {
-        updateAsyncStatus("Failed to create battle scene from the snapshot.");
+    if (auto previous = _gridMap->getChildByName(kLayoutHeatmapName)) {
+        previous->removeFromParent();
+    }
+    if (evaluation.gridWidth != _gridMap->getGridWidth() || evaluation.gridHeight != _gridMap->getGridHeight()) {
         return;
     }
-    updateAsyncStatus("Target base loaded. Ready to attack.");
-    Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+
+    auto heatmap = DrawNode::create();
+    heatmap->setName(kLayoutHeatmapName);
+    const float cellSize = _gridMap->getCellSize();
+    for (int y = 0; y < evaluation.gridHeight; ++y) {
+        for (int x = 0; x < evaluation.gridWidth; ++x) {
+            float heat = evaluation.heat[static_cast<size_t>(y * evaluation.gridWidth + x)];
+            if (heat <= 0.0f) {
+                continue;
+            }
+            Vec2 origin(x * cellSize, y * cellSize);
+            heatmap->drawSolidRect(origin, origin + Vec2(cellSize, cellSize),
+                Color4F(1.0f, 0.15f, 0.1f, 0.15f + heat * 0.5f));
+        }
+    }
+    _gridMap->addChild(heatmap, 50);
+    heatmap->runAction(Sequence::create(
+        DelayTime::create(kLayoutHeatmapDuration),
+        RemoveSelf::create(),
+        nullptr));
 }
 
-void BaseScene::handleExportReplay() {
+void BaseScene::handleImportBaseAttack() {
     auto* shareMgr = BattleShareManager::getInstance();
     if (!shareMgr) {
         updateAsyncStatus("Share manager unavailable.");
         return;
     }
-    std::string path;
-    if (shareMgr->exportLastReplay(&path)) {
-        updateAsyncStatus("Replay exported to: " + path);
-    }
-    else {
-        updateAsyncStatus("Export failed: finish a battle first.");
-    }
+    updateAsyncStatus("Loading target base...");
+    this->retain();
+    shareMgr->loadIncomingSnapshot([this, shareMgr](bool ok, const BaseSnapshot& snapshot) {
+        if (!isRunning()) {
+            this->release();
+            return;
+        }
+        if (!ok) {
+            updateAsyncStatus("Failed to load the target base snapshot. See the log for details.");
+            this->release();
+            return;
+        }
+        shareMgr->setActiveTargetSnapshot(snapshot);
+        auto deployUnits = UnitManager::getInstance()->getTrainedUnits();
+        bool allowDefault = deployUnits.empty();
+        auto scene = BattleScene::createSnapshotScene(snapshot, deployUnits, allowDefault);
+        if (!scene) {
+            updateAsyncStatus("Failed to create battle scene from the snapshot.");
+            this->release();
+            return;
+        }
+        updateAsyncStatus("Target base loaded. Ready to attack.");
+        Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+        this->release();
+    });
 }
 
-void BaseScene::handleImportReplay() {
+void BaseScene::handleExportReplay() {
     auto* shareMgr = BattleShareManager::getInstance();
     if (!shareMgr) {
         updateAsyncStatus("Share manager unavailable.");
         return;
     }
-    BattleReplay replay;
-    if (!shareMgr->loadIncomingReplay(&replay)) {
-        updateAsyncStatus("Failed to load target_replay.json.");
-        return;
-    }
-    auto scene = BattleScene::createReplayScene(replay);
-    if (!scene) {
-        updateAsyncStatus("Unable to create replay scene.");
+    updateAsyncStatus("Exporting replay...");
+    this->retain();
+    shareMgr->exportLastReplay([this](bool ok, const std::string& path) {
+        if (isRunning()) {
+            if (ok) {
+                updateAsyncStatus("Replay exported to: " + path);
+            }
+            else {
+                updateAsyncStatus("Export failed: finish a battle first.");
+            }
+        }
+        this->release();
+    });
+}
+
+void BaseScene::handleImportReplay() {
+    auto* shareMgr = BattleShareManager::getInstance();
+    if (!shareMgr) {
+        updateAsyncStatus("Share manager unavailable.");
         return;
     }
-    updateAsyncStatus("Replay file loaded. Ready to play.");
-    Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+    updateAsyncStatus("Loading replay file...");
+    this->retain();
+    shareMgr->loadIncomingReplay([this](bool ok, const BattleReplay& replay) {
+        if (!isRunning()) {
+            this->release();
+            return;
+        }
+        if (!ok) {
+            updateAsyncStatus("Failed to load target_replay.json.");
+            this->release();
+            return;
+        }
+        auto scene = BattleScene::createReplayScene(replay);
+        if (!scene) {
+            updateAsyncStatus("Unable to create replay scene.");
+            this->release();
+            return;
+        }
+        updateAsyncStatus("Replay file loaded. Ready to play.");
+        Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+        this->release();
+    });
 }
 
 // ==================== 基地建筑初始化 ====================
@@ -1303,6 +1505,7 @@ void BaseScene::savePlacedBuilding(const BuildingOption& option, int gridX, int
     s_savedBuildings.push_back(saved);
     if (building) {
         building->setTag(static_cast<int>(kSavedBuildingTagBase + s_savedBuildings.size() - 1));
+        settleSavedProduction(building);
     }
 }
 
@@ -1313,10 +1516,21 @@ void BaseScene::restoreSavedBuildings() {
 
     float cellSize = _gridMap->getCellSize();
     for (size_t i = 0; i < s_savedBuildings.size(); ++i) {
-        const auto& saved = s_savedBuildings[i];
+        auto& saved = s_savedBuildings[i];
         const auto& option = saved.option;
         if (!_gridMap->canPlaceBuilding(saved.gridX, saved.gridY, option.gridWidth, option.gridHeight)) {
-            continue;
+            // 存档位置已被占用或越界（如布局/网格尺寸变化）：就近安置并更新存档坐标，而不是丢弃
+            int freeX = 0;
+            int freeY = 0;
+            if (!_gridMap->findNearestFreeSpot(saved.gridX, saved.gridY, option.gridWidth, option.gridHeight,
+                                               &freeX, &freeY)) {
+                CCLOG("[基地场景] 存档建筑无处安置: %s", option.name.c_str());
+                continue;
+            }
+            CCLOG("[基地场景] 存档建筑 %s 从 (%d, %d) 移到 (%d, %d)",
+                option.name.c_str(), saved.gridX, saved.gridY, freeX, freeY);
+            saved.gridX = freeX;
+            saved.gridY = freeY;
         }
 
         Node* building = createBuildingFromOption(option, saved.level);
@@ -1333,6 +1547,23 @@ void BaseScene::restoreSavedBuildings() {
         if (auto* trap = dynamic_cast<TrapBase*>(building)) {
             trap->setGridContext(_gridMap, saved.gridX, saved.gridY, option.gridWidth, option.gridHeight);
         }
+        if (auto* production = dynamic_cast<ProductionBuilding*>(building)) {
+            production->setProduceTimestamp(saved.produceTimestampMs);
+            settleSavedProduction(production);
+        }
+    }
+}
+
+void BaseScene::settleSavedProduction(Node* building) {
+    // 按墙钟时间结算产出（含离线时段），并把计时起点写回存档数据
+    auto* production = dynamic_cast<ProductionBuilding*>(building);
+    if (!production) {
+        return;
+    }
+    production->settleProduction();
+    int savedIndex = getSavedBuildingIndex(production);
+    if (savedIndex >= 0) {
+        s_savedBuildings[static_cast<size_t>(savedIndex)].produceTimestampMs = production->getProduceTimestamp();
     }
 }
 
@@ -1340,6 +1571,14 @@ void BaseScene::setupProductionCollect(ProductionBuilding* building) {
     if (!building) {
         return;
     }
+    // 自动入账的产出建筑由 EconomyScheduler 定时结算，计时起点同样要写回存档
+    building->setSettleCallback([this](ProductionBuilding* source) {
+        int savedIndex = getSavedBuildingIndex(source);
+        if (savedIndex >= 0) {
+            s_savedBuildings[static_cast<size_t>(savedIndex)].produceTimestampMs = source->getProduceTimestamp();
+        }
+    });
+
     int id = building->getId();
     const std::string& name = building->getName();
     bool isCollector = (id == 3003 || id == 3004 || name == "GoldMaker" || name == "DiamondMaker");
@@ -1347,7 +1586,11 @@ void BaseScene::setupProductionCollect(ProductionBuilding* building) {
         return;
     }
 
-    building->setCollectCallback([this](ProductionBuilding*, ResourceType type, int amount, const Vec2& worldPos) {
+    building->setCollectCallback([this](ProductionBuilding* source, ResourceType type, int amount, const Vec2& worldPos) {
+        int savedIndex = getSavedBuildingIndex(source);
+        if (savedIndex >= 0) {
+            s_savedBuildings[static_cast<size_t>(savedIndex)].produceTimestampMs = source->getProduceTimestamp();
+        }
         Core::getInstance()->addResource(type, amount);
         if (_uiPanel) {
             _uiPanel->updateResourceDisplay(
@@ -1411,45 +1654,17 @@ bool BaseScene::onTouchBegan(Touch* touch, Event* event) {
         return true;
     }
 
-    // 检查是否点击了兵营建筑
-    Vec2 touchPos = touch->getLocation();
-    Vec2 localInLayer = _buildingLayer->convertToNodeSpace(touchPos);
-
-    auto& buildings = _buildingLayer->getChildren();
-    for (auto& child : buildings) {
-        auto building = dynamic_cast<ProductionBuilding*>(child);
-        if (!building) continue;
-
-        // 使用建筑子精灵包围盒做点击检测，避免Node尺寸为0导致失效
-        bool isHit = false;
-        Sprite* bodySprite = nullptr;
-        for (auto& bChild : building->getChildren()) {
-            bodySprite = dynamic_cast<Sprite*>(bChild);
-            if (bodySprite) break;
-        }
-
-        if (bodySprite) {
-            // 使用世界坐标转到建筑本地坐标，避免坐标系不一致导致点击失效
-            Vec2 localInBuilding = building->convertToNodeSpace(touchPos);
-            Rect spriteBox = bodySprite->getBoundingBox();
-            isHit = spriteBox.containsPoint(localInBuilding);
-        }
-        else {
-            isHit = building->getBoundingBox().containsPoint(localInLayer);
-        }
-
-        if (isHit) {
-            // 只有兵营（SoldierBuilder, ID=3002）才打开训练面板
-            if (building->getId() == 3002 || building->getName() == "SoldierBuilder") {
-                CCLOG("[基地场景] 点击兵营，打开训练面板");
-                showTrainPanel();
-                return true;
-            }
-            else {
-                CCLOG("[基地场景] 点击建筑: %s (ID: %d)",
-                    building->getName().c_str(), building->getId());
-            }
+    // 检查是否点击了兵营建筑（与悬浮共用网格拾取）
+    auto* building = dynamic_cast<ProductionBuilding*>(pickBuildingAt(touch->getLocation()));
+    if (building) {
+        // 只有兵营（SoldierBuilder, ID=3002）才打开训练面板
+        if (building->getId() == 3002 || building->getName() == "SoldierBuilder") {
+            CCLOG("[基地场景] 点击兵营，打开训练面板");
+            showTrainPanel();
+            return true;
         }
+        CCLOG("[基地场景] 点击建筑: %s (ID: %d)",
+            building->getName().c_str(), building->getId());
     }
 
     return false;
@@ -1532,20 +1747,26 @@ void BaseScene::updateHoverInfo(const Vec2& worldPos) {
 }
 
 Node* BaseScene::pickBuildingAt(const Vec2& worldPos) const {
-    if (!_buildingLayer) {
+    if (!_buildingLayer || !_gridMap) {
         return nullptr;
     }
 
-    for (auto* child : _buildingLayer->getChildren()) {
-        if (!child) {
+    // 按网格取光标附近的候选（拆除/移动建筑时会释放占地，网格与场景一致），只对候选做精灵测试
+    Vec2 gridPos = _gridMap->worldToGrid(_gridMap->convertToNodeSpace(worldPos));
+    std::vector<Node*> candidates;
+    _gridMap->collectBuildingsAround(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y),
+        kPickSideCells, kPickBelowCells, candidates);
+
+    for (auto* candidate : candidates) {
+        if (candidate->getParent() != _buildingLayer) {
             continue;
         }
-        if (dynamic_cast<DefenceBuilding*>(child)
-            || dynamic_cast<ProductionBuilding*>(child)
-            || dynamic_cast<StorageBuilding*>(child)
-            || dynamic_cast<TrapBase*>(child)) {
-            if (NodeUtils::hitTestBuilding(child, worldPos)) {
-                return child;
+        if (dynamic_cast<DefenceBuilding*>(candidate)
+            || dynamic_cast<ProductionBuilding*>(candidate)
+            || dynamic_cast<StorageBuilding*>(candidate)
+            || dynamic_cast<TrapBase*>(candidate)) {
+            if (NodeUtils::hitTestBuilding(candidate, worldPos)) {
+                return candidate;
             }
         }
     }
@@ -27,6 +27,7 @@
 #include "Scenes/Components/PlacementManager.h"
 #include "Scenes/Components/BaseUIPanel.h"
 #include "Scenes/Components/GridBackground.h"
+#include "Scenes/Components/MapCamera.h"
 
 USING_NS_CC;
 using namespace cocos2d::ui;
@@ -37,6 +38,8 @@ class BuildShopPanel;
 class PlacementManager;
 class BaseUIPanel;
 class GridBackground;
+struct LayoutEvaluation;
+struct BattleReplay;
 enum class ResourceType;
 
 struct BaseSavedBuilding {
@@ -44,6 +47,7 @@ struct BaseSavedBuilding {
     int gridX = 0;
     int gridY = 0;
     int level = 0;
+    int64_t produceTimestampMs = 0;     // 产出建筑上次结算的墙钟时间（毫秒）
 };
 
 /**
@@ -71,6 +75,8 @@ public:
      * @return 初始化是否成功
      */
     virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
 
     CREATE_FUNC(BaseScene);
 
@@ -78,6 +84,8 @@ public:
     static Vec2 getBaseAnchorGrid();
     static Vec2 getBarracksAnchorGrid();
     static int getBarracksLevel();
+    static int getBaseGridWidth();
+    static int getBaseGridHeight();
     static void applySavedState(const std::vector<BaseSavedBuilding>& buildings,
                                 const Vec2& baseAnchor,
                                 const Vec2& barracksAnchor,
@@ -90,6 +98,7 @@ private:
     GridMap* _gridMap = nullptr;                   // 网格地图，管理建筑位置
     Node* _buildingLayer = nullptr;                // 建筑层，所有建筑的父节点
     GridBackground* _gridBackground = nullptr;     // 网格背景组件
+    MapCamera* _mapCamera = nullptr;               // 地图视角控制（平移/缩放/视口裁剪）
     BaseUIPanel* _uiPanel = nullptr;               // UI面板组件
     BuildShopPanel* _buildShopPanel = nullptr;     // 建筑商店面板组件
     PlacementManager* _placementManager = nullptr; // 建筑放置管理器组件
@@ -236,6 +245,7 @@ private:
      */
     void scaleBuildingToFit(Node* building, int gridWidth, int gridHeight, float cellSize);
     void setupProductionCollect(ProductionBuilding* building);
+    void settleSavedProduction(Node* building);
     void playCollectEffect(ResourceType type, int amount, const Vec2& worldPos);
     static Node* buildBuildingFromOption(const BuildingOption& option, BaseScene* owner, int level);
 
@@ -292,6 +302,9 @@ private:
         const Color4B& pressedColor = Color4B(90, 90, 90, 255));
     void handleExportBase();
     void handleImportBaseAttack();
+    void handleEvaluateLayout();
+    void evaluateLayoutWith(const BattleReplay* replay);
+    void showLayoutHeatmap(const LayoutEvaluation& evaluation);
     void handleExportReplay();
     void handleImportReplay();
 };
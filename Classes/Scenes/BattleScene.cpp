@@ -11,20 +11,30 @@
 #include "BattleScene.h"
 #include "BaseScene.h"
 #include "Core/Core.h"
+#include "Core/CombatRules.h"
 #include "Save/SaveManager.h"
+#include "Share/SnapshotPlacement.h"
 #include "Buildings/BuildingManager.h"
+#include "Buildings/LevelLayout.h"
 #include "Buildings/DefenceBuilding.h"
 #include "Buildings/ProductionBuilding.h"
 #include "Buildings/StorageBuilding.h"
 #include "Buildings/Trap.h"
+#include "Map/BattleSpace.h"
+#include "Replay/BattleStateHash.h"
 #include "Soldier/UnitManager.h"
+#include "Utils/AnimationRegistry.h"
 #include "Utils/AnimationUtils.h"
 #include "Utils/AudioManager.h"
+#include "Utils/FixedMath.h"
 #include "Utils/GameSettings.h"
 #include "Utils/NodeUtils.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <ctime>
+#include <limits>
+#include <unordered_map>
 
 USING_NS_CC;
 
@@ -34,16 +44,43 @@ constexpr float kHoverPanelPaddingY = 14.0f;
 constexpr float kHoverPanelMinWidth = 260.0f;
 constexpr float kHoverPanelMinHeight = 140.0f;
 constexpr float kHoverPanelOffsetX = 16.0f;
+// 拾取时在光标所在格左右各看 1 列、向下看 3 行（覆盖高出占地的建筑精灵）
+constexpr int kPickSideCells = 1;
+constexpr int kPickBelowCells = 3;
 constexpr int kMaxLevelId = 12;
 constexpr int kDefenseLevelOffset = 100;
 constexpr int kDefenseMaxLevelId = 6;
-constexpr int kEnemyMaxBuildingLevel = 2;
 constexpr int kKingUnitId = 1007;
-constexpr int kTowerArrow = 1;
-constexpr int kTowerBoom = 2;
-constexpr int kTowerDoubleBoom = 3;
-constexpr int kTowerMagic = 4;
-constexpr int kTowerFire = 5;
+// 防守出兵上限：每个模拟帧最多出兵数量，超出部分顺延到下一帧
+constexpr int kDefenseSpawnsPerFrame = 4;
+// 加载关卡时预建的来袭士兵数量；战斗中每个渲染帧最多预建的数量与耗时
+constexpr int kDefensePrewarmOnLoad = 12;
+constexpr int kDefensePrewarmPerFrame = 4;
+constexpr double kDefensePrewarmBudgetMs = 2.0;
+// 对象池中每个兵种保持的可用士兵数量
+constexpr int kDefensePoolTarget = 4;
+// 防守出兵点（格子坐标），-1 表示贴地图最右列/最上行
+const int kDefenseSpawnPoints[][2] = {
+    {2, 4}, {2, 12}, {2, 20}, {2, -1},
+    {-1, 4}, {-1, 12}, {-1, 20}, {-1, -1},
+    {8, 2}, {18, 2}, {28, 2},
+    {8, -1}, {18, -1}, {28, -1}
+};
+constexpr int kDefenseSpawnPointCount = static_cast<int>(sizeof(kDefenseSpawnPoints) / sizeof(kDefenseSpawnPoints[0]));
+// 压力测试：兵种轮换、每波人数、全部出兵所用时长与每帧出兵上限
+const int kStressUnitIds[] = { 1012, 1011, 1010, 1001, 1006, 1003 };
+constexpr int kStressWaveSize = 50;
+constexpr float kStressSpawnWindow = 20.0f;
+constexpr int kStressSpawnsPerFrame = 24;
+// 压力测试寻敌基准的重复轮数
+constexpr int kTargetingBenchmarkRounds = 20;
+// 压力测试定点/浮点对比的迭代次数
+constexpr int kFixedMathBenchmarkIterations = 200000;
+// 自动进攻规划的墙钟预算（毫秒）
+constexpr int kAutoAttackBudgetMs = 1500;
+// 加载阶段：简报期间每帧预热耗时上限，以及进攻部署前每个兵种预建的士兵数
+constexpr double kWarmupBudgetMs = 4.0;
+constexpr int kAttackPoolTarget = 4;
 
 const char* kBattleFont = "fonts/ScienceGothic.ttf";
 const Color4B kPauseBtnNormal(44, 110, 160, 220);
@@ -118,16 +155,6 @@ Button* createBattlePlainButton(const std::string& title,
     return button;
 }
 
-int resolveAttackTowerLevel(int levelId) {
-    if (levelId >= 7) {
-        return kEnemyMaxBuildingLevel;
-    }
-    if (levelId >= 4) {
-        return 1;
-    }
-    return 0;
-}
-
 cocos2d::Vec2 getHoverAnchorWorldPos(cocos2d::Node* building) {
     if (!building) {
         return cocos2d::Vec2::ZERO;
@@ -204,6 +231,52 @@ cocos2d::Rect getHoverKeepRect(cocos2d::Node* building,
     return cocos2d::Rect(minX, minY, maxX - minX, maxY - minY);
 }
 
+// 批量建造时的配置缓存：同一配置ID只查一次
+struct LayoutConfigCache {
+    std::unordered_map<int, const DefenceBuildingConfig*> defence;
+    std::unordered_map<int, const ProductionBuildingConfig*> production;
+    std::unordered_map<int, const StorageBuildingConfig*> storage;
+};
+
+template <typename Config, typename Lookup>
+const Config* cachedConfig(std::unordered_map<int, const Config*>& cache, int configId, Lookup lookup) {
+    auto it = cache.find(configId);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    const Config* config = lookup(configId);
+    cache.emplace(configId, config);
+    return config;
+}
+
+int clampBuildingLevel(int level, int maxLevel) {
+    return std::max(0, std::min(level, maxLevel));
+}
+
+Node* createLayoutBuilding(const BuildingOption& option, int level, LayoutConfigCache& cache) {
+    auto* manager = BuildingManager::getInstance();
+    switch (option.category) {
+    case BuildingCategory::Defence: {
+        auto* config = cachedConfig(cache.defence, option.configId,
+            [manager](int id) { return manager->getDefenceConfig(id); });
+        return config ? DefenceBuilding::create(config, clampBuildingLevel(level, config->MAXLEVEL)) : nullptr;
+    }
+    case BuildingCategory::Production: {
+        auto* config = cachedConfig(cache.production, option.configId,
+            [manager](int id) { return manager->getProductionConfig(id); });
+        return config ? ProductionBuilding::create(config, clampBuildingLevel(level, config->MAXLEVEL)) : nullptr;
+    }
+    case BuildingCategory::Storage: {
+        auto* config = cachedConfig(cache.storage, option.configId,
+            [manager](int id) { return manager->getStorageConfig(id); });
+        return config ? StorageBuilding::create(config, clampBuildingLevel(level, config->MAXLEVEL)) : nullptr;
+    }
+    case BuildingCategory::Trap:
+        return BaseScene::createBuildingFromOptionForDefense(option, level);
+    default:
+        return nullptr;
+    }
+}
 } // namespace
 
 // ===================================================
@@ -245,6 +318,22 @@ Scene* BattleScene::createReplayScene(const BattleReplay& replay) {
     return nullptr;
 }
 
+Scene* BattleScene::createStressScene(int armySize) {
+    auto scene = new (std::nothrow) BattleScene();
+    if (scene) {
+        scene->setLevelId(kDefenseLevelOffset + 1);
+        scene->_allowDefaultUnits = false;
+        scene->setBattleMode(BattleMode::Defense);
+        scene->_stressArmySize = std::max(1, armySize);
+        if (scene->init()) {
+            scene->autorelease();
+            return scene;
+        }
+    }
+    CC_SAFE_DELETE(scene);
+    return nullptr;
+}
+
 Scene* BattleScene::createSnapshotScene(const BaseSnapshot& snapshot,
     const std::map<int, int>& units,
     bool useDefaultUnits) {
@@ -269,7 +358,12 @@ Scene* BattleScene::createSnapshotScene(const BaseSnapshot& snapshot,
 // 初始化
 // ===================================================
 
+BattleScene::~BattleScene() {
+    CC_SAFE_RELEASE_NULL(_simScheduler);
+}
+
 bool BattleScene::init() {
+    _loadTimeline.start();
     if (!Scene::init()) {
         return false;
     }
@@ -285,9 +379,19 @@ bool BattleScene::init() {
 
     _soldiers.clear();
     _enemyBuildings.clear();
+    _entities.clear();
+    EntityTable::setActive(&_entities);
     _enemyBase = nullptr;
     _enemyBaseDestroyed = false;
+    _aliveSoldierCount = 0;
+    _remainingUnitTotal = 0;
+    _trapTriggerCount = 0;
     _battleTime = 0.0f;
+    _simTick = 0;
+    _simAccumulator = 0.0f;
+    if (!_simScheduler) {
+        _simScheduler = new (std::nothrow) Scheduler();
+    }
     _battleEnded = false;
     _battlePaused = false;
     _battleBriefing = false;
@@ -297,10 +401,21 @@ bool BattleScene::init() {
     _deadSoldierCount = 0;
     _resultLayer = nullptr;
     _pauseButton = nullptr;
+    _autoAttackButton = nullptr;
+    _autoPlanning = false;
+    _autoPlanEvents.clear();
+    _autoPlanIndex = 0;
+    _autoPlanStartTick = 0;
     _pauseOverlay = nullptr;
     _briefLayer = nullptr;
     _resultRewardCoin = 0;
     _resultRewardDiamond = 0;
+    _frameStats.reset();
+    _lastCrowdMs = 0.0f;
+    _targetingBenchmark.clear();
+    _warmupTasks.clear();
+    _warmupMs = 0.0f;
+    _warmupTaskCount = 0;
 
     CCLOG("[战斗场景] 初始化关卡 %d", _levelId);
     BuildingManager::getInstance()->loadConfigs();
@@ -328,22 +443,44 @@ bool BattleScene::init() {
     else {
         _remainingUnits = _deployableUnits;
     }
+    for (const auto& pair : _remainingUnits) {
+        _remainingUnitTotal += std::max(0, pair.second);
+    }
+    _loadTimeline.mark("config");
 
     // 初始化各个组件
     initGridMap();
+    _loadTimeline.mark("grid");
     initLevel();
+    _loadTimeline.mark("level");
+    if (_buildingLayer) {
+        for (auto* child : _buildingLayer->getChildren()) {
+            if (dynamic_cast<DefenceBuilding*>(child) || dynamic_cast<TrapBase*>(child)) {
+                attachToSimClock(child);
+            }
+        }
+    }
     // 绑定战斗对象列表，便于自动寻敌
     Soldier::setEnemyBuildings(&_enemyBuildings);
     DefenceBuilding::setEnemySoldiers(&_soldiers);
     TrapBase::setEnemySoldiers(&_soldiers);
+    initBattleEvents();
+    _targeting.setParallel(GameSettings::getParallelTargeting());
+    TargetingSystem::setActive(&_targeting);
+    _loadTimeline.mark("combat");
     initUI();
     initTouchListener();
-    initHoverInfo();
     initReplayState();
+    _loadTimeline.mark("ui");
     if (!_isReplay) {
         showBattleBriefing();
     }
     AudioManager::playBattleBgm(getRewardLevel());
+    _loadTimeline.mark("briefing");
+
+    // 悬浮面板、部署栏动画图标与池预热挪到简报期间分帧完成
+    queueWarmupTasks();
+    CCLOG("[战斗场景] 场景构建 %s，延后 %d 项预热", _loadTimeline.buildReport().c_str(), _warmupTaskCount);
 
     // 设置更新
     this->scheduleUpdate();
@@ -382,6 +519,9 @@ void BattleScene::initGridMap() {
     _gridMap->setPosition(Vec2(offsetX, offsetY));
     _gridMap->setScale(scale);
     this->addChild(_gridMap, 0);
+    // 战斗几何（距离、包围盒、陷阱触发）统一使用地图局部坐标
+    _space.setRoot(_gridMap);
+    BattleSpace::setActive(&_space);
 
     auto bgColor = LayerColor::create(Color4B(50, 80, 50, 255), mapWidth, mapHeight);
     _gridMap->addChild(bgColor, -3);
@@ -405,14 +545,31 @@ void BattleScene::initGridMap() {
         setupDeployRangeHint();
     }
 
-    _buildingLayer = Node::create();
+    auto* buildingLayer = MapCamera::createLayerForMap(_gridMap, false);
+    _buildingLayer = buildingLayer;
     _gridMap->addChild(_buildingLayer, 5);
 
-    _soldierLayer = Node::create();
+    auto* soldierLayer = MapCamera::createLayerForMap(_gridMap, true);
+    _soldierLayer = soldierLayer;
     _gridMap->addChild(_soldierLayer, 10);
+    _crowd.setup(Rect(0.0f, 0.0f, mapWidth, mapHeight), CombatRules::kCrowdSeparationRadius);
 
     _gridMap->showGrid(GameSettings::getShowGrid());
 
+    // 视角控制：默认缩放即整图适配，可放大查看细节；只渲染视口内的建筑与士兵
+    Rect viewport(origin.x, origin.y + BattleConfig::UI_BOTTOM_HEIGHT, availableWidth, availableHeight);
+    _mapCamera = MapCamera::create(_gridMap, viewport, scale, std::max(scale, 1.5f));
+    if (_mapCamera) {
+        _mapCamera->addCulledLayer(buildingLayer);
+        _mapCamera->addCulledLayer(soldierLayer);
+        _mapCamera->addAnimationLodLayer(buildingLayer);
+        _mapCamera->addAnimationLodLayer(soldierLayer);
+        _mapCamera->setInputFilter([this]() {
+            return !_battlePaused && !_battleBriefing && !_battleEnded;
+        });
+        this->addChild(_mapCamera);
+    }
+
     CCLOG("[BattleScene] Grid map initialized");
 }
 
@@ -421,388 +578,79 @@ void BattleScene::initGridMap() {
 // 关卡初始化
 // ===================================================
 
+// 耗时计入场景构建报告的 level 阶段
 void BattleScene::initLevel() {
     if (_useSnapshotLayout) {
         createSnapshotLayout();
         CCLOG("[战斗场景] 使用基地快照生成敌方布局，共 %d 个建筑", _totalBuildingCount);
-        return;
     }
-
-    if (_battleMode == BattleMode::Defense) {
+    else if (isStressBattle()) {
+        createStressLevel();
+        CCLOG("[战斗场景] 压力测试初始化完成，来袭 %d 个单位，共 %d 个建筑", _stressArmySize, _totalBuildingCount);
+    }
+    else if (_battleMode == BattleMode::Defense) {
         int defenseId = getDefenseLevelIndex();
-        switch (defenseId) {
-        case 1:
-            createDefenseLevel1();
-            break;
-        case 2:
-            createDefenseLevel2();
-            break;
-        case 3:
-            createDefenseLevel3();
-            break;
-        case 4:
-            createDefenseLevel4();
-            break;
-        case 5:
-            createDefenseLevel5();
-            break;
-        case 6:
-            createDefenseLevel6();
-            break;
-        default:
-            createDefenseLevel1();
-            break;
-        }
-
+        createDefenseLevel(defenseId);
         CCLOG("[战斗场景] 防守关卡 %d 初始化完成，共 %d 个建筑", defenseId, _totalBuildingCount);
-        return;
-    }
-
-    // 根据关卡ID创建不同的关卡
-    switch (_levelId) {
-    case 1:
-        createLevel1();
-        break;
-    case 2:
-        createLevel2();
-        break;
-    case 3:
-        createLevel3();
-        break;
-    case 4:
-        createLevel4();
-        break;
-    case 5:
-        createLevel5();
-        break;
-    case 6:
-        createLevel6();
-        break;
-    case 7:
-        createLevel7();
-        break;
-    case 8:
-        createLevel8();
-        break;
-    case 9:
-        createLevel9();
-        break;
-    case 10:
-        createLevel10();
-        break;
-    case 11:
-        createLevel11();
-        break;
-    case 12:
-        createLevel12();
-        break;
-    default:
-        createLevel1();
-        break;
-    }
-
-    CCLOG("[战斗场景] 关卡 %d 初始化完成，共 %d 个建筑", _levelId, _totalBuildingCount);
-}
-
-// ===================================================
-// 创建第1关 - 入门试炼：双箭护卫
-// ===================================================
-
-void BattleScene::createLevel1() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 教学关：宽松的箭塔与地刺引导
-    createDefenseTower(16, 8, kTowerArrow, towerLevel);
-    createDefenseTower(16, 18, kTowerArrow, towerLevel);
-    createDefenseTower(18, 12, kTowerBoom, towerLevel);
-
-    for (int x = 10; x <= 14; ++x) {
-        createSpikeTrap(x, 13);
-    }
-    createSnapTrap(12, 10);
-}
-
-// ===================================================
-// 创建第2关 - 交叉火力走廊
-// ===================================================
-
-void BattleScene::createLevel2() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 交叉火力走廊：箭塔与炮塔组合
-    createDefenseTower(14, 6, kTowerArrow, towerLevel);
-    createDefenseTower(14, 22, kTowerArrow, towerLevel);
-    createDefenseTower(18, 14, kTowerBoom, towerLevel);
-    createDefenseTower(20, 12, kTowerMagic, towerLevel);
-
-    for (int x = 8; x <= 18; ++x) {
-        createSpikeTrap(x, 10);
-        createSpikeTrap(x, 18);
     }
-    createSnapTrap(10, 12);
-    createSnapTrap(10, 16);
-}
-
-// ===================================================
-// 创建第3关 - 陷阱方阵
-// ===================================================
-
-void BattleScene::createLevel3() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 陷阱方阵：环形/棋盘陷阱并辅以双管炮
-    createDefenseTower(12, 8, kTowerArrow, towerLevel);
-    createDefenseTower(12, 20, kTowerArrow, towerLevel);
-    createDefenseTower(18, 12, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(20, 20, kTowerMagic, towerLevel);
-
-    for (int x = 8; x <= 18; ++x) {
-        for (int y = 10; y <= 20; ++y) {
-            if ((x + y) % 2 == 0) {
-                createSpikeTrap(x, y);
-            }
-        }
-    }
-    createSnapTrap(10, 14);
-    createSnapTrap(14, 16);
-}
-
-// ===================================================
-// 创建第4关 - 断层火力
-// ===================================================
-
-void BattleScene::createLevel4() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 断层火力：左右断层组合
-    createDefenseTower(10, 14, kTowerArrow, towerLevel);
-    createDefenseTower(16, 6, kTowerBoom, towerLevel);
-    createDefenseTower(16, 20, kTowerBoom, towerLevel);
-    createDefenseTower(20, 14, kTowerMagic, towerLevel);
-
-    for (int x = 8; x <= 20; ++x) {
-        if (x == 14) continue;
-        createSpikeTrap(x, 10);
-        createSpikeTrap(x, 18);
-    }
-    createSnapTrap(14, 12);
-    createSnapTrap(14, 16);
-}
-
-// ===================================================
-// 创建第5关 - 双管压制
-// ===================================================
-
-void BattleScene::createLevel5() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 双管压制：中心炮线与两翼箭塔
-    createDefenseTower(12, 6, kTowerArrow, towerLevel);
-    createDefenseTower(12, 22, kTowerArrow, towerLevel);
-    createDefenseTower(18, 8, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(18, 18, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(22, 14, kTowerFire, towerLevel);
-
-    for (int x = 8; x <= 22; ++x) {
-        createSpikeTrap(x, 11);
-        createSpikeTrap(x, 17);
-    }
-    for (int y = 12; y <= 16; ++y) {
-        createSpikeTrap(10, y);
-        createSpikeTrap(20, y);
+    else {
+        createAttackLevel(_levelId);
+        CCLOG("[战斗场景] 关卡 %d 初始化完成，共 %d 个建筑", _levelId, _totalBuildingCount);
     }
-    createSnapTrap(14, 14);
 }
 
 // ===================================================
-// 创建第6关 - 火焰走廊
+// 进攻关卡（布局见 res/levels_config.json）
 // ===================================================
 
-void BattleScene::createLevel6() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    createDefenseTower(10, 14, kTowerBoom, towerLevel);
-    createDefenseTower(16, 8, kTowerFire, towerLevel);
-    createDefenseTower(16, 18, kTowerFire, towerLevel);
-    createDefenseTower(20, 14, kTowerMagic, towerLevel);
-
-    for (int x = 6; x <= 20; ++x) {
-        if (x == 14) {
-            continue;
-        }
-        createSpikeTrap(x, 12);
+void BattleScene::createAttackLevel(int levelId) {
+    auto* library = LevelLayoutLibrary::getInstance();
+    library->load();
+    const LevelLayout* layout = library->getAttackLevel(levelId);
+    if (!layout) {
+        CCLOG("[战斗场景] 未找到关卡 %d 的布局，使用第1关", levelId);
+        layout = library->getAttackLevel(1);
     }
-    for (int x = 8; x <= 18; ++x) {
-        if (x == 14) {
-            continue;
-        }
-        if (x >= 10 && x <= 12) {
-            continue;
-        }
-        createSpikeTrap(x, 16);
+    if (layout) {
+        buildLevelLayout(*layout);
     }
-    createSnapTrap(14, 12);
-    createSnapTrap(14, 18);
 }
 
-// ===================================================
-// 创建第7关 - 极限交叉火力
-// ===================================================
-
-void BattleScene::createLevel7() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 超多火焰塔阵列（火焰为主的关卡）
-    for (int y = 6; y <= 20; y += 2) {
-        createDefenseTower(12, y, kTowerFire, towerLevel);
-        createDefenseTower(14, y, kTowerFire, towerLevel);
-        createDefenseTower(16, y, kTowerFire, towerLevel);
-        createDefenseTower(18, y, kTowerFire, towerLevel);
+void BattleScene::buildLevelLayout(const LevelLayout& layout) {
+    if (!_gridMap || !_buildingLayer) {
+        return;
     }
 
-    // 少量其他类型作点缀
-    createDefenseTower(20, 12, kTowerBoom, towerLevel);
-    createSnapTrap(10, 12);
-    createSpikeTrap(8, 14);
-}
-
-// ===================================================
-// 创建第8关 - 交错火网
-// ===================================================
-
-void BattleScene::createLevel8() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 交错火网：魔法与双管炮穿插
-    createDefenseTower(8, 14, kTowerArrow, towerLevel);
-    createDefenseTower(12, 6, kTowerMagic, towerLevel);
-    createDefenseTower(12, 22, kTowerMagic, towerLevel);
-    createDefenseTower(18, 8, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(18, 18, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(22, 14, kTowerFire, towerLevel);
+    auto* manager = BuildingManager::getInstance();
+    manager->loadConfigs();
 
-    for (int x = 8; x <= 20; ++x) {
-        if (x == 14) continue;
-        createSpikeTrap(x, 12);
-    }
-    for (int x = 10; x <= 18; ++x) {
-        if (x == 14) continue;
-        createSpikeTrap(x, 16);
-    }
-    for (int y = 10; y <= 18; ++y) {
-        createSpikeTrap(14, y);
+    // 敌方基地先占地，之后的建筑与它的重叠同样被校验
+    int baseId = manager->getEnemyBaseId();
+    if (baseId <= 0) {
+        baseId = 9001;
     }
-    createSnapTrap(12, 14);
-    createSnapTrap(16, 14);
-}
-
-// ===================================================
-// 创建第9关 - 究极地刺
-// ===================================================
-
-void BattleScene::createLevel9() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 超多地刺：大范围覆盖
-    for (int y = 6; y <= 22; ++y) {
-        for (int x = 6; x <= 20; ++x) {
-            // 密集但留出通路每5列一小间隙
-            if (x % 5 == 0) continue;
-            createSpikeTrap(x, y);
+    const auto* baseConfig = manager->getProductionConfig(baseId);
+    if (baseConfig) {
+        int baseX = static_cast<int>(std::round(layout.baseAnchor.x));
+        int baseY = static_cast<int>(std::round(layout.baseAnchor.y));
+        auto base = ProductionBuilding::create(baseConfig, clampBuildingLevel(layout.towerLevel, baseConfig->MAXLEVEL));
+        if (base) {
+            float cellSize = _gridMap->getCellSize();
+            _buildingLayer->addChild(base);
+            base->setPosition(Vec2((baseX + baseConfig->width * 0.5f) * cellSize,
+                                   (baseY + baseConfig->length * 0.5f) * cellSize));
+            scaleBuildingToFit(base, baseConfig->width, baseConfig->length, cellSize);
+            _gridMap->occupyCell(baseX, baseY, baseConfig->width, baseConfig->length, base);
+
+            _entities.insert(EntityKind::BUILDING, _enemyBuildings, base);
+            base->retain();
+            _totalBuildingCount++;
+            _enemyBase = base;
+            _enemyBaseDestroyed = false;
         }
     }
 
-    // 支撑性防御塔
-    createDefenseTower(22, 10, kTowerArrow, towerLevel);
-    createDefenseTower(22, 14, kTowerMagic, towerLevel);
-}
-
-// ===================================================
-// 创建第10关 - 双管炮的极意
-// ===================================================
-
-void BattleScene::createLevel10() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 双管炮密集阵：侧翼与中路重炮
-    createDefenseTower(10, 6, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(10, 20, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(16, 6, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(16, 20, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(14, 12, kTowerDoubleBoom, towerLevel);
-    createDefenseTower(22, 12, kTowerFire, towerLevel);
-
-    for (int x = 6; x <= 20; ++x) {
-        if (x == 14) continue;
-        createSpikeTrap(x, 10);
-        createSpikeTrap(x, 18);
-    }
-    for (int y = 11; y <= 17; ++y) {
-        createSpikeTrap(12, y);
-    }
-    createSnapTrap(14, 10);
-    createSnapTrap(14, 18);
-}
-
-// ===================================================
-// 创建第11关 - 夺命连环箭
-// ===================================================
-
-void BattleScene::createLevel11() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 夺命连环箭：多列箭塔压制并穿插地刺
-    createDefenseTower(8, 6, kTowerArrow, towerLevel);
-    createDefenseTower(12, 6, kTowerArrow, towerLevel);
-    createDefenseTower(16, 6, kTowerArrow, towerLevel);
-    createDefenseTower(8, 22, kTowerArrow, towerLevel);
-    createDefenseTower(12, 22, kTowerArrow, towerLevel);
-    createDefenseTower(16, 22, kTowerArrow, towerLevel);
-
-    for (int x = 6; x <= 22; ++x) {
-        createSpikeTrap(x, 12);
-        createSpikeTrap(x, 18);
-    }
-    createSnapTrap(10, 14);
-    createSnapTrap(14, 14);
-    createSnapTrap(18, 14);
-}
-
-// ===================================================
-// 创建第12关 - 地狱的火焰
-// ===================================================
-
-void BattleScene::createLevel12() {
-    int towerLevel = resolveAttackTowerLevel(_levelId);
-    createEnemyBase(26, 12, towerLevel);
-
-    // 最后一关：先三列夹子（snap trap），然后每类防御塔各一列
-    // 三列夹子（x=6,8,10）覆盖纵向
-    for (int y = 6; y <= 22; ++y) {
-        createSnapTrap(6, y);
-        createSnapTrap(8, y);
-        createSnapTrap(10, y);
-    }
-
-    // 每类防御塔各一列（arrow, boom, doubleboom, magic, fire）
-    for (int y = 6; y <= 22; y+=3) {
-        createDefenseTower(14, y, kTowerArrow, towerLevel);
-        createDefenseTower(16, y, kTowerBoom, towerLevel);
-        createDefenseTower(18, y, kTowerDoubleBoom, towerLevel);
-        createDefenseTower(20, y, kTowerMagic, towerLevel);
-        createDefenseTower(22, y, kTowerFire, towerLevel);
-    }
+    placeBuildingsInBulk(layout.buildings, 0, 0, layout.allowOverlap);
 }
 
 // ===================================================
@@ -830,350 +678,172 @@ void BattleScene::buildSnapshotLayout(const BaseSnapshot& snapshot) {
         return;
     }
 
+    // 摆放与校验与 LayoutEvaluator 共用 SnapshotPlacement，这里只负责生成节点
+    SnapshotPlacement placement = SnapshotPlacement::compute(snapshot, _gridMap->getBlockedBits());
     auto* manager = BuildingManager::getInstance();
-    manager->loadConfigs();
-
     const float cellSize = _gridMap->getCellSize();
 
-    int baseId = manager->getMainBaseId();
-    if (baseId <= 0) {
-        baseId = 3001;
-    }
-    const auto* baseConfig = manager->getProductionConfig(baseId);
-    int baseWidth = baseConfig ? baseConfig->width : 4;
-    int baseHeight = baseConfig ? baseConfig->length : 4;
-    int defenseBaseX = BattleConfig::GRID_WIDTH / 2 - baseWidth / 2;
-    int defenseBaseY = BattleConfig::GRID_HEIGHT / 2 - baseHeight / 2;
-    if (defenseBaseX < 0) defenseBaseX = 0;
-    if (defenseBaseY < 0) defenseBaseY = 0;
-
-    int anchorX = static_cast<int>(std::round(snapshot.baseAnchor.x));
-    int anchorY = static_cast<int>(std::round(snapshot.baseAnchor.y));
-    int offsetX = defenseBaseX - anchorX;
-    int offsetY = defenseBaseY - anchorY;
-
-    auto registerBuilding = [this](Node* building, bool isBase) {
+    std::vector<const BaseSavedBuilding*> saved;
+    std::vector<GridFootprint> footprints;
+    saved.reserve(placement.buildings.size());
+    footprints.reserve(placement.buildings.size());
+    for (const auto& placed : placement.buildings) {
+        if (placed.role == PlacedSnapshotBuilding::Role::SAVED) {
+            GridFootprint footprint;
+            footprint.x = placed.gridX;
+            footprint.y = placed.gridY;
+            footprint.width = placed.width;
+            footprint.height = placed.height;
+            saved.push_back(placed.saved);
+            footprints.push_back(footprint);
+            continue;
+        }
+
+        auto* building = manager->createProductionBuilding(placed.configId, placed.level);
         if (!building) {
-            return;
+            continue;
         }
-        _enemyBuildings.push_back(building);
+        _buildingLayer->addChild(building);
+        building->setPosition(Vec2((placed.gridX + placed.width * 0.5f) * cellSize,
+                                   (placed.gridY + placed.height * 0.5f) * cellSize));
+        scaleBuildingToFit(building, placed.width, placed.height, cellSize);
+        _gridMap->occupyCell(placed.gridX, placed.gridY, placed.width, placed.height, building);
+
+        _entities.insert(EntityKind::BUILDING, _enemyBuildings, building);
         building->retain();
         _totalBuildingCount++;
-        if (isBase) {
+        if (placed.role == PlacedSnapshotBuilding::Role::BASE) {
             _enemyBase = building;
             _enemyBaseDestroyed = false;
         }
-    };
-
-    auto placeBuilding = [this, cellSize, &registerBuilding](Node* building,
-        int gridX,
-        int gridY,
-        int width,
-        int height,
-        bool isBase) {
-            if (!building) {
-                return;
-            }
-            if (!_gridMap->canPlaceBuilding(gridX, gridY, width, height)) {
-                return;
-            }
-
-            _buildingLayer->addChild(building);
-
-            float centerX = (gridX + width * 0.5f) * cellSize;
-            float centerY = (gridY + height * 0.5f) * cellSize;
-            building->setPosition(Vec2(centerX, centerY));
-
-            scaleBuildingToFit(building, width, height, cellSize);
-            _gridMap->occupyCell(gridX, gridY, width, height, building);
-
-            if (auto* trap = dynamic_cast<TrapBase*>(building)) {
-                trap->setGridContext(_gridMap, gridX, gridY, width, height);
-                return;
-            }
-
-            registerBuilding(building, isBase);
-    };
-
-    int baseLevel = snapshot.baseLevel;
-    if (baseLevel < 0) {
-        baseLevel = 0;
-    }
-    if (baseConfig && baseLevel > baseConfig->MAXLEVEL) {
-        baseLevel = baseConfig->MAXLEVEL;
     }
-    auto base = manager->createProductionBuilding(baseId, baseLevel);
-    placeBuilding(base, defenseBaseX, defenseBaseY, baseWidth, baseHeight, true);
+    spawnPlacedBuildings(saved, footprints);
 
-    int barracksId = manager->getBarracksId();
-    if (barracksId <= 0) {
-        barracksId = 3002;
+    if (!placement.isClean()) {
+        CCLOG("[战斗场景] 快照布局校验：越界 %d 个，重叠 %d 个已跳过",
+            placement.outOfBounds, placement.overlapped);
     }
-    const auto* barracksConfig = manager->getProductionConfig(barracksId);
-    int barracksWidth = barracksConfig ? barracksConfig->width : 5;
-    int barracksHeight = barracksConfig ? barracksConfig->length : 5;
+}
 
-    int barracksX = static_cast<int>(std::round(snapshot.barracksAnchor.x));
-    int barracksY = static_cast<int>(std::round(snapshot.barracksAnchor.y));
-    int defenseBarracksX = barracksX + offsetX;
-    int defenseBarracksY = barracksY + offsetY;
-    int barracksLevel = snapshot.barracksLevel;
-    if (barracksLevel < 0) {
-        barracksLevel = 0;
-    }
-    if (barracksConfig && barracksLevel > barracksConfig->MAXLEVEL) {
-        barracksLevel = barracksConfig->MAXLEVEL;
+void BattleScene::createDefenseLevel(int levelId) {
+    auto* library = LevelLayoutLibrary::getInstance();
+    library->load();
+    const LevelLayout* layout = library->getDefenseLevel(levelId);
+    if (!layout) {
+        CCLOG("[战斗场景] 未找到防守关卡 %d 的波次，使用第1关", levelId);
+        layout = library->getDefenseLevel(1);
     }
-    auto barracks = manager->createProductionBuilding(barracksId, barracksLevel);
-    placeBuilding(barracks, defenseBarracksX, defenseBarracksY, barracksWidth, barracksHeight, false);
-
-    for (const auto& saved : snapshot.buildings) {
-        const auto& option = saved.option;
-        int gridX = saved.gridX + offsetX;
-        int gridY = saved.gridY + offsetY;
-
-        Node* building = BaseScene::createBuildingFromOptionForDefense(option, saved.level);
-        if (!building) {
-            continue;
-        }
-
-        if (!_gridMap->canPlaceBuilding(gridX, gridY, option.gridWidth, option.gridHeight)) {
-            continue;
-        }
-
-        _buildingLayer->addChild(building);
-
-        float centerX = (gridX + option.gridWidth * 0.5f) * cellSize;
-        float centerY = (gridY + option.gridHeight * 0.5f) * cellSize;
-        building->setPosition(Vec2(centerX, centerY));
-
-        scaleBuildingToFit(building, option.gridWidth, option.gridHeight, cellSize);
-        _gridMap->occupyCell(gridX, gridY, option.gridWidth, option.gridHeight, building);
 
-        if (auto* trap = dynamic_cast<TrapBase*>(building)) {
-            trap->setGridContext(_gridMap, gridX, gridY, option.gridWidth, option.gridHeight);
-            continue;
+    createDefenseBaseLayout(layout ? layout->towerLevel : 0);
+    resetDefenseSpawns();
+    if (layout) {
+        for (const auto& wave : layout->waves) {
+            addDefenseWave(wave.unitId, wave.count, wave.interval, wave.delay);
         }
-
-        registerBuilding(building, false);
     }
 }
 
-void BattleScene::createDefenseLevel1() {
-    createDefenseBaseLayout(0);
-    resetDefenseSpawns();
-    addDefenseWave(1012, 6, 0.45f, 0.6f);
-    addDefenseWave(1011, 4, 0.55f, 1.0f);
-}
-
-void BattleScene::createDefenseLevel2() {
-    createDefenseBaseLayout(0);
-    resetDefenseSpawns();
-    addDefenseWave(1012, 6, 0.45f, 0.6f);
-    addDefenseWave(1010, 4, 0.55f, 0.8f);
-    addDefenseWave(1001, 4, 0.6f, 0.8f);
-}
-
-void BattleScene::createDefenseLevel3() {
-    createDefenseBaseLayout(1);
-    resetDefenseSpawns();
-    addDefenseWave(1011, 6, 0.45f, 0.6f);
-    addDefenseWave(1005, 4, 0.55f, 0.8f);
-    addDefenseWave(1004, 4, 0.55f, 0.8f);
-    addDefenseWave(1008, 3, 0.65f, 0.9f);
-}
-
-void BattleScene::createDefenseLevel4() {
-    createDefenseBaseLayout(1);
-    resetDefenseSpawns();
-    addDefenseWave(1006, 5, 0.5f, 0.6f);
-    addDefenseWave(1003, 4, 0.55f, 0.8f);
-    addDefenseWave(1001, 4, 0.6f, 0.8f);
-    addDefenseWave(1008, 4, 0.65f, 0.8f);
-}
-
-void BattleScene::createDefenseLevel5() {
-    // 倒数第二防守关卡：大量国王防守（60 个）
-    createDefenseBaseLayout(3);
-    resetDefenseSpawns();
-    // 放置 60 个国王作为主要波次
-    addDefenseWave(1007, 60, 0.5f, 0.8f);
-    // 小量辅助小兵
-    addDefenseWave(1009, 6, 0.7f, 1.0f);
-}
-
-void BattleScene::createDefenseLevel6() {
+void BattleScene::createStressLevel() {
+    // 兵力按固定人数切成多波，轮换兵种与出兵点，在固定时长内全部出完
     createDefenseBaseLayout(2);
     resetDefenseSpawns();
-    addDefenseWave(1001, 20, 0.55f, 0.6f);
-    addDefenseWave(1010, 20, 0.55f, 0.6f);
-    addDefenseWave(1011, 20, 0.55f, 0.6f);
-    addDefenseWave(1007, 20, 0.55f, 0.6f);
-    addDefenseWave(1009, 4, 0.7f, 0.8f);
-    addDefenseWave(1002, 4, 0.75f, 0.9f);
-    addDefenseWave(1003, 4, 0.55f, 0.8f);
-    addDefenseWave(1006, 4, 0.55f, 0.8f);
-}
-
-// ===================================================
-// 创建敌方基地
-// ===================================================
-
-void BattleScene::createEnemyBase(int gridX, int gridY, int level) {
-    auto* manager = BuildingManager::getInstance();
-    manager->loadConfigs();
-
-    int baseId = manager->getEnemyBaseId();
-    if (baseId <= 0) {
-        baseId = 9001;
-    }
-    const auto* baseConfig = manager->getProductionConfig(baseId);
-    int baseWidth = baseConfig ? baseConfig->width : 4;
-    int baseHeight = baseConfig ? baseConfig->length : 4;
-
-    int resolvedLevel = level;
-    if (resolvedLevel < 0) {
-        resolvedLevel = 0;
-    }
-    if (baseConfig && resolvedLevel > baseConfig->MAXLEVEL) {
-        resolvedLevel = baseConfig->MAXLEVEL;
-    }
-    auto base = manager->createProductionBuilding(baseId, resolvedLevel);
-    if (base) {
-        _buildingLayer->addChild(base);
-
-        float cellSize = _gridMap->getCellSize();
-        float centerX = (gridX + baseWidth * 0.5f) * cellSize;
-        float centerY = (gridY + baseHeight * 0.5f) * cellSize;
-        base->setPosition(Vec2(centerX, centerY));
-
-        scaleBuildingToFit(base, baseWidth, baseHeight, cellSize);
-
-        _gridMap->occupyCell(gridX, gridY, baseWidth, baseHeight, base);
-
-        _enemyBuildings.push_back(base);
-        base->retain();
-        _totalBuildingCount++;
-        _enemyBase = base;
-        _enemyBaseDestroyed = false;
-
-        CCLOG("[战斗场景] 敌方基地创建完成");
-    }
-}
-
-// ===================================================
-// 创建防御塔
-// ===================================================
-
-void BattleScene::createDefenseTower(int gridX, int gridY, int type, int level) {
-    auto* manager = BuildingManager::getInstance();
-    manager->loadConfigs();
-
-    int configId = manager->getBattleTowerConfigId(type);
-    if (configId <= 0) {
-        CCLOG("[战斗场景] 未找到防御塔配置类型: %d", type);
-        return;
-    }
-    const auto* towerConfig = manager->getDefenceConfig(configId);
-    if (!towerConfig) {
-        CCLOG("[战斗场景] 防御塔配置缺失: %d", configId);
-        return;
-    }
-
-    int towerWidth = towerConfig->width > 0 ? towerConfig->width : 3;
-    int towerHeight = towerConfig->length > 0 ? towerConfig->length : 3;
-
-    int resolvedLevel = level;
-    if (resolvedLevel < 0) {
-        resolvedLevel = 0;
-    }
-    if (resolvedLevel > towerConfig->MAXLEVEL) {
-        resolvedLevel = towerConfig->MAXLEVEL;
+    const int unitTypes = static_cast<int>(sizeof(kStressUnitIds) / sizeof(kStressUnitIds[0]));
+    float interval = kStressSpawnWindow / static_cast<float>(_stressArmySize);
+    int remaining = _stressArmySize;
+    for (int wave = 0; remaining > 0; ++wave) {
+        int count = std::min(remaining, kStressWaveSize);
+        addDefenseWave(kStressUnitIds[wave % unitTypes], count, interval, 0.0f,
+                       SpawnPattern::SPREAD, wave * 3);
+        remaining -= count;
+    }
+}
+
+// ===================================================
+// 批量放置建筑
+// ===================================================
+
+int BattleScene::placeBuildingsInBulk(const std::vector<BaseSavedBuilding>& buildings,
+                                      int offsetX, int offsetY, bool allowOverlap) {
+    // 1. 校验：以当前阻挡位图为起点一次遍历，越界剔除，重叠按 allowOverlap 剔除或保留
+    GridBitset occupied = _gridMap->getBlockedBits();
+    std::vector<GridFootprint> footprints;
+    std::vector<const BaseSavedBuilding*> accepted;
+    footprints.reserve(buildings.size());
+    accepted.reserve(buildings.size());
+    int outOfBounds = 0;
+    int overlapped = 0;
+    for (const auto& saved : buildings) {
+        GridFootprint footprint;
+        footprint.x = saved.gridX + offsetX;
+        footprint.y = saved.gridY + offsetY;
+        footprint.width = saved.option.gridWidth;
+        footprint.height = saved.option.gridHeight;
+        if (footprint.width <= 0 || footprint.height <= 0 || footprint.x < 0 || footprint.y < 0
+            || footprint.x + footprint.width > occupied.getWidth()
+            || footprint.y + footprint.height > occupied.getHeight()) {
+            outOfBounds++;
+            continue;
+        }
+        if (occupied.anyInRect(footprint.x, footprint.y, footprint.width, footprint.height)) {
+            overlapped++;
+            if (!allowOverlap) {
+                continue;
+            }
+        }
+        occupied.fillRect(footprint.x, footprint.y, footprint.width, footprint.height);
+        footprints.push_back(footprint);
+        accepted.push_back(&saved);
     }
 
-    auto tower = manager->createDefenceBuilding(configId, resolvedLevel);
-    if (tower) {
-        _buildingLayer->addChild(tower);
-
-        float cellSize = _gridMap->getCellSize();
-        float centerX = (gridX + towerWidth * 0.5f) * cellSize;
-        float centerY = (gridY + towerHeight * 0.5f) * cellSize;
-        tower->setPosition(Vec2(centerX, centerY));
-
-        scaleBuildingToFit(tower, towerWidth, towerHeight, cellSize);
-
-        _gridMap->occupyCell(gridX, gridY, towerWidth, towerHeight, tower);
-
-        _enemyBuildings.push_back(tower);
-        tower->retain();
-        _totalBuildingCount++;
-
-        CCLOG("[战斗场景] 防御塔创建完成 (类型%d)", type);
+    int placed = spawnPlacedBuildings(accepted, footprints);
+    if (outOfBounds > 0 || (overlapped > 0 && !allowOverlap)) {
+        CCLOG("[战斗场景] 布局校验：越界 %d 个，重叠 %d 个已跳过", outOfBounds, allowOverlap ? 0 : overlapped);
     }
+    return placed;
 }
 
-// ===================================================
-// 创建陷阱
-// ===================================================
-
-void BattleScene::createSpikeTrap(int gridX, int gridY) {
-    auto* trap = SpikeTrap::create();
-    if (!trap) {
-        return;
-    }
-
-    _buildingLayer->addChild(trap);
+int BattleScene::spawnPlacedBuildings(const std::vector<const BaseSavedBuilding*>& accepted,
+                                      std::vector<GridFootprint>& footprints) {
+    // 1. 按通过校验的数量预留容器
+    _enemyBuildings.reserve(_enemyBuildings.size() + accepted.size());
 
-    float cellSize = _gridMap->getCellSize();
-    float centerX = (gridX + 0.5f) * cellSize;
-    float centerY = (gridY + 0.5f) * cellSize;
-    trap->setPosition(Vec2(centerX, centerY));
-
-    scaleBuildingToFit(trap, 1, 1, cellSize);
-    _gridMap->occupyCell(gridX, gridY, 1, 1, trap);
-    trap->setGridContext(_gridMap, gridX, gridY, 1, 1);
-}
-
-void BattleScene::createSnapTrap(int gridX, int gridY) {
-    auto* trap = SnapTrap::create();
-    if (!trap) {
-        return;
-    }
-
-    _buildingLayer->addChild(trap);
-
-    float cellSize = _gridMap->getCellSize();
-    float centerX = (gridX + 0.5f) * cellSize;
-    float centerY = (gridY + 0.5f) * cellSize;
-    trap->setPosition(Vec2(centerX, centerY));
-
-    scaleBuildingToFit(trap, 1, 1, cellSize);
-    _gridMap->occupyCell(gridX, gridY, 1, 1, trap);
-    trap->setGridContext(_gridMap, gridX, gridY, 1, 1);
-}
-
-void BattleScene::addTrapCluster(int startX, int startY, int width, int height, const std::vector<Vec2>& snapCells) {
-    auto isSnapCell = [&snapCells](int x, int y) {
-        for (const auto& cell : snapCells) {
-            if (static_cast<int>(cell.x) == x && static_cast<int>(cell.y) == y) {
-                return true;
-            }
+    // 2. 批量创建节点（同一配置只查一次），最后统一写入网格
+    LayoutConfigCache cache;
+    const float cellSize = _gridMap->getCellSize();
+    std::vector<std::pair<TrapBase*, size_t>> traps;
+    size_t placed = 0;
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        const BaseSavedBuilding& saved = *accepted[i];
+        Node* building = createLayoutBuilding(saved.option, saved.level, cache);
+        if (!building) {
+            continue;
         }
-        return false;
-    };
+        GridFootprint footprint = footprints[i];
+        footprint.building = building;
+        footprints[placed] = footprint;
 
-    for (int x = startX; x < startX + width; ++x) {
-        for (int y = startY; y < startY + height; ++y) {
-            if (isSnapCell(x, y)) {
-                continue;
-            }
-            createSpikeTrap(x, y);
+        _buildingLayer->addChild(building);
+        building->setPosition(Vec2((footprint.x + footprint.width * 0.5f) * cellSize,
+                                   (footprint.y + footprint.height * 0.5f) * cellSize));
+        scaleBuildingToFit(building, footprint.width, footprint.height, cellSize);
+
+        if (auto* trap = dynamic_cast<TrapBase*>(building)) {
+            traps.emplace_back(trap, placed);
+        }
+        else {
+            _entities.insert(EntityKind::BUILDING, _enemyBuildings, building);
+            building->retain();
+            _totalBuildingCount++;
         }
+        placed++;
     }
-
-    for (const auto& cell : snapCells) {
-        createSnapTrap(static_cast<int>(cell.x), static_cast<int>(cell.y));
+    footprints.resize(placed);
+    _gridMap->occupyCells(footprints);
+    for (const auto& entry : traps) {
+        const GridFootprint& footprint = footprints[entry.second];
+        entry.first->setGridContext(_gridMap, footprint.x, footprint.y, footprint.width, footprint.height);
     }
+    return static_cast<int>(placed);
 }
 
 
@@ -1284,9 +954,135 @@ void BattleScene::initUI() {
     }
 
     setupPauseControls(topY);
+    setupAutoAttackButton();
     setupDeployArea();
 }
 
+// ===================================================
+// 自动进攻
+// ===================================================
+
+void BattleScene::setupAutoAttackButton() {
+    if (!_uiLayer || !_pauseButton || _isReplay || isStressBattle() || _battleMode != BattleMode::Attack) {
+        return;
+    }
+
+    constexpr float kAutoBtnWidth = 108.0f;
+    constexpr float kAutoBtnHeight = 34.0f;
+    constexpr float kAutoBtnGap = 8.0f;
+
+    _autoAttackButton = createBattlePlainButton("Auto",
+        16,
+        Size(kAutoBtnWidth, kAutoBtnHeight),
+        kStartBtnNormal,
+        kPauseBtnPressed);
+    if (!_autoAttackButton) {
+        _autoAttackButton = Button::create();
+    }
+    _autoAttackButton->setPosition(_pauseButton->getPosition() - Vec2(0.0f, kAutoBtnHeight + kAutoBtnGap));
+    _autoAttackButton->addClickEventListener([this](Ref*) {
+        AudioManager::playButtonClick();
+        startAutoAttack();
+    });
+    _uiLayer->addChild(_autoAttackButton, 10);
+}
+
+void BattleScene::startAutoAttack() {
+    if (_autoPlanning || _battleEnded || !_gridMap || _autoPlanIndex < _autoPlanEvents.size()) {
+        return;
+    }
+
+    AttackPlannerInput input;
+    for (auto* building : _enemyBuildings) {
+        PlannerBuilding planned;
+        if (AttackPlanner::describeBuilding(building, planned)) {
+            planned.isBase = (building == _enemyBase);
+            input.buildings.push_back(planned);
+        }
+    }
+    if (_buildingLayer) {
+        for (auto* child : _buildingLayer->getChildren()) {
+            PlannerTrap trap;
+            if (AttackPlanner::describeTrap(child, trap)) {
+                input.traps.push_back(trap);
+            }
+        }
+    }
+    for (const auto& entry : _remainingUnits) {
+        PlannerUnit unit;
+        if (entry.second > 0 && AttackPlanner::describeUnit(entry.first,
+                UnitManager::getInstance()->getUnitLevel(entry.first), unit)) {
+            input.units.push_back(unit);
+            input.counts[entry.first] = entry.second;
+        }
+    }
+    if (input.buildings.empty() || input.units.empty()) {
+        CCLOG("[战斗场景] 自动进攻：没有可用的兵种或目标");
+        return;
+    }
+    input.minGridX = BattleConfig::DEPLOY_MIN_X;
+    input.maxGridX = BattleConfig::DEPLOY_MAX_X;
+    input.minGridY = BattleConfig::DEPLOY_MIN_Y;
+    input.maxGridY = BattleConfig::DEPLOY_MAX_Y;
+    input.cellSize = _gridMap->getCellSize();
+    input.mapBounds = Rect(0.0f, 0.0f, BattleConfig::GRID_WIDTH * input.cellSize,
+        BattleConfig::GRID_HEIGHT * input.cellSize);
+    input.timeLimit = std::max(0.0f, BattleConfig::BATTLE_TIME_LIMIT - _battleTime);
+
+    AttackPlannerSettings settings;
+    settings.budgetMs = kAutoAttackBudgetMs;
+    settings.seed = static_cast<uint32_t>(_levelId * 7919 + _simTick);
+
+    _autoPlanning = true;
+    if (_autoAttackButton) {
+        _autoAttackButton->setTitleText("Planning...");
+        _autoAttackButton->setEnabled(false);
+    }
+
+    // 规划在后台执行，期间场景可能被切走；方案的 tick 相对于采样输入时的模拟帧
+    const int inputTick = _simTick;
+    this->retain();
+    AttackPlanner::planAsync(input, settings, [this, inputTick](const AttackPlannerResult& result) {
+        _autoPlanning = false;
+        if (isRunning() && !_battleEnded) {
+            applyAutoPlan(result, inputTick);
+        }
+        this->release();
+    });
+}
+
+void BattleScene::applyAutoPlan(const AttackPlannerResult& result, int inputTick) {
+    if (result.plans.empty()) {
+        if (_autoAttackButton) {
+            _autoAttackButton->setTitleText("No plan");
+            _autoAttackButton->setEnabled(true);
+        }
+        return;
+    }
+
+    const AttackPlan& best = result.plans.front();
+    CCLOG("[战斗场景] 自动进攻方案（%d 次模拟）: %s",
+        result.simulations, AttackPlanner::describePlan(best).c_str());
+    _autoPlanEvents = best.events;
+    _autoPlanIndex = 0;
+    _autoPlanStartTick = inputTick;
+    if (_autoAttackButton) {
+        _autoAttackButton->setTitleText(best.win ? "Auto: Win" : "Auto: Best");
+    }
+}
+
+void BattleScene::updateAutoPlan() {
+    // 与回放相同的约定：方案第 tick 帧之后部署，对应 _autoPlanStartTick + tick + 1 步开始前
+    while (_autoPlanIndex < _autoPlanEvents.size()) {
+        const auto& event = _autoPlanEvents[_autoPlanIndex];
+        if (_autoPlanStartTick + event.tick >= _simTick) {
+            break;
+        }
+        deploySoldier(event.unitId, _gridMap->gridToWorld(event.gridX, event.gridY));
+        _autoPlanIndex++;
+    }
+}
+
 // ===================================================
 // 暂停控制
 // ===================================================
@@ -1563,7 +1359,8 @@ void BattleScene::showBattleBriefing() {
         totalUnits += pair.second;
     }
 
-    std::string modeText = (_battleMode == BattleMode::Defense) ? "Defense" : "Attack";
+    std::string modeText = isStressBattle() ? "Stress Test"
+        : ((_battleMode == BattleMode::Defense) ? "Defense" : "Attack");
     std::string objectiveText = (_battleMode == BattleMode::Defense)
         ? "Hold until the timer ends."
         : "Destroy the enemy base.";
@@ -1573,7 +1370,7 @@ void BattleScene::showBattleBriefing() {
         : StringUtils::format("Enemy Buildings: %d (Towers %d / Traps %d / Resources %d)",
             _totalBuildingCount, towerCount, trapCount, resourceCount);
     std::string unitLine = (_battleMode == BattleMode::Defense)
-        ? StringUtils::format("Incoming Units: %d", _defenseTotalUnits)
+        ? StringUtils::format("Incoming Units: %d", _defenseWaves.getTotalUnits())
         : StringUtils::format("Deployable Units: %d", totalUnits);
     std::string timeLine = StringUtils::format("Time Limit: %s", formatTimeText(BattleConfig::BATTLE_TIME_LIMIT).c_str());
 
@@ -1632,6 +1429,7 @@ void BattleScene::hideBattleBriefing() {
         return;
     }
     _battleBriefing = false;
+    finishWarmup();
 
     if (_briefLayer) {
         _briefLayer->removeFromParent();
@@ -1647,6 +1445,95 @@ void BattleScene::hideBattleBriefing() {
     }
 }
 
+// ===================================================
+// 加载阶段预热
+// ===================================================
+
+void BattleScene::queueWarmupTasks() {
+    _warmupTasks.clear();
+
+    // 悬浮面板在简报期间不可用，先于其他任务补上
+    _warmupTasks.push_back([this]() { initHoverInfo(); });
+
+    for (const auto& pair : _deployButtons) {
+        int unitId = pair.first;
+        _warmupTasks.push_back([this, unitId]() { attachDeployIdleIcon(unitId); });
+    }
+
+    // 每种防御塔预载一次攻击序列帧、特效与子弹贴图
+    std::vector<const DefenceBuildingConfig*> towerConfigs;
+    bool hasTrap = false;
+    for (auto* building : _enemyBuildings) {
+        hasTrap = hasTrap || dynamic_cast<TrapBase*>(building) != nullptr;
+        auto* tower = dynamic_cast<DefenceBuilding*>(building);
+        const DefenceBuildingConfig* config = tower ? tower->getConfig() : nullptr;
+        if (config && std::find(towerConfigs.begin(), towerConfigs.end(), config) == towerConfigs.end()) {
+            towerConfigs.push_back(config);
+        }
+    }
+    for (const auto* config : towerConfigs) {
+        _warmupTasks.push_back([config]() { DefenceBuilding::preloadAssets(config); });
+    }
+    if (hasTrap) {
+        _warmupTasks.push_back([]() { TrapBase::preloadAssets(); });
+    }
+
+    // 出战兵种与首批来袭士兵预建进对象池
+    if (_battleMode == BattleMode::Defense || isStressBattle()) {
+        _warmupTasks.push_back([this]() { prewarmDefenseSpawns(kDefensePrewarmOnLoad); });
+    }
+    else {
+        for (const auto& pair : _remainingUnits) {
+            int unitId = pair.first;
+            int count = std::min(pair.second, kAttackPoolTarget);
+            if (count <= 0) {
+                continue;
+            }
+            _warmupTasks.push_back([this, unitId, count]() {
+                _soldierPool.prewarm(unitId, UnitManager::getInstance()->getUnitLevel(unitId), count);
+            });
+        }
+    }
+
+    _warmupTaskCount = static_cast<int>(_warmupTasks.size());
+    _warmupMs = 0.0f;
+    this->schedule([this](float) {
+        runWarmupStep(kWarmupBudgetMs);
+    }, "battleWarmup");
+}
+
+void BattleScene::runWarmupStep(double budgetMs) {
+    // 每帧至少执行一项，超出预算的部分顺延到下一帧
+    auto start = std::chrono::steady_clock::now();
+    while (!_warmupTasks.empty()) {
+        auto task = std::move(_warmupTasks.front());
+        _warmupTasks.pop_front();
+        task();
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budgetMs) {
+            break;
+        }
+    }
+    std::chrono::duration<float, std::milli> stepMs = std::chrono::steady_clock::now() - start;
+    _warmupMs += stepMs.count();
+
+    if (_warmupTasks.empty()) {
+        unschedule("battleWarmup");
+        CCLOG("[战斗场景] 预热完成：%d 项，累计 %.1fms", _warmupTaskCount, _warmupMs);
+        CCLOG("[战斗场景] 序列帧内存:\n%s", AnimationRegistry::getInstance()->buildMemoryReport().c_str());
+    }
+}
+
+void BattleScene::finishWarmup() {
+    if (_warmupTasks.empty()) {
+        return;
+    }
+    int remaining = static_cast<int>(_warmupTasks.size());
+    runWarmupStep(std::numeric_limits<double>::max());
+    CCLOG("[战斗场景] 开战前补完剩余 %d 项预热", remaining);
+}
+
 // ===================================================
 // 创建部署按钮
 // ===================================================
@@ -1688,14 +1575,7 @@ Node* BattleScene::createDeployButton(int unitId, int count, float x) {
     nameLabel->setName("nameLabel");
     node->addChild(nameLabel, 2);
 
-    // 待机动画图标（持续显示）
-    auto idleIcon = createUnitIdleIcon(unitId, 26.0f, true);
-    if (idleIcon) {
-        idleIcon->setPosition(Vec2(0, 0));
-        idleIcon->setVisible(true);
-        idleIcon->setName("idleIcon");
-        node->addChild(idleIcon, 2);
-    }
+    // 待机动画图标在加载阶段由 attachDeployIdleIcon 补上
 
     // 数量
     auto countLabel = createBattleLabel("x" + std::to_string(count), 10);
@@ -1801,6 +1681,26 @@ Sprite* BattleScene::createUnitIdleIcon(int unitId, float targetSize, bool force
     return sprite;
 }
 
+void BattleScene::attachDeployIdleIcon(int unitId) {
+    auto buttonIt = _deployButtons.find(unitId);
+    if (buttonIt == _deployButtons.end() || !buttonIt->second) {
+        return;
+    }
+    Node* node = buttonIt->second;
+    if (node->getChildByName("idleIcon")) {
+        return;
+    }
+
+    // 待机动画图标（持续显示）
+    auto idleIcon = createUnitIdleIcon(unitId, 26.0f, true);
+    if (idleIcon) {
+        idleIcon->setPosition(Vec2(0, 0));
+        idleIcon->setVisible(true);
+        idleIcon->setName("idleIcon");
+        node->addChild(idleIcon, 2);
+    }
+}
+
 // ===================================================
 // 获取第一个可部署单位
 // ===================================================
@@ -1949,16 +1849,21 @@ void BattleScene::deploySoldier(int unitId, const Vec2& position) {
         return;
     }
 
+    // 出生点对齐格子中心，与回放按格子坐标重建的位置一致
+    Vec2 spawnPos = (gridX >= 0 && gridY >= 0) ? _gridMap->gridToWorld(gridX, gridY) : position;
+
     // 创建士兵（同步训练等级）
     int unitLevel = UnitManager::getInstance()->getUnitLevel(unitId);
-    auto soldier = UnitManager::getInstance()->spawnSoldier(unitId, position, unitLevel);
+    auto soldier = _soldierPool.acquire(unitId, spawnPos, unitLevel);
     if (soldier) {
         _soldierLayer->addChild(soldier);
-        _soldiers.push_back(soldier);
+        attachToSimClock(soldier);
+        _entities.insert(EntityKind::SOLDIER, _soldiers, soldier);
         soldier->retain();
         _totalDeployedCount++;
+        _events.publish(BattleEventType::UNIT_SPAWNED, soldier);
 
-        spawnDeployEffect(position);
+        spawnDeployEffect(spawnPos);
 
         if (_recordingEnabled && gridX >= 0 && gridY >= 0) {
             recordDeployEvent(unitId, unitLevel, gridX, gridY);
@@ -1966,10 +1871,11 @@ void BattleScene::deploySoldier(int unitId, const Vec2& position) {
 
         // 更新剩余数量
         it->second--;
+        _remainingUnitTotal--;
         // 训练兵种仅作为出战上限，战斗中不消耗库存
 
         CCLOG("[战斗场景] 部署士兵: %d 在位置 (%.1f, %.1f), 剩余 %d",
-            unitId, position.x, position.y, it->second);
+            unitId, spawnPos.x, spawnPos.y, it->second);
 
         // 更新UI并处理选中状态
         refreshDeployButton(unitId);
@@ -1980,19 +1886,32 @@ void BattleScene::deploySoldier(int unitId, const Vec2& position) {
 }
 
 void BattleScene::spawnEnemySoldier(int unitId, const Vec2& position, int level) {
-    auto soldier = UnitManager::getInstance()->spawnSoldier(unitId, position, level);
+    auto soldier = _soldierPool.acquire(unitId, position, level);
     if (!soldier) {
         return;
     }
 
     _soldierLayer->addChild(soldier);
-    _soldiers.push_back(soldier);
+    attachToSimClock(soldier);
+    _entities.insert(EntityKind::SOLDIER, _soldiers, soldier);
     soldier->retain();
     _totalDeployedCount++;
+    _events.publish(BattleEventType::UNIT_SPAWNED, soldier);
 
     spawnDeployEffect(position);
 }
 
+void BattleScene::attachToSimClock(Node* node) {
+    if (!node || !_simScheduler) {
+        return;
+    }
+    // 更换调度器会清掉节点原有的定时回调，这里只重新挂上逐帧 update
+    if (node->getScheduler() != _simScheduler) {
+        node->setScheduler(_simScheduler);
+    }
+    node->scheduleUpdate();
+}
+
 void BattleScene::spawnDeployEffect(const Vec2& position) {
     if (!_gridMap) {
         return;
@@ -2014,6 +1933,8 @@ void BattleScene::recordDeployEvent(int unitId, int unitLevel, int gridX, int gr
     }
     ReplayDeployEvent event;
     event.time = _battleTime;
+    // 模拟步内（自动进攻）部署时当前步尚未完成
+    event.tick = _simStepping ? _simTick - 1 : _simTick;
     event.unitId = unitId;
     event.gridX = gridX;
     event.gridY = gridY;
@@ -2027,7 +1948,11 @@ void BattleScene::updateReplayPlayback() {
     }
     while (_replayEventIndex < _replayData.events.size()) {
         const auto& event = _replayData.events[_replayEventIndex];
-        if (_battleTime + 0.0001f < event.time) {
+        // 录制时在第 tick 步之后部署，对应回放第 tick + 1 步开始前
+        int eventTick = event.tick >= 0
+            ? event.tick
+            : static_cast<int>(std::lround(event.time * BattleConfig::SIM_TICKS_PER_SECOND));
+        if (eventTick >= _simTick) {
             break;
         }
         deployReplaySoldier(event);
@@ -2035,26 +1960,94 @@ void BattleScene::updateReplayPlayback() {
     }
 }
 
+void BattleScene::updateStateHash() {
+    int interval = 0;
+    if (_recordingEnabled) {
+        interval = _recording.stateHashInterval;
+    }
+    else if (_isReplay && _hasReplayData && _replayData.version >= kStateHashMinVersion) {
+        interval = _replayData.stateHashInterval;
+    }
+    if (interval <= 0) {
+        return;
+    }
+
+    int tick = _simTick;
+    if (tick < _nextStateHashTick) {
+        return;
+    }
+    // 一帧跨过多个检查点时只记录最近的一个
+    int checkpoint = tick - tick % interval;
+    _nextStateHashTick = checkpoint + interval;
+
+    if (_recordingEnabled) {
+        ReplayStateHash state = BattleStateHash::capture(checkpoint, _lastStateHash, _soldiers, _enemyBuildings, _entities);
+        _lastStateHash = state.hash;
+        _recording.stateHashes.push_back(state);
+        return;
+    }
+
+    if (!_desyncReport.empty()) {
+        return;
+    }
+    // 录制与回放的帧长不同，检查点集合可能不一致：只比对双方都有的检查点，
+    // 并以录制中的前一个检查点作为哈希链的前驱
+    const auto& expected = _replayData.stateHashes;
+    while (_stateHashIndex < expected.size() && expected[_stateHashIndex].tick < checkpoint) {
+        _stateHashIndex++;
+    }
+    if (_stateHashIndex >= expected.size() || expected[_stateHashIndex].tick != checkpoint) {
+        return;
+    }
+    uint64_t previous = _stateHashIndex > 0 ? expected[_stateHashIndex - 1].hash : 0;
+    ReplayStateHash actual = BattleStateHash::capture(checkpoint, previous, _soldiers, _enemyBuildings, _entities);
+    const ReplayStateHash& recorded = expected[_stateHashIndex];
+    _stateHashIndex++;
+    if (actual.hash == recorded.hash) {
+        _stateHashMatched++;
+        return;
+    }
+    _desyncReport = BattleStateHash::describeDiff(recorded, actual);
+    CCLOG("[战斗场景] 回放与原始对局分叉: %s", _desyncReport.c_str());
+}
+
+std::string BattleScene::buildReplayCheckLine() const {
+    if (_replayData.stateHashInterval <= 0 || _replayData.stateHashes.empty()) {
+        return "Replay check: not recorded";
+    }
+    if (_replayData.version < kStateHashMinVersion) {
+        return "Replay check: recorded by an older simulation, skipped";
+    }
+    if (!_desyncReport.empty()) {
+        return "Replay DESYNC at " + _desyncReport;
+    }
+    return StringUtils::format("Replay check: %d/%d checkpoints match",
+        _stateHashMatched, static_cast<int>(_replayData.stateHashes.size()));
+}
+
 void BattleScene::deployReplaySoldier(const ReplayDeployEvent& event) {
     if (!_gridMap) {
         return;
     }
     Vec2 position = _gridMap->gridToWorld(event.gridX, event.gridY);
-    auto soldier = UnitManager::getInstance()->spawnSoldier(event.unitId, position, event.level);
+    auto soldier = _soldierPool.acquire(event.unitId, position, event.level);
     if (!soldier) {
         return;
     }
 
     _soldierLayer->addChild(soldier);
-    _soldiers.push_back(soldier);
+    attachToSimClock(soldier);
+    _entities.insert(EntityKind::SOLDIER, _soldiers, soldier);
     soldier->retain();
     _totalDeployedCount++;
+    _events.publish(BattleEventType::UNIT_SPAWNED, soldier);
 
     spawnDeployEffect(position);
 
     auto it = _remainingUnits.find(event.unitId);
     if (it != _remainingUnits.end() && it->second > 0) {
         it->second--;
+        _remainingUnitTotal--;
         refreshDeployButton(event.unitId);
         if (it->second <= 0 && event.unitId == _selectedUnitId) {
             setSelectedUnit(getFirstAvailableUnitId());
@@ -2119,15 +2112,26 @@ void BattleScene::initHoverInfo() {
 void BattleScene::initReplayState() {
     _replayEventIndex = 0;
     _replayFinalized = false;
+    _nextStateHashTick = 0;
+    _lastStateHash = 0;
+    _stateHashIndex = 0;
+    _stateHashMatched = 0;
+    _desyncReport.clear();
 
     if (_isReplay) {
         _recordingEnabled = false;
         return;
     }
 
+    if (isStressBattle()) {
+        // 压力测试不记录回放、不计入关卡进度
+        _recordingEnabled = false;
+        return;
+    }
+
     _recordingEnabled = true;
     _recording = BattleReplay();
-    _recording.version = 1;
+    _recording.version = kReplayVersion;
     _recording.levelId = _levelId;
     _recording.defenseMode = (_battleMode == BattleMode::Defense);
     _recording.allowDefaultUnits = _allowDefaultUnits;
@@ -2135,10 +2139,13 @@ void BattleScene::initReplayState() {
     _recording.timestamp = static_cast<int64_t>(std::time(nullptr));
     _recording.deployableUnits = _remainingUnits;
     _recording.events.clear();
+    _recording.stateHashInterval = BattleStateHash::kDefaultInterval;
+    _recording.stateHashes.clear();
 }
 
 bool BattleScene::onTouchBegan(Touch* touch, Event* event) {
-    if (_battleMode == BattleMode::Defense || _battlePaused || _battleBriefing || _isReplay) {
+    // 规划期间不接受手动部署，保持规划输入与执行起点一致
+    if (_battleMode == BattleMode::Defense || _battlePaused || _battleBriefing || _isReplay || _autoPlanning) {
         return false;
     }
     auto visibleSize = Director::getInstance()->getVisibleSize();
@@ -2236,19 +2243,26 @@ void BattleScene::updateHoverInfo(const Vec2& worldPos) {
 }
 
 Node* BattleScene::pickBuildingAt(const Vec2& worldPos) const {
-    if (!_buildingLayer) {
+    if (!_buildingLayer || !_gridMap) {
         return nullptr;
     }
 
-    for (auto* child : _buildingLayer->getChildren()) {
-        if (!child) {
+    // 按网格取光标附近的候选，只对候选做精灵包围盒测试
+    Vec2 gridPos = _gridMap->worldToGrid(_gridMap->convertToNodeSpace(worldPos));
+    std::vector<Node*> candidates;
+    _gridMap->collectBuildingsAround(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y),
+        kPickSideCells, kPickBelowCells, candidates);
+
+    for (auto* candidate : candidates) {
+        // 被摧毁的建筑不释放占地，网格里的指针可能已失效：先经句柄表确认仍在场再访问
+        if (!_entities.resolve(_entities.find(candidate), EntityKind::BUILDING)) {
             continue;
         }
-        if (dynamic_cast<DefenceBuilding*>(child)
-            || dynamic_cast<ProductionBuilding*>(child)
-            || dynamic_cast<StorageBuilding*>(child)) {
-            if (NodeUtils::hitTestBuilding(child, worldPos)) {
-                return child;
+        if (dynamic_cast<DefenceBuilding*>(candidate)
+            || dynamic_cast<ProductionBuilding*>(candidate)
+            || dynamic_cast<StorageBuilding*>(candidate)) {
+            if (NodeUtils::hitTestBuilding(candidate, worldPos)) {
+                return candidate;
             }
         }
     }
@@ -2430,12 +2444,40 @@ void BattleScene::clearBuildingInfo() {
 // ===================================================
 
 void BattleScene::update(float dt) {
+    if (!_loadTimeline.isInteractive()) {
+        // 首次逐帧回调时场景已完成首帧绘制，简报或部署栏即可响应输入
+        _loadTimeline.markInteractive();
+        CCLOG("[战斗场景] 首个可交互帧 %.1fms（同步构建 %.1fms）",
+            _loadTimeline.getInteractiveMs(), _loadTimeline.getBuildMs());
+    }
+    // 没有简报的场景（回放）在开战前补完预热
+    if (!_battleBriefing && !_warmupTasks.empty()) {
+        finishWarmup();
+    }
     if (_battleEnded || _battlePaused || _battleBriefing) {
         return;
     }
+    // 自动进攻规划期间冻结模拟：方案基于点击时的状态，需从同一帧开始执行
+    if (_autoPlanning) {
+        return;
+    }
+    auto logicStart = std::chrono::steady_clock::now();
 
-    // 更新战斗时间
-    _battleTime += dt;
+    // 真实时间累积后按固定步长推进模拟；卡顿时最多补跑若干步，其余丢弃（表现为慢动作而非跳帧）
+    _simAccumulator += dt;
+    int steps = 0;
+    while (_simAccumulator >= BattleConfig::SIM_TICK_DT && !_battleEnded) {
+        if (steps >= BattleConfig::MAX_SIM_TICKS_PER_FRAME) {
+            _simAccumulator = 0.0f;
+            break;
+        }
+        _simAccumulator -= BattleConfig::SIM_TICK_DT;
+        stepSimulation();
+        steps++;
+    }
+    if (_battleMode == BattleMode::Defense && !_battleEnded) {
+        updateDefensePrewarm();
+    }
 
     // 更新计时器显示
     float remainingTime = std::max(0.0f, BattleConfig::BATTLE_TIME_LIMIT - _battleTime);
@@ -2443,10 +2485,37 @@ void BattleScene::update(float dt) {
         _timerLabel->setString(formatTimeText(remainingTime));
     }
 
+    if (isStressBattle()) {
+        std::chrono::duration<float, std::milli> logicMs = std::chrono::steady_clock::now() - logicStart;
+        float frameMs = Director::getInstance()->getDeltaTime() * 1000.0f;
+        _frameStats.addSample(frameMs, logicMs.count(), _lastCrowdMs, _crowd.getActiveCount());
+
+        // 全部出兵后在满员状态下对比一次串行/并行寻敌
+        if (_targetingBenchmark.empty() && !_defenseWaves.hasPending()) {
+            _targetingBenchmark = _targeting.benchmark(_soldiers, _enemyBuildings, kTargetingBenchmarkRounds);
+            _targetingBenchmark += "\n" + FixedMath::benchmark(kFixedMathBenchmarkIterations);
+            CCLOG("[战斗场景] %s", _targetingBenchmark.c_str());
+        }
+    }
+}
+
+void BattleScene::stepSimulation() {
+    // 战斗时间只由模拟帧数决定，录制与回放在同一帧上看到完全相同的状态
+    _simTick++;
+    _battleTime = _simTick * BattleConfig::SIM_TICK_DT;
+    _simStepping = true;
+
     updateReplayPlayback();
+    updateAutoPlan();
 
     // 更新战斗逻辑
-    updateBattle(dt);
+    updateBattle(BattleConfig::SIM_TICK_DT);
+    // 推进士兵、防御塔、陷阱与子弹
+    if (_simScheduler) {
+        _simScheduler->update(BattleConfig::SIM_TICK_DT);
+    }
+    updateStateHash();
+    _simStepping = false;
 
     // 检查战斗结束
     checkBattleEnd();
@@ -2454,27 +2523,31 @@ void BattleScene::update(float dt) {
 
 void BattleScene::onExit() {
     GameSettings::applyBattleSpeed(false);
+    unschedule("battleWarmup");
+    _warmupTasks.clear();
     DefenceBuilding::clearEnemySoldiersIf(&_soldiers);
     TrapBase::clearEnemySoldiersIf(&_soldiers);
     Soldier::clearEnemyBuildingsIf(&_enemyBuildings);
+    BattleSpace::clearActiveIf(&_space);
+    _space.clear();
+    TargetingSystem::clearActiveIf(&_targeting);
+    BattleEventBus::clearActiveIf(&_events);
+    _events.clear();
+    EntityTable::clearActiveIf(&_entities);
+    _entities.clear();
 
     // 释放保留的引用，避免内存泄漏
-    for (auto& soldier : _soldiers) {
-        if (soldier) {
-            soldier->release();
-            soldier = nullptr;
-        }
+    for (auto* soldier : _soldiers) {
+        soldier->release();
     }
-    for (auto& building : _enemyBuildings) {
-        if (building) {
-            building->release();
-            building = nullptr;
-        }
+    for (auto* building : _enemyBuildings) {
+        building->release();
     }
     _soldiers.clear();
     _enemyBuildings.clear();
     _enemyBase = nullptr;
     _enemyBaseDestroyed = false;
+    _soldierPool.clear();
 
     Scene::onExit();
 }
@@ -2488,71 +2561,152 @@ void BattleScene::updateBattle(float dt) {
         updateDefenseSpawns();
     }
 
-    // 清理已移除的士兵，避免悬空指针
-    for (auto& soldier : _soldiers) {
-        if (soldier && !soldier->getParent()) {
-            _deadSoldierCount++;
-            soldier->release();
-            soldier = nullptr;
-        }
+    // 上一步产生的上场/死亡/摧毁事件在此统一结算，释放已移除节点的引用
+    _events.dispatch();
+
+    // 士兵之间互相推开，避免直线行军叠成一点
+    auto crowdStart = std::chrono::steady_clock::now();
+    _crowd.apply(_soldiers, dt);
+    std::chrono::duration<float, std::milli> crowdMs = std::chrono::steady_clock::now() - crowdStart;
+    _lastCrowdMs = crowdMs.count();
+
+    // 士兵与防御塔的寻敌统一在此批量完成（可分发到工作线程）
+    _targeting.run(_soldiers, _enemyBuildings);
+}
+
+// ===================================================
+// 战斗事件
+// ===================================================
+
+void BattleScene::initBattleEvents() {
+    _events.clear();
+    _events.subscribe(BattleEventType::UNIT_SPAWNED, [this](const BattleEvent&) {
+        _aliveSoldierCount++;
+    });
+    _events.subscribe(BattleEventType::UNIT_DIED, [this](const BattleEvent& event) {
+        onSoldierRemoved(event.node);
+    });
+    _events.subscribe(BattleEventType::BUILDING_DESTROYED, [this](const BattleEvent& event) {
+        onBuildingRemoved(event.node);
+    });
+    _events.subscribe(BattleEventType::TRAP_TRIGGERED, [this](const BattleEvent&) {
+        _trapTriggerCount++;
+    });
+    _events.subscribe(BattleEventType::BASE_DESTROYED, [this](const BattleEvent&) {
+        _enemyBaseDestroyed = true;
+        _enemyBase = nullptr;
+    });
+    BattleEventBus::setActive(&_events);
+}
+
+void BattleScene::onSoldierRemoved(Node* node) {
+    // 句柄已在发布时失效，这里按表中记录的下标交换删除
+    if (!_entities.erase(_soldiers, node)) {
+        return;
     }
 
-    // 检查被摧毁的建筑并释放引用
-    int destroyed = 0;
-    for (auto& building : _enemyBuildings) {
-        if (building && !building->getParent()) {
-            if (building == _enemyBase) {
-                _enemyBaseDestroyed = true;
-                _enemyBase = nullptr;
-            }
-            building->release();
-            building = nullptr;
-        }
-        if (!building) {
-            destroyed++;
-        }
+    // 防守模式下交给对象池复用（复用后登记新句柄，旧目标不会误指向它）
+    Soldier* soldier = static_cast<Soldier*>(node);
+    _deadSoldierCount++;
+    _aliveSoldierCount--;
+    if (_battleMode == BattleMode::Defense) {
+        _soldierPool.recycle(soldier);
+    }
+    else {
+        soldier->release();
+    }
+}
+
+void BattleScene::onBuildingRemoved(Node* node) {
+    if (!_entities.erase(_enemyBuildings, node)) {
+        return;
+    }
+
+    Node* building = node;
+    BattleSpace::forget(building);
+    _destroyedBuildingCount++;
+    refreshProgressLabel();
+    if (building == _enemyBase) {
+        _events.publish(BattleEventType::BASE_DESTROYED, building);
     }
-    _destroyedBuildingCount = destroyed;
+    building->release();
+}
 
-    // 更新进度显示
+void BattleScene::refreshProgressLabel() {
+    if (!_progressLabel) {
+        return;
+    }
     int progress = _totalBuildingCount > 0 ?
-        (destroyed * 100 / _totalBuildingCount) : 0;
+        (_destroyedBuildingCount * 100 / _totalBuildingCount) : 0;
     char progressStr[16];
     snprintf(progressStr, sizeof(progressStr), "%d%%", progress);
-    if (_progressLabel) {
-        _progressLabel->setString(progressStr);
-    }
+    _progressLabel->setString(progressStr);
 }
 
 void BattleScene::updateDefenseSpawns() {
-    if (_nextDefenseSpawnIndex >= _defenseSpawns.size()) {
+    if (!_defenseWaves.hasPending()) {
         return;
     }
-    int defenseId = getDefenseLevelIndex();
-    int enemyLevel = 0;
-    if (defenseId >= 5) {
-        enemyLevel = 2;
-    }
-    else if (defenseId >= 3) {
-        enemyLevel = 1;
+
+    // 大波次按数量分摊到多个模拟帧；只看数量不看墙钟，录制与回放在同一帧出兵
+    int spawned = 0;
+    const int spawnLimit = isStressBattle() ? kStressSpawnsPerFrame : kDefenseSpawnsPerFrame;
+    DefenseSpawn spawn;
+    while (spawned < spawnLimit && _defenseWaves.peekDue(_battleTime, spawn)) {
+        Vec2 pos = getDefenseSpawnPosition(spawn.pointIndex);
+        spawnEnemySoldier(spawn.unitId, pos, resolveDefenseEnemyLevel(spawn.unitId));
+        _defenseWaves.pop();
+        ++spawned;
     }
+}
 
-    while (_nextDefenseSpawnIndex < _defenseSpawns.size()) {
-        const auto& spawn = _defenseSpawns[_nextDefenseSpawnIndex];
-        if (_battleTime < spawn.time) {
-            break;
+void BattleScene::updateDefensePrewarm() {
+    // 在固定步长之外按墙钟预算逐个预建，机器快慢只影响池中余量，不影响模拟
+    auto start = std::chrono::steady_clock::now();
+    for (int created = 0; created < kDefensePrewarmPerFrame; ++created) {
+        if (prewarmDefenseSpawns(1) <= 0) {
+            return;
         }
-        int resolvedLevel = enemyLevel;
-        if (defenseId == kDefenseMaxLevelId && spawn.unitId == kKingUnitId) {
-            const UnitConfig* cfg = UnitManager::getInstance()->getConfig(spawn.unitId);
-            if (cfg) {
-                resolvedLevel = cfg->MAXLEVEL;
-            }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= kDefensePrewarmBudgetMs) {
+            return;
+        }
+    }
+}
+
+int BattleScene::prewarmDefenseSpawns(int maxCreate) {
+    DefenseSpawn next;
+    if (maxCreate <= 0 || !_defenseWaves.peekDue(std::numeric_limits<float>::max(), next)) {
+        return 0;
+    }
+
+    // 按波次顺序为即将出兵的兵种补足池中可用士兵，最多新建 maxCreate 个
+    const auto& waves = _defenseWaves.getWaves();
+    int budget = maxCreate;
+    for (size_t i = static_cast<size_t>(next.waveIndex); i < waves.size() && budget > 0; ++i) {
+        int unitId = waves[i].unitId;
+        int target = std::min(waves[i].count, std::max(kDefensePoolTarget, maxCreate));
+        target = std::min(target, _soldierPool.getAvailableCount(unitId) + budget);
+        budget -= _soldierPool.prewarm(unitId, resolveDefenseEnemyLevel(unitId), target);
+    }
+    return maxCreate - budget;
+}
+
+int BattleScene::resolveDefenseEnemyLevel(int unitId) const {
+    int defenseId = getDefenseLevelIndex();
+    if (defenseId == kDefenseMaxLevelId && unitId == kKingUnitId) {
+        const UnitConfig* cfg = UnitManager::getInstance()->getConfig(unitId);
+        if (cfg) {
+            return cfg->MAXLEVEL;
         }
-        Vec2 pos = getDefenseSpawnPosition(static_cast<int>(_nextDefenseSpawnIndex));
-        spawnEnemySoldier(spawn.unitId, pos, resolvedLevel);
-        _nextDefenseSpawnIndex++;
     }
+    if (defenseId >= 5) {
+        return 2;
+    }
+    if (defenseId >= 3) {
+        return 1;
+    }
+    return 0;
 }
 
 // ===================================================
@@ -2566,15 +2720,8 @@ void BattleScene::checkBattleEnd() {
             return;
         }
 
-        bool hasEnemies = false;
-        for (auto& soldier : _soldiers) {
-            if (soldier && soldier->getParent()) {
-                hasEnemies = true;
-                break;
-            }
-        }
-        bool hasPendingSpawns = _nextDefenseSpawnIndex < _defenseSpawns.size();
-        if (!hasEnemies && !hasPendingSpawns) {
+        bool hasPendingSpawns = _defenseWaves.hasPending();
+        if (_aliveSoldierCount <= 0 && !hasPendingSpawns) {
             onBattleWin();
             return;
         }
@@ -2606,23 +2753,7 @@ void BattleScene::checkBattleEnd() {
     }
 
     // 所有士兵阵亡且没有剩余可部署单位 - 失败
-    bool hasSurvivors = false;
-    for (auto& soldier : _soldiers) {
-        if (soldier && soldier->getParent()) {
-            hasSurvivors = true;
-            break;
-        }
-    }
-
-    bool hasRemainingUnits = false;
-    for (auto& pair : _remainingUnits) {
-        if (pair.second > 0) {
-            hasRemainingUnits = true;
-            break;
-        }
-    }
-
-    if (!hasSurvivors && !hasRemainingUnits && _soldiers.size() > 0) {
+    if (_aliveSoldierCount <= 0 && _remainingUnitTotal <= 0 && _totalDeployedCount > 0) {
         onBattleLose();
     }
 }
@@ -2668,7 +2799,7 @@ void BattleScene::onBattleWin() {
     AudioManager::stopBgm();
     AudioManager::playVictory();
 
-    if (_isReplay) {
+    if (_isReplay || isStressBattle()) {
         _resultRewardCoin = 0;
         _resultRewardDiamond = 0;
         int stars = calculateStarCount();
@@ -2794,30 +2925,13 @@ int BattleScene::getRecordLevelId() const {
 }
 
 void BattleScene::resetDefenseSpawns() {
-    _defenseSpawns.clear();
-    _nextDefenseSpawnIndex = 0;
-    _defenseSpawnCursor = 0.0f;
-    _defenseTotalUnits = 0;
+    _defenseWaves.reset();
+    _defenseWaves.setSpawnPointCount(kDefenseSpawnPointCount);
 }
 
-void BattleScene::addDefenseWave(int unitId, int count, float interval, float delay) {
-    if (count <= 0) {
-        return;
-    }
-    if (delay > 0.0f) {
-        _defenseSpawnCursor += delay;
-    }
-    if (interval < 0.05f) {
-        interval = 0.05f;
-    }
-    for (int i = 0; i < count; ++i) {
-        DefenseSpawn spawn;
-        spawn.time = _defenseSpawnCursor;
-        spawn.unitId = unitId;
-        _defenseSpawns.push_back(spawn);
-        _defenseSpawnCursor += interval;
-    }
-    _defenseTotalUnits += count;
+void BattleScene::addDefenseWave(int unitId, int count, float interval, float delay,
+                                 SpawnPattern pattern, int pointIndex) {
+    _defenseWaves.addWave(unitId, count, interval, delay, pattern, pointIndex);
 }
 
 Vec2 BattleScene::getDefenseSpawnPosition(int index) const {
@@ -2827,16 +2941,12 @@ Vec2 BattleScene::getDefenseSpawnPosition(int index) const {
 
     const int maxX = BattleConfig::GRID_WIDTH - 3;
     const int maxY = BattleConfig::GRID_HEIGHT - 3;
-    const Vec2 points[] = {
-        Vec2(2, 4), Vec2(2, 12), Vec2(2, 20), Vec2(2, maxY),
-        Vec2(maxX, 4), Vec2(maxX, 12), Vec2(maxX, 20), Vec2(maxX, maxY),
-        Vec2(8, 2), Vec2(18, 2), Vec2(28, 2),
-        Vec2(8, maxY), Vec2(18, maxY), Vec2(28, maxY)
-    };
-    int total = static_cast<int>(sizeof(points) / sizeof(points[0]));
-    int idx = index % total;
-    int gridX = static_cast<int>(points[idx].x);
-    int gridY = static_cast<int>(points[idx].y);
+    int idx = index % kDefenseSpawnPointCount;
+    if (idx < 0) {
+        idx += kDefenseSpawnPointCount;
+    }
+    int gridX = kDefenseSpawnPoints[idx][0] < 0 ? maxX : kDefenseSpawnPoints[idx][0];
+    int gridY = kDefenseSpawnPoints[idx][1] < 0 ? maxY : kDefenseSpawnPoints[idx][1];
     return _gridMap->gridToWorld(gridX, gridY);
 }
 
@@ -2950,6 +3060,15 @@ void BattleScene::createResultStatsPanel(Node* parent, bool isWin) {
     if (panelHeight < 120.0f) {
         panelHeight = 120.0f;
     }
+    if (isStressBattle()) {
+        // 压力测试额外显示帧耗时统计
+        panelWidth = visibleSize.width * 0.8f;
+        panelHeight += 70.0f;
+    }
+    else if (_isReplay) {
+        // 回放额外显示状态哈希比对结果
+        panelHeight += 20.0f;
+    }
 
     auto panel = LayerColor::create(Color4B(20, 20, 20, 200), panelWidth, panelHeight);
     panel->setPosition(Vec2(origin.x + (visibleSize.width - panelWidth) * 0.5f,
@@ -2966,10 +3085,13 @@ void BattleScene::createResultStatsPanel(Node* parent, bool isWin) {
         : 100.0f;
     std::string buildingLine = StringUtils::format("Buildings: %d/%d (%.0f%%)",
         _destroyedBuildingCount, _totalBuildingCount, destroyedRatio);
+    if (_trapTriggerCount > 0) {
+        buildingLine += StringUtils::format("  Traps sprung: %d", _trapTriggerCount);
+    }
 
     std::string unitLine;
     if (_battleMode == BattleMode::Defense) {
-        int totalEnemies = std::max(0, _defenseTotalUnits);
+        int totalEnemies = std::max(0, _defenseWaves.getTotalUnits());
         unitLine = StringUtils::format("Enemies: %d/%d defeated", _deadSoldierCount, totalEnemies);
     }
     else {
@@ -2977,8 +3099,16 @@ void BattleScene::createResultStatsPanel(Node* parent, bool isWin) {
     }
 
     std::string rewardLine;
-    if (_isReplay) {
-        rewardLine = "Reward: -";
+    if (isStressBattle()) {
+        rewardLine = _frameStats.buildReport();
+        rewardLine += "\nLoad: " + _loadTimeline.buildReport();
+        if (!_targetingBenchmark.empty()) {
+            rewardLine += "\n" + _targetingBenchmark;
+        }
+        CCLOG("[战斗场景] 压力测试 %d 单位帧耗时统计:\n%s", _stressArmySize, rewardLine.c_str());
+    }
+    else if (_isReplay) {
+        rewardLine = "Reward: -\n" + buildReplayCheckLine();
     }
     else {
         rewardLine = isWin
@@ -3049,6 +3179,11 @@ void BattleScene::createResultButtons(Node* parent, bool isWin) {
         retryBtn->addClickEventListener([this](Ref*) {
             AudioManager::playButtonClick();
             SaveManager::getInstance()->saveActiveSlot();
+            if (isStressBattle()) {
+                auto scene = BattleScene::createStressScene(_stressArmySize);
+                Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+                return;
+            }
             bool defenseMode = (_battleMode == BattleMode::Defense);
             int retryLevel = defenseMode ? getRecordLevelId() : _levelId;
             auto scene = BattleScene::createScene(retryLevel, _deployableUnits, _allowDefaultUnits, defenseMode);
@@ -3064,7 +3199,7 @@ void BattleScene::createResultButtons(Node* parent, bool isWin) {
         bool defenseMode = (_battleMode == BattleMode::Defense);
         int currentLevelId = defenseMode ? getRecordLevelId() : _levelId;
         int maxLevelId = defenseMode ? (kDefenseLevelOffset + kDefenseMaxLevelId) : kMaxLevelId;
-        bool canNext = isWin && currentLevelId < maxLevelId;
+        bool canNext = isWin && currentLevelId < maxLevelId && !isStressBattle();
         if (!canNext) {
             nextBtn->setEnabled(false);
             nextBtn->setBright(false);
@@ -13,18 +13,33 @@
 
 #include "cocos2d.h"
 #include "ui/CocosGUI.h"
+#include "Core/BattleEventBus.h"
+#include "Core/EntityTable.h"
+#include "Map/BattleSpace.h"
 #include "Map/GridMap.h"
 #include "Soldier/Soldier.h"
+#include "Soldier/SoldierPool.h"
+#include "Soldier/DefenseWaveScheduler.h"
+#include "Soldier/CrowdSeparation.h"
+#include "Soldier/TargetingSystem.h"
+#include "Utils/FrameStats.h"
+#include "Utils/LoadTimeline.h"
 #include "Buildings/DefenceBuilding.h"
 #include "Buildings/ProductionBuilding.h"
 #include "Replay/ReplayManager.h"
+#include "Replay/AttackPlanner.h"
 #include "Share/BattleShareManager.h"
+#include "Scenes/Components/MapCamera.h"
+#include <deque>
+#include <functional>
 #include <vector>
 #include <map>
 
 USING_NS_CC;
 using namespace cocos2d::ui;
 
+struct LevelLayout;
+
 // ===================================================
 // 战斗场景配置
 // ===================================================
@@ -48,6 +63,11 @@ namespace BattleConfig {
 
     // 战斗配置
     constexpr float BATTLE_TIME_LIMIT = 160.0f;  // 战斗时间限制（秒）
+
+    // 模拟时钟：战斗逻辑按固定步长推进，与渲染帧率无关
+    constexpr int SIM_TICKS_PER_SECOND = 60;                    // 每秒模拟帧数
+    constexpr float SIM_TICK_DT = 1.0f / SIM_TICKS_PER_SECOND;  // 单步时长（秒）
+    constexpr int MAX_SIM_TICKS_PER_FRAME = 8;                  // 单帧最多补跑的步数，超出部分丢弃
 }
 
 enum class BattleMode {
@@ -71,7 +91,13 @@ public:
         const std::map<int, int>& units = {},
         bool useDefaultUnits = true);
     static Scene* createReplayScene(const BattleReplay& replay);
+    /**
+     * @brief 创建压力测试战斗：大量来袭士兵进攻当前基地，结束时显示帧耗时统计
+     * @param armySize 来袭士兵总数
+     */
+    static Scene* createStressScene(int armySize);
 
+    virtual ~BattleScene();
     virtual bool init() override;
     virtual void update(float dt) override;
     virtual void onExit() override;
@@ -92,6 +118,7 @@ private:
     GridMap* _gridMap = nullptr;                    // 网格地图
     Node* _buildingLayer = nullptr;                 // 建筑层
     Node* _soldierLayer = nullptr;                  // 士兵层
+    MapCamera* _mapCamera = nullptr;                // 地图视角控制（平移/缩放/视口裁剪）
     Node* _uiLayer = nullptr;                       // UI层
 
     // ==================== 关卡数据 ====================
@@ -101,21 +128,31 @@ private:
     bool _allowDefaultUnits = true;                 // 是否允许使用默认兵种（未传入训练兵种时）
     BattleMode _battleMode = BattleMode::Attack;    // 战斗模式
 
-    struct DefenseSpawn {
-        float time = 0.0f;
-        int unitId = 0;
-    };
-    std::vector<DefenseSpawn> _defenseSpawns;
-    size_t _nextDefenseSpawnIndex = 0;
-    float _defenseSpawnCursor = 0.0f;
-    int _defenseTotalUnits = 0;
+    DefenseWaveScheduler _defenseWaves;             // 防守波次（惰性展开出兵）
+    SoldierPool _soldierPool;                       // 士兵对象池（防守来袭回收复用，进攻部署预建）
+    int _stressArmySize = 0;                        // 压力测试兵力（>0 表示压力测试）
 
     // ==================== 战斗状态 ====================
-    std::vector<Soldier*> _soldiers;                // 场上的士兵
-    std::vector<Node*> _enemyBuildings;             // 敌方建筑
+    std::vector<Soldier*> _soldiers;                // 场上的士兵（移除时交换删除，不留空槽）
+    EntityTable _entities;                          // 士兵/敌方建筑句柄表（目标以句柄保存）
+    BattleEventBus _events;                         // 战斗事件（计数与胜负条件按事件增量更新）
+    BattleSpace _space;                             // 战斗坐标缓存（按实体缓存，移动后失效）
+    int _aliveSoldierCount = 0;                     // 场上存活士兵数
+    int _remainingUnitTotal = 0;                    // 剩余可部署单位总数
+    int _trapTriggerCount = 0;                      // 陷阱触发次数
+    CrowdSeparation _crowd;                         // 士兵局部分离
+    FrameStats _frameStats;                         // 压力测试帧耗时统计
+    float _lastCrowdMs = 0.0f;                      // 本帧分离耗时
+    TargetingSystem _targeting;                     // 批量寻敌阶段（可选并行）
+    std::string _targetingBenchmark;                // 压力测试寻敌基准结果
+    std::vector<Node*> _enemyBuildings;             // 敌方建筑（同上）
     Node* _enemyBase = nullptr;                     // 敌方基地
     bool _enemyBaseDestroyed = false;               // 敌方基地是否已摧毁
-    float _battleTime = 0.0f;                       // 战斗时间
+    float _battleTime = 0.0f;                       // 战斗时间（= 模拟帧数 × 步长）
+    int _simTick = 0;                               // 已完成的模拟帧数
+    bool _simStepping = false;                      // 正在执行模拟步（此时 _simTick 已含当前步）
+    float _simAccumulator = 0.0f;                   // 未消化的真实时间
+    Scheduler* _simScheduler = nullptr;             // 战斗单位专用调度器（只在模拟步内推进）
     bool _battleEnded = false;                      // 战斗是否结束
     bool _battlePaused = false;                     // 战斗是否暂停
     bool _battleBriefing = false;                   // 是否处于战前简报
@@ -132,13 +169,29 @@ private:
     BattleReplay _recording;                        // 录制数据
     BattleReplay _replayData;                       // 回放数据
     bool _hasReplayData = false;                    // 是否加载回放数据
+    int _nextStateHashTick = 0;                     // 下一个状态检查点（逻辑帧）
+    uint64_t _lastStateHash = 0;                    // 录制时上一个检查点的滚动哈希
+    size_t _stateHashIndex = 0;                     // 回放比对进度
+    int _stateHashMatched = 0;                      // 回放已一致的检查点数
+    std::string _desyncReport;                      // 回放分叉报告（空表示未分叉）
+    bool _autoPlanning = false;                     // 自动部署规划中
+    std::vector<ReplayDeployEvent> _autoPlanEvents; // 自动部署方案（tick 相对 _autoPlanStartTick）
+    size_t _autoPlanIndex = 0;                      // 自动部署进度
+    int _autoPlanStartTick = 0;                     // 方案开始执行的模拟帧（即规划输入的采样帧）
     bool _useSnapshotLayout = false;                // 是否使用基地快照布局
     BaseSnapshot _snapshotLayout;                   // 当前基地快照
 
+    // ==================== 加载阶段 ====================
+    LoadTimeline _loadTimeline;                     // 场景构建分阶段耗时与首个可交互帧
+    std::deque<std::function<void()>> _warmupTasks; // 简报期间分帧执行的预热与延后建节点
+    float _warmupMs = 0.0f;                         // 预热累计耗时
+    int _warmupTaskCount = 0;                       // 预热任务总数
+
     // ==================== UI组件 ====================
     Label* _timerLabel = nullptr;                   // 计时器
     Label* _progressLabel = nullptr;                // 进度显示
     Button* _pauseButton = nullptr;                 // 暂停按钮
+    Button* _autoAttackButton = nullptr;            // 自动进攻按钮
     Node* _pauseOverlay = nullptr;                  // 暂停遮罩
     Node* _unitDeployArea = nullptr;                // 单位部署区域
     std::map<int, Node*> _deployButtons;            // 部署按钮缓存
@@ -162,37 +215,29 @@ private:
     void initHoverInfo();
     void initReplayState();
     void setupPauseControls(float topY);
+    void setupAutoAttackButton();
     void setPausedState(bool paused);
     void showBattleBriefing();
     void hideBattleBriefing();
+    // 加载阶段：收集预热任务，按帧预算执行，开战前补完剩余部分
+    void queueWarmupTasks();
+    void runWarmupStep(double budgetMs);
+    void finishWarmup();
 
     // ==================== 关卡初始化 ====================
-    void createLevel1();  // 创建第1关
-    void createLevel2();
-    void createLevel3();
-    void createLevel4();
-    void createLevel5();
-    void createLevel6();
-    void createLevel7();
-    void createLevel8();
-    void createLevel9();
-    void createLevel10();
-    void createLevel11();
-    void createLevel12();
-    void createDefenseLevel1();
-    void createDefenseLevel2();
-    void createDefenseLevel3();
-    void createDefenseLevel4();
-    void createDefenseLevel5();
-    void createDefenseLevel6();
+    void createAttackLevel(int levelId);
+    void createDefenseLevel(int levelId);
+    void buildLevelLayout(const LevelLayout& layout);
+    void createStressLevel();
     void createDefenseBaseLayout(int towerLevel);
     void createSnapshotLayout();
     void buildSnapshotLayout(const BaseSnapshot& snapshot);
-    void createEnemyBase(int gridX, int gridY, int level = 0);
-    void createDefenseTower(int gridX, int gridY, int type, int level = 0);
-    void createSpikeTrap(int gridX, int gridY);
-    void createSnapTrap(int gridX, int gridY);
-    void addTrapCluster(int startX, int startY, int width, int height, const std::vector<Vec2>& snapCells);
+    // 一次遍历校验并登记占地后批量创建，返回实际放置数量
+    int placeBuildingsInBulk(const std::vector<BaseSavedBuilding>& buildings,
+                             int offsetX, int offsetY, bool allowOverlap);
+    // 为已校验的建筑生成节点并批量占用网格（footprints 与 accepted 一一对应），返回实际放置数量
+    int spawnPlacedBuildings(const std::vector<const BaseSavedBuilding*>& accepted,
+                             std::vector<GridFootprint>& footprints);
 
     // ==================== 辅助方法 ====================
     /**
@@ -211,6 +256,7 @@ private:
     void spawnDeployEffect(const Vec2& position);
     Node* createDeployButton(int unitId, int count, float x);
     Sprite* createUnitIdleIcon(int unitId, float targetSize, bool forceAnimate = false);
+    void attachDeployIdleIcon(int unitId);
     int getFirstAvailableUnitId() const;
     void setSelectedUnit(int unitId);
     void refreshDeployButton(int unitId);
@@ -228,8 +274,17 @@ private:
     void updateHoverPanelPosition(const Vec2& worldPos);
 
     // ==================== 战斗逻辑 ====================
+    void stepSimulation();
+    // 订阅战斗事件：士兵上场/死亡、建筑摧毁、陷阱触发、大本营摧毁
+    void initBattleEvents();
+    void onSoldierRemoved(Node* node);
+    void onBuildingRemoved(Node* node);
+    void refreshProgressLabel();
+    // 让节点的 update 改由模拟时钟驱动
+    void attachToSimClock(Node* node);
     void updateBattle(float dt);
     void updateDefenseSpawns();
+    void updateDefensePrewarm();
     void checkBattleEnd();
     void freezeBattleActors();
     void onBattleWin();
@@ -240,14 +295,25 @@ private:
     void createResultStatsPanel(Node* parent, bool isWin);
     void recordDeployEvent(int unitId, int unitLevel, int gridX, int gridY);
     void updateReplayPlayback();
+    void updateStateHash();
+    std::string buildReplayCheckLine() const;
     void deployReplaySoldier(const ReplayDeployEvent& event);
+    // 自动进攻：规划部署方案并按模拟帧执行
+    void startAutoAttack();
+    void applyAutoPlan(const AttackPlannerResult& result, int inputTick);
+    void updateAutoPlan();
     void finalizeReplay(bool isWin, int stars);
 
+    bool isStressBattle() const { return _stressArmySize > 0; }
     int getDefenseLevelIndex() const;
     int getRewardLevel() const;
     int getRecordLevelId() const;
     void resetDefenseSpawns();
-    void addDefenseWave(int unitId, int count, float interval, float delay);
+    void addDefenseWave(int unitId, int count, float interval, float delay,
+                        SpawnPattern pattern = SpawnPattern::ROUND_ROBIN, int pointIndex = 0);
+    // 返回实际新建的数量
+    int prewarmDefenseSpawns(int maxCreate);
+    int resolveDefenseEnemyLevel(int unitId) const;
     Vec2 getDefenseSpawnPosition(int index) const;
 
     // ==================== 回调 ====================
@@ -207,6 +207,21 @@ void LevelSelectScene::setSelectedUnits(const std::map<int, int>& units) {
 void LevelSelectScene::initLevelData(LevelTab tab) {
     _levels.clear();
 
+    if (tab == LevelTab::Stress) {
+        int index = 1;
+        for (int armySize : LevelSelectConfig::STRESS_ARMY_SIZES) {
+            LevelInfo level;
+            level.levelId = armySize;
+            level.displayId = index++;
+            level.name = "x" + std::to_string(armySize);
+            level.starCount = 0;
+            level.isUnlocked = true;
+            level.description = "Stress test with " + std::to_string(armySize) + " attackers";
+            _levels.push_back(level);
+        }
+        return;
+    }
+
     int highestCompleted = 0;
     int maxLevels = (tab == LevelTab::Defense)
         ? LevelSelectConfig::MAX_DEFENSE_LEVELS
@@ -384,7 +399,13 @@ void LevelSelectScene::setupModeButton() {
     _modeButton->setSwallowTouches(true);
     _modeButton->addClickEventListener([this](Ref*) {
         AudioManager::playButtonClick();
-        LevelTab nextTab = (_currentTab == LevelTab::Attack) ? LevelTab::Defense : LevelTab::Attack;
+        LevelTab nextTab = LevelTab::Attack;
+        if (_currentTab == LevelTab::Attack) {
+            nextTab = LevelTab::Defense;
+        }
+        else if (_currentTab == LevelTab::Defense) {
+            nextTab = LevelTab::Stress;
+        }
         this->switchTab(nextTab);
     });
     _modeButtonNode->addChild(_modeButton, 3);
@@ -509,6 +530,13 @@ Node* LevelSelectScene::createLevelButton(const LevelInfo& level, int index) {
         }
     }
 
+    if (_currentTab == LevelTab::Stress) {
+        auto sizeLabel = createLevelLabel(level.name, 10);
+        sizeLabel->setPosition(Vec2(size / 2, size * 0.22f));
+        sizeLabel->setColor(Color3B(120, 220, 255));
+        node->addChild(sizeLabel, 2);
+    }
+
     if (level.isUnlocked && level.starCount > 0) {
         std::string starStr;
         for (int s = 0; s < level.starCount; ++s) {
@@ -653,7 +681,7 @@ void LevelSelectScene::setupUnitPreview() {
     this->addChild(_unitPreviewArea, 10);
 
     if (_unitPreviewTitle) {
-        _unitPreviewTitle->setString(_currentTab == LevelTab::Defense ? "DEFENSE:" : "UNITS:");
+        _unitPreviewTitle->setString(_currentTab == LevelTab::Attack ? "UNITS:" : "DEFENSE:");
     }
 
     updateUnitPreview();
@@ -675,14 +703,13 @@ void LevelSelectScene::updateUnitPreview() {
     float baseY = origin.y + LevelSelectConfig::UNIT_PREVIEW_BOTTOM +
         (LevelSelectConfig::UNIT_PREVIEW_HEIGHT - size) / 2;
 
-    if (_currentTab == LevelTab::Defense) {
-        auto defenseLabel = Label::createWithTTF(
-            "Defense mode - no deployment",
-            "fonts/ScienceGothic.ttf",
-            10
-        );
+    if (_currentTab != LevelTab::Attack) {
+        std::string hint = (_currentTab == LevelTab::Stress)
+            ? "Stress mode - mass attack on your base, frame stats at the end"
+            : "Defense mode - no deployment";
+        auto defenseLabel = Label::createWithTTF(hint, "fonts/ScienceGothic.ttf", 10);
         if (!defenseLabel) {
-            defenseLabel = createLevelLabel("Defense mode - no deployment", 10);
+            defenseLabel = createLevelLabel(hint, 10);
         }
         defenseLabel->setAnchorPoint(Vec2(0.5f, 0.5f));
         defenseLabel->setPosition(Vec2(origin.x + visibleSize.width / 2, baseY + size / 2));
@@ -866,6 +893,11 @@ void LevelSelectScene::startBattle(int levelId) {
     // 引入战斗场景头文件在cpp顶部
     // 跳转到战斗场景，传入已选择的兵种
     // 传入已训练兵种，不使用默认兵种
+    if (_currentTab == LevelTab::Stress) {
+        auto scene = BattleScene::createStressScene(levelId);
+        Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
+        return;
+    }
     bool defenseMode = (_currentTab == LevelTab::Defense);
     auto scene = BattleScene::createScene(levelId, _selectedUnits, false, defenseMode);
     Director::getInstance()->replaceScene(TransitionFade::create(0.5f, scene));
@@ -889,10 +921,24 @@ void LevelSelectScene::switchTab(LevelTab tab) {
 
 void LevelSelectScene::updateModeButton() {
     if (_modeButtonLabel) {
-        _modeButtonLabel->setString(_currentTab == LevelTab::Defense ? "MODE: DEFENSE" : "MODE: ATTACK");
+        const char* modeText = "MODE: ATTACK";
+        if (_currentTab == LevelTab::Defense) {
+            modeText = "MODE: DEFENSE";
+        }
+        else if (_currentTab == LevelTab::Stress) {
+            modeText = "MODE: STRESS";
+        }
+        _modeButtonLabel->setString(modeText);
     }
     if (_modeButtonBg) {
-        _modeButtonBg->setColor(_currentTab == LevelTab::Defense ? Color3B(80, 60, 60) : Color3B(50, 50, 50));
+        Color3B bgColor(50, 50, 50);
+        if (_currentTab == LevelTab::Defense) {
+            bgColor = Color3B(80, 60, 60);
+        }
+        else if (_currentTab == LevelTab::Stress) {
+            bgColor = Color3B(50, 65, 85);
+        }
+        _modeButtonBg->setColor(bgColor);
     }
     if (_modeButtonBorder && _modeButtonBg) {
         Size size = _modeButtonBg->getContentSize();
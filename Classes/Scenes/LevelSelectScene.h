@@ -21,6 +21,7 @@ namespace LevelSelectConfig {
     constexpr int MAX_ATTACK_LEVELS = 12;            // 进攻关卡数
     constexpr int MAX_DEFENSE_LEVELS = 6;            // 防守关卡数
     constexpr int DEFENSE_LEVEL_OFFSET = 100;        // 防守关卡ID偏移
+    constexpr int STRESS_ARMY_SIZES[] = { 250, 500, 1000, 2000 }; // 压力测试兵力档位
     constexpr int LEVEL_GRID_COLS = 4;               // 关卡网格列数
     constexpr float LEVEL_BUTTON_SIZE = 115.0f;      // 关卡按钮尺寸
     constexpr float LEVEL_BUTTON_SPACING = 26.0f;    // 关卡按钮间距
@@ -43,7 +44,8 @@ namespace LevelSelectConfig {
 
 enum class LevelTab {
     Attack,
-    Defense
+    Defense,
+    Stress      // 压力测试（关卡ID即来袭兵力）
 };
 
 // ===================================================
@@ -26,6 +26,7 @@
 #include "MainMenuScene.h"
 #include "BaseScene.h"
 #include "Save/SaveManager.h"
+#include "Replay/ReplayManager.h"
 #include "Utils/AudioManager.h"
 #include "Utils/GameSettings.h"
 #include <algorithm>
@@ -66,6 +67,7 @@ bool MainMenuScene::init()
 	createOtherThings();
 	createModalOverlay();
     SaveManager::getInstance();
+    ReplayManager::getInstance()->preloadLastReplay();
 	
 	// 创建各个界面层
 	createMainMenuLayer();
@@ -724,6 +726,8 @@ void MainMenuScene::createSettingsLayer()
 
     addLine("[Battle]", 22, headerColor, 10.0f);
     addSpeedSelector(GameSettings::getBattleSpeed());
+    addToggle("Parallel Targeting", GameSettings::getParallelTargeting(),
+        [](bool enabled) { GameSettings::setParallelTargeting(enabled); });
 
     //Return 按钮
     auto returnBtn = createIconButton(
@@ -4,7 +4,7 @@
  */
 
 #include "GridBackground.h"
-#include <algorithm>
+#include "Utils/GridPatternUtils.h"
 
 // ===================================================
 // 创建与初始化
@@ -50,10 +50,6 @@ bool GridBackground::init(int gridWidth, int gridHeight, float cellSize) {
         this->addChild(_tileBackground, -2);
     }
 
-    // 创建网格线绘制节点
-    _gridLines = DrawNode::create();
-    this->addChild(_gridLines, -1);
-
     // 绘制网格
     drawDashedGrid();
 
@@ -66,47 +62,19 @@ bool GridBackground::init(int gridWidth, int gridHeight, float cellSize) {
 // 绘制虚线网格
 // ===================================================
 void GridBackground::drawDashedGrid() {
-    if (!_gridLines) {
-        return;
-    }
-
-    _gridLines->clear();
-
-    float dashLength = GridBackgroundConfig::DASH_LENGTH;
-    float gapLength = GridBackgroundConfig::GAP_LENGTH;
-    Color4F lineColor = GridBackgroundConfig::LINE_COLOR;
-
-    float totalWidth = _gridWidth * _cellSize;
-    float totalHeight = _gridHeight * _cellSize;
-
-    // 绘制竖线
-    for (int x = 0; x <= _gridWidth; ++x) {
-        float xPos = x * _cellSize;
-        float y = 0;
-        while (y < totalHeight) {
-            float endY = std::min(y + dashLength, totalHeight);
-            _gridLines->drawLine(
-                Vec2(xPos, y),
-                Vec2(xPos, endY),
-                lineColor
-            );
-            y += dashLength + gapLength;
-        }
+    if (_gridLines) {
+        _gridLines->removeFromParent();
+        _gridLines = nullptr;
     }
 
-    // 绘制横线
-    for (int y = 0; y <= _gridHeight; ++y) {
-        float yPos = y * _cellSize;
-        float x = 0;
-        while (x < totalWidth) {
-            float endX = std::min(x + dashLength, totalWidth);
-            _gridLines->drawLine(
-                Vec2(x, yPos),
-                Vec2(endX, yPos),
-                lineColor
-            );
-            x += dashLength + gapLength;
-        }
+    // 虚线网格纹理按参数缓存，重绘只是重建一个平铺精灵
+    _gridLines = GridPatternUtils::createGridLineSprite(
+        _gridWidth, _gridHeight, _cellSize,
+        GridBackgroundConfig::LINE_COLOR,
+        GridBackgroundConfig::DASH_LENGTH,
+        GridBackgroundConfig::GAP_LENGTH);
+    if (_gridLines) {
+        this->addChild(_gridLines, -1);
     }
 }
 
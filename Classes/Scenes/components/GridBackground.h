@@ -56,10 +56,10 @@ private:
 
     LayerColor* _bgColor = nullptr;
     Sprite* _tileBackground = nullptr;
-    DrawNode* _gridLines = nullptr;
+    Sprite* _gridLines = nullptr;
 
     /**
-     * @brief 绘制虚线网格
+     * @brief 绘制虚线网格（单格纹理平铺，顶点数恒定）
      */
     void drawDashedGrid();
 };
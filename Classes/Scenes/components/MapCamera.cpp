@@ -0,0 +1,250 @@
+﻿/**
+ * @file MapCamera.cpp
+ * @brief 地图视角控制实现
+ */
+
+#include "MapCamera.h"
+#include "Utils/AnimationLod.h"
+#include <algorithm>
+
+// ===================================================
+// 创建与初始化
+// ===================================================
+MapCamera* MapCamera::create(GridMap* gridMap, const Rect& viewport, float minZoom, float maxZoom) {
+    MapCamera* ret = new (std::nothrow) MapCamera();
+    if (ret && ret->init(gridMap, viewport, minZoom, maxZoom)) {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+bool MapCamera::init(GridMap* gridMap, const Rect& viewport, float minZoom, float maxZoom) {
+    if (!Node::init() || !gridMap) {
+        return false;
+    }
+
+    _gridMap = gridMap;
+    _viewport = viewport;
+    _minZoom = std::max(0.05f, std::min(minZoom, maxZoom));
+    _maxZoom = std::max(_minZoom, maxZoom);
+
+    clampToViewport();
+    initInput();
+    this->scheduleUpdate();
+
+    return true;
+}
+
+ChunkedLayer* MapCamera::createLayerForMap(GridMap* gridMap, bool dynamicChildren) {
+    if (!gridMap) {
+        return nullptr;
+    }
+    float cellSize = gridMap->getCellSize();
+    Size mapSize(gridMap->getGridWidth() * cellSize, gridMap->getGridHeight() * cellSize);
+    return ChunkedLayer::create(mapSize, cellSize * MapCameraConfig::CHUNK_CELLS, dynamicChildren);
+}
+
+void MapCamera::addCulledLayer(ChunkedLayer* layer) {
+    if (!layer) {
+        return;
+    }
+    if (std::find(_culledLayers.begin(), _culledLayers.end(), layer) == _culledLayers.end()) {
+        _culledLayers.push_back(layer);
+    }
+    refreshCulling();
+}
+
+void MapCamera::addAnimationLodLayer(Node* layer) {
+    if (!layer) {
+        return;
+    }
+    if (std::find(_lodLayers.begin(), _lodLayers.end(), layer) == _lodLayers.end()) {
+        _lodLayers.push_back(layer);
+    }
+}
+
+// ===================================================
+// 输入处理
+// ===================================================
+void MapCamera::initInput() {
+    auto mouseListener = EventListenerMouse::create();
+    mouseListener->onMouseDown = [this](EventMouse* event) {
+        auto button = event->getMouseButton();
+        if (button != EventMouse::MouseButton::BUTTON_RIGHT
+            && button != EventMouse::MouseButton::BUTTON_MIDDLE) {
+            return;
+        }
+        if (!isInputAllowed()) {
+            return;
+        }
+        _dragging = true;
+        _lastDragPos = Vec2(event->getCursorX(), event->getCursorY());
+    };
+    mouseListener->onMouseMove = [this](EventMouse* event) {
+        if (!_dragging) {
+            return;
+        }
+        Vec2 cursor(event->getCursorX(), event->getCursorY());
+        panBy(cursor - _lastDragPos);
+        _lastDragPos = cursor;
+    };
+    mouseListener->onMouseUp = [this](EventMouse*) {
+        _dragging = false;
+    };
+    mouseListener->onMouseScroll = [this](EventMouse* event) {
+        if (!isInputAllowed()) {
+            return;
+        }
+        float scroll = event->getScrollY();
+        if (scroll == 0.0f) {
+            return;
+        }
+        float factor = scroll > 0.0f ? 1.0f / MapCameraConfig::ZOOM_STEP : MapCameraConfig::ZOOM_STEP;
+        zoomAt(Vec2(event->getCursorX(), event->getCursorY()), factor);
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(mouseListener, this);
+
+    auto keyListener = EventListenerKeyboard::create();
+    auto keyToDir = [](EventKeyboard::KeyCode code) -> Vec2 {
+        switch (code) {
+        case EventKeyboard::KeyCode::KEY_LEFT_ARROW:
+        case EventKeyboard::KeyCode::KEY_A:
+            return Vec2(1.0f, 0.0f);
+        case EventKeyboard::KeyCode::KEY_RIGHT_ARROW:
+        case EventKeyboard::KeyCode::KEY_D:
+            return Vec2(-1.0f, 0.0f);
+        case EventKeyboard::KeyCode::KEY_UP_ARROW:
+        case EventKeyboard::KeyCode::KEY_W:
+            return Vec2(0.0f, -1.0f);
+        case EventKeyboard::KeyCode::KEY_DOWN_ARROW:
+        case EventKeyboard::KeyCode::KEY_S:
+            return Vec2(0.0f, 1.0f);
+        default:
+            return Vec2::ZERO;
+        }
+    };
+    keyListener->onKeyPressed = [this, keyToDir](EventKeyboard::KeyCode code, Event*) {
+        _keyPanDir += keyToDir(code);
+    };
+    keyListener->onKeyReleased = [this, keyToDir](EventKeyboard::KeyCode code, Event*) {
+        _keyPanDir -= keyToDir(code);
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(keyListener, this);
+}
+
+bool MapCamera::isInputAllowed() const {
+    return !_inputFilter || _inputFilter();
+}
+
+void MapCamera::update(float dt) {
+    // 按实际帧间隔计时，不受战斗倍速影响
+    float realDt = dt;
+    auto* scheduler = Director::getInstance()->getScheduler();
+    if (scheduler && scheduler->getTimeScale() > 0.0f) {
+        realDt = dt / scheduler->getTimeScale();
+    }
+
+    if (_keyPanDir != Vec2::ZERO && isInputAllowed()) {
+        panBy(_keyPanDir * (MapCameraConfig::KEY_PAN_SPEED * realDt));
+    }
+
+    _lodTimer += realDt;
+    if (_lodTimer >= MapCameraConfig::LOD_INTERVAL) {
+        _lodTimer = 0.0f;
+        refreshAnimationLod();
+    }
+}
+
+// ===================================================
+// 视角变换
+// ===================================================
+void MapCamera::panBy(const Vec2& screenDelta) {
+    if (!_gridMap) {
+        return;
+    }
+    _gridMap->setPosition(_gridMap->getPosition() + screenDelta);
+    clampToViewport();
+}
+
+void MapCamera::zoomAt(const Vec2& screenPos, float factor) {
+    if (!_gridMap || factor <= 0.0f) {
+        return;
+    }
+    float oldScale = _gridMap->getScale();
+    float newScale = std::max(_minZoom, std::min(_maxZoom, oldScale * factor));
+    if (newScale == oldScale) {
+        return;
+    }
+
+    // 保持光标下的地图点不动
+    Vec2 anchorLocal = _gridMap->convertToNodeSpace(screenPos);
+    _gridMap->setScale(newScale);
+    Vec2 anchorAfter = _gridMap->convertToWorldSpace(anchorLocal);
+    _gridMap->setPosition(_gridMap->getPosition() + (screenPos - anchorAfter));
+    clampToViewport();
+}
+
+void MapCamera::clampToViewport() {
+    if (!_gridMap) {
+        return;
+    }
+
+    float scale = _gridMap->getScale();
+    float mapWidth = _gridMap->getGridWidth() * _gridMap->getCellSize() * scale;
+    float mapHeight = _gridMap->getGridHeight() * _gridMap->getCellSize() * scale;
+    Vec2 pos = _gridMap->getPosition();
+
+    // 地图小于视口时居中，否则保证视口内始终铺满地图
+    if (mapWidth <= _viewport.size.width) {
+        pos.x = _viewport.getMidX() - mapWidth * 0.5f;
+    }
+    else {
+        pos.x = std::min(_viewport.getMinX(), std::max(_viewport.getMaxX() - mapWidth, pos.x));
+    }
+    if (mapHeight <= _viewport.size.height) {
+        pos.y = _viewport.getMidY() - mapHeight * 0.5f;
+    }
+    else {
+        pos.y = std::min(_viewport.getMinY(), std::max(_viewport.getMaxY() - mapHeight, pos.y));
+    }
+
+    _gridMap->setPosition(pos);
+    refreshCulling();
+}
+
+Rect MapCamera::getVisibleMapRect() const {
+    if (!_gridMap) {
+        return Rect::ZERO;
+    }
+    // GridMap 仅有平移与等比缩放，两个角点即可确定可见区域
+    Vec2 bottomLeft = _gridMap->convertToNodeSpace(_viewport.origin);
+    Vec2 topRight = _gridMap->convertToNodeSpace(
+        Vec2(_viewport.getMaxX(), _viewport.getMaxY()));
+    return Rect(bottomLeft.x, bottomLeft.y, topRight.x - bottomLeft.x, topRight.y - bottomLeft.y);
+}
+
+void MapCamera::refreshCulling() {
+    if (_culledLayers.empty() || !_gridMap) {
+        return;
+    }
+    Rect visibleRect = getVisibleMapRect();
+    float margin = _gridMap->getCellSize() * MapCameraConfig::CULL_MARGIN_CELLS;
+    for (auto* layer : _culledLayers) {
+        layer->setCullRect(visibleRect, margin);
+    }
+}
+
+void MapCamera::refreshAnimationLod() {
+    if (_lodLayers.empty() || !_gridMap) {
+        return;
+    }
+    // LOD图层与GridMap同坐标系，可直接使用可见区域
+    Rect visibleRect = getVisibleMapRect();
+    float crowdCellSize = _gridMap->getCellSize() * MapCameraConfig::LOD_CROWD_CELLS;
+    float zoom = _gridMap->getScale();
+    for (auto* layer : _lodLayers) {
+        AnimationLod::updateLayer(layer, visibleRect, crowdCellSize, zoom);
+    }
+}
@@ -0,0 +1,110 @@
+﻿/**
+ * @file MapCamera.h
+ * @brief 地图视角控制组件
+ *
+ * 通过平移/缩放 GridMap 节点实现地图视角控制，并把当前可见区域
+ * 同步给各个 ChunkedLayer 做视口裁剪，使渲染开销只与可见内容相关。
+ * 操作方式：鼠标右键/中键拖拽平移、滚轮缩放、方向键/WASD 平移。
+ */
+
+#ifndef __MAP_CAMERA_H__
+#define __MAP_CAMERA_H__
+
+#include "cocos2d.h"
+#include "Map/GridMap.h"
+#include "Map/ChunkedLayer.h"
+#include <functional>
+#include <vector>
+
+USING_NS_CC;
+
+// ===================================================
+// 视角控制配置常量
+// ===================================================
+namespace MapCameraConfig {
+    constexpr float ZOOM_STEP = 1.1f;           // 滚轮每格缩放倍率
+    constexpr float KEY_PAN_SPEED = 720.0f;     // 键盘平移速度（屏幕像素/秒）
+    constexpr float CHUNK_CELLS = 8.0f;         // 分块边长（格子数）
+    constexpr float CULL_MARGIN_CELLS = 6.0f;   // 裁剪外扩（格子数），覆盖最大建筑与血条
+    constexpr float LOD_INTERVAL = 0.2f;        // 动画LOD刷新间隔（秒）
+    constexpr float LOD_CROWD_CELLS = 2.0f;     // 拥挤度统计格边长（格子数）
+}
+
+// ===================================================
+// 地图视角控制类
+// ===================================================
+class MapCamera : public Node {
+public:
+    /**
+     * @brief 创建视角控制器
+     * @param gridMap 被控制的网格地图（需已设置好初始位置与缩放）
+     * @param viewport 地图可见区域（世界坐标，不含上下UI）
+     * @param minZoom 最小缩放
+     * @param maxZoom 最大缩放
+     */
+    static MapCamera* create(GridMap* gridMap, const Rect& viewport, float minZoom, float maxZoom);
+
+    /**
+     * @brief 初始化
+     */
+    virtual bool init(GridMap* gridMap, const Rect& viewport, float minZoom, float maxZoom);
+
+    virtual void update(float dt) override;
+
+    /**
+     * @brief 创建与地图等大的分块裁剪层
+     */
+    static ChunkedLayer* createLayerForMap(GridMap* gridMap, bool dynamicChildren);
+
+    /**
+     * @brief 注册需要视口裁剪的图层（需为 GridMap 的直接子节点且无变换）
+     */
+    void addCulledLayer(ChunkedLayer* layer);
+
+    /**
+     * @brief 注册需要动画LOD的图层（屏幕外冻结、扎堆/缩小时降频）
+     */
+    void addAnimationLodLayer(Node* layer);
+
+    /**
+     * @brief 按屏幕像素平移地图
+     */
+    void panBy(const Vec2& screenDelta);
+
+    /**
+     * @brief 以屏幕上某点为中心缩放
+     */
+    void zoomAt(const Vec2& screenPos, float factor);
+
+    /**
+     * @brief 设置输入过滤（返回false时忽略视角操作，如有面板打开时）
+     */
+    void setInputFilter(const std::function<bool()>& filter) { _inputFilter = filter; }
+
+    /**
+     * @brief 获取当前可见的地图区域（GridMap本地坐标）
+     */
+    Rect getVisibleMapRect() const;
+
+private:
+    GridMap* _gridMap = nullptr;
+    Rect _viewport;
+    float _minZoom = 1.0f;
+    float _maxZoom = 1.0f;
+    std::vector<ChunkedLayer*> _culledLayers;
+    std::vector<Node*> _lodLayers;
+    float _lodTimer = 0.0f;
+    std::function<bool()> _inputFilter;
+
+    bool _dragging = false;
+    Vec2 _lastDragPos;
+    Vec2 _keyPanDir;
+
+    void initInput();
+    bool isInputAllowed() const;
+    void clampToViewport();
+    void refreshCulling();
+    void refreshAnimationLod();
+};
+
+#endif // __MAP_CAMERA_H__
@@ -52,11 +52,6 @@ bool PlacementManager::init(
     _onPlacementConfirmed = onPlacementConfirmed;
     _onPlacementCancelled = onPlacementCancelled;
 
-    // 创建全地图格子显示节点
-    _gridDisplayNode = DrawNode::create();
-    this->addChild(_gridDisplayNode, 0);
-    _gridDisplayNode->setVisible(false);
-
     // 创建放置位置格子显示节点
     _placementGridNode = DrawNode::create();
     this->addChild(_placementGridNode, 1);
@@ -140,52 +135,21 @@ void PlacementManager::startPlacement(const BuildingOption& option) {
 // 绘制全地图格子状态（建造模式时显示）
 // ===================================================
 void PlacementManager::drawAllGridCells() {
-    if (!_gridMap || !_gridDisplayNode) return;
-
-    _gridDisplayNode->clear();
-    _gridDisplayNode->setVisible(true);
-
-    float cellSize = _gridMap->getCellSize();
-    int gridWidth = _gridMap->getGridWidth();
-    int gridHeight = _gridMap->getGridHeight();
-
-    // 遍历所有格子，根据状态绘制不同颜色
-    for (int y = 0; y < gridHeight; ++y) {
-        for (int x = 0; x < gridWidth; ++x) {
-            Vec2 bottomLeft(x * cellSize, y * cellSize);
-            Vec2 topRight((x + 1) * cellSize, (y + 1) * cellSize);
+    if (!_gridMap) return;
 
-            // 检查格子是否可以放置建筑（单格检测）
-            bool canPlace = _gridMap->canPlaceBuilding(x, y, 1, 1);
-
-            Color4F fillColor;
-            if (canPlace) {
-                fillColor = PlacementConfig::GRID_COLOR_EMPTY;  // 空闲：淡绿色
-            }
-            else {
-                // 检查是否是边界禁止区域
-                if (x < 2 || x >= gridWidth - 2 || y < 2 || y >= gridHeight - 2) {
-                    fillColor = PlacementConfig::GRID_COLOR_FORBIDDEN;  // 禁止区域：深灰色
-                }
-                else {
-                    fillColor = PlacementConfig::GRID_COLOR_OCCUPIED;   // 已占用：灰色
-                }
-            }
-
-            // 绘制填充矩形
-            _gridDisplayNode->drawSolidRect(bottomLeft, topRight, fillColor);
-        }
-    }
-
-    CCLOG("[放置管理器] 绘制全地图格子状态完成");
+    // 格子状态由GridMap的纹理覆盖层维护，占用变化时只上传变化的格子
+    _gridMap->setCellOverlayColors(PlacementConfig::GRID_COLOR_EMPTY,
+                                   PlacementConfig::GRID_COLOR_OCCUPIED,
+                                   PlacementConfig::GRID_COLOR_FORBIDDEN);
+    _gridMap->showCellOverlay(true);
 }
 
 // ===================================================
 // 隐藏格子状态显示
 // ===================================================
 void PlacementManager::hideGridDisplay() {
-    if (_gridDisplayNode) {
-        _gridDisplayNode->setVisible(false);
+    if (_gridMap) {
+        _gridMap->showCellOverlay(false);
     }
     if (_placementGridNode) {
         _placementGridNode->setVisible(false);
@@ -239,6 +203,15 @@ void PlacementManager::updatePreviewPosition(const Vec2& worldPos) {
 void PlacementManager::updatePlacementGridDisplay(int gridX, int gridY, bool canPlace) {
     if (!_placementGridNode || !_gridMap) return;
 
+    // 位置与可放置状态均未变化时无需重绘
+    if (_placementGridNode->isVisible() && gridX == _displayGridX && gridY == _displayGridY
+        && canPlace == _displayCanPlace) {
+        return;
+    }
+    _displayGridX = gridX;
+    _displayGridY = gridY;
+    _displayCanPlace = canPlace;
+
     _placementGridNode->clear();
     _placementGridNode->setVisible(true);
 
@@ -253,27 +226,17 @@ void PlacementManager::updatePlacementGridDisplay(int gridX, int gridY, bool can
         PlacementConfig::GRID_BORDER_CAN_PLACE :
         PlacementConfig::GRID_BORDER_CANNOT_PLACE;
 
-    // 绘制建筑占用的每个格子
-    for (int dy = 0; dy < _state.gridHeight; ++dy) {
-        for (int dx = 0; dx < _state.gridWidth; ++dx) {
-            int cellX = gridX + dx;
-            int cellY = gridY + dy;
-
-            Vec2 bottomLeft(cellX * cellSize, cellY * cellSize);
-            Vec2 topRight((cellX + 1) * cellSize, (cellY + 1) * cellSize);
-
-            // 绘制填充矩形
-            _placementGridNode->drawSolidRect(bottomLeft, topRight, fillColor);
-
-            // 绘制边框
-            Vec2 vertices[] = {
-                bottomLeft,
-                Vec2(topRight.x, bottomLeft.y),
-                topRight,
-                Vec2(bottomLeft.x, topRight.y)
-            };
-            _placementGridNode->drawPolygon(vertices, 4, Color4F(0, 0, 0, 0), 1.0f, borderColor);
-        }
+    // 占地区域整体填充一次，格子边框用 (w+1)+(h+1) 条线绘制
+    Vec2 bottomLeft(gridX * cellSize, gridY * cellSize);
+    Vec2 topRight((gridX + _state.gridWidth) * cellSize, (gridY + _state.gridHeight) * cellSize);
+    _placementGridNode->drawSolidRect(bottomLeft, topRight, fillColor);
+    for (int dx = 0; dx <= _state.gridWidth; ++dx) {
+        float x = (gridX + dx) * cellSize;
+        _placementGridNode->drawLine(Vec2(x, bottomLeft.y), Vec2(x, topRight.y), borderColor);
+    }
+    for (int dy = 0; dy <= _state.gridHeight; ++dy) {
+        float y = (gridY + dy) * cellSize;
+        _placementGridNode->drawLine(Vec2(bottomLeft.x, y), Vec2(topRight.x, y), borderColor);
     }
 
     updatePlacementOverlays(gridX, gridY, canPlace);
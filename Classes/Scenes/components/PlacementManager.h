@@ -118,7 +118,7 @@ public:
     const PlacementState& getState() const { return _state; }
 
     /**
-     * @brief 绘制全地图格子状态（建造模式时显示）
+     * @brief 显示全地图格子状态（建造模式时显示，由GridMap纹理覆盖层增量维护）
      */
     void drawAllGridCells();
 
@@ -133,7 +133,6 @@ private:
 
     // UI组件
     Sprite* _previewSprite = nullptr;       // 建筑预览精灵
-    DrawNode* _gridDisplayNode = nullptr;   // 全地图格子显示节点
     DrawNode* _placementGridNode = nullptr; // 当前放置位置格子显示节点
     DrawNode* _placementFootprintNode = nullptr; // 建筑占地轮廓
     DrawNode* _placementRangeNode = nullptr;     // 攻击范围提示
@@ -147,6 +146,9 @@ private:
     int _currentGridY = 0;
     int _lastPaintGridX = -9999;
     int _lastPaintGridY = -9999;
+    int _displayGridX = -9999;              // 当前已绘制的放置格子位置
+    int _displayGridY = -9999;
+    bool _displayCanPlace = false;
 
     // 回调函数
     std::function<void(const BuildingOption&, int, int)> _onPlacementConfirmed;
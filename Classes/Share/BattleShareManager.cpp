@@ -1,22 +1,31 @@
 #include "Share/BattleShareManager.h"
 #include "Core/Core.h"
+#include "Share/SnapshotCodec.h"
 #include "Soldier/UnitManager.h"
 #include "json/document.h"
 #include "json/stringbuffer.h"
 #include "json/writer.h"
+#include <cstring>
 #include <functional>
+#include <memory>
 
 using namespace cocos2d;
 
 namespace {
 constexpr int kSnapshotVersion = 1;
 const char* kShareDir = "share/";
-const char* kOutgoingSnapshotFile = "my_base_snapshot.json";
-const char* kIncomingSnapshotFile = "target_base_snapshot.json";
+const char* kOutgoingSnapshotFile = "my_base_snapshot.vkb";
+const char* kOutgoingDeltaFile = "my_base_snapshot.delta.vkb";
+const char* kIncomingSnapshotFile = "target_base_snapshot.vkb";
+const char* kIncomingLegacySnapshotFile = "target_base_snapshot.json";
+const char* kIncomingDeltaFile = "target_base_snapshot.delta.vkb";
+const char* kBinarySnapshotExt = ".vkb";
 const char* kOutgoingReplayFile = "last_replay.json";
 const char* kIncomingReplayFile = "target_replay.json";
 const char* kBuildingsConfigPath = "res/buildings_config.json";
 const char* kUnitsConfigPath = "res/units_config.json";
+// 任务线程内 JSON 节点使用线程私有临时内存区的大小
+constexpr size_t kJsonScratchBytes = 32 * 1024;
 
 int readInt(const rapidjson::Value& obj, const char* key, int fallback) {
     auto it = obj.FindMember(key);
@@ -65,55 +74,56 @@ std::string toHexHash(size_t value) {
     return buffer;
 }
 
-bool writeDocumentToFile(const rapidjson::Document& doc, const std::string& path) {
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    doc.Accept(writer);
-    return FileUtils::getInstance()->writeStringToFile(buffer.GetString(), path);
-}
-} // namespace
-
-BattleShareManager* BattleShareManager::s_instance = nullptr;
-
-BattleShareManager* BattleShareManager::getInstance() {
-    if (!s_instance) {
-        s_instance = new BattleShareManager();
+std::string categoryToString(BuildingCategory category) {
+    switch (category) {
+    case BuildingCategory::Defence:
+        return "defence";
+    case BuildingCategory::Production:
+        return "production";
+    case BuildingCategory::Storage:
+        return "storage";
+    case BuildingCategory::Trap:
+        return "trap";
+    default:
+        return "unknown";
     }
-    return s_instance;
-}
-
-BaseSnapshot BattleShareManager::captureCurrentBase() const {
-    BaseSnapshot snapshot;
-    snapshot.version = kSnapshotVersion;
-    snapshot.configHash = computeConfigHash();
-    snapshot.baseLevel = std::max(0, Core::getInstance()->getBaseLevel() - 1);
-    snapshot.barracksLevel = std::max(0, BaseScene::getBarracksLevel());
-    snapshot.baseAnchor = BaseScene::getBaseAnchorGrid();
-    snapshot.barracksAnchor = BaseScene::getBarracksAnchorGrid();
-    snapshot.buildings = BaseScene::getSavedBuildings();
-    return snapshot;
 }
 
-bool BattleShareManager::exportPlayerBaseSnapshot(std::string* outPath) {
-    BaseSnapshot snapshot = captureCurrentBase();
-    std::string path = getOutgoingSnapshotPath();
-    bool ok = saveSnapshotToPath(snapshot, path);
-    if (ok && outPath) {
-        *outPath = path;
+BuildingCategory stringToCategory(const std::string& str) {
+    if (str == "defence" || str == "defense") {
+        return BuildingCategory::Defence;
     }
-    return ok;
+    if (str == "production") {
+        return BuildingCategory::Production;
+    }
+    if (str == "storage") {
+        return BuildingCategory::Storage;
+    }
+    if (str == "trap") {
+        return BuildingCategory::Trap;
+    }
+    return BuildingCategory::Unknown;
 }
 
-bool BattleShareManager::loadIncomingSnapshot(BaseSnapshot* outSnapshot) {
-    if (!outSnapshot) {
-        return false;
+// 以下函数只处理纯数据，在任务线程执行
+// 配置读不到时返回空串（快照视为未知配置），不能拿两份空内容算出一个看似有效的哈希
+std::string hashConfigFiles(const std::string& buildingFull, const std::string& unitFull) {
+    std::string buildingData;
+    std::string unitData;
+    std::string error;
+    if (!JobIO::readFile(buildingFull, buildingData, &error)
+        || !JobIO::readFile(unitFull, unitData, &error)) {
+        CCLOG("[分享] 配置哈希计算失败: %s", error.c_str());
+        return "";
     }
-    return loadSnapshotFromPath(getIncomingSnapshotPath(), outSnapshot);
+    std::string merged = buildingData + "|" + unitData;
+    std::hash<std::string> hasher;
+    return toHexHash(hasher(merged));
 }
 
-bool BattleShareManager::saveSnapshotToPath(const BaseSnapshot& snapshot, const std::string& path) {
-    ensureShareDirectory();
-    rapidjson::Document doc;
+std::string serializeSnapshot(const BaseSnapshot& snapshot) {
+    rapidjson::MemoryPoolAllocator<> allocator(JobSystem::scratch().allocate(kJsonScratchBytes), kJsonScratchBytes);
+    rapidjson::Document doc(&allocator);
     doc.SetObject();
     auto& alloc = doc.GetAllocator();
 
@@ -154,23 +164,15 @@ bool BattleShareManager::saveSnapshotToPath(const BaseSnapshot& snapshot, const
     }
     doc.AddMember("buildings", buildings, alloc);
 
-    return writeDocumentToFile(doc, path);
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+    return buffer.GetString();
 }
 
-bool BattleShareManager::loadSnapshotFromPath(const std::string& path, BaseSnapshot* outSnapshot) {
-    if (!outSnapshot) {
-        return false;
-    }
-    auto* fileUtils = FileUtils::getInstance();
-    if (!fileUtils->isFileExist(path)) {
-        return false;
-    }
-    std::string data = fileUtils->getStringFromFile(path);
-    if (data.empty()) {
-        return false;
-    }
-
-    rapidjson::Document doc;
+bool parseSnapshot(const std::string& data, BaseSnapshot* outSnapshot) {
+    rapidjson::MemoryPoolAllocator<> allocator(JobSystem::scratch().allocate(kJsonScratchBytes), kJsonScratchBytes);
+    rapidjson::Document doc(&allocator);
     doc.Parse(data.c_str());
     if (doc.HasParseError() || !doc.IsObject()) {
         return false;
@@ -217,6 +219,184 @@ bool BattleShareManager::loadSnapshotFromPath(const std::string& path, BaseSnaps
     return true;
 }
 
+bool isBinarySnapshotPath(const std::string& path) {
+    const size_t extLength = strlen(kBinarySnapshotExt);
+    return path.size() >= extLength && path.compare(path.size() - extLength, extLength, kBinarySnapshotExt) == 0;
+}
+
+std::string encodeSnapshot(const BaseSnapshot& snapshot, const std::string& path) {
+    return isBinarySnapshotPath(path) ? SnapshotCodec::encode(snapshot) : serializeSnapshot(snapshot);
+}
+
+// 按内容识别格式：二进制快照解码，其余按旧版 JSON 解析，之后都校验占地
+bool readSnapshotFile(const std::string& path, const SnapshotCatalog& catalog, BaseSnapshot* outSnapshot) {
+    std::string data;
+    std::string error;
+    if (!JobIO::readFile(path, data, &error)) {
+        CCLOG("[分享] 读取快照失败: %s", error.c_str());
+        return false;
+    }
+    if (data.empty()) {
+        CCLOG("[分享] 快照 %s 为空", path.c_str());
+        return false;
+    }
+    // 两种格式走同一套校验：建筑数量、类型、越界与占地重叠
+    bool ok = false;
+    if (SnapshotCodec::isBinary(data)) {
+        ok = SnapshotCodec::decode(data, catalog, outSnapshot, &error);
+    }
+    else {
+        BaseSnapshot snapshot;
+        if (!parseSnapshot(data, &snapshot)) {
+            error = "malformed JSON";
+        }
+        else if (SnapshotCodec::restoreAndValidate(&snapshot, catalog, &error)) {
+            *outSnapshot = std::move(snapshot);
+            ok = true;
+        }
+    }
+    if (!ok) {
+        CCLOG("[分享] 快照 %s 无效: %s", path.c_str(), error.c_str());
+    }
+    return ok;
+}
+} // namespace
+
+BattleShareManager* BattleShareManager::s_instance = nullptr;
+
+BattleShareManager* BattleShareManager::getInstance() {
+    if (!s_instance) {
+        s_instance = new BattleShareManager();
+    }
+    return s_instance;
+}
+
+BaseSnapshot BattleShareManager::captureCurrentBase() const {
+    BaseSnapshot snapshot;
+    snapshot.version = kSnapshotVersion;
+    snapshot.baseLevel = std::max(0, Core::getInstance()->getBaseLevel() - 1);
+    snapshot.barracksLevel = std::max(0, BaseScene::getBarracksLevel());
+    snapshot.baseAnchor = BaseScene::getBaseAnchorGrid();
+    snapshot.barracksAnchor = BaseScene::getBarracksAnchorGrid();
+    snapshot.buildings = BaseScene::getSavedBuildings();
+    return snapshot;
+}
+
+// 导出完整二进制快照；本次运行中导出过的话，再写一份相对上次导出的增量
+void BattleShareManager::exportPlayerBaseSnapshot(const ExportCallback& onDone) {
+    ensureShareDirectory();
+    std::string buildingFull;
+    std::string unitFull;
+    resolveConfigPaths(&buildingFull, &unitFull);
+    BaseSnapshot snapshot = captureCurrentBase();
+    std::string path = getOutgoingSnapshotPath();
+    std::string deltaPath = buildSharePath(kOutgoingDeltaFile);
+    auto previous = _hasLastExport ? std::make_shared<BaseSnapshot>(_lastExport) : nullptr;
+    queueIoJob("share.exportSnapshot", [this, snapshot, path, deltaPath, previous, buildingFull, unitFull, onDone]() {
+        auto output = std::make_shared<BaseSnapshot>(snapshot);
+        output->configHash = hashConfigFiles(buildingFull, unitFull);
+        std::string error;
+        bool ok = JobIO::writeFile(path, SnapshotCodec::encode(*output), &error);
+        if (!ok) {
+            CCLOG("[分享] 导出快照失败: %s", error.c_str());
+        }
+        else if (previous) {
+            std::string delta = SnapshotCodec::encodeDelta(*previous, *output);
+            if (JobIO::writeFile(deltaPath, delta, &error)) {
+                CCLOG("[分享] 增量快照 %d 字节", static_cast<int>(delta.size()));
+            }
+            else {
+                CCLOG("[分享] 导出增量快照失败: %s", error.c_str());
+            }
+        }
+        JobSystem::runOnMainThread([this, onDone, ok, path, output]() {
+            if (ok) {
+                _lastExport = *output;
+                _hasLastExport = true;
+            }
+            if (onDone) {
+                onDone(ok, path);
+            }
+        });
+    });
+}
+
+// 先读完整快照（优先二进制），目录中有增量快照且基准吻合时再在其上应用
+void BattleShareManager::loadIncomingSnapshot(const SnapshotCallback& onDone) {
+    std::string path = getIncomingSnapshotPath();
+    std::string deltaPath = buildSharePath(kIncomingDeltaFile);
+    if (!FileUtils::getInstance()->isFileExist(deltaPath)) {
+        deltaPath.clear();
+    }
+    SnapshotCatalog catalog = SnapshotCatalog::capture();
+    queueIoJob("share.loadIncomingSnapshot", [path, deltaPath, catalog, onDone]() {
+        auto snapshot = std::make_shared<BaseSnapshot>();
+        bool ok = readSnapshotFile(path, catalog, snapshot.get());
+        std::string delta;
+        std::string error;
+        if (ok && !deltaPath.empty() && !JobIO::readFile(deltaPath, delta, &error)) {
+            CCLOG("[分享] 读取增量快照失败: %s", error.c_str());
+        }
+        else if (ok && !deltaPath.empty() && SnapshotCodec::isDelta(delta)) {
+            BaseSnapshot updated;
+            std::string error;
+            if (SnapshotCodec::applyDelta(*snapshot, delta, catalog, &updated, &error)) {
+                *snapshot = std::move(updated);
+            }
+            else {
+                CCLOG("[分享] 忽略增量快照: %s", error.c_str());
+            }
+        }
+        if (onDone) {
+            JobSystem::runOnMainThread([onDone, ok, snapshot]() {
+                onDone(ok, *snapshot);
+            });
+        }
+    });
+}
+
+void BattleShareManager::saveSnapshotAsync(const BaseSnapshot& snapshot, const std::string& path,
+                                           const ExportCallback& onDone) {
+    ensureShareDirectory();
+    std::string buildingFull;
+    std::string unitFull;
+    resolveConfigPaths(&buildingFull, &unitFull);
+    queueIoJob("share.saveSnapshot", [snapshot, path, buildingFull, unitFull, onDone]() {
+        BaseSnapshot output = snapshot;
+        if (output.configHash.empty()) {
+            output.configHash = hashConfigFiles(buildingFull, unitFull);
+        }
+        std::string error;
+        bool ok = JobIO::writeFile(path, encodeSnapshot(output, path), &error);
+        if (!ok) {
+            CCLOG("[分享] 保存快照失败: %s", error.c_str());
+        }
+        if (onDone) {
+            JobSystem::runOnMainThread([onDone, ok, path]() {
+                onDone(ok, path);
+            });
+        }
+    });
+}
+
+void BattleShareManager::loadSnapshotAsync(const std::string& path, const SnapshotCallback& onDone) {
+    SnapshotCatalog catalog = SnapshotCatalog::capture();
+    queueIoJob("share.loadSnapshot", [path, catalog, onDone]() {
+        auto snapshot = std::make_shared<BaseSnapshot>();
+        bool ok = readSnapshotFile(path, catalog, snapshot.get());
+        if (onDone) {
+            JobSystem::runOnMainThread([onDone, ok, snapshot]() {
+                onDone(ok, *snapshot);
+            });
+        }
+    });
+}
+
+void BattleShareManager::queueIoJob(const char* name, std::function<void()> task) {
+    // 只在主线程调用：每个任务依赖上一个，保证分享文件按提交顺序读写
+    _ioChain = JobSystem::getInstance()->submit(name, std::move(task), { _ioChain });
+}
+
 void BattleShareManager::setActiveTargetSnapshot(const BaseSnapshot& snapshot) {
     _targetSnapshot = snapshot;
     _hasTargetSnapshot = true;
@@ -235,25 +415,26 @@ void BattleShareManager::clearActiveTargetSnapshot() {
     _targetSnapshot = BaseSnapshot();
 }
 
-bool BattleShareManager::exportLastReplay(std::string* outPath) {
-    auto* replayMgr = ReplayManager::getInstance();
-    const BattleReplay* replay = replayMgr->getLastReplay();
-    if (!replay) {
-        return false;
-    }
+void BattleShareManager::exportLastReplay(const ExportCallback& onDone) {
+    // 回放尚未预读时先在后台读取，不阻塞当前帧
     std::string path = getOutgoingReplayPath();
-    bool ok = replayMgr->exportReplayTo(path, *replay);
-    if (ok && outPath) {
-        *outPath = path;
-    }
-    return ok;
+    ReplayManager::getInstance()->preloadLastReplay([onDone, path](const BattleReplay* replay) {
+        if (!replay) {
+            if (onDone) {
+                onDone(false, "");
+            }
+            return;
+        }
+        ReplayManager::getInstance()->exportReplayAsync(path, *replay, [onDone, path](bool ok) {
+            if (onDone) {
+                onDone(ok, path);
+            }
+        });
+    });
 }
 
-bool BattleShareManager::loadIncomingReplay(BattleReplay* outReplay) const {
-    if (!outReplay) {
-        return false;
-    }
-    return ReplayManager::getInstance()->importReplayFrom(getIncomingReplayPath(), outReplay);
+void BattleShareManager::loadIncomingReplay(const ReplayManager::ImportCallback& onDone) const {
+    ReplayManager::getInstance()->importReplayAsync(getIncomingReplayPath(), onDone);
 }
 
 bool BattleShareManager::hasIncomingSnapshot() const {
@@ -274,7 +455,15 @@ std::string BattleShareManager::getOutgoingSnapshotPath() const {
 }
 
 std::string BattleShareManager::getIncomingSnapshotPath() const {
-    return buildSharePath(kIncomingSnapshotFile);
+    // 没有二进制快照时退回旧版 JSON
+    std::string path = buildSharePath(kIncomingSnapshotFile);
+    if (!FileUtils::getInstance()->isFileExist(path)) {
+        std::string legacyPath = buildSharePath(kIncomingLegacySnapshotFile);
+        if (FileUtils::getInstance()->isFileExist(legacyPath)) {
+            return legacyPath;
+        }
+    }
+    return path;
 }
 
 std::string BattleShareManager::getOutgoingReplayPath() const {
@@ -297,44 +486,9 @@ void BattleShareManager::ensureShareDirectory() const {
     }
 }
 
-std::string BattleShareManager::computeConfigHash() const {
+void BattleShareManager::resolveConfigPaths(std::string* buildingFull, std::string* unitFull) const {
+    // FileUtils 的路径解析带缓存且非线程安全，只在主线程解析完整路径
     auto* fileUtils = FileUtils::getInstance();
-    std::string buildingFull = fileUtils->fullPathForFilename(kBuildingsConfigPath);
-    std::string unitFull = fileUtils->fullPathForFilename(kUnitsConfigPath);
-    std::string buildingData = buildingFull.empty() ? "" : fileUtils->getStringFromFile(buildingFull);
-    std::string unitData = unitFull.empty() ? "" : fileUtils->getStringFromFile(unitFull);
-    std::string merged = buildingData + "|" + unitData;
-    std::hash<std::string> hasher;
-    return toHexHash(hasher(merged));
-}
-
-std::string BattleShareManager::categoryToString(BuildingCategory category) const {
-    switch (category) {
-    case BuildingCategory::Defence:
-        return "defence";
-    case BuildingCategory::Production:
-        return "production";
-    case BuildingCategory::Storage:
-        return "storage";
-    case BuildingCategory::Trap:
-        return "trap";
-    default:
-        return "unknown";
-    }
-}
-
-BuildingCategory BattleShareManager::stringToCategory(const std::string& str) const {
-    if (str == "defence" || str == "defense") {
-        return BuildingCategory::Defence;
-    }
-    if (str == "production") {
-        return BuildingCategory::Production;
-    }
-    if (str == "storage") {
-        return BuildingCategory::Storage;
-    }
-    if (str == "trap") {
-        return BuildingCategory::Trap;
-    }
-    return BuildingCategory::Unknown;
+    *buildingFull = fileUtils->fullPathForFilename(kBuildingsConfigPath);
+    *unitFull = fileUtils->fullPathForFilename(kUnitsConfigPath);
 }
@@ -4,6 +4,8 @@
 #include "cocos2d.h"
 #include "Scenes/BaseScene.h"
 #include "Replay/ReplayManager.h"
+#include "Utils/JobSystem.h"
+#include <functional>
 
 /**
  * @brief 异步攻防-基地快照
@@ -24,24 +26,30 @@ struct BaseSnapshot {
  * @brief 异步攻防分享管理器
  *
  * 负责导出/导入基地快照以及回放文件，并提供默认的共享目录。
+ * 基地快照默认使用二进制格式（见 SnapshotCodec），路径不以 .vkb 结尾时读写旧版 JSON。
+ * 文件读写与编解码在任务系统中执行，结果通过主线程回调返回。
  */
 class BattleShareManager {
 public:
+    using ExportCallback = std::function<void(bool ok, const std::string& path)>;
+    using SnapshotCallback = std::function<void(bool ok, const BaseSnapshot& snapshot)>;
+
     static BattleShareManager* getInstance();
 
+    // 采集当前基地（configHash 留空，导出时在后台计算）
     BaseSnapshot captureCurrentBase() const;
-    bool exportPlayerBaseSnapshot(std::string* outPath = nullptr);
-    bool loadIncomingSnapshot(BaseSnapshot* outSnapshot);
-    bool saveSnapshotToPath(const BaseSnapshot& snapshot, const std::string& path);
-    bool loadSnapshotFromPath(const std::string& path, BaseSnapshot* outSnapshot);
+    void exportPlayerBaseSnapshot(const ExportCallback& onDone);
+    void loadIncomingSnapshot(const SnapshotCallback& onDone);
+    void saveSnapshotAsync(const BaseSnapshot& snapshot, const std::string& path, const ExportCallback& onDone);
+    void loadSnapshotAsync(const std::string& path, const SnapshotCallback& onDone);
 
     void setActiveTargetSnapshot(const BaseSnapshot& snapshot);
     bool hasActiveTargetSnapshot() const;
     const BaseSnapshot* getActiveTargetSnapshot() const;
     void clearActiveTargetSnapshot();
 
-    bool exportLastReplay(std::string* outPath = nullptr);
-    bool loadIncomingReplay(BattleReplay* outReplay) const;
+    void exportLastReplay(const ExportCallback& onDone);
+    void loadIncomingReplay(const ReplayManager::ImportCallback& onDone) const;
 
     bool hasIncomingSnapshot() const;
     bool hasIncomingReplay() const;
@@ -58,12 +66,14 @@ private:
 
     std::string buildSharePath(const std::string& filename) const;
     void ensureShareDirectory() const;
-    std::string computeConfigHash() const;
-    std::string categoryToString(BuildingCategory category) const;
-    BuildingCategory stringToCategory(const std::string& str) const;
+    void resolveConfigPaths(std::string* buildingFull, std::string* unitFull) const;
+    void queueIoJob(const char* name, std::function<void()> task);
 
     BaseSnapshot _targetSnapshot;
     bool _hasTargetSnapshot = false;
+    BaseSnapshot _lastExport;               // 上次导出的快照（增量快照的基准）
+    bool _hasLastExport = false;
+    JobSystem::JobHandle _ioChain;          // 分享文件读写任务链
 
     static BattleShareManager* s_instance;
 };
@@ -0,0 +1,480 @@
+#include "Share/SnapshotCodec.h"
+#include "Buildings/BuildingManager.h"
+#include "Map/GridMap.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace cocos2d;
+
+namespace {
+const char kMagic[4] = { 'V', 'K', 'B', 'S' };
+constexpr uint8_t kFormatVersion = 1;
+constexpr uint8_t kKindFull = 0;
+constexpr uint8_t kKindDelta = 1;
+constexpr size_t kHeaderSize = 6;       // 魔数 + 格式版本 + 类型
+
+// 增量操作：varint((参数 << 2) | 类型)
+enum DeltaOp : uint32_t {
+    kOpKeep = 0,        // 参数为连续保留的建筑数
+    kOpRemove = 1,      // 参数为连续删除的建筑数
+    kOpModify = 2,      // 参数为字段掩码，之后依次跟随变化的字段
+};
+constexpr uint32_t kFieldLevel = 1;
+constexpr uint32_t kFieldX = 2;
+constexpr uint32_t kFieldY = 4;
+
+// ==================== 字节流 ====================
+
+void writeVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void writeSigned(std::string& out, int value) {
+    // zigzag：小的负数也只占一个字节
+    writeVarint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+void writeString(std::string& out, const std::string& value) {
+    writeVarint(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+void writeU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+class ByteReader {
+public:
+    explicit ByteReader(const std::string& data, size_t pos = 0) : _data(data), _pos(pos) {}
+
+    bool varint(uint32_t* value) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (_pos >= _data.size()) {
+                return false;
+            }
+            uint8_t byte = static_cast<uint8_t>(_data[_pos++]);
+            result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                *value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool signedInt(int* value) {
+        uint32_t raw = 0;
+        if (!varint(&raw)) {
+            return false;
+        }
+        *value = static_cast<int>((raw >> 1) ^ (~(raw & 1) + 1));
+        return true;
+    }
+
+    bool string(std::string* value) {
+        uint32_t size = 0;
+        if (!varint(&size) || size > _data.size() - _pos) {
+            return false;
+        }
+        value->assign(_data, _pos, size);
+        _pos += size;
+        return true;
+    }
+
+    bool u64(uint64_t* value) {
+        if (_data.size() - _pos < 8) {
+            return false;
+        }
+        uint64_t result = 0;
+        for (int i = 0; i < 8; ++i) {
+            result |= static_cast<uint64_t>(static_cast<uint8_t>(_data[_pos++])) << (i * 8);
+        }
+        *value = result;
+        return true;
+    }
+
+    bool atEnd() const { return _pos == _data.size(); }
+
+private:
+    const std::string& _data;
+    size_t _pos;
+};
+
+bool fail(std::string* error, const std::string& reason) {
+    if (error) {
+        *error = reason;
+    }
+    return false;
+}
+
+// 每个建筑至少占一格，超过网格格数的建筑数量必然越界或重叠，解码前直接拒绝
+size_t maxBuildings(const SnapshotCatalog& catalog) {
+    return static_cast<size_t>(std::max(0, catalog.gridWidth * catalog.gridHeight));
+}
+
+// ==================== 快照字段 ====================
+
+int roundAnchor(float value) {
+    return static_cast<int>(std::round(value));
+}
+
+void writeHeader(std::string& out, uint8_t kind) {
+    out.append(kMagic, sizeof(kMagic));
+    out.push_back(static_cast<char>(kFormatVersion));
+    out.push_back(static_cast<char>(kind));
+}
+
+void writeBaseFields(std::string& out, const BaseSnapshot& snapshot) {
+    writeString(out, snapshot.configHash);
+    writeVarint(out, static_cast<uint32_t>(std::max(0, snapshot.version)));
+    writeVarint(out, static_cast<uint32_t>(std::max(0, snapshot.baseLevel)));
+    writeVarint(out, static_cast<uint32_t>(std::max(0, snapshot.barracksLevel)));
+    writeSigned(out, roundAnchor(snapshot.baseAnchor.x));
+    writeSigned(out, roundAnchor(snapshot.baseAnchor.y));
+    writeSigned(out, roundAnchor(snapshot.barracksAnchor.x));
+    writeSigned(out, roundAnchor(snapshot.barracksAnchor.y));
+}
+
+bool readBaseFields(ByteReader& reader, BaseSnapshot* out) {
+    uint32_t version = 0;
+    uint32_t baseLevel = 0;
+    uint32_t barracksLevel = 0;
+    int anchors[4] = { 0, 0, 0, 0 };
+    if (!reader.string(&out->configHash) || !reader.varint(&version)
+        || !reader.varint(&baseLevel) || !reader.varint(&barracksLevel)) {
+        return false;
+    }
+    for (int& anchor : anchors) {
+        if (!reader.signedInt(&anchor)) {
+            return false;
+        }
+    }
+    out->version = static_cast<int>(version);
+    out->baseLevel = static_cast<int>(baseLevel);
+    out->barracksLevel = static_cast<int>(barracksLevel);
+    out->baseAnchor = Vec2(static_cast<float>(anchors[0]), static_cast<float>(anchors[1]));
+    out->barracksAnchor = Vec2(static_cast<float>(anchors[2]), static_cast<float>(anchors[3]));
+    return true;
+}
+
+void writeBuildings(std::string& out, const std::vector<BaseSavedBuilding>& buildings, size_t begin) {
+    writeVarint(out, static_cast<uint32_t>(buildings.size() - begin));
+    for (size_t i = begin; i < buildings.size(); ++i) {
+        const auto& saved = buildings[i];
+        writeVarint(out, static_cast<uint32_t>(std::max(0, saved.option.type)));
+        writeVarint(out, static_cast<uint32_t>(std::max(0, saved.level)));
+        writeSigned(out, saved.gridX);
+        writeSigned(out, saved.gridY);
+    }
+}
+
+bool readBuildings(ByteReader& reader, const SnapshotCatalog& catalog,
+                   std::vector<BaseSavedBuilding>* out, std::string* error) {
+    uint32_t count = 0;
+    if (!reader.varint(&count)) {
+        return fail(error, "truncated building count");
+    }
+    if (count > maxBuildings(catalog)) {
+        return fail(error, StringUtils::format("too many buildings (%u)", count));
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t type = 0;
+        uint32_t level = 0;
+        BaseSavedBuilding saved;
+        if (!reader.varint(&type) || !reader.varint(&level)
+            || !reader.signedInt(&saved.gridX) || !reader.signedInt(&saved.gridY)) {
+            return fail(error, "truncated building record");
+        }
+        auto it = catalog.options.find(static_cast<int>(type));
+        if (it == catalog.options.end()) {
+            return fail(error, StringUtils::format("unknown building type %u", type));
+        }
+        saved.option = it->second;
+        saved.level = static_cast<int>(level);
+        out->push_back(saved);
+    }
+    return true;
+}
+
+bool readHeader(const std::string& data, uint8_t expectedKind, std::string* error) {
+    if (!SnapshotCodec::isBinary(data)) {
+        return fail(error, "not a binary snapshot");
+    }
+    if (static_cast<uint8_t>(data[4]) != kFormatVersion) {
+        return fail(error, StringUtils::format("unsupported format version %u", static_cast<uint8_t>(data[4])));
+    }
+    if (static_cast<uint8_t>(data[5]) != expectedKind) {
+        return fail(error, expectedKind == kKindDelta ? "not a delta snapshot" : "not a full snapshot");
+    }
+    return true;
+}
+
+bool sameRecord(const BaseSavedBuilding& a, const BaseSavedBuilding& b) {
+    return a.option.type == b.option.type && a.level == b.level && a.gridX == b.gridX && a.gridY == b.gridY;
+}
+
+// 连续的保留/删除合并成一条操作
+void flushRun(std::string& out, uint32_t op, uint32_t* count) {
+    if (*count > 0) {
+        writeVarint(out, (*count << 2) | op);
+        *count = 0;
+    }
+}
+} // namespace
+
+SnapshotCatalog SnapshotCatalog::capture() {
+    SnapshotCatalog catalog;
+    auto* manager = BuildingManager::getInstance();
+    manager->loadConfigs();
+    for (const auto& option : manager->getBuildOptions()) {
+        catalog.options[option.type] = option;
+    }
+    catalog.gridWidth = BaseScene::getBaseGridWidth();
+    catalog.gridHeight = BaseScene::getBaseGridHeight();
+
+    int baseId = manager->getMainBaseId() > 0 ? manager->getMainBaseId() : 3001;
+    if (const auto* config = manager->getProductionConfig(baseId)) {
+        catalog.baseWidth = config->width;
+        catalog.baseHeight = config->length;
+    }
+    int barracksId = manager->getBarracksId() > 0 ? manager->getBarracksId() : 3002;
+    if (const auto* config = manager->getProductionConfig(barracksId)) {
+        catalog.barracksWidth = config->width;
+        catalog.barracksHeight = config->length;
+    }
+    return catalog;
+}
+
+std::string SnapshotCodec::encode(const BaseSnapshot& snapshot) {
+    std::string out;
+    out.reserve(kHeaderSize + 32 + snapshot.buildings.size() * 5);
+    writeHeader(out, kKindFull);
+    writeBaseFields(out, snapshot);
+    writeBuildings(out, snapshot.buildings, 0);
+    return out;
+}
+
+std::string SnapshotCodec::encodeDelta(const BaseSnapshot& previous, const BaseSnapshot& current) {
+    std::string out;
+    writeHeader(out, kKindDelta);
+    writeU64(out, fingerprint(previous));
+    writeBaseFields(out, current);
+
+    // 按顺序对齐：类型相同视为同一建筑（保留或修改），否则删除旧建筑；
+    // 旧列表走完后剩下的新建筑追加。应用后与 current 顺序完全一致。
+    std::string ops;
+    uint32_t opCount = 0;
+    uint32_t keepRun = 0;
+    uint32_t removeRun = 0;
+    size_t i = 0;
+    size_t j = 0;
+    const auto& before = previous.buildings;
+    const auto& after = current.buildings;
+    while (i < before.size()) {
+        if (j < after.size() && before[i].option.type == after[j].option.type) {
+            if (removeRun > 0) {
+                flushRun(ops, kOpRemove, &removeRun);
+                opCount++;
+            }
+            if (sameRecord(before[i], after[j])) {
+                keepRun++;
+            }
+            else {
+                if (keepRun > 0) {
+                    flushRun(ops, kOpKeep, &keepRun);
+                    opCount++;
+                }
+                uint32_t mask = (before[i].level != after[j].level ? kFieldLevel : 0)
+                    | (before[i].gridX != after[j].gridX ? kFieldX : 0)
+                    | (before[i].gridY != after[j].gridY ? kFieldY : 0);
+                writeVarint(ops, (mask << 2) | kOpModify);
+                opCount++;
+                if (mask & kFieldLevel) writeVarint(ops, static_cast<uint32_t>(std::max(0, after[j].level)));
+                if (mask & kFieldX) writeSigned(ops, after[j].gridX);
+                if (mask & kFieldY) writeSigned(ops, after[j].gridY);
+            }
+            ++j;
+        }
+        else {
+            if (keepRun > 0) {
+                flushRun(ops, kOpKeep, &keepRun);
+                opCount++;
+            }
+            removeRun++;
+        }
+        ++i;
+    }
+    if (keepRun > 0) {
+        flushRun(ops, kOpKeep, &keepRun);
+        opCount++;
+    }
+    if (removeRun > 0) {
+        flushRun(ops, kOpRemove, &removeRun);
+        opCount++;
+    }
+
+    writeVarint(out, opCount);
+    out.append(ops);
+    writeBuildings(out, after, j);
+    return out;
+}
+
+uint64_t SnapshotCodec::fingerprint(const BaseSnapshot& snapshot) {
+    const std::string data = encode(snapshot);
+    uint64_t hash = 1469598103934665603ULL;
+    for (char c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool SnapshotCodec::isBinary(const std::string& data) {
+    return data.size() >= kHeaderSize && data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) == 0;
+}
+
+bool SnapshotCodec::isDelta(const std::string& data) {
+    return isBinary(data) && static_cast<uint8_t>(data[5]) == kKindDelta;
+}
+
+bool SnapshotCodec::decode(const std::string& data, const SnapshotCatalog& catalog,
+                           BaseSnapshot* out, std::string* error) {
+    if (!readHeader(data, kKindFull, error)) {
+        return false;
+    }
+    ByteReader reader(data, kHeaderSize);
+    BaseSnapshot snapshot;
+    if (!readBaseFields(reader, &snapshot)) {
+        return fail(error, "truncated header");
+    }
+    if (!readBuildings(reader, catalog, &snapshot.buildings, error)) {
+        return false;
+    }
+    if (!reader.atEnd()) {
+        return fail(error, "trailing bytes");
+    }
+    if (!validate(snapshot, catalog, error)) {
+        return false;
+    }
+    *out = std::move(snapshot);
+    return true;
+}
+
+bool SnapshotCodec::applyDelta(const BaseSnapshot& previous, const std::string& data,
+                               const SnapshotCatalog& catalog, BaseSnapshot* out, std::string* error) {
+    if (!readHeader(data, kKindDelta, error)) {
+        return false;
+    }
+    ByteReader reader(data, kHeaderSize);
+    uint64_t baseFingerprint = 0;
+    if (!reader.u64(&baseFingerprint)) {
+        return fail(error, "truncated header");
+    }
+    if (baseFingerprint != fingerprint(previous)) {
+        return fail(error, "delta does not match the previous snapshot");
+    }
+    BaseSnapshot snapshot;
+    if (!readBaseFields(reader, &snapshot)) {
+        return fail(error, "truncated header");
+    }
+
+    uint32_t opCount = 0;
+    if (!reader.varint(&opCount)) {
+        return fail(error, "truncated delta");
+    }
+    const auto& before = previous.buildings;
+    snapshot.buildings.reserve(before.size());
+    size_t cursor = 0;
+    for (uint32_t n = 0; n < opCount; ++n) {
+        uint32_t op = 0;
+        if (!reader.varint(&op)) {
+            return fail(error, "truncated delta");
+        }
+        const uint32_t arg = op >> 2;
+        const uint32_t kind = op & 3;
+        const size_t span = kind == kOpModify ? 1 : arg;
+        if (span > before.size() - cursor) {
+            return fail(error, "delta op out of range");
+        }
+        if (kind == kOpKeep) {
+            snapshot.buildings.insert(snapshot.buildings.end(), before.begin() + cursor, before.begin() + cursor + span);
+        }
+        else if (kind == kOpModify) {
+            BaseSavedBuilding saved = before[cursor];
+            uint32_t level = 0;
+            if (((arg & kFieldLevel) && !reader.varint(&level))
+                || ((arg & kFieldX) && !reader.signedInt(&saved.gridX))
+                || ((arg & kFieldY) && !reader.signedInt(&saved.gridY))) {
+                return fail(error, "truncated delta");
+            }
+            if (arg & kFieldLevel) {
+                saved.level = static_cast<int>(level);
+            }
+            snapshot.buildings.push_back(saved);
+        }
+        else if (kind != kOpRemove) {
+            return fail(error, "unknown delta op");
+        }
+        cursor += span;
+    }
+    if (cursor != before.size()) {
+        return fail(error, "delta does not cover the previous snapshot");
+    }
+    if (!readBuildings(reader, catalog, &snapshot.buildings, error)) {
+        return false;
+    }
+    if (!reader.atEnd()) {
+        return fail(error, "trailing bytes");
+    }
+    if (!validate(snapshot, catalog, error)) {
+        return false;
+    }
+    *out = std::move(snapshot);
+    return true;
+}
+
+bool SnapshotCodec::validate(const BaseSnapshot& snapshot, const SnapshotCatalog& catalog, std::string* error) {
+    if (snapshot.buildings.size() > maxBuildings(catalog)) {
+        return fail(error, StringUtils::format("too many buildings (%d)", static_cast<int>(snapshot.buildings.size())));
+    }
+    GridBitset occupied;
+    GridMap::initBlockedBits(catalog.gridWidth, catalog.gridHeight, occupied);
+
+    if (!occupied.tryOccupy(roundAnchor(snapshot.baseAnchor.x), roundAnchor(snapshot.baseAnchor.y),
+                            catalog.baseWidth, catalog.baseHeight)) {
+        return fail(error, "base anchor out of bounds");
+    }
+    if (!occupied.tryOccupy(roundAnchor(snapshot.barracksAnchor.x), roundAnchor(snapshot.barracksAnchor.y),
+                            catalog.barracksWidth, catalog.barracksHeight)) {
+        return fail(error, "barracks overlaps the base or is out of bounds");
+    }
+    for (size_t i = 0; i < snapshot.buildings.size(); ++i) {
+        const auto& saved = snapshot.buildings[i];
+        if (!occupied.tryOccupy(saved.gridX, saved.gridY, saved.option.gridWidth, saved.option.gridHeight)) {
+            return fail(error, StringUtils::format("building #%d (type %d) at (%d,%d) overlaps or is out of bounds",
+                static_cast<int>(i), saved.option.type, saved.gridX, saved.gridY));
+        }
+    }
+    return true;
+}
+
+bool SnapshotCodec::restoreAndValidate(BaseSnapshot* snapshot, const SnapshotCatalog& catalog, std::string* error) {
+    if (snapshot->buildings.size() > maxBuildings(catalog)) {
+        return fail(error, StringUtils::format("too many buildings (%d)", static_cast<int>(snapshot->buildings.size())));
+    }
+    for (auto& saved : snapshot->buildings) {
+        auto it = catalog.options.find(saved.option.type);
+        if (it == catalog.options.end()) {
+            return fail(error, StringUtils::format("unknown building type %d", saved.option.type));
+        }
+        saved.option = it->second;
+    }
+    return validate(*snapshot, catalog, error);
+}
@@ -0,0 +1,58 @@
+#ifndef __SNAPSHOT_CODEC_H__
+#define __SNAPSHOT_CODEC_H__
+
+#include "Share/BattleShareManager.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * @brief 解码/校验快照所需的配置数据
+ *
+ * 二进制快照只存建筑类型，BuildingOption 在加载时按类型从商店配置还原。
+ * 只能在主线程通过 capture() 采集，之后按值交给任务线程使用。
+ */
+struct SnapshotCatalog {
+    std::map<int, BuildingOption> options;  // 建筑类型 -> 商店选项
+    int gridWidth = 80;                     // 基地网格尺寸
+    int gridHeight = 80;
+    int baseWidth = 4;                      // 大本营/兵营占地
+    int baseHeight = 4;
+    int barracksWidth = 5;
+    int barracksHeight = 5;
+
+    static SnapshotCatalog capture();
+};
+
+/**
+ * @brief 基地快照二进制编解码
+ *
+ * 每个建筑只记录（类型, 等级, 格子坐标），整数按变长编码，文件头带配置哈希。
+ * 增量快照记录相对上一版本的保留/删除/修改与新增建筑，并带上一版本的指纹，
+ * 基准不符时拒绝应用。加载时用 GridBitset 一次遍历校验越界与占地重叠。
+ * 所有函数只处理纯数据，可在任务线程执行。
+ */
+namespace SnapshotCodec {
+std::string encode(const BaseSnapshot& snapshot);
+std::string encodeDelta(const BaseSnapshot& previous, const BaseSnapshot& current);
+
+// 快照完整编码的 FNV-1a 指纹（增量快照以此确认基准）
+uint64_t fingerprint(const BaseSnapshot& snapshot);
+
+bool isBinary(const std::string& data);
+bool isDelta(const std::string& data);
+
+// 解码完整快照并校验；失败时 error 说明原因
+bool decode(const std::string& data, const SnapshotCatalog& catalog, BaseSnapshot* out, std::string* error);
+// 在 previous 上应用增量快照并校验
+bool applyDelta(const BaseSnapshot& previous, const std::string& data, const SnapshotCatalog& catalog,
+                BaseSnapshot* out, std::string* error);
+
+// 一次遍历校验：建筑数量不超过网格格数，大本营、兵营与所有建筑必须在界内、不压边界禁放格且互不重叠
+bool validate(const BaseSnapshot& snapshot, const SnapshotCatalog& catalog, std::string* error);
+
+// 旧版 JSON 快照自带的商店选项不可信：按类型从配置还原占地与配置ID，再执行与二进制快照相同的校验
+bool restoreAndValidate(BaseSnapshot* snapshot, const SnapshotCatalog& catalog, std::string* error);
+} // namespace SnapshotCodec
+
+#endif // __SNAPSHOT_CODEC_H__
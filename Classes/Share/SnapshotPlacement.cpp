@@ -0,0 +1,87 @@
+#include "Share/SnapshotPlacement.h"
+#include "Buildings/BuildingManager.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 配置缺失时沿用的默认ID与占地
+constexpr int kDefaultBaseId = 3001;
+constexpr int kDefaultBarracksId = 3002;
+constexpr int kDefaultBaseSize = 4;
+constexpr int kDefaultBarracksSize = 5;
+
+int roundAnchor(float value) {
+    return static_cast<int>(std::round(value));
+}
+
+int clampLevel(int level, const ProductionBuildingConfig* config) {
+    level = std::max(0, level);
+    return config ? std::min(level, config->MAXLEVEL) : level;
+}
+
+bool outOfGrid(const GridBitset& grid, int x, int y, int width, int height) {
+    return width <= 0 || height <= 0 || x < 0 || y < 0
+        || x + width > grid.getWidth() || y + height > grid.getHeight();
+}
+
+// 通过校验则登记占地并加入结果，否则计数
+bool tryPlace(SnapshotPlacement& out, GridBitset& occupied, PlacedSnapshotBuilding placed) {
+    if (outOfGrid(occupied, placed.gridX, placed.gridY, placed.width, placed.height)) {
+        out.outOfBounds++;
+        return false;
+    }
+    if (!occupied.tryOccupy(placed.gridX, placed.gridY, placed.width, placed.height)) {
+        out.overlapped++;
+        return false;
+    }
+    out.buildings.push_back(placed);
+    return true;
+}
+} // namespace
+
+SnapshotPlacement SnapshotPlacement::compute(const BaseSnapshot& snapshot, const GridBitset& blocked) {
+    SnapshotPlacement out;
+    GridBitset occupied = blocked;
+    out.buildings.reserve(snapshot.buildings.size() + 2);
+
+    auto* manager = BuildingManager::getInstance();
+    manager->loadConfigs();
+
+    // 大本营：居中放置，决定整体平移量
+    PlacedSnapshotBuilding base;
+    base.role = PlacedSnapshotBuilding::Role::BASE;
+    base.configId = manager->getMainBaseId() > 0 ? manager->getMainBaseId() : kDefaultBaseId;
+    const auto* baseConfig = manager->getProductionConfig(base.configId);
+    base.level = clampLevel(snapshot.baseLevel, baseConfig);
+    base.width = baseConfig ? baseConfig->width : kDefaultBaseSize;
+    base.height = baseConfig ? baseConfig->length : kDefaultBaseSize;
+    base.gridX = std::max(0, occupied.getWidth() / 2 - base.width / 2);
+    base.gridY = std::max(0, occupied.getHeight() / 2 - base.height / 2);
+    out.offsetX = base.gridX - roundAnchor(snapshot.baseAnchor.x);
+    out.offsetY = base.gridY - roundAnchor(snapshot.baseAnchor.y);
+    tryPlace(out, occupied, base);
+
+    PlacedSnapshotBuilding barracks;
+    barracks.role = PlacedSnapshotBuilding::Role::BARRACKS;
+    barracks.configId = manager->getBarracksId() > 0 ? manager->getBarracksId() : kDefaultBarracksId;
+    const auto* barracksConfig = manager->getProductionConfig(barracks.configId);
+    barracks.level = clampLevel(snapshot.barracksLevel, barracksConfig);
+    barracks.width = barracksConfig ? barracksConfig->width : kDefaultBarracksSize;
+    barracks.height = barracksConfig ? barracksConfig->length : kDefaultBarracksSize;
+    barracks.gridX = roundAnchor(snapshot.barracksAnchor.x) + out.offsetX;
+    barracks.gridY = roundAnchor(snapshot.barracksAnchor.y) + out.offsetY;
+    tryPlace(out, occupied, barracks);
+
+    for (const auto& saved : snapshot.buildings) {
+        PlacedSnapshotBuilding placed;
+        placed.saved = &saved;
+        placed.configId = saved.option.configId;
+        placed.level = saved.level;
+        placed.gridX = saved.gridX + out.offsetX;
+        placed.gridY = saved.gridY + out.offsetY;
+        placed.width = saved.option.gridWidth;
+        placed.height = saved.option.gridHeight;
+        tryPlace(out, occupied, placed);
+    }
+    return out;
+}
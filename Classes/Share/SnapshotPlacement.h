@@ -0,0 +1,46 @@
+#ifndef __SNAPSHOT_PLACEMENT_H__
+#define __SNAPSHOT_PLACEMENT_H__
+
+#include "Share/BattleShareManager.h"
+#include "Map/GridBitset.h"
+#include <vector>
+
+// 快照中一个建筑在战斗地图上的落点
+struct PlacedSnapshotBuilding {
+    enum class Role {
+        BASE,
+        BARRACKS,
+        SAVED
+    };
+    Role role = Role::SAVED;
+    int configId = 0;                           // 大本营/兵营的配置ID
+    int level = 0;                              // 大本营/兵营已截断到有效等级
+    const BaseSavedBuilding* saved = nullptr;   // SAVED 时指向快照中的条目
+    int gridX = 0;                              // 战斗网格坐标（左下角）
+    int gridY = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief 基地快照在战斗地图上的摆放
+ *
+ * 大本营居中，兵营与其余建筑按大本营锚点平移。以战斗地图的阻挡位图为起点一次遍历，
+ * 越界或与已放置建筑、边界禁放格重叠的建筑被剔除并计数。
+ * BattleScene 按它生成节点，LayoutEvaluator 按它生成评估目标，两边看到的是同一个布局。
+ */
+struct SnapshotPlacement {
+    int offsetX = 0;            // 战斗网格 = 基地网格 + offset
+    int offsetY = 0;
+    std::vector<PlacedSnapshotBuilding> buildings;  // 通过校验的建筑：大本营、兵营，然后按快照顺序
+    int outOfBounds = 0;
+    int overlapped = 0;
+
+    bool isClean() const { return outOfBounds == 0 && overlapped == 0; }
+
+    // blocked 为战斗地图当前的阻挡位图；读取建筑配置，只能在主线程调用。
+    // 结果中的 saved 指针引用 snapshot，只能在 snapshot 存活期间使用
+    static SnapshotPlacement compute(const BaseSnapshot& snapshot, const GridBitset& blocked);
+};
+
+#endif // __SNAPSHOT_PLACEMENT_H__
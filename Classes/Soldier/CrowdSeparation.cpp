@@ -0,0 +1,156 @@
+﻿// CrowdSeparation.cpp
+#include "CrowdSeparation.h"
+#include "Soldier.h"
+#include "Map/BattleSpace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 每秒消除的重叠比例（越大越"硬"）
+const Fixed kSeparationStiffness = Fixed::fromInt(8);
+// 单帧最大推开速度（像素/秒），避免被挤飞
+const Fixed kMaxPushSpeed = Fixed::fromInt(90);
+// 中心距离小于此值（约 0.001）视为完全重合
+const Fixed kOverlapEpsilon = Fixed::fromRaw(66);
+// 完全重合时按下标查表取确定的方向（Q16.16 单位向量，0.7071068 = 46341）
+const int32_t kOverlapDirections[8][2] = {
+    { 65536, 0 }, { -46341, 46341 }, { 0, -65536 }, { 46341, 46341 },
+    { -65536, 0 }, { 46341, -46341 }, { 0, 65536 }, { -46341, -46341 },
+};
+// 每个士兵最多检查的邻居数，极端扎堆时仍保持线性耗时
+constexpr int kMaxNeighborChecks = 24;
+} // namespace
+
+void CrowdSeparation::setup(const cocos2d::Rect& bounds, float radius) {
+    _bounds = FixedRect::fromRect(bounds);
+    _radius = Fixed::fromFloat(std::max(radius, 1.0f));
+    _cellSize = _radius;
+    _cols = std::max(1, static_cast<int>(std::ceil(bounds.size.width / _cellSize.toFloat())));
+    _rows = std::max(1, static_cast<int>(std::ceil(bounds.size.height / _cellSize.toFloat())));
+    _cellStart.assign(static_cast<size_t>(_cols * _rows + 1), 0);
+}
+
+int CrowdSeparation::cellIndexOf(const FixedVec2& pos) const {
+    int cx = ((pos.x - _bounds.minX) / _cellSize).floorToInt();
+    int cy = ((pos.y - _bounds.minY) / _cellSize).floorToInt();
+    cx = std::min(std::max(cx, 0), _cols - 1);
+    cy = std::min(std::max(cy, 0), _rows - 1);
+    return cy * _cols + cx;
+}
+
+void CrowdSeparation::apply(const std::vector<Soldier*>& soldiers, float dt) {
+    _active.clear();
+    if (_cols <= 0 || dt <= 0.0f) {
+        return;
+    }
+    for (auto* soldier : soldiers) {
+        if (soldier && soldier->getParent() && soldier->getHP() > Fixed()) {
+            _active.push_back(soldier);
+        }
+    }
+    const int count = static_cast<int>(_active.size());
+    if (count < 2) {
+        return;
+    }
+
+    _positions.resize(count);
+    _flying.resize(count);
+    for (int i = 0; i < count; ++i) {
+        _positions[i] = BattleSpace::simPositionOf(_active[i]);
+        _flying[i] = _active[i]->isFlying() ? 1 : 0;
+    }
+    separate(_positions, _flying, dt);
+    for (int i = 0; i < count; ++i) {
+        if (_moved[i]) {
+            BattleSpace::place(_active[i], _positions[i]);
+        }
+    }
+}
+
+void CrowdSeparation::separate(std::vector<FixedVec2>& positions, const std::vector<unsigned char>& flying,
+                               float dt) {
+    const int count = static_cast<int>(positions.size());
+    _moved.assign(count, 0);
+    if (_cols <= 0 || dt <= 0.0f || count < 2) {
+        return;
+    }
+
+    _push.assign(count, FixedVec2());
+    _cellOf.resize(count);
+    _sorted.resize(count);
+
+    // 1. 计数排序分格
+    std::fill(_cellStart.begin(), _cellStart.end(), 0);
+    for (int i = 0; i < count; ++i) {
+        _cellOf[i] = cellIndexOf(positions[i]);
+        ++_cellStart[_cellOf[i] + 1];
+    }
+    for (size_t c = 1; c < _cellStart.size(); ++c) {
+        _cellStart[c] += _cellStart[c - 1];
+    }
+    _cellFill.assign(_cellStart.begin(), _cellStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        _sorted[_cellFill[_cellOf[i]]++] = i;
+    }
+
+    // 2. 只检查相邻格，每对只处理一次
+    // dt 为固定模拟步长，换算结果恒定
+    const Fixed stepDt = Fixed::fromFloat(dt);
+    const int64_t radiusSqRaw = static_cast<int64_t>(_radius.raw) * _radius.raw;
+    const Fixed blend = std::min(Fixed::fromInt(1), kSeparationStiffness * stepDt) * Fixed::fromRaw(Fixed::kOne / 2);
+    for (int i = 0; i < count; ++i) {
+        int cx = _cellOf[i] % _cols;
+        int cy = _cellOf[i] / _cols;
+        int checks = 0;
+        for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, _rows - 1) && checks < kMaxNeighborChecks; ++ny) {
+            for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, _cols - 1) && checks < kMaxNeighborChecks; ++nx) {
+                int cell = ny * _cols + nx;
+                // 格内下标升序（稳定计数排序），直接跳到 j > i 的部分
+                auto first = _sorted.begin() + _cellStart[cell];
+                auto last = _sorted.begin() + _cellStart[cell + 1];
+                for (auto it = std::upper_bound(first, last, i); it != last && checks < kMaxNeighborChecks; ++it) {
+                    int j = *it;
+                    if (flying[i] != flying[j]) {
+                        continue;
+                    }
+                    ++checks;
+                    FixedVec2 diff = positions[i] - positions[j];
+                    if (diff.lengthSquaredRaw() >= radiusSqRaw) {
+                        continue;
+                    }
+                    Fixed dist = diff.length();
+                    FixedVec2 dir;
+                    if (dist > kOverlapEpsilon) {
+                        dir = { diff.x / dist, diff.y / dist };
+                    }
+                    else {
+                        const int32_t* table = kOverlapDirections[(i + j) & 7];
+                        dir = { Fixed::fromRaw(table[0]), Fixed::fromRaw(table[1]) };
+                    }
+                    FixedVec2 offset = dir * ((_radius - dist) * blend);
+                    _push[i] = _push[i] + offset;
+                    _push[j] = _push[j] - offset;
+                }
+            }
+        }
+    }
+
+    // 3. 限速后写回位置
+    const Fixed maxStep = kMaxPushSpeed * stepDt;
+    const int64_t maxStepSqRaw = static_cast<int64_t>(maxStep.raw) * maxStep.raw;
+    for (int i = 0; i < count; ++i) {
+        FixedVec2 push = _push[i];
+        int64_t lenSqRaw = push.lengthSquaredRaw();
+        if (lenSqRaw <= 0) {
+            continue;
+        }
+        if (lenSqRaw > maxStepSqRaw) {
+            push = push * (maxStep / push.length());
+        }
+        FixedVec2 pos = positions[i] + push;
+        pos.x = std::min(std::max(pos.x, _bounds.minX), _bounds.maxX);
+        pos.y = std::min(std::max(pos.y, _bounds.minY), _bounds.maxY);
+        positions[i] = pos;
+        _moved[i] = 1;
+    }
+}
@@ -0,0 +1,55 @@
+﻿// CrowdSeparation.h
+#ifndef __CROWD_SEPARATION_H__
+#define __CROWD_SEPARATION_H__
+
+#include "cocos2d.h"
+#include "Utils/FixedMath.h"
+#include <vector>
+
+class Soldier;
+
+/**
+ * 士兵局部分离（避免直线行军时叠成一点）
+ * 每帧用计数排序把士兵分入均匀网格，只检查相邻 3x3 格内的士兵对，
+ * 整体为线性复杂度；缓冲区跨帧复用，稳定后不再分配内存。
+ * 地面与飞行单位互不推挤。
+ * 位置、距离与推力全程定点运算，经 BattleSpace 读写模拟位置。
+ */
+class CrowdSeparation {
+public:
+    /**
+     * @param bounds  战斗空间中的活动范围（推开后会被夹在范围内），设置时换算为定点
+     * @param radius  两个士兵中心的最小间距
+     */
+    void setup(const cocos2d::Rect& bounds, float radius);
+
+    // 对存活的士兵施加分离位移
+    void apply(const std::vector<Soldier*>& soldiers, float dt);
+
+    // 不依赖节点的分离（快进模拟共用）：positions 原地更新，flying 与之一一对应
+    void separate(std::vector<FixedVec2>& positions, const std::vector<unsigned char>& flying, float dt);
+
+    // 上一次 apply 参与分离的士兵数量
+    int getActiveCount() const { return static_cast<int>(_active.size()); }
+
+private:
+    int cellIndexOf(const FixedVec2& pos) const;
+
+    FixedRect _bounds;
+    Fixed _radius;
+    Fixed _cellSize = Fixed::fromInt(1);
+    int _cols = 0;
+    int _rows = 0;
+
+    std::vector<Soldier*> _active;
+    std::vector<FixedVec2> _positions;
+    std::vector<unsigned char> _flying;
+    std::vector<unsigned char> _moved;      // separate 中被推开的下标
+    std::vector<FixedVec2> _push;
+    std::vector<int> _cellOf;
+    std::vector<int> _cellStart;   // 每格在 _sorted 中的起始下标（长度 cells+1）
+    std::vector<int> _cellFill;    // 排序时每格的写入游标
+    std::vector<int> _sorted;      // 按格子排序后的士兵下标
+};
+
+#endif // __CROWD_SEPARATION_H__
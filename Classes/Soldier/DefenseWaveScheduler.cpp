@@ -0,0 +1,87 @@
+﻿// DefenseWaveScheduler.cpp
+#include "DefenseWaveScheduler.h"
+
+namespace {
+constexpr float kMinSpawnInterval = 0.05f;
+} // namespace
+
+void DefenseWaveScheduler::reset() {
+    _waves.clear();
+    _waveStartTimes.clear();
+    _cursor = 0.0f;
+    _waveIndex = 0;
+    _indexInWave = 0;
+    _spawnedCount = 0;
+    _totalUnits = 0;
+}
+
+void DefenseWaveScheduler::addWave(const DefenseWave& wave) {
+    if (wave.count <= 0) {
+        return;
+    }
+    DefenseWave stored = wave;
+    if (stored.interval < kMinSpawnInterval) {
+        stored.interval = kMinSpawnInterval;
+    }
+    if (stored.delay > 0.0f) {
+        _cursor += stored.delay;
+    }
+    _waveStartTimes.push_back(_cursor);
+    _cursor += stored.interval * stored.count;
+    _waves.push_back(stored);
+    _totalUnits += stored.count;
+}
+
+void DefenseWaveScheduler::addWave(int unitId, int count, float interval, float delay,
+                                   SpawnPattern pattern, int pointIndex) {
+    DefenseWave wave;
+    wave.unitId = unitId;
+    wave.count = count;
+    wave.interval = interval;
+    wave.delay = delay;
+    wave.pattern = pattern;
+    wave.pointIndex = pointIndex;
+    addWave(wave);
+}
+
+void DefenseWaveScheduler::setSpawnPointCount(int count) {
+    _spawnPointCount = count > 0 ? count : 1;
+}
+
+bool DefenseWaveScheduler::peekDue(float battleTime, DefenseSpawn& outSpawn) const {
+    if (!hasPending()) {
+        return false;
+    }
+    const DefenseWave& wave = _waves[_waveIndex];
+    float time = _waveStartTimes[_waveIndex] + wave.interval * _indexInWave;
+    if (battleTime < time) {
+        return false;
+    }
+
+    outSpawn.time = time;
+    outSpawn.unitId = wave.unitId;
+    outSpawn.waveIndex = static_cast<int>(_waveIndex);
+    switch (wave.pattern) {
+    case SpawnPattern::SINGLE_POINT:
+        outSpawn.pointIndex = wave.pointIndex % _spawnPointCount;
+        break;
+    case SpawnPattern::SPREAD:
+        outSpawn.pointIndex = (wave.pointIndex + _indexInWave) % _spawnPointCount;
+        break;
+    default:
+        outSpawn.pointIndex = _spawnedCount % _spawnPointCount;
+        break;
+    }
+    return true;
+}
+
+void DefenseWaveScheduler::pop() {
+    if (!hasPending()) {
+        return;
+    }
+    ++_spawnedCount;
+    if (++_indexInWave >= _waves[_waveIndex].count) {
+        _indexInWave = 0;
+        ++_waveIndex;
+    }
+}
@@ -0,0 +1,71 @@
+﻿// DefenseWaveScheduler.h
+#ifndef __DEFENSE_WAVE_SCHEDULER_H__
+#define __DEFENSE_WAVE_SCHEDULER_H__
+
+#include <cstddef>
+#include <vector>
+
+// 出兵点分布方式
+enum class SpawnPattern {
+    ROUND_ROBIN = 0,    // 依次轮换所有出兵点（按全局出兵序号）
+    SINGLE_POINT = 1,   // 整波从同一个出兵点涌出
+    SPREAD = 2          // 整波在所有出兵点间均匀铺开（按波内序号）
+};
+
+// 紧凑的波次描述：只记录兵种、数量、间隔与分布方式，单个出兵在推进时按需生成
+struct DefenseWave {
+    int unitId = 0;
+    int count = 0;
+    float interval = 0.5f;      // 同波相邻出兵的间隔（秒）
+    float delay = 0.0f;         // 与上一波最后一次出兵之间的间隔（秒）
+    SpawnPattern pattern = SpawnPattern::ROUND_ROBIN;
+    int pointIndex = 0;         // SINGLE_POINT 使用的出兵点 / SPREAD 的起始出兵点
+};
+
+// 一次具体出兵
+struct DefenseSpawn {
+    float time = 0.0f;          // 计划出兵时间（战斗时间）
+    int unitId = 0;
+    int pointIndex = 0;         // 出兵点下标（由场景映射到地图坐标）
+    int waveIndex = 0;          // 所属波次
+};
+
+/**
+ * 防守波次调度器
+ * 波次只保存描述，出兵序列由游标惰性展开，数百个进攻单位也不会预先占用内存；
+ * 调用方每帧用 peek/pop 取出到期的出兵，并自行控制每帧的出兵预算。
+ */
+class DefenseWaveScheduler {
+public:
+    void reset();
+
+    // 追加波次；interval 会被钳制到最小值，count<=0 的波次被忽略
+    void addWave(const DefenseWave& wave);
+    void addWave(int unitId, int count, float interval, float delay,
+                 SpawnPattern pattern = SpawnPattern::ROUND_ROBIN, int pointIndex = 0);
+
+    // 设置出兵点数量（SPREAD/ROUND_ROBIN 取模使用）
+    void setSpawnPointCount(int count);
+
+    // 下一次出兵是否已到期，到期时写入 outSpawn
+    bool peekDue(float battleTime, DefenseSpawn& outSpawn) const;
+    // 消费下一次出兵
+    void pop();
+
+    bool hasPending() const { return _waveIndex < _waves.size(); }
+    int getTotalUnits() const { return _totalUnits; }
+    int getSpawnedCount() const { return _spawnedCount; }
+    const std::vector<DefenseWave>& getWaves() const { return _waves; }
+
+private:
+    std::vector<DefenseWave> _waves;
+    std::vector<float> _waveStartTimes; // 各波次首次出兵时间
+    float _cursor = 0.0f;       // 已追加波次末尾的时间游标
+    size_t _waveIndex = 0;      // 当前波次
+    int _indexInWave = 0;       // 当前波次内的出兵序号
+    int _spawnedCount = 0;      // 已出兵数量（也是全局出兵序号）
+    int _totalUnits = 0;
+    int _spawnPointCount = 1;
+};
+
+#endif // __DEFENSE_WAVE_SCHEDULER_H__
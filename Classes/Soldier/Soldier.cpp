@@ -1,116 +1,27 @@
 ﻿// Soldier.cpp
 #include "Soldier.h"
+#include "UnitManager.h"
 #include "Buildings/DefenceBuilding.h"
 #include "Buildings/ProductionBuilding.h"
 #include "Buildings/StorageBuilding.h"
-#include "Utils/AnimationUtils.h"
+#include "Core/BattleEventBus.h"
+#include "Core/CombatRules.h"
 #include "Utils/EffectUtils.h"
 #include "Utils/AudioManager.h"
-#include "Utils/NodeUtils.h"
+#include "TargetingSystem.h"
+#include "Map/BattleSpace.h"
+#include "Utils/FixedMath.h"
 #include <algorithm>
 #include <cmath>
-#include <limits>
 #include <string>
 
 namespace {
-// 根据ID映射资源目录，避免兵种资源找不到
-std::string resolveSpriteBaseName(const UnitConfig* config) {
-    if (!config) return "";
-
-    switch (config->id) {
-    case 101:
-        return "unit/MiniSpearMan_output/spearman";
-    case 102:
-        return "unit/MiniSwordMan_output/swordman";
-    case 103:
-        return "unit/MiniArcherMan_output/archer";
-    default:
-        return config->spriteFrameName;
-    }
-}
-
 bool isMageUnit(const UnitConfig* config) {
     if (!config) {
         return false;
     }
     return config->name.find("Mage") != std::string::npos;
 }
-
-// 攻击判定的容差，避免贴近目标却卡在移动动画
-constexpr float kAttackRangeTolerance = 6.0f;
-// 最小移动步长，低于此值不切换为移动动画
-constexpr float kMinMoveStep = 0.05f;
-// 目标刷新间隔，避免每帧全量扫描
-constexpr float kTargetRefreshInterval = 0.25f;
-// 目标切换门槛，差距不大时保持当前目标
-constexpr float kTargetSwitchThreshold = 15.0f;
-// 评分比较的微小容差
-constexpr float kTargetScoreEpsilon = 0.01f;
-
-cocos2d::Rect rectInParentSpace(const cocos2d::Node* node,
-                               const cocos2d::Sprite* sprite,
-                               const cocos2d::Node* parent) {
-    const cocos2d::Node* ref = sprite ? static_cast<const cocos2d::Node*>(sprite) : node;
-    if (!ref) {
-        return cocos2d::Rect::ZERO;
-    }
-
-    cocos2d::Rect localRect = ref->getBoundingBox();
-    const cocos2d::Node* refParent = ref->getParent();
-    if (!refParent) {
-        if (!parent) {
-            return localRect;
-        }
-        cocos2d::Vec2 parentBL = parent->convertToNodeSpace(localRect.origin);
-        cocos2d::Vec2 parentTR = parent->convertToNodeSpace(localRect.origin +
-            cocos2d::Vec2(localRect.size.width, localRect.size.height));
-        float minX = std::min(parentBL.x, parentTR.x);
-        float minY = std::min(parentBL.y, parentTR.y);
-        float maxX = std::max(parentBL.x, parentTR.x);
-        float maxY = std::max(parentBL.y, parentTR.y);
-        return cocos2d::Rect(minX, minY, maxX - minX, maxY - minY);
-    }
-
-    cocos2d::Vec2 worldBL = refParent->convertToWorldSpace(localRect.origin);
-    cocos2d::Vec2 worldTR = refParent->convertToWorldSpace(localRect.origin +
-        cocos2d::Vec2(localRect.size.width, localRect.size.height));
-
-    if (!parent) {
-        float minX = std::min(worldBL.x, worldTR.x);
-        float minY = std::min(worldBL.y, worldTR.y);
-        float maxX = std::max(worldBL.x, worldTR.x);
-        float maxY = std::max(worldBL.y, worldTR.y);
-        return cocos2d::Rect(minX, minY, maxX - minX, maxY - minY);
-    }
-
-    cocos2d::Vec2 parentBL = parent->convertToNodeSpace(worldBL);
-    cocos2d::Vec2 parentTR = parent->convertToNodeSpace(worldTR);
-    float minX = std::min(parentBL.x, parentTR.x);
-    float minY = std::min(parentBL.y, parentTR.y);
-    float maxX = std::max(parentBL.x, parentTR.x);
-    float maxY = std::max(parentBL.y, parentTR.y);
-    return cocos2d::Rect(minX, minY, maxX - minX, maxY - minY);
-}
-
-float rectDistance(const cocos2d::Rect& a, const cocos2d::Rect& b) {
-    float dx = 0.0f;
-    if (a.getMaxX() < b.getMinX()) {
-        dx = b.getMinX() - a.getMaxX();
-    }
-    else if (b.getMaxX() < a.getMinX()) {
-        dx = a.getMinX() - b.getMaxX();
-    }
-
-    float dy = 0.0f;
-    if (a.getMaxY() < b.getMinY()) {
-        dy = b.getMinY() - a.getMaxY();
-    }
-    else if (b.getMaxY() < a.getMinY()) {
-        dy = a.getMinY() - b.getMaxY();
-    }
-
-    return std::sqrt(dx * dx + dy * dy);
-}
 } // namespace
 
 const std::vector<cocos2d::Node*>* Soldier::s_enemyBuildings = nullptr;
@@ -148,20 +59,21 @@ bool Soldier::init(const UnitConfig* config, int level) {
    if (_level > _config->MAXLEVEL) _level = _config->MAXLEVEL;
     
    // 3. 初始化运行时状态
-   _currentHP = getCurrentMaxHP();
-   if (_currentHP <= 0.0f) {
-       // 兜底：避免配置缺失导致单位无法更新
-       _currentHP = 1.0f;
-   }
+   // 配置缺失时血量兜底为 1，避免单位无法更新
+   _currentHP = getSimMaxHP();
    _attackTimer = 0.0f;
    _targetRefreshTimer = 0.0f;
    _direction = Direction::RIGHT;  // 默认朝右
-   _currentActionKey.clear();
-   _target = nullptr;
+   _animState = UnitAnim::IDLE;
+   _animPlaying = false;
+   _animClip = nullptr;
+   _animFrame = 0;
+   _animElapsed = 0.0f;
+   _animClock = AnimationLod::LoopClock();
+   _target = EntityHandle();
 
    // 4. 创建精灵
-   _spriteBaseName = resolveSpriteBaseName(_config);
-   std::string initialFrame = _spriteBaseName.empty() ? _config->spriteFrameName : _spriteBaseName;
+   std::string initialFrame = _config->spriteBaseName.empty() ? _config->spriteFrameName : _config->spriteBaseName;
 
    std::string filePath = initialFrame;
    if (filePath.find(".png") == std::string::npos) {
@@ -196,9 +108,11 @@ bool Soldier::init(const UnitConfig* config, int level) {
    }
 
    if (_bodySprite) {
+       _bodySprite->setName("bodySprite");
        this->addChild(_bodySprite);
    }
    if (_healthBar) {
+       _healthBar->setName("healthBar");
        this->addChild(_healthBar);
    }
 
@@ -226,6 +140,44 @@ bool Soldier::init(const UnitConfig* config, int level) {
     return true;
 }
 
+void Soldier::reuse(int level) {
+    setLevel(level);
+    _currentHP = getSimMaxHP();
+    _attackTimer = 0.0f;
+    _targetRefreshTimer = 0.0f;
+    setTarget(nullptr);
+
+    // 清掉上一条命残留的受击闪烁与朝向
+    this->stopAllActions();
+    if (_bodySprite) {
+        _bodySprite->stopAllActions();
+        _bodySprite->setColor(cocos2d::Color3B::WHITE);
+        _bodySprite->setScaleX(std::abs(_bodySprite->getScaleX()));
+    }
+    _direction = Direction::RIGHT;
+
+    _animState = UnitAnim::IDLE;
+    _animPlaying = false;
+    _animClip = nullptr;
+    _animFrame = 0;
+    _animElapsed = 0.0f;
+    _animClock = AnimationLod::LoopClock();
+    playAnimation(UnitAnim::IDLE);
+    if (!_animPlaying) {
+        // 没有待机资源时停在行走首帧，避免保留死亡帧
+        playAnimation(UnitAnim::WALK);
+        stopCurrentAnimation();
+    }
+
+    if (_healthBar) {
+        _healthBar->stopAllActions();
+    }
+    updateHealthBar(false);
+
+    this->setVisible(true);
+    this->scheduleUpdate();
+}
+
 void Soldier::setLevel(int level) {
     if (level < 0) level = 0;
     if (level > _config->MAXLEVEL) level = _config->MAXLEVEL;
@@ -270,31 +222,51 @@ float Soldier::getCurrentRange() const {
 }
 
 float Soldier::getCurrentHP() const {
-    return _currentHP;
+    return _currentHP.toFloat();
+}
+
+Fixed Soldier::getSimMaxHP() const {
+    return CombatRules::unitMaxHP(_config, _level);
+}
+
+Fixed Soldier::getSimSpeed() const {
+    return CombatRules::unitSpeed(_config, _level);
+}
+
+Fixed Soldier::getSimATK() const {
+    return CombatRules::unitATK(_config, _level);
+}
+
+Fixed Soldier::getSimRange() const {
+    return CombatRules::unitRange(_config, _level);
 }
 
 void Soldier::update(float dt) {
-    if (_currentHP <= 0) {
+    if (!advanceAnimation(dt)) {
+        return;
+    }
+    if (_currentHP <= Fixed()) {
         return;
     }
 
     _attackTimer += dt;
 
-    if (_target && !_target->getParent()) {
-        setTarget(nullptr);
+    cocos2d::Node* target = getTarget();
+    if (!target && !_target.isNull()) {
+        _target = EntityHandle();
         _targetRefreshTimer = 0.0f;
     }
 
+    // 战斗场景启用批量寻敌时由寻敌阶段统一处理到期的请求
     _targetRefreshTimer -= dt;
-    if (_targetRefreshTimer <= 0.0f) {
+    if (_targetRefreshTimer <= 0.0f && !TargetingSystem::isBatching()) {
         findTarget();
-        _targetRefreshTimer = kTargetRefreshInterval;
+        target = getTarget();
     }
 
-    if (_target) {
-        float dist = getDistanceToTarget(_target);
-        float attackRange = getCurrentRange();
-        if (dist <= attackRange + kAttackRangeTolerance) {
+    if (target) {
+        Fixed dist = getDistanceToTarget(target);
+        if (dist <= CombatRules::attackReach(getSimRange())) {
             attackTarget();
             tryPlayIdleAnimation();
         }
@@ -309,253 +281,120 @@ void Soldier::update(float dt) {
 
 void Soldier::onExit() {
     setTarget(nullptr);
+    BattleSpace::forget(this);
     Node::onExit();
 }
 
 void Soldier::setTarget(cocos2d::Node* target) {
-    if (_target == target) {
-        return;
-    }
-    if (_target) {
-        _target->release();
-    }
-    _target = target;
-    if (_target) {
-        _target->retain();
-    }
+    _target = EntityTable::handleOf(target);
 }
 
 void Soldier::findTarget() {
     if (!s_enemyBuildings || s_enemyBuildings->empty()) {
+        _targetRefreshTimer = CombatRules::kTargetRefreshInterval;
         return;
     }
 
-    const bool wantDefense = _config && _config->aiType == TargetPriority::DEFENSE;
-    const bool wantResource = _config && _config->aiType == TargetPriority::RESOURCE;
-
-    // 过滤无效目标并标记类型
-    auto classifyBuilding = [&](cocos2d::Node* building, bool& isDefense, bool& isResource) -> bool {
-        if (!building || !building->getParent()) {
-            return false;
+    std::vector<BuildingTarget> candidates;
+    candidates.reserve(s_enemyBuildings->size());
+    for (auto* building : *s_enemyBuildings) {
+        BuildingTarget candidate;
+        if (TargetSelection::describeBuilding(building, candidate)) {
+            candidates.push_back(candidate);
         }
-
-        isDefense = false;
-        isResource = false;
-
-        if (auto* defence = dynamic_cast<DefenceBuilding*>(building)) {
-            if (defence->getCurrentHP() <= 0.0f) {
-                return false;
-            }
-            isDefense = true;
-        }
-        else if (auto* production = dynamic_cast<ProductionBuilding*>(building)) {
-            if (production->getCurrentHP() <= 0.0f) {
-                return false;
-            }
-            isResource = true;
-        }
-        else if (auto* storage = dynamic_cast<StorageBuilding*>(building)) {
-            if (storage->getCurrentHP() <= 0.0f) {
-                return false;
-            }
-            isResource = true;
-        }
-
-        return true;
-    };
-
-    // 评分：距离扣除攻击范围，越小越接近可攻击
-    auto calcScore = [&](cocos2d::Node* building, float& outDist) -> float {
-        outDist = getDistanceToTarget(building);
-        float attackRange = getCurrentRange();
-        float score = outDist - attackRange;
-        if (score < 0.0f) {
-            score = 0.0f;
-        }
-        return score;
-    };
-
-    // 按偏好挑选最佳目标（若分数接近则选更近的）
-    auto pickBest = [&](bool onlyDefense, bool onlyResource, float& outScore) -> cocos2d::Node* {
-        cocos2d::Node* best = nullptr;
-        float bestScore = std::numeric_limits<float>::max();
-        float bestDist = std::numeric_limits<float>::max();
-
-        for (auto* building : *s_enemyBuildings) {
-            bool isDefense = false;
-            bool isResource = false;
-            if (!classifyBuilding(building, isDefense, isResource)) {
-                continue;
-            }
-            if (onlyDefense && !isDefense) {
-                continue;
-            }
-            if (onlyResource && !isResource) {
-                continue;
-            }
-
-            float dist = 0.0f;
-            float score = calcScore(building, dist);
-            if (score < bestScore - kTargetScoreEpsilon
-                || (std::abs(score - bestScore) <= kTargetScoreEpsilon && dist < bestDist)) {
-                bestScore = score;
-                bestDist = dist;
-                best = building;
-            }
-        }
-
-        outScore = bestScore;
-        return best;
-    };
-
-    cocos2d::Node* bestTarget = nullptr;
-    float bestScore = std::numeric_limits<float>::max();
-    bool hasPriorityTarget = false;
-
-    if (wantDefense || wantResource) {
-        bestTarget = pickBest(wantDefense, wantResource, bestScore);
-        hasPriorityTarget = (bestTarget != nullptr);
     }
 
-    if (!bestTarget) {
-        bestTarget = pickBest(false, false, bestScore);
-    }
-
-    if (!bestTarget) {
-        return;
-    }
-
-    if (_target && _target->getParent()) {
-        bool currentDefense = false;
-        bool currentResource = false;
-        if (classifyBuilding(_target, currentDefense, currentResource)) {
-            float currentDist = 0.0f;
-            float currentScore = calcScore(_target, currentDist);
-            float attackRange = getCurrentRange();
-            bool inRange = currentDist <= attackRange + kAttackRangeTolerance;
-
-            // 已进入攻击距离时保持目标，避免来回切换
-            if (inRange) {
-                return;
-            }
+    SoldierTargetQuery query;
+    buildTargetQuery(query);
+    applyTargetDecision(TargetSelection::selectBuilding(query, candidates.data(), candidates.size()),
+        candidates.data());
+}
 
-            // 有优先级目标且当前目标不匹配时直接切换
-            if (hasPriorityTarget && ((wantDefense && !currentDefense) || (wantResource && !currentResource))) {
-                setTarget(bestTarget);
-                return;
-            }
+bool Soldier::needsTargetRefresh() const {
+    return _currentHP > Fixed() && this->getParent() && _targetRefreshTimer <= 0.0f;
+}
 
-            if (bestTarget == _target) {
-                return;
-            }
+void Soldier::buildTargetQuery(SoldierTargetQuery& query) const {
+    query.position = BattleSpace::simPositionOf(this);
+    query.footprint = BattleSpace::simFootprintOf(this);
+    query.range = getSimRange();
+    query.keepRange = CombatRules::attackReach(query.range);
+    query.remote = _config && _config->ISREMOTE;
+    query.wantDefense = _config && _config->aiType == TargetPriority::DEFENSE;
+    query.wantResource = _config && _config->aiType == TargetPriority::RESOURCE;
+    cocos2d::Node* target = getTarget();
+    query.hasCurrent = target && TargetSelection::describeBuilding(target, query.current);
+}
 
-            // 目标差距不明显时不切换，减少抖动
-            if (currentScore <= bestScore + kTargetSwitchThreshold) {
-                return;
-            }
-        }
+void Soldier::applyTargetDecision(const TargetDecision& decision, const BuildingTarget* candidates) {
+    if (decision.change && decision.index >= 0) {
+        setTarget(candidates[decision.index].node);
     }
-
-    setTarget(bestTarget);
+    _targetRefreshTimer = CombatRules::kTargetRefreshInterval;
 }
 
 void Soldier::moveToTarget(float dt) {
-    if (!_target) return;
-
-    cocos2d::Vec2 targetPos = getTargetPositionInParent(_target);
-    cocos2d::Vec2 diff = targetPos - this->getPosition();
-    float dist = getDistanceToTarget(_target);
-    float stopDistance = getCurrentRange() + kAttackRangeTolerance;
-    if (dist <= stopDistance) {
-        tryPlayIdleAnimation();
-        return;
-    }
-
-    cocos2d::Vec2 direction = diff.getNormalized();
-    float step = getCurrentSpeed() * dt;
-    if (step <= 0.0f) {
-        // 速度为0或dt异常时不切换为移动动画
-        tryPlayIdleAnimation();
-        return;
-    }
-    float remaining = dist - stopDistance;
-    if (remaining < 0.0f) {
-        remaining = 0.0f;
-    }
-    float move = std::min(step, remaining);
-    if (remaining <= kMinMoveStep) {
-        // 剩余距离很小也要补齐，否则会卡在攻击距离外
-        if (remaining > 0.0f) {
-            this->setPosition(this->getPosition() + direction * remaining);
-        }
-        tryPlayIdleAnimation();
-        return;
-    }
-    if (move <= kMinMoveStep) {
-        // 步长过小，先推进但不切换移动动画，避免抖动
-        this->setPosition(this->getPosition() + direction * move);
+    cocos2d::Node* target = getTarget();
+    if (!target) return;
+
+    // 位置、方向与步长全程定点，位置由 BattleSpace 记录，渲染位置只是它的近似，
+    // 保证回放在不同平台上逐位一致；步进规则与快进模拟共用
+    FixedVec2 origin = BattleSpace::simPositionOf(this);
+    FixedVec2 targetPos = BattleSpace::simPositionOf(target);
+    CombatRules::MoveStep step = CombatRules::stepToward(origin, targetPos,
+        getDistanceToTarget(target), CombatRules::attackReach(getSimRange()), getSimSpeed(), dt);
+    if (step.moved) {
+        BattleSpace::place(this, step.position);
+    }
+    if (!step.walking) {
         tryPlayIdleAnimation();
         return;
     }
 
     // 计算方向(只有左右)
-    Direction newDir = calcDirection(this->getPosition(), targetPos);
+    Direction newDir = calcDirection(origin.toVec2(), targetPos.toVec2());
     // 更新精灵朝向并播放移动动画
     updateSpriteDirection(newDir);
-    playAnimation(_config->anim_walk, _config->anim_walk_frames, _config->anim_walk_delay, true);
-
-    cocos2d::Vec2 newPos = this->getPosition() + (direction * move);
-    this->setPosition(newPos);
+    playAnimation(UnitAnim::WALK);
 }
 
-void Soldier::takeDamage(float damage) {
-    _currentHP -= damage;
-    if (_currentHP < 0) _currentHP = 0;
+void Soldier::takeDamage(Fixed damage) {
+    CombatRules::applyDamage(_currentHP, damage);
 
     EffectUtils::playHitFlash(_bodySprite);
     AudioManager::playRandomHit();
     updateHealthBar(true);
 
-    if (_currentHP <= 0) {
+    if (_currentHP <= Fixed()) {
         // 播放死亡动画(使用当前方向)
         this->stopAllActions();
-        playAnimation(_config->anim_dead, _config->anim_dead_frames, _config->anim_dead_delay, false);
+        playAnimation(UnitAnim::DEAD);
     }
 }
 
 void Soldier::attackTarget() {
-    if (!_target || !_target->getParent()) {
+    cocos2d::Node* target = getTarget();
+    if (!target) {
         setTarget(nullptr);
         return;
     }
 
-    float dist = getDistanceToTarget(_target);
-    float attackRange = getCurrentRange();
-    if (dist > attackRange + kAttackRangeTolerance) {
+    if (getDistanceToTarget(target) > CombatRules::attackReach(getSimRange())) {
         return;
     }
 
-    float attackInterval = 0.4f;
-    if (_config) {
-        attackInterval = _config->anim_attack_delay * _config->anim_attack_frames;
-    }
-    if (attackInterval < 0.2f) {
-        attackInterval = 0.2f;
-    }
-
     // 简单攻击间隔控制
-    if (_attackTimer < attackInterval) {
+    if (_attackTimer < CombatRules::unitAttackInterval(_config)) {
         return;
     }
     _attackTimer = 0.0f;
 
     // 计算攻击方向
-    cocos2d::Vec2 targetPos = getTargetPositionInParent(_target);
-    Direction attackDir = calcDirection(this->getPosition(), targetPos);
+    Direction attackDir = calcDirection(BattleSpace::positionOf(this), BattleSpace::positionOf(target));
     updateSpriteDirection(attackDir);
 
     // 播放攻击动画
-    playAnimation(_config->anim_attack, _config->anim_attack_frames, _config->anim_attack_delay, false);
+    playAnimation(UnitAnim::ATTACK);
 
     if (_config) {
         if (_config->ISREMOTE) {
@@ -571,14 +410,14 @@ void Soldier::attackTarget() {
         }
     }
 
-    float attackPower = getCurrentATK();
-    if (auto defence = dynamic_cast<DefenceBuilding*>(_target)) {
+    Fixed attackPower = getSimATK();
+    if (auto defence = dynamic_cast<DefenceBuilding*>(target)) {
         defence->takeDamage(attackPower);
     }
-    else if (auto production = dynamic_cast<ProductionBuilding*>(_target)) {
+    else if (auto production = dynamic_cast<ProductionBuilding*>(target)) {
         production->takeDamage(attackPower);
     }
-    else if (auto storage = dynamic_cast<StorageBuilding*>(_target)) {
+    else if (auto storage = dynamic_cast<StorageBuilding*>(target)) {
         storage->takeDamage(attackPower);
     }
 }
@@ -589,7 +428,7 @@ void Soldier::updateHealthBar(bool animate) {
     float maxHP = getCurrentMaxHP();
     float pct = 0.0f;
     if (maxHP > 0.00001f) {
-        pct = _currentHP / maxHP;
+        pct = _currentHP.toFloat() / maxHP;
     }
     if (pct < 0.0f) pct = 0.0f;
     if (pct > 1.0f) pct = 1.0f;
@@ -624,27 +463,30 @@ void Soldier::updateHealthBar(bool animate) {
 }
 
 void Soldier::stopCurrentAnimation() {
-    if (!_bodySprite) return;
-    _bodySprite->stopAllActions();
-    _currentActionKey.clear();
+    // 停在当前帧
+    _animPlaying = false;
+    _animClip = nullptr;
 }
 
 void Soldier::tryPlayIdleAnimation() {
     if (!_config) {
         return;
     }
-    if (_currentActionKey == _config->anim_attack || _currentActionKey == _config->anim_dead) {
+    if (_animPlaying && (_animState == UnitAnim::ATTACK || _animState == UnitAnim::DEAD)) {
         return;
     }
 
-    std::string prevKey = _currentActionKey;
-    playAnimation(_config->anim_idle, _config->anim_idle_frames, _config->anim_idle_delay, true);
-    if (_currentActionKey == prevKey && prevKey != _config->anim_idle) {
+    playAnimation(UnitAnim::IDLE);
+    if (!_animPlaying || _animState != UnitAnim::IDLE) {
         // 没有待机资源时停止循环移动动画
         stopCurrentAnimation();
     }
 }
 
+void Soldier::setAnimationLevel(AnimationLod::Level level) {
+    _animClock.setLevel(level);
+}
+
 // 计算方向: 简化为左右两个方向
 // 向正上/正下时保持当前方向不变
 Direction Soldier::calcDirection(const cocos2d::Vec2& from, const cocos2d::Vec2& to) {
@@ -659,49 +501,16 @@ Direction Soldier::calcDirection(const cocos2d::Vec2& from, const cocos2d::Vec2&
     return (diff.x >= 0) ? Direction::RIGHT : Direction::LEFT;
 }
 
-cocos2d::Vec2 Soldier::getTargetPositionInParent(const cocos2d::Node* target) const {
+Fixed Soldier::getDistanceToTarget(const cocos2d::Node* target) const {
     if (!target) {
-        return cocos2d::Vec2::ZERO;
-    }
-
-    auto* parent = this->getParent();
-    if (!parent || target->getParent() == parent) {
-        return target->getPosition();
-    }
-
-    cocos2d::Vec2 worldPos = target->convertToWorldSpace(cocos2d::Vec2::ZERO);
-    return parent->convertToNodeSpace(worldPos);
-}
-
-float Soldier::getDistanceToTarget(const cocos2d::Node* target) const {
-    if (!target) {
-        return std::numeric_limits<float>::max();
-    }
-
-    cocos2d::Vec2 selfPos = this->getPosition();
-    cocos2d::Vec2 targetPos = getTargetPositionInParent(target);
-    float centerDist = selfPos.distance(targetPos);
-    if (_config && _config->ISREMOTE) {
-        return centerDist;
-    }
-
-    const cocos2d::Node* parent = this->getParent();
-    cocos2d::Rect selfRect = rectInParentSpace(this, _bodySprite, parent);
-    cocos2d::Rect targetRect = rectInParentSpace(target, NodeUtils::findBodySprite(target), parent);
-    if (selfRect.size.width <= 0.0f || selfRect.size.height <= 0.0f
-        || targetRect.size.width <= 0.0f || targetRect.size.height <= 0.0f) {
-        return centerDist;
+        return Fixed::maxValue();
     }
 
-    // 近战单位使用边缘距离，避免贴近目标却一直走动。
-    float edgeDist = rectDistance(selfRect, targetRect);
-    if (!std::isfinite(edgeDist)) {
-        return centerDist;
-    }
-    if (edgeDist > centerDist + 5.0f) {
-        return centerDist;
-    }
-    return edgeDist;
+    // 距离与包围盒统一在战斗空间中按定点计算
+    return TargetSelection::measureDistance(
+        BattleSpace::simPositionOf(this), BattleSpace::simFootprintOf(this),
+        BattleSpace::simPositionOf(target), BattleSpace::simFootprintOf(target),
+        _config && _config->ISREMOTE);
 }
 
 // 更新精灵朝向 - 通过水平翻转实现左向
@@ -725,40 +534,65 @@ void Soldier::updateSpriteDirection(Direction dir) {
     }
 }
 
-// 统一的动画播放函数
-void Soldier::playAnimation(const std::string& animType, int frameCount, float delay, bool loop) {
+// 统一的动画播放函数：只切换状态与首帧，后续由 advanceAnimation 推进
+void Soldier::playAnimation(UnitAnim anim) {
     if (!_bodySprite || !_config) return;
-    
-    // 生成动画key用于去重
-    std::string key = animType;
-    if (_currentActionKey == key) return; // 已在播放相同动画
-    
-    std::string baseName = _spriteBaseName.empty() ? _config->spriteFrameName : _spriteBaseName;
-    auto anim = AnimationUtils::buildAnimationFromFrames(baseName, animType, frameCount, delay);
-    if (!anim) return;
-    
-    _bodySprite->stopAllActions();
-    
+    if (_animPlaying && _animState == anim) return; // 已在播放相同动画
+
+    const UnitAnimClip* clip = UnitManager::getInstance()->getAnimClip(_config->animHandles[static_cast<int>(anim)]);
+    if (!clip || clip->frames.empty()) return;
+
+    _animState = anim;
+    _animClip = clip;
+    _animPlaying = true;
+    _animFrame = 0;
+    _animElapsed = 0.0f;
+    _animClock.reset();
+    _bodySprite->setSpriteFrame(clip->frames.at(0));
+}
+
+bool Soldier::advanceAnimation(float dt) {
+    if (!_animPlaying || !_animClip || !_bodySprite) {
+        return true;
+    }
+
+    // 循环动画(移动/待机)按LOD推进；单次动画(攻击/死亡)始终按真实时间推进
+    bool loop = (_animState == UnitAnim::WALK || _animState == UnitAnim::IDLE);
+    float stepDt = dt;
+    if (loop && !_animClock.advance(dt, stepDt)) {
+        return true;
+    }
+
+    const int frameCount = static_cast<int>(_animClip->frames.size());
+    const float delay = _animClip->delay > 0.0f ? _animClip->delay : 0.1f;
+    const float duration = delay * frameCount;
+    _animElapsed += stepDt;
+
+    int frame = 0;
     if (loop) {
-        // 循环播放(移动/待机)
-        auto act = cocos2d::RepeatForever::create(cocos2d::Animate::create(anim));
-        _bodySprite->runAction(act);
+        _animElapsed = std::fmod(_animElapsed, duration);
+        frame = static_cast<int>(_animElapsed / delay);
+    }
+    else if (_animElapsed >= duration) {
+        // 单次动画播完停在最后一帧
+        frame = frameCount - 1;
+        _animPlaying = false;
     }
     else {
-        // 单次播放(攻击/死亡)
-        auto sequence = cocos2d::Sequence::create(
-            cocos2d::Animate::create(anim),
-            cocos2d::CallFunc::create([this]() {
-                _currentActionKey.clear();
-                // 死亡动画结束后移除
-                if (_currentHP <= 0) {
-                    this->removeFromParent();
-                }
-            }),
-            nullptr
-        );
-        _bodySprite->runAction(sequence);
+        frame = static_cast<int>(_animElapsed / delay);
     }
-    
-    _currentActionKey = key;
+    frame = std::min(std::max(frame, 0), frameCount - 1);
+
+    if (frame != _animFrame) {
+        _animFrame = frame;
+        _bodySprite->setSpriteFrame(_animClip->frames.at(frame));
+    }
+
+    if (!_animPlaying && _animState == UnitAnim::DEAD && _currentHP <= Fixed()) {
+        // 死亡动画结束后移除（之后不能再访问成员）
+        BattleEventBus::post(BattleEventType::UNIT_DIED, this);
+        this->removeFromParent();
+        return false;
+    }
+    return true;
 }
@@ -4,19 +4,27 @@
 
 #include "cocos2d.h"
 #include "UnitData.h"
+#include "Core/EntityTable.h"
+#include "Utils/AnimationLod.h"
 #include <vector>
 
+struct BuildingTarget;
+struct SoldierTargetQuery;
+struct TargetDecision;
+
 // 此处开始写士兵类
 // 说明 - 这里为什么继承Node而不是Sprite？
 // Soldier从画图的角度来说，不只有Soldier本身需要绘制，还有血条，可能还有阴影
 // 当士兵缩放、旋转时，血条都应该进行变换
 // 所以创建一个Node，Sprite作为其子节点，加入渲染逻辑，就能够渲染动画
-class Soldier : public cocos2d::Node {
+class Soldier : public cocos2d::Node, public AnimationLod::Receiver {
 public:
     // 标准 Cocos create 方法
     static Soldier* create(const UnitConfig* config, int level = 0); // 创建士兵实例,默认等级为0
 
     virtual bool init(const UnitConfig* config, int level = 0); // 初始化并添加子节点
+    // 对象池复用：恢复到刚创建时的状态（须已从场景移除）
+    void reuse(int level);
     virtual void update(float dt) override;
     virtual void onExit() override;
 
@@ -25,25 +33,43 @@ public:
     static void clearEnemyBuildingsIf(const std::vector<cocos2d::Node*>* buildings);
 
     // 状态操作
-    void takeDamage(float damage);
+    void takeDamage(Fixed damage);
     
     // 等级相关方法
     int getLevel() const { return _level; }
     void setLevel(int level);
     
-    // 获取当前等级的属性
+    // 获取当前等级的属性（界面显示用）
     float getCurrentHP() const;
     float getCurrentMaxHP() const;
     float getCurrentSpeed() const;
     float getCurrentATK() const;
     float getCurrentRange() const;
 
+    // 战斗模拟用的定点属性（配置加载时已换算，战斗中不再经过 float）
+    Fixed getHP() const { return _currentHP; }
+    Fixed getSimMaxHP() const;
+    Fixed getSimSpeed() const;
+    Fixed getSimATK() const;
+    Fixed getSimRange() const;
+
+    int getUnitId() const { return _config ? _config->id : 0; }
+    cocos2d::Node* getTarget() const { return EntityTable::lookup(_target, EntityKind::BUILDING); }
+
     // 获取当前方向
     Direction getDirection() const { return _direction; }
 
     // 是否为飞行单位（用于防御建筑判定可攻击目标）
     bool isFlying() const { return _config ? _config->ISFLY : false; }
 
+    // 循环动画（行走/待机）的LOD，由战斗场景定期刷新
+    virtual void setAnimationLevel(AnimationLod::Level level) override;
+
+    // 批量寻敌（TargetingSystem）：是否到了刷新目标的时间、生成请求、应用结论
+    bool needsTargetRefresh() const;
+    void buildTargetQuery(SoldierTargetQuery& query) const;
+    void applyTargetDecision(const TargetDecision& decision, const BuildingTarget* candidates);
+
 private:
     static const std::vector<cocos2d::Node*>* s_enemyBuildings;
 
@@ -52,20 +78,26 @@ private:
 
     // 运行时数据
     int _level;                   // 当前等级
-    float _currentHP;
+    Fixed _currentHP;
     float _attackTimer;
     float _targetRefreshTimer;    // 目标刷新计时
     cocos2d::Sprite* _bodySprite; // 以后会定义这个为动画,暂时应该渲染成图片
     cocos2d::Sprite* _healthBar;  // 血条精灵
-    cocos2d::Node* _target;       // 当前锁定的攻击目标（也是一个Node）
-    // 动画支持
-    std::string _currentActionKey;     // 当前动画的键
-    std::string _spriteBaseName;       // 动画资源基准名（可含目录）
+    EntityHandle _target;         // 当前锁定的攻击目标（建筑句柄，建筑摧毁后自动失效）
+    // 动画状态机：按预解析句柄直接切帧，不创建 action
+    UnitAnim _animState;               // 当前动画
+    bool _animPlaying;                 // 是否正在播放（单次动画播完后为 false）
+    const UnitAnimClip* _animClip;     // 当前动画片段
+    int _animFrame;                    // 当前帧下标
+    float _animElapsed;                // 当前动画已播放时长
+    AnimationLod::LoopClock _animClock; // 循环动画的LOD推进时钟
     Direction _direction;              // 当前方向 (LEFT/RIGHT)
 
     // 带方向动画接口 - 只需要一个方向(RIGHT),LEFT方向通过翻转实现
-    void playAnimation(const std::string& animType, int frameCount, float delay, bool loop);
+    void playAnimation(UnitAnim anim);
     void stopCurrentAnimation();
+    // 推进当前动画，返回 false 表示死亡动画已播完且士兵已移除
+    bool advanceAnimation(float dt);
     void updateSpriteDirection(Direction dir); // 更新图片翻转
     // 尝试播放待机动画，避免停在移动状态
     void tryPlayIdleAnimation();
@@ -73,8 +105,7 @@ private:
     // 方向转换辅助函数
     Direction calcDirection(const cocos2d::Vec2& from, const cocos2d::Vec2& to);
 
-    cocos2d::Vec2 getTargetPositionInParent(const cocos2d::Node* target) const;
-    float getDistanceToTarget(const cocos2d::Node* target) const;
+    Fixed getDistanceToTarget(const cocos2d::Node* target) const;
 
     // 内部行为逻辑
     void setTarget(cocos2d::Node* target);
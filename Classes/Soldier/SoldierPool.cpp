@@ -0,0 +1,83 @@
+﻿// SoldierPool.cpp
+#include "SoldierPool.h"
+#include "UnitManager.h"
+
+namespace {
+// 仍被子弹/塔等持有引用的士兵不能复用，否则旧引用会指向新单位
+bool isReusable(const Soldier* soldier) {
+    return soldier && !soldier->getParent() && soldier->getReferenceCount() == 1;
+}
+} // namespace
+
+SoldierPool::~SoldierPool() {
+    clear();
+}
+
+Soldier* SoldierPool::acquire(int unitId, const cocos2d::Vec2& position, int level) {
+    auto it = _free.find(unitId);
+    if (it != _free.end()) {
+        auto& bucket = it->second;
+        for (size_t i = bucket.size(); i-- > 0;) {
+            Soldier* soldier = bucket[i];
+            if (!isReusable(soldier)) {
+                continue;
+            }
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            soldier->reuse(level);
+            soldier->setPosition(position);
+            soldier->autorelease();
+            return soldier;
+        }
+    }
+    return UnitManager::getInstance()->spawnSoldier(unitId, position, level);
+}
+
+void SoldierPool::recycle(Soldier* soldier) {
+    if (!soldier) {
+        return;
+    }
+    if (soldier->getParent()) {
+        soldier->removeFromParent();
+    }
+    _free[soldier->getUnitId()].push_back(soldier);
+}
+
+int SoldierPool::prewarm(int unitId, int level, int count) {
+    // 新建的士兵要等本帧 autorelease 之后才可复用，这里按新建数量计入
+    int available = getAvailableCount(unitId);
+    int created = 0;
+    while (available + created < count) {
+        auto soldier = UnitManager::getInstance()->spawnSoldier(unitId, cocos2d::Vec2::ZERO, level);
+        if (!soldier) {
+            break;
+        }
+        soldier->retain();
+        _free[unitId].push_back(soldier);
+        ++created;
+    }
+    return created;
+}
+
+int SoldierPool::getAvailableCount(int unitId) const {
+    auto it = _free.find(unitId);
+    if (it == _free.end()) {
+        return 0;
+    }
+    int count = 0;
+    for (auto* soldier : it->second) {
+        if (isReusable(soldier)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void SoldierPool::clear() {
+    for (auto& pair : _free) {
+        for (auto* soldier : pair.second) {
+            CC_SAFE_RELEASE(soldier);
+        }
+    }
+    _free.clear();
+}
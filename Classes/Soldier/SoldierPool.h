@@ -0,0 +1,43 @@
+﻿// SoldierPool.h
+#ifndef __SOLDIER_POOL_H__
+#define __SOLDIER_POOL_H__
+
+#include "cocos2d.h"
+#include "Soldier.h"
+#include <map>
+#include <vector>
+
+/**
+ * 士兵对象池（按兵种ID分桶）
+ * - acquire：优先复用已回收且无人引用的士兵，否则新建
+ * - recycle：接管调用方的引用，士兵须已从场景移除
+ * - prewarm：提前构建士兵，把创建开销挪到空闲帧
+ * 池中士兵都被 retain，clear 时统一释放。
+ */
+class SoldierPool {
+public:
+    SoldierPool() = default;
+    ~SoldierPool();
+
+    SoldierPool(const SoldierPool&) = delete;
+    SoldierPool& operator=(const SoldierPool&) = delete;
+
+    // 取出一个士兵（autorelease 语义与 UnitManager::spawnSoldier 一致）
+    Soldier* acquire(int unitId, const cocos2d::Vec2& position, int level);
+
+    // 回收已移除的士兵，接管调用方持有的一次 retain
+    void recycle(Soldier* soldier);
+
+    // 确保某兵种至少有 count 个可用士兵，返回实际新建数量
+    int prewarm(int unitId, int level, int count);
+
+    // 当前可立即复用的数量
+    int getAvailableCount(int unitId) const;
+
+    void clear();
+
+private:
+    std::map<int, std::vector<Soldier*>> _free;
+};
+
+#endif // __SOLDIER_POOL_H__
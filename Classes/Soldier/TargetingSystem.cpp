@@ -0,0 +1,373 @@
+﻿// TargetingSystem.cpp
+#include "TargetingSystem.h"
+#include "Soldier.h"
+#include "Buildings/DefenceBuilding.h"
+#include "Buildings/ProductionBuilding.h"
+#include "Buildings/StorageBuilding.h"
+#include "Map/BattleSpace.h"
+#include "Utils/FixedMath.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+
+USING_NS_CC;
+
+namespace {
+// 目标切换门槛，差距不大时保持当前目标
+const Fixed kTargetSwitchThreshold = Fixed::fromInt(15);
+// 评分比较的微小容差（约 0.01）
+const Fixed kTargetScoreEpsilon = Fixed::fromRaw(655);
+// 近战边缘距离比中心距离还远这么多时视为包围盒异常，改用中心距离
+const Fixed kEdgeDistanceSlack = Fixed::fromInt(5);
+// 每个并行分块的请求数，过小时调度开销会超过收益
+constexpr int kQueriesPerChunk = 16;
+// 请求数少于此值时直接在主线程计算
+constexpr int kParallelThreshold = 32;
+
+float elapsedMs(const std::chrono::steady_clock::time_point& start) {
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+} // namespace
+
+// ===================================================
+// 寻敌规则
+// ===================================================
+
+Fixed TargetSelection::measureDistance(const FixedVec2& selfPos, const FixedRect& selfRect,
+                                       const FixedVec2& targetPos, const FixedRect& targetRect,
+                                       bool remote) {
+    // 距离统一走定点运算，不同平台的判定结果逐位一致
+    Fixed centerDist = FixedMath::distance(selfPos, targetPos);
+    if (remote) {
+        return centerDist;
+    }
+
+    if (selfRect.isEmpty() || targetRect.isEmpty()) {
+        return centerDist;
+    }
+
+    // 近战单位使用边缘距离，避免贴近目标却一直走动。
+    Fixed edgeDist = FixedMath::rectDistance(selfRect, targetRect);
+    if (edgeDist > centerDist + kEdgeDistanceSlack) {
+        return centerDist;
+    }
+    return edgeDist;
+}
+
+bool TargetSelection::describeBuilding(Node* building, BuildingTarget& out) {
+    if (!building || !building->getParent()) {
+        return false;
+    }
+
+    out.node = building;
+    out.key = reinterpret_cast<uintptr_t>(building);
+    out.isDefense = false;
+    out.isResource = false;
+
+    if (auto* defence = dynamic_cast<DefenceBuilding*>(building)) {
+        if (defence->getHP() <= Fixed()) {
+            return false;
+        }
+        out.isDefense = true;
+    }
+    else if (auto* production = dynamic_cast<ProductionBuilding*>(building)) {
+        if (production->getHP() <= Fixed()) {
+            return false;
+        }
+        out.isResource = true;
+    }
+    else if (auto* storage = dynamic_cast<StorageBuilding*>(building)) {
+        if (storage->getHP() <= Fixed()) {
+            return false;
+        }
+        out.isResource = true;
+    }
+
+    out.position = BattleSpace::simPositionOf(building);
+    out.footprint = BattleSpace::simFootprintOf(building);
+    return true;
+}
+
+void TargetSelection::describeSoldier(const Soldier* soldier, SoldierTarget& out) {
+    out.alive = soldier && soldier->getParent() && soldier->getHP() > Fixed();
+    out.flying = soldier && soldier->isFlying();
+    out.position = out.alive ? BattleSpace::simPositionOf(soldier) : FixedVec2();
+}
+
+TargetDecision TargetSelection::selectBuilding(const SoldierTargetQuery& query,
+                                               const BuildingTarget* candidates, size_t count) {
+    // 评分：距离扣除攻击范围，越小越接近可攻击
+    auto calcScore = [&query](const BuildingTarget& building, Fixed& outDist) -> Fixed {
+        outDist = measureDistance(query.position, query.footprint,
+            building.position, building.footprint, query.remote);
+        Fixed score = outDist - query.range;
+        if (score < Fixed()) {
+            score = Fixed();
+        }
+        return score;
+    };
+
+    // 按偏好挑选最佳目标（若分数接近则选更近的）
+    auto pickBest = [&](bool onlyDefense, bool onlyResource, Fixed& outScore) -> int {
+        int best = -1;
+        Fixed bestScore = Fixed::maxValue();
+        Fixed bestDist = Fixed::maxValue();
+
+        for (size_t i = 0; i < count; ++i) {
+            const BuildingTarget& building = candidates[i];
+            if (onlyDefense && !building.isDefense) {
+                continue;
+            }
+            if (onlyResource && !building.isResource) {
+                continue;
+            }
+
+            Fixed dist;
+            Fixed score = calcScore(building, dist);
+            Fixed gap = score - bestScore;
+            if (bestScore == Fixed::maxValue() || gap < -kTargetScoreEpsilon
+                || (gap <= kTargetScoreEpsilon && dist < bestDist)) {
+                bestScore = score;
+                bestDist = dist;
+                best = static_cast<int>(i);
+            }
+        }
+
+        outScore = bestScore;
+        return best;
+    };
+
+    TargetDecision decision;
+    int best = -1;
+    Fixed bestScore = Fixed::maxValue();
+    bool hasPriorityTarget = false;
+
+    if (query.wantDefense || query.wantResource) {
+        best = pickBest(query.wantDefense, query.wantResource, bestScore);
+        hasPriorityTarget = (best >= 0);
+    }
+
+    if (best < 0) {
+        best = pickBest(false, false, bestScore);
+    }
+
+    if (best < 0) {
+        return decision;
+    }
+
+    if (query.hasCurrent) {
+        Fixed currentDist;
+        Fixed currentScore = calcScore(query.current, currentDist);
+
+        // 已进入攻击距离时保持目标，避免来回切换
+        if (currentDist <= query.keepRange) {
+            return decision;
+        }
+
+        // 有优先级目标且当前目标不匹配时直接切换
+        bool currentMismatch = (query.wantDefense && !query.current.isDefense)
+            || (query.wantResource && !query.current.isResource);
+        if (!(hasPriorityTarget && currentMismatch)) {
+            if (candidates[best].key == query.current.key) {
+                return decision;
+            }
+
+            // 目标差距不明显时不切换，减少抖动
+            if (currentScore <= bestScore + kTargetSwitchThreshold) {
+                return decision;
+            }
+        }
+    }
+
+    decision.change = true;
+    decision.index = best;
+    return decision;
+}
+
+int TargetSelection::selectSoldier(const TowerTargetQuery& query,
+                                   const SoldierTarget* candidates, size_t count) {
+    int nearest = -1;
+    Fixed nearestDist = Fixed::maxValue();
+
+    for (size_t i = 0; i < count; ++i) {
+        const SoldierTarget& soldier = candidates[i];
+        if (!soldier.alive) {
+            continue;
+        }
+        if (soldier.flying ? !query.skyAble : !query.groundAble) {
+            continue;
+        }
+
+        Fixed dist = FixedMath::distance(query.position, soldier.position);
+        if (query.range > Fixed() && dist > query.range) {
+            continue;
+        }
+        if (dist < nearestDist) {
+            nearestDist = dist;
+            nearest = static_cast<int>(i);
+        }
+    }
+
+    return nearest;
+}
+
+// ===================================================
+// 寻敌阶段
+// ===================================================
+
+TargetingSystem* TargetingSystem::s_active = nullptr;
+
+void TargetingSystem::setActive(TargetingSystem* system) {
+    s_active = system;
+}
+
+void TargetingSystem::clearActiveIf(const TargetingSystem* system) {
+    if (s_active == system) {
+        s_active = nullptr;
+    }
+}
+
+void TargetingSystem::snapshot(const std::vector<Soldier*>& soldiers, const std::vector<Node*>& buildings) {
+    _buildingTargets.clear();
+    _buildingTargets.reserve(buildings.size());
+    for (auto* building : buildings) {
+        BuildingTarget target;
+        if (TargetSelection::describeBuilding(building, target)) {
+            _buildingTargets.push_back(target);
+        }
+    }
+
+    // 士兵快照与列表一一对应，结果下标可直接映射回士兵
+    _soldierTargets.resize(soldiers.size());
+    for (size_t i = 0; i < soldiers.size(); ++i) {
+        TargetSelection::describeSoldier(soldiers[i], _soldierTargets[i]);
+    }
+}
+
+void TargetingSystem::collectQueries(const std::vector<Soldier*>& soldiers,
+                                     const std::vector<Node*>& buildings,
+                                     bool includeAll) {
+    _soldierQueries.clear();
+    _querySoldiers.clear();
+    for (auto* soldier : soldiers) {
+        if (!soldier || !(includeAll ? soldier->getParent() != nullptr : soldier->needsTargetRefresh())) {
+            continue;
+        }
+        SoldierTargetQuery query;
+        soldier->buildTargetQuery(query);
+        _soldierQueries.push_back(query);
+        _querySoldiers.push_back(soldier);
+    }
+
+    _towerQueries.clear();
+    _queryTowers.clear();
+    for (auto* building : buildings) {
+        auto* tower = dynamic_cast<DefenceBuilding*>(building);
+        if (!tower || !tower->getParent()) {
+            continue;
+        }
+        if (!includeAll && !tower->needsTarget()) {
+            continue;
+        }
+        TowerTargetQuery query;
+        if (tower->buildTargetQuery(query)) {
+            _towerQueries.push_back(query);
+            _queryTowers.push_back(tower);
+        }
+    }
+}
+
+void TargetingSystem::execute(bool parallel) {
+    const int soldierCount = static_cast<int>(_soldierQueries.size());
+    const int towerCount = static_cast<int>(_towerQueries.size());
+    const int total = soldierCount + towerCount;
+    _soldierDecisions.resize(soldierCount);
+    _towerDecisions.resize(towerCount);
+
+    // 士兵与防御塔请求合并为一个下标区间，每个下标只写自己的结果槽位
+    auto runRange = [this, soldierCount](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            if (i < soldierCount) {
+                _soldierDecisions[i] = TargetSelection::selectBuilding(
+                    _soldierQueries[i], _buildingTargets.data(), _buildingTargets.size());
+            }
+            else {
+                int tower = i - soldierCount;
+                _towerDecisions[tower] = TargetSelection::selectSoldier(
+                    _towerQueries[tower], _soldierTargets.data(), _soldierTargets.size());
+            }
+        }
+    };
+
+    if (parallel && total >= kParallelThreshold) {
+        JobSystem::getInstance()->parallelFor(total, kQueriesPerChunk, runRange);
+    }
+    else {
+        runRange(0, total);
+    }
+}
+
+void TargetingSystem::run(const std::vector<Soldier*>& soldiers, const std::vector<Node*>& buildings) {
+    auto start = std::chrono::steady_clock::now();
+
+    collectQueries(soldiers, buildings, false);
+    if (_soldierQueries.empty() && _towerQueries.empty()) {
+        _lastMs = elapsedMs(start);
+        return;
+    }
+
+    snapshot(soldiers, buildings);
+    execute(_parallel);
+
+    // 主线程按列表顺序应用，结果与执行方式无关
+    for (size_t i = 0; i < _querySoldiers.size(); ++i) {
+        _querySoldiers[i]->applyTargetDecision(_soldierDecisions[i], _buildingTargets.data());
+    }
+    for (size_t i = 0; i < _queryTowers.size(); ++i) {
+        int index = _towerDecisions[i];
+        auto* tower = static_cast<DefenceBuilding*>(_queryTowers[i]);
+        tower->applyTargetDecision(index >= 0 ? soldiers[index] : nullptr);
+    }
+
+    _lastMs = elapsedMs(start);
+}
+
+std::string TargetingSystem::benchmark(const std::vector<Soldier*>& soldiers,
+                                       const std::vector<Node*>& buildings,
+                                       int rounds) {
+    rounds = std::max(1, rounds);
+    collectQueries(soldiers, buildings, true);
+    snapshot(soldiers, buildings);
+
+    auto serialStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        execute(false);
+    }
+    float serialMs = elapsedMs(serialStart) / static_cast<float>(rounds);
+    std::vector<TargetDecision> serialSoldiers = _soldierDecisions;
+    std::vector<int> serialTowers = _towerDecisions;
+
+    auto parallelStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        execute(true);
+    }
+    float parallelMs = elapsedMs(parallelStart) / static_cast<float>(rounds);
+
+    bool identical = (serialTowers == _towerDecisions);
+    for (size_t i = 0; identical && i < serialSoldiers.size(); ++i) {
+        identical = serialSoldiers[i].change == _soldierDecisions[i].change
+            && serialSoldiers[i].index == _soldierDecisions[i].index;
+    }
+
+    float speedup = parallelMs > 0.0001f ? serialMs / parallelMs : 0.0f;
+    return StringUtils::format(
+        "Targeting %d units x %d buildings: serial %.3fms  parallel %.3fms (%d workers)  %.2fx  %s",
+        static_cast<int>(_soldierQueries.size()),
+        static_cast<int>(_buildingTargets.size()),
+        serialMs,
+        parallelMs,
+        JobSystem::getInstance()->getWorkerCount(),
+        speedup,
+        identical ? "match" : "MISMATCH");
+}
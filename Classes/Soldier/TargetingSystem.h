@@ -0,0 +1,137 @@
+﻿// TargetingSystem.h
+#ifndef __TARGETING_SYSTEM_H__
+#define __TARGETING_SYSTEM_H__
+
+#include "cocos2d.h"
+#include "Utils/FixedMath.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Soldier;
+
+// ===================================================
+// 寻敌快照数据（纯数据，可在工作线程读取）
+// 坐标、距离与射程均为定点数，判定结果不依赖平台浮点
+// ===================================================
+
+// 士兵可攻击的建筑
+struct BuildingTarget {
+    cocos2d::Node* node = nullptr;  // 寻敌结论应用到的节点，工作线程不解引用（快进模拟中为空）
+    uintptr_t key = 0;              // 身份标识：实时战斗为节点地址，快进模拟为建筑序号 + 1
+    FixedVec2 position;             // 战斗空间位置
+    FixedRect footprint;            // 战斗空间包围盒
+    bool isDefense = false;
+    bool isResource = false;
+};
+
+// 单个士兵的寻敌请求
+struct SoldierTargetQuery {
+    FixedVec2 position;
+    FixedRect footprint;
+    Fixed range;                   // 攻击距离
+    Fixed keepRange;               // 攻击距离 + 容差，当前目标在此范围内时不再切换
+    bool remote = false;           // 远程单位只用中心距离
+    bool wantDefense = false;
+    bool wantResource = false;
+    bool hasCurrent = false;       // 当前目标仍有效
+    BuildingTarget current;
+};
+
+// 寻敌结论：保持当前目标，或切换到候选列表中的 index
+struct TargetDecision {
+    bool change = false;
+    int index = -1;
+};
+
+// 防御塔可攻击的士兵
+struct SoldierTarget {
+    FixedVec2 position;
+    bool flying = false;
+    bool alive = false;
+};
+
+// 单座防御塔的寻敌请求
+struct TowerTargetQuery {
+    FixedVec2 position;
+    Fixed range;
+    bool skyAble = false;
+    bool groundAble = false;
+};
+
+// 寻敌规则本身（单线程、并行路径与快进模拟共用同一份实现，保证结果一致）
+namespace TargetSelection {
+// 士兵到目标的距离：远程用中心距离，近战用包围盒边缘距离
+Fixed measureDistance(const FixedVec2& selfPos, const FixedRect& selfRect,
+                      const FixedVec2& targetPos, const FixedRect& targetRect,
+                      bool remote);
+
+// 生成建筑快照，无效目标（已移除/已被摧毁）返回 false；只能在主线程调用
+bool describeBuilding(cocos2d::Node* building, BuildingTarget& out);
+// 生成士兵快照（死亡/已移除的士兵标记为不可攻击）；只能在主线程调用
+void describeSoldier(const Soldier* soldier, SoldierTarget& out);
+
+TargetDecision selectBuilding(const SoldierTargetQuery& query,
+                              const BuildingTarget* candidates, size_t count);
+
+// 返回射程内最近的可攻击士兵下标，没有则为 -1
+int selectSoldier(const TowerTargetQuery& query, const SoldierTarget* candidates, size_t count);
+} // namespace TargetSelection
+
+/**
+ * 战斗寻敌阶段
+ * 每帧由战斗场景调用一次 run()：
+ * 1. 主线程把双方位置/血量/类型拍成扁平数组；
+ * 2. 收集本帧需要寻敌的士兵与防御塔，按需在线程池上分块计算（只读快照）；
+ * 3. 回到主线程按列表顺序应用结果。
+ * 每个请求只写自己的结果槽位，串行与并行结果逐位一致，可在运行时切换。
+ * 激活期间士兵与防御塔不再在各自 update 中寻敌。
+ */
+class TargetingSystem {
+public:
+    static void setActive(TargetingSystem* system);
+    static void clearActiveIf(const TargetingSystem* system);
+    static bool isBatching() { return s_active != nullptr; }
+
+    void setParallel(bool parallel) { _parallel = parallel; }
+    bool isParallel() const { return _parallel; }
+
+    void run(const std::vector<Soldier*>& soldiers, const std::vector<cocos2d::Node*>& buildings);
+
+    // 上一次 run() 的耗时与请求数
+    float getLastMs() const { return _lastMs; }
+    int getLastQueryCount() const { return static_cast<int>(_soldierQueries.size() + _towerQueries.size()); }
+
+    /**
+     * 基准测试：对当前全部士兵与防御塔各构造一次请求，串行/并行各跑 rounds 轮，
+     * 校验两种路径结果一致并返回一行报告。不修改任何目标。
+     */
+    std::string benchmark(const std::vector<Soldier*>& soldiers,
+                          const std::vector<cocos2d::Node*>& buildings,
+                          int rounds);
+
+private:
+    void snapshot(const std::vector<Soldier*>& soldiers, const std::vector<cocos2d::Node*>& buildings);
+    void collectQueries(const std::vector<Soldier*>& soldiers,
+                        const std::vector<cocos2d::Node*>& buildings,
+                        bool includeAll);
+    void execute(bool parallel);
+
+    static TargetingSystem* s_active;
+
+    bool _parallel = true;
+    float _lastMs = 0.0f;
+
+    std::vector<BuildingTarget> _buildingTargets;
+    std::vector<SoldierTarget> _soldierTargets;
+
+    std::vector<SoldierTargetQuery> _soldierQueries;
+    std::vector<Soldier*> _querySoldiers;
+    std::vector<TargetDecision> _soldierDecisions;
+
+    std::vector<TowerTargetQuery> _towerQueries;
+    std::vector<cocos2d::Node*> _queryTowers;
+    std::vector<int> _towerDecisions;
+};
+
+#endif // __TARGETING_SYSTEM_H__
@@ -3,6 +3,7 @@
 #define __UNIT_DATA_H__
 
 #include "cocos2d.h"
+#include "Utils/FixedMath.h"
 #include <vector>
 
 // 目标优先级
@@ -21,6 +22,21 @@ enum class Direction {
     RIGHT = 1       // 右
 };
 
+// 兵种动画状态（也是 UnitConfig::animHandles 的下标）
+enum class UnitAnim {
+    WALK = 0,       // 行走（循环）
+    ATTACK = 1,     // 攻击（单次）
+    IDLE = 2,       // 待机（循环）
+    DEAD = 3,       // 死亡（单次）
+    COUNT = 4
+};
+
+// 预解析的动画片段：加载配置时解析一次，运行时按整数句柄访问
+struct UnitAnimClip {
+    cocos2d::Vector<cocos2d::SpriteFrame*> frames; // 按播放顺序排列的帧（持有引用）
+    float delay = 0.1f;                            // 帧间隔
+};
+
 // 兵种配置（通常来自 JSON）
 struct UnitConfig {
 // 基础信息
@@ -68,6 +84,15 @@ struct UnitConfig {
     std::string anim_dead = "dead";        // 死亡动画名
     int anim_dead_frames = 4;              // 死亡帧数
     float anim_dead_delay = 0.06f;         // 死亡帧间隔
+
+    // 以下由 UnitManager 在加载配置时填充
+    std::string spriteBaseName;            // 动画资源基准名（可含目录）
+    int animHandles[static_cast<int>(UnitAnim::COUNT)] = { -1, -1, -1, -1 }; // 动画片段句柄，-1 表示无资源
+    // 战斗模拟用的定点属性（由上面的等级数组换算）
+    std::vector<Fixed> simHP;
+    std::vector<Fixed> simSPEED;
+    std::vector<Fixed> simATK;
+    std::vector<Fixed> simRANGE;
 };
 
 #endif // __UNIT_DATA_H__
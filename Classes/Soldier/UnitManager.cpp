@@ -1,5 +1,6 @@
 ﻿// UnitManager.cpp
 #include "UnitManager.h"
+#include "Utils/AnimationUtils.h"
 
 // 单例实例
 UnitManager* UnitManager::_instance = nullptr;
@@ -28,6 +29,19 @@ void stripUtf8Bom(std::string& text) {
         text.erase(0, 3);
     }
 }
+// 根据ID映射资源目录，避免兵种资源找不到
+std::string resolveSpriteBaseName(const UnitConfig& config) {
+    switch (config.id) {
+    case 101:
+        return "unit/MiniSpearMan_output/spearman";
+    case 102:
+        return "unit/MiniSwordMan_output/swordman";
+    case 103:
+        return "unit/MiniArcherMan_output/archer";
+    default:
+        return config.spriteFrameName;
+    }
+}
 } // namespace
 
 // 从json文件中加载配置，输入为文件路径，返回是否成功
@@ -62,6 +76,11 @@ bool UnitManager::loadConfig(const std::string& jsonFile) {
     for (rapidjson::SizeType i = 0; i < units.Size(); i++) {
         UnitConfig config;
 		if (parseUnitConfig(units[i], config)) { // 将units[i]的数据解析到config结构体中
+            resolveAnimations(config); // 动画只在加载时解析一次，战斗中按句柄访问
+            config.simHP = FixedMath::fromFloats(config.HP);
+            config.simSPEED = FixedMath::fromFloats(config.SPEED);
+            config.simATK = FixedMath::fromFloats(config.ATK);
+            config.simRANGE = FixedMath::fromFloats(config.RANGE);
             _configCache[config.id] = config; // 解析后存入缓存，方便创建时调用
             cocos2d::log("UnitManager: Loaded unit [%d] %s", config.id, config.name.c_str());
         }
@@ -165,6 +184,61 @@ const UnitConfig* UnitManager::getConfig(int unitId) const {
     return nullptr;
 }
 
+const UnitAnimClip* UnitManager::getAnimClip(int handle) const {
+    if (handle < 0 || static_cast<size_t>(handle) >= _animClips.size()) {
+        return nullptr;
+    }
+    return &_animClips[handle];
+}
+
+void UnitManager::resolveAnimations(UnitConfig& config) {
+    config.spriteBaseName = resolveSpriteBaseName(config);
+    const std::string& baseName = config.spriteBaseName;
+    config.animHandles[static_cast<int>(UnitAnim::WALK)] =
+        resolveAnimClip(baseName, config.anim_walk, config.anim_walk_frames, config.anim_walk_delay);
+    config.animHandles[static_cast<int>(UnitAnim::ATTACK)] =
+        resolveAnimClip(baseName, config.anim_attack, config.anim_attack_frames, config.anim_attack_delay);
+    config.animHandles[static_cast<int>(UnitAnim::IDLE)] =
+        resolveAnimClip(baseName, config.anim_idle, config.anim_idle_frames, config.anim_idle_delay);
+    config.animHandles[static_cast<int>(UnitAnim::DEAD)] =
+        resolveAnimClip(baseName, config.anim_dead, config.anim_dead_frames, config.anim_dead_delay);
+}
+
+int UnitManager::resolveAnimClip(const std::string& baseName, const std::string& animKey, int frameCount, float delay) {
+    if (baseName.empty() || animKey.empty() || frameCount <= 0) {
+        return -1;
+    }
+
+    // 重复加载配置时复用已解析的片段，句柄保持稳定
+    std::string key = baseName + "_" + animKey;
+    auto it = _animClipIndex.find(key);
+    if (it != _animClipIndex.end()) {
+        _animClips[it->second].delay = delay;
+        return it->second;
+    }
+
+    auto anim = AnimationUtils::buildAnimationFromFrames(baseName, animKey, frameCount, delay);
+    if (!anim) {
+        return -1;
+    }
+
+    UnitAnimClip clip;
+    clip.delay = delay;
+    for (auto* frame : anim->getFrames()) {
+        if (frame && frame->getSpriteFrame()) {
+            clip.frames.pushBack(frame->getSpriteFrame());
+        }
+    }
+    if (clip.frames.empty()) {
+        return -1;
+    }
+
+    int handle = static_cast<int>(_animClips.size());
+    _animClips.push_back(clip);
+    _animClipIndex[key] = handle;
+    return handle;
+}
+
 bool UnitManager::hasConfig(int unitId) const {
     return _configCache.find(unitId) != _configCache.end();
 }
@@ -7,6 +7,7 @@
 #include "Soldier.h"
 #include "json/rapidjson.h"
 #include "json/document.h"
+#include <deque>
 #include <map>
 #include <string>
 
@@ -23,6 +24,9 @@ public:
     // 获取配置
     const UnitConfig* getConfig(int unitId) const;
 
+    // 按句柄获取预解析的动画片段，句柄无效时返回 nullptr
+    const UnitAnimClip* getAnimClip(int handle) const;
+
     // 检查配置是否存在
     bool hasConfig(int unitId) const;
 
@@ -58,9 +62,17 @@ private:
     // 解析AI类型
     TargetPriority parseAIType(int aiType);
 
+    // 解析兵种的资源基准名与各动画句柄
+    void resolveAnimations(UnitConfig& config);
+    int resolveAnimClip(const std::string& baseName, const std::string& animKey, int frameCount, float delay);
+
     // ID -> Config 的映射表
     std::map<int, UnitConfig> _configCache;
 
+    // 动画片段表（deque 保证扩容时已有片段地址不变），以及 "{baseName}_{animKey}" -> 句柄
+    std::deque<UnitAnimClip> _animClips;
+    std::map<std::string, int> _animClipIndex;
+
     // 兵种训练与等级数据（跨场景持久化）
     std::map<int, int> _trainedUnits;
     std::map<int, int> _unitLevels;
@@ -0,0 +1,180 @@
+﻿// AnimationLod.cpp
+#include "AnimationLod.h"
+#include "Utils/NodeUtils.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace AnimationLod {
+namespace {
+constexpr int kHalfCrowdCount = 4;      // 同格单位数达到此值降为半速推进
+constexpr int kQuarterCrowdCount = 8;   // 同格单位数达到此值降为1/4推进
+constexpr float kHalfZoom = 0.6f;       // 地图缩放低于此值降为半速推进
+constexpr float kCullMargin = 48.0f;    // 可见判定外扩，避免边缘单位闪停
+
+// 包装循环动画：按步长跳帧推进，冻结时不推进
+class LodLoopAction : public cocos2d::Action {
+public:
+    static LodLoopAction* create(cocos2d::ActionInterval* inner) {
+        auto* ret = new (std::nothrow) LodLoopAction();
+        if (ret && inner) {
+            ret->_inner = inner;
+            inner->retain();
+            ret->autorelease();
+            return ret;
+        }
+        CC_SAFE_DELETE(ret);
+        return nullptr;
+    }
+
+    virtual ~LodLoopAction() {
+        CC_SAFE_RELEASE(_inner);
+    }
+
+    void setLevel(Level level) {
+        _clock.setLevel(level);
+    }
+
+    virtual LodLoopAction* clone() const override {
+        return LodLoopAction::create(_inner->clone());
+    }
+
+    virtual LodLoopAction* reverse() const override {
+        return LodLoopAction::create(_inner->reverse());
+    }
+
+    virtual void startWithTarget(cocos2d::Node* target) override {
+        cocos2d::Action::startWithTarget(target);
+        _inner->startWithTarget(target);
+    }
+
+    virtual void stop() override {
+        _inner->stop();
+        cocos2d::Action::stop();
+    }
+
+    virtual void step(float dt) override {
+        float stepDt = 0.0f;
+        if (_clock.advance(dt, stepDt)) {
+            _inner->step(stepDt);
+        }
+    }
+
+    virtual bool isDone() const override {
+        return _inner->isDone();
+    }
+
+private:
+    cocos2d::ActionInterval* _inner = nullptr;
+    LoopClock _clock;
+};
+
+int64_t crowdKey(const cocos2d::Vec2& pos, float cellSize) {
+    int64_t cx = static_cast<int64_t>(std::floor(pos.x / cellSize));
+    int64_t cy = static_cast<int64_t>(std::floor(pos.y / cellSize));
+    return (cx << 32) ^ (cy & 0xffffffff);
+}
+} // namespace
+
+void LoopClock::setLevel(Level level) {
+    _frozen = (level == Level::Frozen);
+    switch (level) {
+    case Level::Half:
+        _stride = 2;
+        break;
+    case Level::Quarter:
+        _stride = 4;
+        break;
+    default:
+        _stride = 1;
+        break;
+    }
+}
+
+bool LoopClock::advance(float dt, float& outDt) {
+    if (_frozen) {
+        return false;
+    }
+    _pendingDt += dt;
+    if (++_frameCounter < _stride) {
+        return false;
+    }
+    outDt = _pendingDt;
+    _pendingDt = 0.0f;
+    _frameCounter = 0;
+    return true;
+}
+
+void LoopClock::reset() {
+    _frameCounter = 0;
+    _pendingDt = 0.0f;
+}
+
+cocos2d::Action* createLoop(cocos2d::Animation* animation) {
+    if (!animation) {
+        return nullptr;
+    }
+    auto* loop = cocos2d::RepeatForever::create(cocos2d::Animate::create(animation));
+    auto* action = LodLoopAction::create(loop);
+    if (action) {
+        action->setTag(kLoopActionTag);
+    }
+    return action;
+}
+
+void setLevel(cocos2d::Node* target, Level level) {
+    if (!target) {
+        return;
+    }
+    if (auto* action = dynamic_cast<LodLoopAction*>(target->getActionByTag(kLoopActionTag))) {
+        action->setLevel(level);
+    }
+}
+
+Level resolveLevel(bool onScreen, int crowdCount, float zoom) {
+    if (!onScreen) {
+        return Level::Frozen;
+    }
+    if (crowdCount >= kQuarterCrowdCount) {
+        return Level::Quarter;
+    }
+    if (crowdCount >= kHalfCrowdCount || zoom < kHalfZoom) {
+        return Level::Half;
+    }
+    return Level::Full;
+}
+
+void updateLayer(cocos2d::Node* layer, const cocos2d::Rect& visibleRect, float crowdCellSize, float zoom) {
+    if (!layer || crowdCellSize <= 0.0f) {
+        return;
+    }
+
+    const auto& children = layer->getChildren();
+    std::unordered_map<int64_t, int> crowd;
+    crowd.reserve(children.size());
+    for (auto* child : children) {
+        ++crowd[crowdKey(child->getPosition(), crowdCellSize)];
+    }
+
+    cocos2d::Rect expanded(visibleRect.origin.x - kCullMargin, visibleRect.origin.y - kCullMargin,
+                           visibleRect.size.width + kCullMargin * 2.0f,
+                           visibleRect.size.height + kCullMargin * 2.0f);
+    for (auto* child : children) {
+        auto* receiver = dynamic_cast<Receiver*>(child);
+        auto* body = receiver ? nullptr : NodeUtils::findBodySprite(child);
+        if (!receiver && !body) {
+            continue;
+        }
+        const cocos2d::Vec2& pos = child->getPosition();
+        Level level = resolveLevel(expanded.containsPoint(pos),
+                                   crowd[crowdKey(pos, crowdCellSize)], zoom);
+        if (receiver) {
+            receiver->setAnimationLevel(level);
+        }
+        else {
+            setLevel(body, level);
+        }
+    }
+}
+
+} // namespace AnimationLod
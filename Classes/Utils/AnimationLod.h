@@ -0,0 +1,64 @@
+﻿// AnimationLod.h
+#pragma once
+
+#include "cocos2d.h"
+
+// 动画细节层级（LOD）
+// 只作用于循环的表现动画（移动/待机/建筑待机），攻击、死亡等单次动画与
+// 所有战斗逻辑都不受影响：
+// - 屏幕外：冻结时间轴，回到屏幕内后从原处继续
+// - 缩得很小或扎堆：每 N 帧推进一次（累计 dt，播放时长不变）
+namespace AnimationLod {
+
+enum class Level {
+    Full,       // 每帧推进
+    Half,       // 每2帧推进
+    Quarter,    // 每4帧推进
+    Frozen      // 暂停
+};
+
+// 按LOD累计并分批推进的时钟（LOD循环动画与自驱动帧动画共用）
+class LoopClock {
+public:
+    void setLevel(Level level);
+
+    // 累计 dt，到推进时机返回 true 并通过 outDt 给出累计时长；冻结时始终返回 false
+    bool advance(float dt, float& outDt);
+
+    // 切换动画时清空累计
+    void reset();
+
+private:
+    int _stride = 1;
+    int _frameCounter = 0;
+    float _pendingDt = 0.0f;
+    bool _frozen = false;
+};
+
+// 不使用 action、自行推进帧的节点实现此接口以接收LOD
+class Receiver {
+public:
+    virtual ~Receiver() = default;
+    virtual void setAnimationLevel(Level level) = 0;
+};
+
+// 可按LOD推进的循环动画 action tag
+constexpr int kLoopActionTag = 0x4C4F44;
+
+// 创建可被LOD控制的循环动画（替代 RepeatForever(Animate)）
+cocos2d::Action* createLoop(cocos2d::Animation* animation);
+
+// 设置 target 上循环动画的LOD，没有LOD循环动画时无操作（Receiver 见 updateLayer）
+void setLevel(cocos2d::Node* target, Level level);
+
+// 根据可见性、所在格拥挤度和地图缩放决定LOD
+Level resolveLevel(bool onScreen, int crowdCount, float zoom);
+
+/**
+ * 对 layer 的所有子节点（建筑/士兵）刷新LOD：
+ * visibleRect 为 layer 坐标系下的可见区域，crowdCellSize 为统计拥挤度的格子边长，
+ * zoom 为地图当前缩放。
+ */
+void updateLayer(cocos2d::Node* layer, const cocos2d::Rect& visibleRect, float crowdCellSize, float zoom);
+
+} // namespace AnimationLod
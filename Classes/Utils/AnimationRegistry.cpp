@@ -0,0 +1,150 @@
+﻿// AnimationRegistry.cpp
+#include "AnimationRegistry.h"
+#include <set>
+
+USING_NS_CC;
+
+namespace {
+struct SequenceDesc {
+    AnimSeq seq;
+    const char* name;           // 日志名
+    const char* pathFormat;     // 帧路径格式（参数为帧号）
+    int firstFrame;
+    int lastFrame;
+    float delay;
+};
+
+// 所有编号序列帧在此声明，顺序与 AnimSeq 一致
+const SequenceDesc kSequences[] = {
+    { AnimSeq::MAGIC_IMPACT, "magic_impact", "buildings/magic/fire_%d.png", 1, 18, 0.05f },
+    { AnimSeq::FIRE_LOOP, "fire_loop", "buildings/fire/fire_%d.png", 1, 33, 0.06f },
+    { AnimSeq::SPIKE_TRAP, "spike_trap", "buildings/spike/spike_%d.png", 1, 14, 0.08f },
+    { AnimSeq::SNAP_TRAP, "snap_trap", "buildings/trap/trap_%d.png", 1, 4, 0.06f },
+    { AnimSeq::TREE_SWAY, "tree_sway", "buildings/Tree/sprite_%04d.png", 0, 15, 0.1f },
+};
+static_assert(sizeof(kSequences) / sizeof(kSequences[0]) == static_cast<size_t>(AnimSeq::COUNT),
+    "kSequences must declare every AnimSeq");
+
+// 帧优先取 SpriteFrameCache，没有时从单张图片创建并登记，供其他加载路径复用
+SpriteFrame* loadFrame(const std::string& framePath) {
+    auto* frameCache = SpriteFrameCache::getInstance();
+    SpriteFrame* frame = frameCache->getSpriteFrameByName(framePath);
+    if (frame) {
+        return frame;
+    }
+    auto* texture = Director::getInstance()->getTextureCache()->addImage(framePath);
+    if (!texture) {
+        return nullptr;
+    }
+    Size size = texture->getContentSize();
+    frame = SpriteFrame::createWithTexture(texture, Rect(0, 0, size.width, size.height));
+    if (frame) {
+        frameCache->addSpriteFrame(frame, framePath);
+    }
+    return frame;
+}
+
+size_t textureBytes(const Texture2D* texture) {
+    if (!texture) {
+        return 0;
+    }
+    size_t pixels = static_cast<size_t>(texture->getPixelsWide()) * static_cast<size_t>(texture->getPixelsHigh());
+    return pixels * static_cast<size_t>(texture->getBitsPerPixelForFormat()) / 8;
+}
+} // namespace
+
+AnimationRegistry* AnimationRegistry::getInstance() {
+    static AnimationRegistry instance;
+    return &instance;
+}
+
+AnimationRegistry::Entry* AnimationRegistry::findEntry(AnimSeq seq) {
+    int index = static_cast<int>(seq);
+    if (index < 0 || index >= static_cast<int>(AnimSeq::COUNT)) {
+        return nullptr;
+    }
+    return &_entries[index];
+}
+
+const AnimationRegistry::Entry* AnimationRegistry::findEntry(AnimSeq seq) const {
+    int index = static_cast<int>(seq);
+    if (index < 0 || index >= static_cast<int>(AnimSeq::COUNT)) {
+        return nullptr;
+    }
+    return &_entries[index];
+}
+
+Animation* AnimationRegistry::get(AnimSeq seq) {
+    Entry* entry = findEntry(seq);
+    if (!entry) {
+        return nullptr;
+    }
+    if (!entry->loaded) {
+        load(seq, *entry);
+    }
+    return entry->animation;
+}
+
+bool AnimationRegistry::preload(AnimSeq seq) {
+    return get(seq) != nullptr;
+}
+
+void AnimationRegistry::preloadAll() {
+    for (const auto& desc : kSequences) {
+        preload(desc.seq);
+    }
+}
+
+bool AnimationRegistry::isLoaded(AnimSeq seq) const {
+    const Entry* entry = findEntry(seq);
+    return entry && entry->loaded;
+}
+
+size_t AnimationRegistry::getMemoryBytes(AnimSeq seq) const {
+    const Entry* entry = findEntry(seq);
+    return entry ? entry->bytes : 0;
+}
+
+void AnimationRegistry::load(AnimSeq seq, Entry& entry) {
+    entry.loaded = true;
+    const SequenceDesc& desc = kSequences[static_cast<int>(seq)];
+
+    Vector<SpriteFrame*> frames;
+    std::set<const Texture2D*> textures;
+    for (int i = desc.firstFrame; i <= desc.lastFrame; ++i) {
+        // 缺号的帧直接跳过（如 fire_30）
+        auto* frame = loadFrame(StringUtils::format(desc.pathFormat, i));
+        if (!frame) {
+            continue;
+        }
+        frames.pushBack(frame);
+        textures.insert(frame->getTexture());
+    }
+    if (frames.empty()) {
+        CCLOG("[动画注册表] 序列 %s 没有可用帧", desc.name);
+        return;
+    }
+
+    entry.animation = Animation::createWithSpriteFrames(frames, desc.delay);
+    entry.animation->retain();
+    entry.frames = static_cast<int>(frames.size());
+    for (const auto* texture : textures) {
+        entry.bytes += textureBytes(texture);
+    }
+    CCLOG("[动画注册表] 加载 %s：%d 帧，%.1fKB", desc.name, entry.frames, entry.bytes / 1024.0f);
+}
+
+std::string AnimationRegistry::buildMemoryReport() const {
+    std::string report;
+    size_t total = 0;
+    for (const auto& desc : kSequences) {
+        const Entry& entry = _entries[static_cast<int>(desc.seq)];
+        if (!entry.animation) {
+            continue;
+        }
+        total += entry.bytes;
+        report += StringUtils::format("%s: %d frames %.1fKB\n", desc.name, entry.frames, entry.bytes / 1024.0f);
+    }
+    report += StringUtils::format("Total: %.1fKB", total / 1024.0f);
+    return report;
+}
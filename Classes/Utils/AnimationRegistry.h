@@ -0,0 +1,62 @@
+﻿// AnimationRegistry.h
+#ifndef __ANIMATION_REGISTRY_H__
+#define __ANIMATION_REGISTRY_H__
+
+#include "cocos2d.h"
+#include <string>
+
+// 固定编号序列帧动画（建筑特效、陷阱、树）；兵种与建筑配置里的动画仍由
+// UnitManager 句柄与 AnimationUtils 的 AnimationCache 管理
+enum class AnimSeq {
+    NONE = -1,
+    MAGIC_IMPACT,       // 魔法塔落点爆炸
+    FIRE_LOOP,          // 火焰塔喷火循环
+    SPIKE_TRAP,         // 地刺循环
+    SNAP_TRAP,          // 捕兽夹合拢
+    TREE_SWAY,          // 树摆动
+    COUNT
+};
+
+/**
+ * 序列帧动画注册表
+ * 每个序列只在表中声明一次（路径格式、帧范围、帧间隔），首次 get 或 preload 时构建，
+ * 之后所有调用方共享同一个被 retain 的 Animation，战斗中不再重复查询纹理、创建帧。
+ */
+class AnimationRegistry {
+public:
+    static AnimationRegistry* getInstance();
+
+    // 取共享动画（未加载时同步加载），资源缺失时返回 nullptr；调用方不要修改返回的动画
+    cocos2d::Animation* get(AnimSeq seq);
+
+    // 提前加载，返回是否有可用帧
+    bool preload(AnimSeq seq);
+    void preloadAll();
+
+    bool isLoaded(AnimSeq seq) const;
+
+    // 序列占用的纹理内存（字节，按去重后的纹理计算），未加载时为 0
+    size_t getMemoryBytes(AnimSeq seq) const;
+
+    // 多行报告：每个已加载序列的帧数与纹理内存
+    std::string buildMemoryReport() const;
+
+private:
+    AnimationRegistry() = default;
+    ~AnimationRegistry() = default;
+
+    struct Entry {
+        cocos2d::Animation* animation = nullptr;
+        bool loaded = false;            // 已尝试加载（资源缺失时也不再重试）
+        int frames = 0;
+        size_t bytes = 0;
+    };
+
+    Entry* findEntry(AnimSeq seq);
+    const Entry* findEntry(AnimSeq seq) const;
+    void load(AnimSeq seq, Entry& entry);
+
+    Entry _entries[static_cast<int>(AnimSeq::COUNT)];
+};
+
+#endif // __ANIMATION_REGISTRY_H__
@@ -1,11 +1,14 @@
 ﻿#include "Utils/AudioManager.h"
-#include "audio/include/SimpleAudioEngine.h"
+#include "audio/include/AudioEngine.h"
 #include "base/CCUserDefault.h"
 #include "cocos2d.h"
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <map>
 #include <string>
 
-using namespace CocosDenshion;
+using cocos2d::experimental::AudioEngine;
 
 namespace {
 // 音量默认值
@@ -48,14 +51,29 @@ constexpr const char* kSfxLose = "music/Lose.wav";
 
 #undef VK_UTF8_LITERAL
 
+// 背景音乐优先使用同名 .ogg：AudioEngine 对长音频只解码开头几个缓冲区，
+// 其余在音频线程上边解码边播放，不会整首解成 PCM 常驻内存
+constexpr const char* kBgmStreamExt = ".ogg";
+
+// 音效库：preload 时把所有短音效异步解码成 PCM 缓存，首次播放不再同步解码
+struct SfxEntry {
+    bool ready = false;
+    bool failed = false;
+    bool played = false;
+    float decodeMs = 0.0f;      // 从 preload 开始到解码完成
+    long bytes = 0;             // 源文件大小（wav 近似等于 PCM 大小）
+};
+
 std::string s_currentBgm;
+int s_bgmAudioId = AudioEngine::INVALID_AUDIO_ID;
 bool s_bgmMuted = false;
 bool s_sfxMuted = false;
 bool s_volumeLoaded = false;
-
-SimpleAudioEngine* getEngine() {
-    return SimpleAudioEngine::getInstance();
-}
+bool s_bankRequested = false;
+int s_bankPending = 0;
+int s_coldPlays = 0;            // 解码完成前就被播放的次数
+std::map<std::string, SfxEntry> s_sfxBank;
+std::chrono::steady_clock::time_point s_bankStart;
 
 float getEffectiveBgmVolume() {
     return s_bgmMuted ? 0.0f : kDefaultBgmVolume;
@@ -66,12 +84,9 @@ float getEffectiveSfxVolume() {
 }
 
 void applyEngineVolumes() {
-    auto* engine = getEngine();
-    if (!engine) {
-        return;
+    if (s_bgmAudioId != AudioEngine::INVALID_AUDIO_ID) {
+        AudioEngine::setVolume(s_bgmAudioId, getEffectiveBgmVolume());
     }
-    engine->setBackgroundMusicVolume(getEffectiveBgmVolume());
-    engine->setEffectsVolume(getEffectiveSfxVolume());
 }
 
 void ensureVolumeLoaded() {
@@ -98,53 +113,90 @@ std::string resolveAudioPath(const char* file) {
     return std::string(file);
 }
 
+std::string resolveBgmPath(const char* file) {
+    std::string name = file ? file : "";
+    size_t dot = name.rfind('.');
+    if (dot != std::string::npos) {
+        std::string streamName = name.substr(0, dot) + kBgmStreamExt;
+        auto* fileUtils = cocos2d::FileUtils::getInstance();
+        if (fileUtils && fileUtils->isFileExist(streamName)) {
+            return resolveAudioPath(streamName.c_str());
+        }
+    }
+    return resolveAudioPath(file);
+}
+
+void stopBgmInternal() {
+    if (s_bgmAudioId != AudioEngine::INVALID_AUDIO_ID) {
+        AudioEngine::stop(s_bgmAudioId);
+        s_bgmAudioId = AudioEngine::INVALID_AUDIO_ID;
+    }
+    // 流式音乐的缓存只有开头几块，切歌时释放
+    if (!s_currentBgm.empty()) {
+        AudioEngine::uncache(s_currentBgm);
+    }
+    s_currentBgm.clear();
+}
+
 void playBgmInternal(const char* file) {
     ensureVolumeLoaded();
-    std::string path = resolveAudioPath(file);
+    std::string path = resolveBgmPath(file);
     if (path.empty()) {
         return;
     }
     if (s_currentBgm == path) {
         return;
     }
-    auto* engine = getEngine();
-    if (!engine) {
-        return;
-    }
-    engine->setBackgroundMusicVolume(getEffectiveBgmVolume());
-    engine->playBackgroundMusic(path.c_str(), true);
+    stopBgmInternal();
+    s_bgmAudioId = AudioEngine::play2d(path, true, getEffectiveBgmVolume());
     s_currentBgm = path;
 }
 
 void playEffectInternal(const char* file) {
     ensureVolumeLoaded();
+    if (s_sfxMuted) {
+        return;
+    }
     std::string path = resolveAudioPath(file);
     if (path.empty()) {
         return;
     }
-    auto* engine = getEngine();
-    if (!engine) {
+
+    auto it = s_sfxBank.find(path);
+    if (it != s_sfxBank.end() && !it->second.played) {
+        it->second.played = true;
+        if (!it->second.ready) {
+            s_coldPlays++;
+            CCLOG("[音频] 音效首次播放时尚未解码完成: %s", file);
+        }
+    }
+    AudioEngine::play2d(path, false, getEffectiveSfxVolume());
+}
+
+void onSfxDecoded(const std::string& path, bool success) {
+    auto it = s_sfxBank.find(path);
+    if (it == s_sfxBank.end()) {
         return;
     }
-    engine->setEffectsVolume(getEffectiveSfxVolume());
-    engine->playEffect(path.c_str(), false);
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - s_bankStart;
+    it->second.ready = success;
+    it->second.failed = !success;
+    it->second.decodeMs = elapsed.count();
+    if (--s_bankPending == 0) {
+        CCLOG("[音频] %s", AudioManager::buildReport().c_str());
+    }
 }
 } // namespace
 
 namespace AudioManager {
 void preload() {
     ensureVolumeLoaded();
-    auto* engine = getEngine();
-    if (!engine) {
+    if (s_bankRequested) {
         return;
     }
-    applyEngineVolumes();
-
-    engine->preloadBackgroundMusic(resolveAudioPath(kBgmStart).c_str());
-    engine->preloadBackgroundMusic(resolveAudioPath(kBgmBattle1).c_str());
-    engine->preloadBackgroundMusic(resolveAudioPath(kBgmBattle2).c_str());
-    engine->preloadBackgroundMusic(resolveAudioPath(kBgmBattle3).c_str());
+    s_bankRequested = true;
 
+    // 背景音乐走流式播放，不再整首预载
     std::array<const char*, 18> effects = {
         kSfxButtonClick,
         kSfxButtonCancel,
@@ -165,11 +217,60 @@ void preload() {
         kSfxVictory,
         kSfxLose
     };
+
+    auto* fileUtils = cocos2d::FileUtils::getInstance();
+    s_bankStart = std::chrono::steady_clock::now();
     for (const auto& effect : effects) {
-        engine->preloadEffect(resolveAudioPath(effect).c_str());
+        std::string path = resolveAudioPath(effect);
+        if (path.empty() || s_sfxBank.count(path) > 0) {
+            continue;
+        }
+        SfxEntry entry;
+        entry.bytes = fileUtils ? fileUtils->getFileSize(path) : 0;
+        if (entry.bytes <= 0) {
+            // 缺失的资源不进入解码队列
+            entry.failed = true;
+            s_sfxBank[path] = entry;
+            continue;
+        }
+        s_sfxBank[path] = entry;
+        s_bankPending++;
+    }
+
+    // 解码在 AudioEngine 的线程池上进行，完成回调回到主线程
+    for (auto& pair : s_sfxBank) {
+        if (pair.second.failed) {
+            continue;
+        }
+        std::string path = pair.first;
+        AudioEngine::preload(path, [path](bool success) {
+            onSfxDecoded(path, success);
+        });
     }
 }
 
+std::string buildReport() {
+    int ready = 0;
+    int failed = 0;
+    long pcmBytes = 0;
+    float slowestMs = 0.0f;
+    for (const auto& pair : s_sfxBank) {
+        const SfxEntry& entry = pair.second;
+        if (entry.ready) {
+            ready++;
+            pcmBytes += entry.bytes;
+            slowestMs = std::max(slowestMs, entry.decodeMs);
+        }
+        else if (entry.failed) {
+            failed++;
+        }
+    }
+    return cocos2d::StringUtils::format(
+        "SFX bank %d/%d ready (%d missing), ~%.1fKB PCM, all decoded in %.0fms, cold first plays %d; BGM %s",
+        ready, static_cast<int>(s_sfxBank.size()), failed, pcmBytes / 1024.0f, slowestMs, s_coldPlays,
+        s_currentBgm.empty() ? "-" : s_currentBgm.c_str());
+}
+
 bool isBgmMuted() {
     ensureVolumeLoaded();
     return s_bgmMuted;
@@ -221,29 +322,15 @@ void playBattleBgm(int levelId) {
 }
 
 void stopBgm() {
-    auto* engine = getEngine();
-    if (engine) {
-        engine->stopBackgroundMusic(false);
-    }
-    s_currentBgm.clear();
+    stopBgmInternal();
 }
 
 void pauseAll() {
-    auto* engine = getEngine();
-    if (!engine) {
-        return;
-    }
-    engine->pauseBackgroundMusic();
-    engine->pauseAllEffects();
+    AudioEngine::pauseAll();
 }
 
 void resumeAll() {
-    auto* engine = getEngine();
-    if (!engine) {
-        return;
-    }
-    engine->resumeBackgroundMusic();
-    engine->resumeAllEffects();
+    AudioEngine::resumeAll();
 }
 
 void playButtonClick() {
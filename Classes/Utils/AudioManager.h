@@ -1,9 +1,14 @@
 ﻿#ifndef __AUDIO_MANAGER_H__
 #define __AUDIO_MANAGER_H__
 
+#include <string>
+
 // 音频管理：统一控制BGM与音效
+// BGM 流式播放（优先 .ogg），短音效在 preload 时异步解码进 PCM 缓存
 namespace AudioManager {
     void preload();
+    // 音效库就绪情况、PCM 内存估算、首次播放未命中次数与当前 BGM
+    std::string buildReport();
     bool isBgmMuted();
     bool isSfxMuted();
     void setBgmMuted(bool muted);
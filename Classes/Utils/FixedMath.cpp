@@ -0,0 +1,151 @@
+﻿// FixedMath.cpp
+#include "FixedMath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+USING_NS_CC;
+
+namespace {
+// 64 位整数平方根（逐位试商，结果向下取整），纯整数运算
+uint64_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+Fixed axisGap(Fixed minA, Fixed maxA, Fixed minB, Fixed maxB) {
+    if (maxA < minB) {
+        return minB - maxA;
+    }
+    if (maxB < minA) {
+        return minA - maxB;
+    }
+    return Fixed();
+}
+
+double elapsedNs(const std::chrono::steady_clock::time_point& start, int iterations) {
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / std::max(1, iterations);
+}
+} // namespace
+
+Fixed Fixed::fromFloat(float value) {
+    // 乘以 2^16 是精确运算，再按最近整数取整，各平台结果一致
+    return fromRaw(static_cast<int32_t>(std::lround(static_cast<double>(value) * kOne)));
+}
+
+FixedVec2 FixedVec2::fromVec2(const Vec2& v) {
+    return { Fixed::fromFloat(v.x), Fixed::fromFloat(v.y) };
+}
+
+FixedRect FixedRect::fromRect(const Rect& rect) {
+    return { Fixed::fromFloat(rect.getMinX()), Fixed::fromFloat(rect.getMinY()),
+             Fixed::fromFloat(rect.getMaxX()), Fixed::fromFloat(rect.getMaxY()) };
+}
+
+int64_t FixedVec2::lengthSquaredRaw() const {
+    return static_cast<int64_t>(x.raw) * x.raw + static_cast<int64_t>(y.raw) * y.raw;
+}
+
+Fixed FixedVec2::length() const {
+    // sqrt(Q32.32) 正好是 Q16.16
+    return Fixed::fromRaw(static_cast<int32_t>(isqrt64(static_cast<uint64_t>(lengthSquaredRaw()))));
+}
+
+FixedVec2 FixedVec2::normalized() const {
+    Fixed len = length();
+    if (len.raw == 0) {
+        return FixedVec2();
+    }
+    return { x / len, y / len };
+}
+
+Fixed FixedMath::sqrt(Fixed value) {
+    if (value.raw <= 0) {
+        return Fixed();
+    }
+    return Fixed::fromRaw(static_cast<int32_t>(isqrt64(static_cast<uint64_t>(value.raw) << Fixed::kFracBits)));
+}
+
+Fixed FixedMath::distance(const FixedVec2& a, const FixedVec2& b) {
+    return (b - a).length();
+}
+
+Fixed FixedMath::rectDistance(const FixedRect& a, const FixedRect& b) {
+    FixedVec2 gap;
+    gap.x = axisGap(a.minX, a.maxX, b.minX, b.maxX);
+    gap.y = axisGap(a.minY, a.maxY, b.minY, b.maxY);
+    return gap.length();
+}
+
+std::vector<Fixed> FixedMath::fromFloats(const std::vector<float>& values) {
+    std::vector<Fixed> result;
+    result.reserve(values.size());
+    for (float value : values) {
+        result.push_back(Fixed::fromFloat(value));
+    }
+    return result;
+}
+
+Fixed FixedMath::levelValue(const std::vector<Fixed>& values, int level) {
+    if (level >= 0 && static_cast<size_t>(level) < values.size()) {
+        return values[level];
+    }
+    return values.empty() ? Fixed() : values[0];
+}
+
+std::string FixedMath::benchmark(int iterations) {
+    iterations = std::max(1, iterations);
+    // 固定种子的伪随机点，两种实现处理同一组输入
+    std::vector<Vec2> points(256);
+    uint32_t seed = 12345;
+    for (auto& p : points) {
+        seed = seed * 1664525u + 1013904223u;
+        p.x = static_cast<float>(seed % 2000u);
+        seed = seed * 1664525u + 1013904223u;
+        p.y = static_cast<float>(seed % 1500u);
+    }
+    const size_t mask = points.size() - 1;
+
+    volatile float floatSink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        const Vec2& a = points[i & mask];
+        const Vec2& b = points[(i * 7 + 3) & mask];
+        Vec2 dir = (b - a).getNormalized();
+        floatSink = floatSink + a.distance(b) + dir.x;
+    }
+    double floatNs = elapsedNs(start, iterations);
+
+    // 无符号累加：回绕有定义，避免有符号溢出
+    uint32_t fixedSink = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        const Vec2& a = points[i & mask];
+        const Vec2& b = points[(i * 7 + 3) & mask];
+        FixedVec2 diff = FixedVec2::fromVec2(b) - FixedVec2::fromVec2(a);
+        fixedSink += static_cast<uint32_t>(diff.length().raw) + static_cast<uint32_t>(diff.normalized().x.raw);
+    }
+    double fixedNs = elapsedNs(start, iterations);
+    volatile uint32_t keep = fixedSink;
+    (void)keep;
+
+    double ratio = floatNs > 0.0 ? fixedNs / floatNs : 0.0;
+    return StringUtils::format("Fixed math: dist+normalize %.1fns vs float %.1fns (x%.2f)",
+        fixedNs, floatNs, ratio);
+}
@@ -0,0 +1,97 @@
+﻿// FixedMath.h
+#pragma once
+
+#include "cocos2d.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Q16.16 定点数：战斗模拟中的距离、方向与位移都用整数运算，
+// 不依赖平台的浮点实现（sqrt/除法/编译器浮点优化），保证不同平台逐位一致。
+// 渲染与界面仍使用 float，只在判定/位移时进出定点。
+struct Fixed {
+    static constexpr int kFracBits = 16;
+    static constexpr int32_t kOne = 1 << kFracBits;
+
+    int32_t raw = 0;
+
+    static Fixed fromRaw(int32_t value) { Fixed f; f.raw = value; return f; }
+    static Fixed fromInt(int value) { return fromRaw(value * kOne); }
+    static Fixed fromFloat(float value);
+    static Fixed maxValue() { return fromRaw(INT32_MAX); }
+    float toFloat() const { return static_cast<float>(raw) / static_cast<float>(kOne); }
+    // 向下取整（算术右移，负数也向负无穷取整）
+    int floorToInt() const { return raw >> kFracBits; }
+
+    Fixed operator+(Fixed o) const { return fromRaw(raw + o.raw); }
+    Fixed operator-(Fixed o) const { return fromRaw(raw - o.raw); }
+    Fixed operator-() const { return fromRaw(-raw); }
+    Fixed operator*(Fixed o) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * o.raw) >> kFracBits));
+    }
+    Fixed operator/(Fixed o) const {
+        return o.raw == 0 ? Fixed() : fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) << kFracBits) / o.raw));
+    }
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+
+    bool operator<(Fixed o) const { return raw < o.raw; }
+    bool operator<=(Fixed o) const { return raw <= o.raw; }
+    bool operator>(Fixed o) const { return raw > o.raw; }
+    bool operator>=(Fixed o) const { return raw >= o.raw; }
+    bool operator==(Fixed o) const { return raw == o.raw; }
+    bool operator!=(Fixed o) const { return raw != o.raw; }
+};
+
+struct FixedVec2 {
+    Fixed x;
+    Fixed y;
+
+    static FixedVec2 fromVec2(const cocos2d::Vec2& v);
+    cocos2d::Vec2 toVec2() const { return cocos2d::Vec2(x.toFloat(), y.toFloat()); }
+
+    FixedVec2 operator+(const FixedVec2& o) const { return { x + o.x, y + o.y }; }
+    FixedVec2 operator-(const FixedVec2& o) const { return { x - o.x, y - o.y }; }
+    FixedVec2 operator*(Fixed s) const { return { x * s, y * s }; }
+
+    // 平方长度保留 Q32.32 精度，避免大坐标平方溢出
+    int64_t lengthSquaredRaw() const;
+    Fixed length() const;
+    FixedVec2 normalized() const;
+};
+
+// 轴对齐包围盒（战斗空间）
+struct FixedRect {
+    Fixed minX;
+    Fixed minY;
+    Fixed maxX;
+    Fixed maxY;
+
+    static FixedRect fromRect(const cocos2d::Rect& rect);
+
+    bool isEmpty() const { return maxX <= minX || maxY <= minY; }
+    // 闭区间，与 Rect::containsPoint 一致
+    bool containsPoint(const FixedVec2& p) const {
+        return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+    }
+    // 左闭右开，用于格子判定（相邻格子不会同时命中）
+    bool coversPoint(const FixedVec2& p) const {
+        return p.x >= minX && p.x < maxX && p.y >= minY && p.y < maxY;
+    }
+    FixedRect offsetBy(const FixedVec2& d) const { return { minX + d.x, minY + d.y, maxX + d.x, maxY + d.y }; }
+};
+
+namespace FixedMath {
+Fixed sqrt(Fixed value);
+Fixed distance(const FixedVec2& a, const FixedVec2& b);
+// 两个包围盒边缘之间的距离（相交为 0）
+Fixed rectDistance(const FixedRect& a, const FixedRect& b);
+
+// 配置数值在加载时一次性转为定点，战斗中不再从 float 换算
+std::vector<Fixed> fromFloats(const std::vector<float>& values);
+// 按等级取值，兜底与 float 版 getter 一致：越界取 0 级，空数组为 0
+Fixed levelValue(const std::vector<Fixed>& values, int level);
+
+// 对比定点与浮点版本的距离/归一化耗时，返回一行报告
+std::string benchmark(int iterations);
+} // namespace FixedMath
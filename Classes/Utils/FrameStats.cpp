@@ -0,0 +1,88 @@
+﻿// FrameStats.cpp
+#include "FrameStats.h"
+#include "cocos2d.h"
+#include <algorithm>
+
+namespace {
+// 超过此耗时视为掉帧（约30FPS）
+constexpr float kSlowFrameMs = 33.4f;
+
+float percentile(std::vector<float>& sorted, float p) {
+    if (sorted.empty()) {
+        return 0.0f;
+    }
+    size_t index = static_cast<size_t>(p * static_cast<float>(sorted.size() - 1) + 0.5f);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+} // namespace
+
+void FrameStats::reset() {
+    _frameMs.clear();
+    _frameMs.reserve(60 * 180);
+    _logicMsSum = 0.0;
+    _crowdMsSum = 0.0;
+    _peakUnits = 0;
+    for (auto& bucket : _buckets) {
+        bucket = Bucket();
+    }
+}
+
+void FrameStats::addSample(float frameMs, float logicMs, float crowdMs, int units) {
+    _frameMs.push_back(frameMs);
+    _logicMsSum += logicMs;
+    _crowdMsSum += crowdMs;
+    _peakUnits = std::max(_peakUnits, units);
+
+    int index = std::min(std::max(units, 0) / kBucketUnits, kBucketCount - 1);
+    Bucket& bucket = _buckets[index];
+    bucket.samples++;
+    bucket.frameMs += frameMs;
+    bucket.worstMs = std::max(bucket.worstMs, frameMs);
+}
+
+std::string FrameStats::buildReport() const {
+    if (_frameMs.empty()) {
+        return "Frames: -";
+    }
+
+    std::vector<float> sorted = _frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    int slowFrames = 0;
+    for (float ms : sorted) {
+        total += ms;
+        if (ms > kSlowFrameMs) {
+            slowFrames++;
+        }
+    }
+    float count = static_cast<float>(sorted.size());
+    float avg = static_cast<float>(total / count);
+
+    std::string report = cocos2d::StringUtils::format(
+        "Frames: %d  avg %.1fms (%.0f FPS)  p50 %.1f  p95 %.1f  p99 %.1f  max %.1f\n"
+        "Logic avg %.2fms  Crowd avg %.2fms  Slow frames: %d  Peak units: %d",
+        static_cast<int>(sorted.size()), avg, avg > 0.0f ? 1000.0f / avg : 0.0f,
+        percentile(sorted, 0.5f), percentile(sorted, 0.95f), percentile(sorted, 0.99f), sorted.back(),
+        static_cast<float>(_logicMsSum / count), static_cast<float>(_crowdMsSum / count),
+        slowFrames, _peakUnits);
+
+    // 按单位数量分段，找出开始掉帧的规模
+    std::string buckets;
+    for (int i = 0; i < kBucketCount; ++i) {
+        const Bucket& bucket = _buckets[i];
+        if (bucket.samples == 0) {
+            continue;
+        }
+        int from = i * kBucketUnits;
+        std::string range = (i == kBucketCount - 1)
+            ? cocos2d::StringUtils::format("%d+", from)
+            : cocos2d::StringUtils::format("%d-%d", from, from + kBucketUnits - 1);
+        buckets += cocos2d::StringUtils::format("%s%s: %.1f/%.1fms",
+            buckets.empty() ? "" : "  ", range.c_str(),
+            static_cast<float>(bucket.frameMs / bucket.samples), bucket.worstMs);
+    }
+    if (!buckets.empty()) {
+        report += "\nUnits avg/max: " + buckets;
+    }
+    return report;
+}
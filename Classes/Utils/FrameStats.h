@@ -0,0 +1,42 @@
+﻿// FrameStats.h
+#pragma once
+
+#include <string>
+#include <vector>
+
+// 帧耗时统计：记录每帧耗时与当时的单位数量，结束时给出分位数和按单位数量分段的均值，
+// 用于压力测试定位引擎在多少单位时开始掉帧
+class FrameStats {
+public:
+    void reset();
+
+    /**
+     * @param frameMs  整帧耗时（真实时间，毫秒）
+     * @param logicMs  场景逻辑耗时（毫秒）
+     * @param crowdMs  士兵分离耗时（毫秒）
+     * @param units    当前存活单位数
+     */
+    void addSample(float frameMs, float logicMs, float crowdMs, int units);
+
+    int getSampleCount() const { return static_cast<int>(_frameMs.size()); }
+    int getPeakUnits() const { return _peakUnits; }
+
+    // 多行文本报告（结算面板与日志共用）
+    std::string buildReport() const;
+
+private:
+    static constexpr int kBucketUnits = 250;    // 单位数量分段宽度
+    static constexpr int kBucketCount = 9;      // 0~2000+ 共9段
+
+    struct Bucket {
+        int samples = 0;
+        double frameMs = 0.0;
+        float worstMs = 0.0f;
+    };
+
+    std::vector<float> _frameMs;
+    double _logicMsSum = 0.0;
+    double _crowdMsSum = 0.0;
+    int _peakUnits = 0;
+    Bucket _buckets[kBucketCount];
+};
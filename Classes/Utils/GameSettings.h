@@ -8,6 +8,7 @@ namespace GameSettings {
 constexpr const char* kShowFpsKey = "ui_show_fps";
 constexpr const char* kShowGridKey = "ui_show_grid";
 constexpr const char* kBattleSpeedKey = "battle_speed";
+constexpr const char* kParallelTargetingKey = "battle_parallel_targeting";
 
 inline bool getShowFps() {
     return cocos2d::UserDefault::getInstance()->getBoolForKey(kShowFpsKey, true);
@@ -56,6 +57,17 @@ inline void setBattleSpeed(float value) {
     defaults->flush();
 }
 
+// 战斗寻敌是否分发到工作线程（结果与单线程一致，仅影响耗时）
+inline bool getParallelTargeting() {
+    return cocos2d::UserDefault::getInstance()->getBoolForKey(kParallelTargetingKey, true);
+}
+
+inline void setParallelTargeting(bool value) {
+    auto* defaults = cocos2d::UserDefault::getInstance();
+    defaults->setBoolForKey(kParallelTargetingKey, value);
+    defaults->flush();
+}
+
 inline void applyTimeScale(float value) {
     auto* scheduler = cocos2d::Director::getInstance()->getScheduler();
     if (scheduler) {
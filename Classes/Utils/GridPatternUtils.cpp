@@ -0,0 +1,98 @@
+﻿/**
+ * @file GridPatternUtils.cpp
+ * @brief 平铺网格线工具实现
+ */
+
+#include "Utils/GridPatternUtils.h"
+#include <cmath>
+#include <vector>
+
+namespace GridPatternUtils {
+namespace {
+bool isDashOn(float offset, float dashLength, float gapLength) {
+    if (gapLength <= 0.0f || dashLength <= 0.0f) {
+        return true;
+    }
+    return std::fmod(offset, dashLength + gapLength) < dashLength;
+}
+}
+
+cocos2d::Texture2D* getGridTileTexture(int tileSize,
+                                       const cocos2d::Color4F& lineColor,
+                                       float dashLength,
+                                       float gapLength) {
+    if (tileSize <= 0) {
+        return nullptr;
+    }
+
+    cocos2d::Color4B color(lineColor);
+    std::string key = cocos2d::StringUtils::format("grid_tile_%d_%.1f_%.1f_%02x%02x%02x%02x",
+        tileSize, dashLength, gapLength, color.r, color.g, color.b, color.a);
+    auto* cache = cocos2d::Director::getInstance()->getTextureCache();
+    if (auto* cached = cache->getTextureForKey(key)) {
+        return cached;
+    }
+
+    // 纹理第0行位于精灵顶部：第0行画横线，第0列画竖线。
+    // 竖线上第 row 行对应格子内自下而上的偏移 (tileSize - row) % tileSize，
+    // 使虚线相位与从地图原点起画的 DrawNode 版本一致。
+    std::vector<unsigned char> pixels(static_cast<size_t>(tileSize) * tileSize * 4, 0);
+    auto setPixel = [&](int col, int row) {
+        unsigned char* p = &pixels[(static_cast<size_t>(row) * tileSize + col) * 4];
+        p[0] = color.r;
+        p[1] = color.g;
+        p[2] = color.b;
+        p[3] = color.a;
+    };
+    for (int col = 0; col < tileSize; ++col) {
+        if (isDashOn(static_cast<float>(col), dashLength, gapLength)) {
+            setPixel(col, 0);
+        }
+    }
+    for (int row = 0; row < tileSize; ++row) {
+        float offset = static_cast<float>((tileSize - row) % tileSize);
+        if (isDashOn(offset, dashLength, gapLength)) {
+            setPixel(0, row);
+        }
+    }
+
+    auto* image = new (std::nothrow) cocos2d::Image();
+    if (!image || !image->initWithRawData(pixels.data(), static_cast<ssize_t>(pixels.size()),
+        tileSize, tileSize, 8, false)) {
+        CC_SAFE_RELEASE(image);
+        return nullptr;
+    }
+    auto* texture = cache->addImage(image, key);
+    image->release();
+    if (texture) {
+        cocos2d::Texture2D::TexParams params = { GL_NEAREST, GL_NEAREST, GL_REPEAT, GL_REPEAT };
+        texture->setTexParameters(params);
+    }
+    return texture;
+}
+
+cocos2d::Sprite* createGridLineSprite(int gridWidth,
+                                      int gridHeight,
+                                      float cellSize,
+                                      const cocos2d::Color4F& lineColor,
+                                      float dashLength,
+                                      float gapLength) {
+    int tileSize = static_cast<int>(std::lround(cellSize));
+    auto* texture = getGridTileTexture(tileSize, lineColor, dashLength, gapLength);
+    if (!texture) {
+        return nullptr;
+    }
+
+    // 多出1像素，让最右/最上的边界线也落在平铺纹理的第0列/第0行上
+    float width = static_cast<float>(gridWidth * tileSize + 1);
+    float height = static_cast<float>(gridHeight * tileSize + 1);
+    auto* sprite = cocos2d::Sprite::createWithTexture(texture, cocos2d::Rect(0, 0, width, height));
+    if (!sprite) {
+        return nullptr;
+    }
+    sprite->setAnchorPoint(cocos2d::Vec2::ZERO);
+    sprite->setPosition(cocos2d::Vec2::ZERO);
+    sprite->setScale(cellSize / static_cast<float>(tileSize));
+    return sprite;
+}
+} // namespace GridPatternUtils
@@ -0,0 +1,41 @@
+﻿/**
+ * @file GridPatternUtils.h
+ * @brief 平铺网格线工具
+ *
+ * 用单格大小的网格线纹理配合 GL_REPEAT 平铺整张地图，
+ * 顶点数与地图尺寸无关，显示/隐藏无需重新生成几何。
+ */
+
+#ifndef __GRID_PATTERN_UTILS_H__
+#define __GRID_PATTERN_UTILS_H__
+
+#include "cocos2d.h"
+
+namespace GridPatternUtils {
+    /**
+     * @brief 获取单格网格线纹理（按参数缓存在TextureCache中）
+     * @param tileSize 纹理边长（像素，GLES2下需为2的幂才能REPEAT）
+     * @param lineColor 线条颜色
+     * @param dashLength 虚线段长度
+     * @param gapLength 虚线间隔，<=0 表示实线
+     */
+    cocos2d::Texture2D* getGridTileTexture(int tileSize,
+                                           const cocos2d::Color4F& lineColor,
+                                           float dashLength,
+                                           float gapLength);
+
+    /**
+     * @brief 创建覆盖整张地图的网格线精灵（锚点左下角，位于父节点原点）
+     * @param gridWidth 网格宽度（格子数）
+     * @param gridHeight 网格高度（格子数）
+     * @param cellSize 每格像素大小
+     */
+    cocos2d::Sprite* createGridLineSprite(int gridWidth,
+                                          int gridHeight,
+                                          float cellSize,
+                                          const cocos2d::Color4F& lineColor,
+                                          float dashLength,
+                                          float gapLength);
+}
+
+#endif // __GRID_PATTERN_UTILS_H__
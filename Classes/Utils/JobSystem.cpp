@@ -0,0 +1,427 @@
+﻿// JobSystem.cpp
+#include "JobSystem.h"
+#include "cocos2d.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+// 工作线程上限（留一个核心给主线程和渲染）
+constexpr int kMaxWorkers = 7;
+// 主线程等待任务时的轮询间隔
+constexpr int kWaitPollMs = 1;
+
+thread_local int t_workerIndex = -1;
+thread_local ScratchArena t_scratch;
+
+float elapsedMs(const std::chrono::steady_clock::time_point& from,
+                const std::chrono::steady_clock::time_point& to) {
+    std::chrono::duration<float, std::milli> elapsed = to - from;
+    return elapsed.count();
+}
+} // namespace
+
+// ===================================================
+// ScratchArena
+// ===================================================
+
+ScratchArena::ScratchArena(size_t blockSize)
+    : _blockSize(blockSize) {
+}
+
+void* ScratchArena::allocate(size_t size, size_t align) {
+    if (size > _blockSize) {
+        return nullptr;
+    }
+    while (true) {
+        if (_blockIndex >= _blocks.size()) {
+            _blocks.emplace_back(new char[_blockSize]);
+            _offset = 0;
+        }
+        uintptr_t base = reinterpret_cast<uintptr_t>(_blocks[_blockIndex].get());
+        size_t aligned = (static_cast<size_t>(base + _offset + align - 1) & ~(align - 1)) - base;
+        if (aligned + size <= _blockSize) {
+            _offset = aligned + size;
+            _used += size;
+            return _blocks[_blockIndex].get() + aligned;
+        }
+        ++_blockIndex;
+        _offset = 0;
+    }
+}
+
+void ScratchArena::reset() {
+    _blockIndex = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+// ===================================================
+// JobSystem
+// ===================================================
+
+JobSystem* JobSystem::s_instance = nullptr;
+
+JobSystem* JobSystem::getInstance() {
+    if (!s_instance) {
+        s_instance = new JobSystem();
+    }
+    return s_instance;
+}
+
+void JobSystem::destroyInstance() {
+    if (s_instance) {
+        CCLOG("[任务系统] %s", s_instance->buildStatsReport().c_str());
+    }
+    delete s_instance;
+    s_instance = nullptr;
+}
+
+JobSystem::JobSystem() {
+    // 至少保留一个工作线程，保证异步 I/O 不会回落到主线程
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int workerCount = std::max(1, std::min(kMaxWorkers, hardware - 1));
+    for (int i = 0; i < workerCount; ++i) {
+        _queues.emplace_back(new WorkQueue());
+    }
+    _workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        _workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+    CCLOG("[任务系统] 启动 %d 个工作线程", workerCount);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeCv.notify_all();
+    for (auto& worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+JobSystem::JobHandle JobSystem::submit(const char* name, std::function<void()> task,
+                                       const std::vector<JobHandle>& dependencies) {
+    return createJob(name, std::move(task), dependencies, false);
+}
+
+JobSystem::JobHandle JobSystem::createJob(const char* name, std::function<void()> task,
+                                          const std::vector<JobHandle>& dependencies, bool helpable) {
+    auto job = std::make_shared<Job>();
+    job->_name = name ? name : "";
+    job->_task = std::move(task);
+    job->_helpable = helpable;
+
+    // 先占一个计数，避免依赖在登记过程中完成导致提前入队
+    job->_pendingDeps.store(1);
+    for (const auto& dependency : dependencies) {
+        if (!dependency) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(dependency->_mutex);
+        if (!dependency->_done.load()) {
+            job->_pendingDeps.fetch_add(1);
+            dependency->_continuations.push_back(job);
+        }
+    }
+    if (job->_pendingDeps.fetch_sub(1) == 1) {
+        enqueue(job);
+    }
+    return job;
+}
+
+void JobSystem::enqueue(const JobHandle& job) {
+    job->_readyTime = std::chrono::steady_clock::now();
+
+    // 工作线程派生的任务放进自己的队列，外部提交的任务轮流分配
+    WorkQueue* queue = &_helpableQueue;
+    if (!job->_helpable) {
+        int index = t_workerIndex;
+        if (index < 0) {
+            index = static_cast<int>(_nextQueue.fetch_add(1) % _queues.size());
+        }
+        queue = _queues[index].get();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(job);
+    }
+
+    int depth = _queued.fetch_add(1) + 1;
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _peakQueued = std::max(_peakQueued, depth);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wakeCv.notify_one();
+}
+
+bool JobSystem::tryRunOne(int preferredQueue, bool helpableOnly) {
+    JobHandle job;
+    const int queueCount = static_cast<int>(_queues.size());
+
+    // 优先处理有线程在等待的并行分块
+    {
+        std::lock_guard<std::mutex> lock(_helpableQueue.mutex);
+        if (!_helpableQueue.jobs.empty()) {
+            job = std::move(_helpableQueue.jobs.front());
+            _helpableQueue.jobs.pop_front();
+        }
+    }
+
+    // 再取自己队列尾部，最后从其他队列头部窃取
+    if (!job && helpableOnly) {
+        return false;
+    }
+    if (!job && preferredQueue >= 0) {
+        auto& own = *_queues[preferredQueue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+        }
+    }
+    if (!job) {
+        int start = preferredQueue >= 0 ? preferredQueue + 1 : 0;
+        for (int i = 0; i < queueCount && !job; ++i) {
+            auto& victim = *_queues[(start + i) % queueCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+            }
+        }
+    }
+    if (!job) {
+        return false;
+    }
+
+    _queued.fetch_sub(1);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(const JobHandle& job) {
+    auto start = std::chrono::steady_clock::now();
+    if (job->_task) {
+        job->_task();
+        job->_task = nullptr;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (t_workerIndex >= 0) {
+        t_scratch.reset();
+    }
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->_mutex);
+        job->_done.store(true);
+        continuations.swap(job->_continuations);
+    }
+    for (const auto& next : continuations) {
+        if (next->_pendingDeps.fetch_sub(1) == 1) {
+            enqueue(next);
+        }
+    }
+
+    float waitMs = elapsedMs(job->_readyTime, start);
+    float runMs = elapsedMs(start, end);
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        ++_completed;
+        _totalWaitMs += waitMs;
+        _totalRunMs += runMs;
+        _maxWaitMs = std::max(_maxWaitMs, waitMs);
+        _maxRunMs = std::max(_maxRunMs, runMs);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _completionCv.notify_all();
+}
+
+void JobSystem::workerLoop(int index) {
+    t_workerIndex = index;
+    while (true) {
+        if (tryRunOne(index, false)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wakeCv.wait(lock, [this]() {
+            return _stopping || _queued.load() > 0;
+        });
+        // 退出前先排空队列，保证已提交的存档/回放写入落盘
+        if (_stopping && _queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+void JobSystem::wait(const JobHandle& job) {
+    if (!job) {
+        return;
+    }
+    while (!job->_done.load()) {
+        if (tryRunOne(t_workerIndex, t_workerIndex < 0)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _completionCv.wait_for(lock, std::chrono::milliseconds(kWaitPollMs), [&job]() {
+            return job->_done.load();
+        });
+    }
+}
+
+bool JobSystem::isDone(const JobHandle& job) {
+    return !job || job->_done.load();
+}
+
+void JobSystem::parallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    grain = std::max(1, grain);
+    int chunks = (count + grain - 1) / grain;
+    if (chunks <= 1) {
+        fn(0, count);
+        return;
+    }
+
+    // 调用线程执行第一块，其余分块入队，再帮忙执行直到全部完成
+    std::vector<JobHandle> jobs;
+    jobs.reserve(chunks - 1);
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        int begin = chunk * grain;
+        int end = std::min(count, begin + grain);
+        jobs.push_back(createJob("parallelFor", [&fn, begin, end]() {
+            fn(begin, end);
+        }, {}, true));
+    }
+    fn(0, std::min(count, grain));
+    for (const auto& job : jobs) {
+        wait(job);
+    }
+}
+
+void JobSystem::runOnMainThread(std::function<void()> fn) {
+    cocos2d::Director::getInstance()->getScheduler()->performFunctionInCocosThread(fn);
+}
+
+ScratchArena& JobSystem::scratch() {
+    return t_scratch;
+}
+
+JobSystem::Stats JobSystem::getStats() const {
+    Stats stats;
+    stats.workers = getWorkerCount();
+    stats.queueDepth = std::max(0, _queued.load());
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    stats.peakQueueDepth = _peakQueued;
+    stats.completed = _completed;
+    if (_completed > 0) {
+        stats.avgWaitMs = static_cast<float>(_totalWaitMs / static_cast<double>(_completed));
+        stats.avgRunMs = static_cast<float>(_totalRunMs / static_cast<double>(_completed));
+    }
+    stats.maxWaitMs = _maxWaitMs;
+    stats.maxRunMs = _maxRunMs;
+    return stats;
+}
+
+std::string JobSystem::buildStatsReport() const {
+    Stats stats = getStats();
+    return cocos2d::StringUtils::format(
+        "Jobs: %llu done  workers %d  queue %d (peak %d)  wait avg %.2fms max %.2fms  run avg %.2fms max %.2fms",
+        static_cast<unsigned long long>(stats.completed),
+        stats.workers,
+        stats.queueDepth,
+        stats.peakQueueDepth,
+        stats.avgWaitMs,
+        stats.maxWaitMs,
+        stats.avgRunMs,
+        stats.maxRunMs);
+}
+
+// ===================================================
+// JobIO
+// ===================================================
+
+namespace {
+const char* describeStatus(cocos2d::FileUtils::Status status) {
+    switch (status) {
+    case cocos2d::FileUtils::Status::NotExists:
+        return "文件不存在";
+    case cocos2d::FileUtils::Status::OpenFailed:
+        return "无法打开";
+    case cocos2d::FileUtils::Status::ReadFailed:
+        return "读取失败";
+    case cocos2d::FileUtils::Status::TooLarge:
+        return "文件过大";
+    case cocos2d::FileUtils::Status::ObtainSizeFailed:
+        return "无法获取大小";
+    default:
+        return "未知错误";
+    }
+}
+
+void setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+// 用临时文件整体替换目标文件，不预先删除目标（替换失败时旧文件仍完好）
+bool replaceFile(const std::string& fromPath, const std::string& toPath) {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    auto widen = [](const std::string& utf8) {
+        int length = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, nullptr, 0);
+        std::wstring wide(length > 0 ? length - 1 : 0, L'\0');
+        if (length > 1) {
+            MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wide[0], length);
+        }
+        return wide;
+    };
+    return MoveFileExW(widen(fromPath).c_str(), widen(toPath).c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    // POSIX rename 对已存在的目标是原子替换
+    return std::rename(fromPath.c_str(), toPath.c_str()) == 0;
+#endif
+}
+} // namespace
+
+bool JobIO::readFile(const std::string& fullPath, std::string& out, std::string* error) {
+    if (fullPath.empty()) {
+        setError(error, "路径为空");
+        return false;
+    }
+    auto status = cocos2d::FileUtils::getInstance()->getContents(fullPath, &out);
+    if (status != cocos2d::FileUtils::Status::OK) {
+        setError(error, cocos2d::StringUtils::format("%s: %s", describeStatus(status), fullPath.c_str()));
+        return false;
+    }
+    return true;
+}
+
+bool JobIO::writeFile(const std::string& fullPath, const std::string& data, std::string* error) {
+    if (fullPath.empty()) {
+        setError(error, "路径为空");
+        return false;
+    }
+    std::string tempPath = fullPath + ".tmp";
+    auto* fileUtils = cocos2d::FileUtils::getInstance();
+    if (!fileUtils->writeStringToFile(data, tempPath)) {
+        setError(error, "无法写入临时文件: " + tempPath);
+        return false;
+    }
+    if (!replaceFile(tempPath, fullPath)) {
+        setError(error, "无法替换目标文件: " + fullPath);
+        fileUtils->removeFile(tempPath);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,198 @@
+﻿// JobSystem.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===================================================
+// 临时内存区：按块线性分配，reset() 后整体复用
+// ===================================================
+class ScratchArena {
+public:
+    explicit ScratchArena(size_t blockSize = 64 * 1024);
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+    void reset();
+
+    size_t getUsed() const { return _used; }
+    size_t getCapacity() const { return _blocks.size() * _blockSize; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    size_t _blockSize;
+    size_t _blockIndex = 0;
+    size_t _offset = 0;
+    size_t _used = 0;
+};
+
+/**
+ * 任务系统（工作窃取线程池）
+ * - 每个工作线程持有一个双端队列：自己从尾部取（后进先出，缓存友好），空闲时从别人头部窃取；
+ * - 任务可声明依赖，全部依赖完成后才会入队（任务图）；
+ * - JobFuture 保存返回值，then() 把后续回调转发到 cocos Scheduler 在主线程执行；
+ * - 每个线程有独立的 ScratchArena，任务结束后自动清空；
+ * - 统计队列深度与任务排队/执行耗时。
+ * 任务内不能触碰 cocos 节点与 FileUtils 的路径解析（非线程安全），文件读写请用 JobIO。
+ */
+class JobSystem {
+public:
+    class Job;
+    using JobHandle = std::shared_ptr<Job>;
+
+    struct Stats {
+        int workers = 0;
+        int queueDepth = 0;          // 当前排队任务数
+        int peakQueueDepth = 0;      // 历史最大排队数
+        uint64_t completed = 0;      // 已完成任务数
+        float avgWaitMs = 0.0f;      // 入队到开始执行的平均耗时
+        float maxWaitMs = 0.0f;
+        float avgRunMs = 0.0f;       // 平均执行耗时
+        float maxRunMs = 0.0f;
+    };
+
+    static JobSystem* getInstance();
+    static void destroyInstance();
+
+    int getWorkerCount() const { return static_cast<int>(_workers.size()); }
+
+    // 提交任务；dependencies 全部完成后才会执行
+    JobHandle submit(const char* name, std::function<void()> task,
+                     const std::vector<JobHandle>& dependencies = {});
+
+    // 等待任务完成，等待期间当前线程会帮忙执行排队任务
+    void wait(const JobHandle& job);
+    static bool isDone(const JobHandle& job);
+
+    // 把 [0, count) 按 grain 切块并行执行 fn(begin, end)，返回时全部完成
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+    // 在主线程执行（经 cocos Scheduler 转发到下一次调度）
+    static void runOnMainThread(std::function<void()> fn);
+
+    // 当前线程的临时内存区：工作线程在每个任务结束后清空，主线程由调用方自行 reset()
+    static ScratchArena& scratch();
+
+    Stats getStats() const;
+    std::string buildStatsReport() const;
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+    };
+
+    JobSystem();
+    ~JobSystem();
+
+    JobHandle createJob(const char* name, std::function<void()> task,
+                        const std::vector<JobHandle>& dependencies, bool helpable);
+    void enqueue(const JobHandle& job);
+    // helpableOnly：主线程等待时只帮忙执行 parallelFor 分块，不会接手耗时的 I/O 任务
+    bool tryRunOne(int preferredQueue, bool helpableOnly);
+    void execute(const JobHandle& job);
+    void workerLoop(int index);
+
+    static JobSystem* s_instance;
+
+    std::vector<std::thread> _workers;
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    WorkQueue _helpableQueue;                   // parallelFor 分块，所有线程共享
+    std::atomic<int> _queued{ 0 };
+    std::atomic<unsigned int> _nextQueue{ 0 };
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeCv;
+    std::condition_variable _completionCv;
+    bool _stopping = false;
+
+    mutable std::mutex _statsMutex;
+    int _peakQueued = 0;
+    uint64_t _completed = 0;
+    double _totalWaitMs = 0.0;
+    double _totalRunMs = 0.0;
+    float _maxWaitMs = 0.0f;
+    float _maxRunMs = 0.0f;
+};
+
+class JobSystem::Job {
+public:
+    const char* getName() const { return _name; }
+
+private:
+    friend class JobSystem;
+
+    const char* _name = "";
+    std::function<void()> _task;
+    bool _helpable = false;
+    std::atomic<int> _pendingDeps{ 0 };
+    std::atomic<bool> _done{ false };
+    std::mutex _mutex;                          // 保护 _continuations 与完成状态切换
+    std::vector<JobHandle> _continuations;      // 依赖本任务的后继任务
+    std::chrono::steady_clock::time_point _readyTime;
+};
+
+/**
+ * 带返回值的任务
+ * 值在任务完成后只读，then() 的回调在主线程收到一份拷贝。
+ */
+template <typename T>
+class JobFuture {
+public:
+    JobFuture() = default;
+
+    static JobFuture run(const char* name, std::function<T()> fn,
+                         const std::vector<JobSystem::JobHandle>& dependencies = {}) {
+        JobFuture future;
+        auto state = std::make_shared<State>();
+        state->job = JobSystem::getInstance()->submit(name, [state, fn]() {
+            state->value = fn();
+        }, dependencies);
+        future._state = state;
+        return future;
+    }
+
+    bool valid() const { return _state != nullptr; }
+    bool isReady() const { return _state && JobSystem::isDone(_state->job); }
+    const JobSystem::JobHandle& getJob() const { return _state->job; }
+
+    // 阻塞等待（只应在确实需要结果时使用）
+    const T& get() const {
+        JobSystem::getInstance()->wait(_state->job);
+        return _state->value;
+    }
+
+    // 任务完成后在主线程调用 onReady(value)
+    void then(std::function<void(const T&)> onReady) const {
+        auto state = _state;
+        JobSystem::getInstance()->submit("then", [state, onReady]() {
+            JobSystem::runOnMainThread([state, onReady]() {
+                onReady(state->value);
+            });
+        }, { state->job });
+    }
+
+private:
+    struct State {
+        JobSystem::JobHandle job;
+        T value{};
+    };
+    std::shared_ptr<State> _state;
+};
+
+// 任务线程中的文件读写
+// 路径须先在主线程用 fullPathForFilename 解析（路径缓存非线程安全），读写本身仍走 FileUtils：
+// 安卓上可读 APK 内的资源，Win32 上支持非 ASCII 路径。失败时 error 给出原因。
+namespace JobIO {
+bool readFile(const std::string& fullPath, std::string& out, std::string* error = nullptr);
+// 原子写入：先写临时文件再整体替换，目标文件要么是旧内容要么是新内容
+bool writeFile(const std::string& fullPath, const std::string& data, std::string* error = nullptr);
+} // namespace JobIO
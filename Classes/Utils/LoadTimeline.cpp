@@ -0,0 +1,53 @@
+﻿// LoadTimeline.cpp
+#include "LoadTimeline.h"
+#include "cocos2d.h"
+
+namespace {
+float elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+} // namespace
+
+void LoadTimeline::start() {
+    _start = Clock::now();
+    _last = _start;
+    _phases.clear();
+    _interactiveMs = -1.0f;
+}
+
+void LoadTimeline::mark(const char* phase) {
+    auto now = Clock::now();
+    Phase entry;
+    entry.name = phase ? phase : "";
+    entry.ms = elapsedMs(_last, now);
+    _phases.push_back(entry);
+    _last = now;
+}
+
+void LoadTimeline::markInteractive() {
+    if (isInteractive()) {
+        return;
+    }
+    _interactiveMs = elapsedMs(_start, Clock::now());
+}
+
+float LoadTimeline::getBuildMs() const {
+    float total = 0.0f;
+    for (const auto& phase : _phases) {
+        total += phase.ms;
+    }
+    return total;
+}
+
+std::string LoadTimeline::buildReport() const {
+    std::string phases;
+    for (const auto& phase : _phases) {
+        phases += cocos2d::StringUtils::format("%s%s %.1f",
+            phases.empty() ? "" : "  ", phase.name.c_str(), phase.ms);
+    }
+    std::string ttfi = isInteractive()
+        ? cocos2d::StringUtils::format("%.1fms", _interactiveMs)
+        : std::string("-");
+    return cocos2d::StringUtils::format("Build %.1fms (%s)  TTFI %s",
+        getBuildMs(), phases.c_str(), ttfi.c_str());
+}
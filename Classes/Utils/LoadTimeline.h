@@ -0,0 +1,39 @@
+﻿// LoadTimeline.h
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 场景构建耗时：按阶段记录同步构建耗时，并记下首个可交互帧（TTFI，从 start 起算）
+class LoadTimeline {
+public:
+    void start();
+
+    // 记录从上一个标记到现在的耗时，归入 phase
+    void mark(const char* phase);
+
+    // 首个可交互帧到达时调用，只记录第一次
+    void markInteractive();
+    bool isInteractive() const { return _interactiveMs >= 0.0f; }
+    float getInteractiveMs() const { return _interactiveMs; }
+
+    // 同步构建总耗时（各阶段之和）
+    float getBuildMs() const;
+
+    // 单行报告：各阶段耗时与 TTFI
+    std::string buildReport() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase {
+        std::string name;
+        float ms = 0.0f;
+    };
+
+    Clock::time_point _start;
+    Clock::time_point _last;
+    std::vector<Phase> _phases;
+    float _interactiveMs = -1.0f;
+};